@@ -0,0 +1,105 @@
+#pragma once
+
+#include <Nile/core/types.hh>
+
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace nile::bench {
+
+  // Entity counts that every registered benchmark is executed with, unless
+  // overridden from the command line with --sizes=
+  inline const std::vector<usize> DEFAULT_SIZES = {1000, 10000, 100000};
+
+  // Keeps the compiler from optimizing away values computed inside the timed region
+  template <typename T>
+  inline void doNotOptimize( const T &value ) noexcept {
+#if defined( __GNUC__ ) || defined( __clang__ )
+    asm volatile( "" : : "r,m"( value ) : "memory" );
+#else
+    const volatile char sink = *reinterpret_cast<const volatile char *>( &value );
+    (void)sink;
+#endif
+  }
+
+  class State {
+  private:
+    using clock = std::chrono::steady_clock;
+
+    usize m_size;
+    std::mt19937 m_rng;
+
+    // Nanoseconds spent in the timed region and the number of operations it performed
+    f64 m_elapsedNs = 0.0;
+    usize m_operations = 0;
+    bool m_measured = false;
+
+  public:
+    State( usize size, u32 seed ) noexcept
+        : m_size( size )
+        , m_rng( seed ) {}
+
+    // Number of entities the benchmark should work with
+    [[nodiscard]] usize size() const noexcept {
+      return m_size;
+    }
+
+    // Deterministic random engine, seeded the same way on every run
+    [[nodiscard]] std::mt19937 &rng() noexcept {
+      return m_rng;
+    }
+
+    // Times the given callable once. Everything outside of it (setup and teardown)
+    // is not measured. `operations` is used to report the time per operation.
+    template <typename F>
+    void measure( usize operations, F &&fn ) noexcept {
+      const auto start = clock::now();
+      fn();
+      const auto end = clock::now();
+
+      m_elapsedNs = std::chrono::duration<f64, std::nano>( end - start ).count();
+      m_operations = operations;
+      m_measured = true;
+    }
+
+    [[nodiscard]] f64 elapsedNs() const noexcept {
+      return m_elapsedNs;
+    }
+
+    [[nodiscard]] usize operations() const noexcept {
+      return m_operations;
+    }
+
+    [[nodiscard]] bool measured() const noexcept {
+      return m_measured;
+    }
+  };
+
+  using BenchmarkFn = void ( * )( State & );
+
+  struct Benchmark {
+    std::string group;
+    std::string name;
+    BenchmarkFn fn;
+  };
+
+  // Global list of benchmarks, filled during static initialization by NILE_BENCHMARK
+  std::vector<Benchmark> &registry() noexcept;
+
+  bool registerBenchmark( const char *group, const char *name, BenchmarkFn fn ) noexcept;
+
+}    // namespace nile::bench
+
+#define NILE_BENCH_CONCAT_IMPL( a, b ) a##b
+#define NILE_BENCH_CONCAT( a, b ) NILE_BENCH_CONCAT_IMPL( a, b )
+
+// Defines and registers a benchmark. The body is invoked once per repetition with a fresh
+// State and must call state.measure() exactly once.
+#define NILE_BENCHMARK( group, name )                                                              \
+  static void NILE_BENCH_CONCAT( nile_benchmark_, __LINE__ )( ::nile::bench::State & );            \
+  [[maybe_unused]] static const bool NILE_BENCH_CONCAT( nile_benchmark_registered_, __LINE__ ) =   \
+      ::nile::bench::registerBenchmark( group, name,                                               \
+                                        &NILE_BENCH_CONCAT( nile_benchmark_, __LINE__ ) );         \
+  static void NILE_BENCH_CONCAT( nile_benchmark_, __LINE__ )( ::nile::bench::State & state )
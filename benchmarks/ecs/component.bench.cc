@@ -0,0 +1,75 @@
+#include "../bench.hh"
+
+#include <Nile/ecs/components/transform.hh>
+#include <Nile/ecs/ecs_coordinator.hh>
+
+#include <algorithm>
+#include <vector>
+
+using nile::Coordinator;
+using nile::Entity;
+using nile::f32;
+using nile::usize;
+using nile::Transform;
+using nile::bench::State;
+
+namespace {
+
+  std::vector<Entity> createEntities( Coordinator &coordinator, usize count ) {
+    std::vector<Entity> entities( count );
+    for ( auto &entity : entities )
+      entity = coordinator.createEntity();
+    return entities;
+  }
+
+}    // namespace
+
+NILE_BENCHMARK( "ecs/component", "add" ) {
+  Coordinator coordinator;
+  coordinator.init();
+  coordinator.registerComponent<Transform>();
+
+  const auto entities = createEntities( coordinator, state.size() );
+
+  state.measure( entities.size(), [&] {
+    for ( auto entity : entities )
+      coordinator.addComponent<Transform>( entity, Transform {} );
+  } );
+}
+
+NILE_BENCHMARK( "ecs/component", "remove" ) {
+  Coordinator coordinator;
+  coordinator.init();
+  coordinator.registerComponent<Transform>();
+
+  auto entities = createEntities( coordinator, state.size() );
+  for ( auto entity : entities )
+    coordinator.addComponent<Transform>( entity, Transform {} );
+
+  // Removing in random order exercises the swap-with-last path of the packed storage
+  std::shuffle( entities.begin(), entities.end(), state.rng() );
+
+  state.measure( entities.size(), [&] {
+    for ( auto entity : entities )
+      coordinator.removeComponent<Transform>( entity );
+  } );
+}
+
+NILE_BENCHMARK( "ecs/component", "get_random" ) {
+  Coordinator coordinator;
+  coordinator.init();
+  coordinator.registerComponent<Transform>();
+
+  auto entities = createEntities( coordinator, state.size() );
+  for ( auto entity : entities )
+    coordinator.addComponent<Transform>( entity, Transform {} );
+
+  std::shuffle( entities.begin(), entities.end(), state.rng() );
+
+  state.measure( entities.size(), [&] {
+    f32 sum = 0.0f;
+    for ( auto entity : entities )
+      sum += coordinator.getComponent<Transform>( entity ).position.x;
+    nile::bench::doNotOptimize( sum );
+  } );
+}
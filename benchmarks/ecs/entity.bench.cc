@@ -0,0 +1,64 @@
+#include "../bench.hh"
+
+#include <Nile/ecs/ecs_coordinator.hh>
+
+#include <algorithm>
+#include <vector>
+
+using nile::Coordinator;
+using nile::Entity;
+using nile::usize;
+using nile::bench::State;
+
+NILE_BENCHMARK( "ecs/entity", "create" ) {
+  Coordinator coordinator;
+  coordinator.init();
+
+  std::vector<Entity> entities( state.size() );
+
+  state.measure( state.size(), [&] {
+    for ( auto &entity : entities )
+      entity = coordinator.createEntity();
+  } );
+
+  nile::bench::doNotOptimize( entities.back() );
+}
+
+NILE_BENCHMARK( "ecs/entity", "destroy" ) {
+  Coordinator coordinator;
+  coordinator.init();
+
+  std::vector<Entity> entities( state.size() );
+  for ( auto &entity : entities )
+    entity = coordinator.createEntity();
+
+  // Destroy in random order so the free list does not stay sorted
+  std::shuffle( entities.begin(), entities.end(), state.rng() );
+
+  state.measure( state.size(), [&] {
+    for ( auto entity : entities )
+      coordinator.destroyEntity( entity );
+  } );
+}
+
+NILE_BENCHMARK( "ecs/entity", "create_destroy_churn" ) {
+  Coordinator coordinator;
+  coordinator.init();
+
+  std::vector<Entity> entities( state.size() );
+  for ( auto &entity : entities )
+    entity = coordinator.createEntity();
+
+  // Recycle half of the entities, the way spawning/despawning looks during gameplay
+  std::shuffle( entities.begin(), entities.end(), state.rng() );
+  const auto half = entities.size() / 2;
+
+  state.measure( half * 2, [&] {
+    for ( usize i = 0; i < half; ++i )
+      coordinator.destroyEntity( entities[ i ] );
+    for ( usize i = 0; i < half; ++i )
+      entities[ i ] = coordinator.createEntity();
+  } );
+
+  nile::bench::doNotOptimize( entities.front() );
+}
@@ -0,0 +1,114 @@
+#include "../bench.hh"
+
+#include <Nile/ecs/components/transform.hh>
+#include <Nile/ecs/ecs_coordinator.hh>
+#include <Nile/ecs/ecs_system.hh>
+
+#include <glm/glm.hpp>
+
+using nile::Coordinator;
+using nile::Entity;
+using nile::usize;
+using nile::f32;
+using nile::Signature;
+using nile::Transform;
+using nile::bench::State;
+
+namespace {
+
+  struct Velocity {
+    glm::vec3 linear {0.0f};
+    glm::vec3 angular {0.0f};
+  };
+
+  struct Tint {
+    glm::vec3 color {1.0f};
+    f32 alpha {1.0f};
+  };
+
+  // Systems in the same shape as the engine ones, iterating over entities_ and
+  // fetching components through the coordinator
+  class MoveSystem : public nile::System {
+  private:
+    Coordinator &ecs_coordinator_;
+
+  public:
+    explicit MoveSystem( Coordinator &coordinator ) noexcept
+        : ecs_coordinator_( coordinator ) {}
+
+    void update( f32 dt ) noexcept {
+      for ( auto entity : entities_ ) {
+        auto &transform = ecs_coordinator_.getComponent<Transform>( entity );
+        transform.position.x += dt;
+      }
+    }
+  };
+
+  class IntegrateSystem : public nile::System {
+  private:
+    Coordinator &ecs_coordinator_;
+
+  public:
+    explicit IntegrateSystem( Coordinator &coordinator ) noexcept
+        : ecs_coordinator_( coordinator ) {}
+
+    void update( f32 dt ) noexcept {
+      for ( auto entity : entities_ ) {
+        auto &transform = ecs_coordinator_.getComponent<Transform>( entity );
+        const auto &velocity = ecs_coordinator_.getComponent<Velocity>( entity );
+        auto &tint = ecs_coordinator_.getComponent<Tint>( entity );
+
+        transform.position += velocity.linear * dt;
+        transform.zRotation += velocity.angular.z * dt;
+        tint.alpha *= 0.99f;
+      }
+    }
+  };
+
+}    // namespace
+
+NILE_BENCHMARK( "ecs/iteration", "single_component" ) {
+  Coordinator coordinator;
+  coordinator.init();
+  coordinator.registerComponent<Transform>();
+
+  auto system = coordinator.registerSystem<MoveSystem>( coordinator );
+  Signature signature;
+  signature.set( coordinator.getComponentType<Transform>() );
+  coordinator.setSystemSignature<MoveSystem>( signature );
+
+  for ( usize i = 0; i < state.size(); ++i ) {
+    auto entity = coordinator.createEntity();
+    coordinator.addComponent<Transform>( entity, Transform {} );
+  }
+
+  state.measure( system->entities_.size(), [&] { coordinator.update( 0.016f ); } );
+}
+
+NILE_BENCHMARK( "ecs/iteration", "multi_component" ) {
+  Coordinator coordinator;
+  coordinator.init();
+  coordinator.registerComponent<Transform>();
+  coordinator.registerComponent<Velocity>();
+  coordinator.registerComponent<Tint>();
+
+  auto system = coordinator.registerSystem<IntegrateSystem>( coordinator );
+  Signature signature;
+  signature.set( coordinator.getComponentType<Transform>() );
+  signature.set( coordinator.getComponentType<Velocity>() );
+  signature.set( coordinator.getComponentType<Tint>() );
+  coordinator.setSystemSignature<IntegrateSystem>( signature );
+
+  // Every other entity is missing the Velocity component, so the system only
+  // sees half of the world, like most gameplay systems do
+  for ( usize i = 0; i < state.size(); ++i ) {
+    auto entity = coordinator.createEntity();
+    coordinator.addComponent<Transform>( entity, Transform {} );
+    coordinator.addComponent<Tint>( entity, Tint {} );
+    if ( i % 2 == 0 )
+      coordinator.addComponent<Velocity>(
+          entity, Velocity {glm::vec3( 1.0f, 2.0f, 0.0f ), glm::vec3( 0.0f, 0.0f, 1.0f )} );
+  }
+
+  state.measure( system->entities_.size(), [&] { coordinator.update( 0.016f ); } );
+}
@@ -0,0 +1,81 @@
+#include "../bench.hh"
+
+#include <Nile/ecs/components/relationship.hh>
+#include <Nile/ecs/ecs_coordinator.hh>
+
+#include <algorithm>
+#include <vector>
+
+using nile::Coordinator;
+using nile::Entity;
+using nile::usize;
+using nile::Relationship;
+using nile::bench::State;
+
+namespace {
+
+  // Children per node of the generated hierarchy
+  constexpr usize FAN_OUT = 4;
+
+  std::vector<Entity> setup( Coordinator &coordinator, usize count ) {
+    coordinator.init();
+    coordinator.registerComponent<Relationship>();
+
+    std::vector<Entity> entities( count );
+    for ( auto &entity : entities ) {
+      entity = coordinator.createEntity();
+      coordinator.addComponent<Relationship>( entity, Relationship {} );
+    }
+    return entities;
+  }
+
+  // Builds a tree where entity i is a child of entity (i - 1) / FAN_OUT
+  void attachAll( Coordinator &coordinator, const std::vector<Entity> &entities ) {
+    for ( usize i = 1; i < entities.size(); ++i )
+      coordinator.attachTo( entities[ ( i - 1 ) / FAN_OUT ], entities[ i ] );
+  }
+
+}    // namespace
+
+NILE_BENCHMARK( "ecs/relationship", "attach" ) {
+  Coordinator coordinator;
+  const auto entities = setup( coordinator, state.size() );
+
+  state.measure( entities.size() - 1, [&] { attachAll( coordinator, entities ); } );
+}
+
+NILE_BENCHMARK( "ecs/relationship", "detach" ) {
+  Coordinator coordinator;
+  auto entities = setup( coordinator, state.size() );
+  attachAll( coordinator, entities );
+
+  // Detach in random order so both the first-child and the middle-of-list paths are hit
+  std::vector<Entity> children( entities.begin() + 1, entities.end() );
+  std::shuffle( children.begin(), children.end(), state.rng() );
+
+  state.measure( children.size(), [&] {
+    for ( auto child : children )
+      coordinator.detach( child );
+  } );
+}
+
+NILE_BENCHMARK( "ecs/relationship", "traverse" ) {
+  Coordinator coordinator;
+  const auto entities = setup( coordinator, state.size() );
+  attachAll( coordinator, entities );
+
+  state.measure( entities.size(), [&] {
+    // Depth first walk through firstChild/next links starting at the root
+    std::vector<Entity> stack {entities.front()};
+    usize visited = 0;
+    while ( !stack.empty() ) {
+      auto entity = stack.back();
+      stack.pop_back();
+      ++visited;
+      for ( auto child = coordinator.getFirst( entity ); child != nile::ecs::null;
+            child = coordinator.getNext( child ) )
+        stack.push_back( child );
+    }
+    nile::bench::doNotOptimize( visited );
+  } );
+}
@@ -0,0 +1,97 @@
+#include "../bench.hh"
+
+#include <Nile/ecs/ecs_coordinator.hh>
+#include <Nile/ecs/ecs_system.hh>
+
+#include <utility>
+#include <vector>
+
+using nile::Coordinator;
+using nile::Entity;
+using nile::usize;
+using nile::Signature;
+using nile::bench::State;
+
+namespace {
+
+  constexpr usize SYSTEMS_COUNT = 32;
+  constexpr usize COMPONENTS_COUNT = 8;
+
+  template <usize N>
+  struct Component {
+    float value {0.0f};
+  };
+
+  template <usize N>
+  class DummySystem : public nile::System {};
+
+  template <usize... I>
+  void registerComponents( Coordinator &coordinator, std::index_sequence<I...> ) {
+    ( coordinator.registerComponent<Component<I>>(), ... );
+  }
+
+  // Each system is interested in a different pair of components, so toggling a
+  // single component moves the entity in and out of several systems at once
+  template <usize I>
+  void registerSystem( Coordinator &coordinator ) {
+    coordinator.registerSystem<DummySystem<I>>();
+    Signature signature;
+    signature.set( coordinator.getComponentType<Component<I % COMPONENTS_COUNT>>() );
+    if ( I >= COMPONENTS_COUNT )
+      signature.set(
+          coordinator.getComponentType<Component<( I / COMPONENTS_COUNT + I ) % COMPONENTS_COUNT>>() );
+    coordinator.setSystemSignature<DummySystem<I>>( signature );
+  }
+
+  template <usize... I>
+  void registerSystems( Coordinator &coordinator, std::index_sequence<I...> ) {
+    ( registerSystem<I>( coordinator ), ... );
+  }
+
+  std::vector<Entity> setup( Coordinator &coordinator, usize count ) {
+    coordinator.init();
+    registerComponents( coordinator, std::make_index_sequence<COMPONENTS_COUNT> {} );
+    registerSystems( coordinator, std::make_index_sequence<SYSTEMS_COUNT> {} );
+
+    std::vector<Entity> entities( count );
+    for ( auto &entity : entities ) {
+      entity = coordinator.createEntity();
+      coordinator.addComponent<Component<1>>( entity, Component<1> {} );
+      coordinator.addComponent<Component<2>>( entity, Component<2> {} );
+    }
+    return entities;
+  }
+
+}    // namespace
+
+NILE_BENCHMARK( "ecs/signature", "add_component_32_systems" ) {
+  Coordinator coordinator;
+  const auto entities = setup( coordinator, state.size() );
+
+  state.measure( entities.size(), [&] {
+    for ( auto entity : entities )
+      coordinator.addComponent<Component<0>>( entity, Component<0> {} );
+  } );
+}
+
+NILE_BENCHMARK( "ecs/signature", "remove_component_32_systems" ) {
+  Coordinator coordinator;
+  const auto entities = setup( coordinator, state.size() );
+  for ( auto entity : entities )
+    coordinator.addComponent<Component<0>>( entity, Component<0> {} );
+
+  state.measure( entities.size(), [&] {
+    for ( auto entity : entities )
+      coordinator.removeComponent<Component<0>>( entity );
+  } );
+}
+
+NILE_BENCHMARK( "ecs/signature", "destroy_entity_32_systems" ) {
+  Coordinator coordinator;
+  const auto entities = setup( coordinator, state.size() );
+
+  state.measure( entities.size(), [&] {
+    for ( auto entity : entities )
+      coordinator.destroyEntity( entity );
+  } );
+}
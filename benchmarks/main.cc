@@ -0,0 +1,276 @@
+#include "bench.hh"
+
+#include <project_config.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <sstream>
+
+namespace nile::bench {
+
+  std::vector<Benchmark> &registry() noexcept {
+    static std::vector<Benchmark> benchmarks;
+    return benchmarks;
+  }
+
+  bool registerBenchmark( const char *group, const char *name, BenchmarkFn fn ) noexcept {
+    registry().push_back( {group, name, fn} );
+    return true;
+  }
+
+}    // namespace nile::bench
+
+namespace {
+
+  using namespace nile;
+  using nile::bench::Benchmark;
+  using nile::bench::State;
+
+  enum class Format { JSON, CSV };
+
+  struct Options {
+    Format format = Format::JSON;
+    std::string output;
+    std::string filter;
+    std::vector<usize> sizes = bench::DEFAULT_SIZES;
+    u32 repetitions = 10;
+    u32 warmup = 2;
+    u32 seed = 1337;
+    bool list = false;
+  };
+
+  struct Result {
+    const Benchmark *benchmark;
+    usize size;
+    usize operations;
+    // Time per operation in nanoseconds
+    f64 min;
+    f64 median;
+    f64 mean;
+    f64 stddev;
+  };
+
+  void printUsage( const char *program ) {
+    std::fprintf( stderr,
+                  "usage: %s [options]\n"
+                  "  --format=json|csv    output format (default: json)\n"
+                  "  --output=<file>      write results to a file instead of stdout\n"
+                  "  --filter=<text>      run only benchmarks whose \"group/name\" contains text\n"
+                  "  --sizes=<n,n,...>    entity counts (default: 1000,10000,100000)\n"
+                  "  --repetitions=<n>    measured runs per benchmark (default: 10)\n"
+                  "  --warmup=<n>         discarded runs per benchmark (default: 2)\n"
+                  "  --seed=<n>           seed of the random engine (default: 1337)\n"
+                  "  --list               list available benchmarks and exit\n",
+                  program );
+  }
+
+  bool startsWith( const char *arg, const char *prefix, const char **value ) {
+    const auto length = std::strlen( prefix );
+    if ( std::strncmp( arg, prefix, length ) != 0 )
+      return false;
+    *value = arg + length;
+    return true;
+  }
+
+  bool parseOptions( int argc, char **argv, Options &options ) {
+    for ( int i = 1; i < argc; ++i ) {
+      const char *value = nullptr;
+      if ( startsWith( argv[ i ], "--format=", &value ) ) {
+        if ( std::strcmp( value, "json" ) == 0 ) {
+          options.format = Format::JSON;
+        } else if ( std::strcmp( value, "csv" ) == 0 ) {
+          options.format = Format::CSV;
+        } else {
+          std::fprintf( stderr, "unknown format: %s\n", value );
+          return false;
+        }
+      } else if ( startsWith( argv[ i ], "--output=", &value ) ) {
+        options.output = value;
+      } else if ( startsWith( argv[ i ], "--filter=", &value ) ) {
+        options.filter = value;
+      } else if ( startsWith( argv[ i ], "--sizes=", &value ) ) {
+        options.sizes.clear();
+        std::stringstream ss( value );
+        std::string item;
+        while ( std::getline( ss, item, ',' ) ) {
+          if ( !item.empty() )
+            options.sizes.push_back( std::strtoull( item.c_str(), nullptr, 10 ) );
+        }
+      } else if ( startsWith( argv[ i ], "--repetitions=", &value ) ) {
+        options.repetitions = std::max( 1ul, std::strtoul( value, nullptr, 10 ) );
+      } else if ( startsWith( argv[ i ], "--warmup=", &value ) ) {
+        options.warmup = std::strtoul( value, nullptr, 10 );
+      } else if ( startsWith( argv[ i ], "--seed=", &value ) ) {
+        options.seed = std::strtoul( value, nullptr, 10 );
+      } else if ( std::strcmp( argv[ i ], "--list" ) == 0 ) {
+        options.list = true;
+      } else {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  Result run( const Benchmark &benchmark, usize size, const Options &options ) {
+
+    std::vector<f64> samples;
+    samples.reserve( options.repetitions );
+    usize operations = 0;
+
+    for ( u32 i = 0; i < options.warmup + options.repetitions; ++i ) {
+      State state( size, options.seed );
+      benchmark.fn( state );
+
+      if ( !state.measured() ) {
+        std::fprintf( stderr, "benchmark %s/%s did not call State::measure()\n",
+                      benchmark.group.c_str(), benchmark.name.c_str() );
+        std::exit( EXIT_FAILURE );
+      }
+
+      if ( i < options.warmup )
+        continue;
+
+      operations = std::max<usize>( state.operations(), 1 );
+      samples.push_back( state.elapsedNs() / static_cast<f64>( operations ) );
+    }
+
+    std::sort( samples.begin(), samples.end() );
+
+    const auto count = static_cast<f64>( samples.size() );
+    const auto mid = samples.size() / 2;
+    const f64 median =
+        samples.size() % 2 ? samples[ mid ] : ( samples[ mid - 1 ] + samples[ mid ] ) * 0.5;
+    const f64 mean = std::accumulate( samples.begin(), samples.end(), 0.0 ) / count;
+
+    f64 variance = 0.0;
+    for ( auto sample : samples )
+      variance += ( sample - mean ) * ( sample - mean );
+
+    return {&benchmark, size,   operations, samples.front(),
+            median,     mean, std::sqrt( variance / count )};
+  }
+
+  const char *buildType() {
+#if defined( NDEBUG )
+    return "release";
+#else
+    return "debug";
+#endif
+  }
+
+  std::string compilerName() {
+    std::stringstream ss;
+#if defined( __clang__ )
+    ss << "clang " << __clang_major__ << "." << __clang_minor__ << "." << __clang_patchlevel__;
+#elif defined( __GNUC__ )
+    ss << "gcc " << __GNUC__ << "." << __GNUC_MINOR__ << "." << __GNUC_PATCHLEVEL__;
+#elif defined( _MSC_VER )
+    ss << "msvc " << _MSC_VER;
+#else
+    ss << "unknown";
+#endif
+    return ss.str();
+  }
+
+  void writeJson( std::ostream &out, const std::vector<Result> &results, const Options &options ) {
+    out << "{\n";
+    out << "  \"context\": {\n";
+    out << "    \"engine_version\": \"" << PROJECT_VERSION_MAJOR << "." << PROJECT_VERSION_MINOR
+        << "." << PROJECT_VERSION_PATCH << "." << PROJECT_VERSION_TWEAK << "\",\n";
+    out << "    \"compiler\": \"" << compilerName() << "\",\n";
+    out << "    \"build_type\": \"" << buildType() << "\",\n";
+    out << "    \"max_entities\": " << ecs::MAX_ENTITIES << ",\n";
+    out << "    \"seed\": " << options.seed << ",\n";
+    out << "    \"warmup\": " << options.warmup << ",\n";
+    out << "    \"repetitions\": " << options.repetitions << "\n";
+    out << "  },\n";
+    out << "  \"benchmarks\": [";
+
+    for ( usize i = 0; i < results.size(); ++i ) {
+      const auto &r = results[ i ];
+      out << ( i ? ",\n" : "\n" );
+      out << "    {\"group\": \"" << r.benchmark->group << "\", \"name\": \""
+          << r.benchmark->name << "\", \"entities\": " << r.size
+          << ", \"operations\": " << r.operations << ", \"min_ns\": " << r.min
+          << ", \"median_ns\": " << r.median << ", \"mean_ns\": " << r.mean
+          << ", \"stddev_ns\": " << r.stddev << "}";
+    }
+
+    out << "\n  ]\n}\n";
+  }
+
+  void writeCsv( std::ostream &out, const std::vector<Result> &results ) {
+    out << "group,name,entities,operations,min_ns,median_ns,mean_ns,stddev_ns\n";
+    for ( const auto &r : results ) {
+      out << r.benchmark->group << "," << r.benchmark->name << "," << r.size << ","
+          << r.operations << "," << r.min << "," << r.median << "," << r.mean << ","
+          << r.stddev << "\n";
+    }
+  }
+
+}    // namespace
+
+int main( int argc, char **argv ) {
+
+  Options options;
+  if ( !parseOptions( argc, argv, options ) ) {
+    printUsage( argv[ 0 ] );
+    return EXIT_FAILURE;
+  }
+
+  auto benchmarks = nile::bench::registry();
+  std::sort( benchmarks.begin(), benchmarks.end(), []( const auto &a, const auto &b ) {
+    return a.group != b.group ? a.group < b.group : a.name < b.name;
+  } );
+
+  if ( options.list ) {
+    for ( const auto &b : benchmarks )
+      std::printf( "%s/%s\n", b.group.c_str(), b.name.c_str() );
+    return EXIT_SUCCESS;
+  }
+
+  std::vector<Result> results;
+
+  for ( const auto &benchmark : benchmarks ) {
+    const auto fullName = benchmark.group + "/" + benchmark.name;
+    if ( !options.filter.empty() && fullName.find( options.filter ) == std::string::npos )
+      continue;
+
+    for ( auto size : options.sizes ) {
+      // Entity 0 is reserved as the null entity
+      if ( size == 0 || size >= nile::ecs::MAX_ENTITIES ) {
+        std::fprintf( stderr,
+                      "skipping %s with %zu entities, the ECS is configured for %u "
+                      "(see NILE_MAX_ENTITIES)\n",
+                      fullName.c_str(), size, nile::ecs::MAX_ENTITIES - 1 );
+        continue;
+      }
+
+      std::fprintf( stderr, "running %s [%zu]\n", fullName.c_str(), size );
+      results.push_back( run( benchmark, size, options ) );
+    }
+  }
+
+  std::ofstream file;
+  if ( !options.output.empty() ) {
+    file.open( options.output );
+    if ( !file ) {
+      std::fprintf( stderr, "cannot open %s for writing\n", options.output.c_str() );
+      return EXIT_FAILURE;
+    }
+  }
+
+  std::ostream &out = options.output.empty() ? std::cout : file;
+  if ( options.format == Format::JSON )
+    writeJson( out, results, options );
+  else
+    writeCsv( out, results );
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,68 @@
+#include "../bench.hh"
+
+#include <Nile/renderer/clustered_lights.hh>
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <random>
+
+using nile::ClusteredLights;
+using nile::PointLightData;
+using nile::bench::State;
+
+namespace {
+
+  // Small lights scattered in front of a perspective camera, most of them on screen
+  void fill( State &state, ClusteredLights &lights ) {
+    std::uniform_real_distribution<float> side( -60.0f, 60.0f );
+    std::uniform_real_distribution<float> depth( -150.0f, 0.0f );
+    std::uniform_real_distribution<float> range( 1.0f, 8.0f );
+
+    lights.setProjection(
+        glm::perspective( glm::radians( 45.0f ), 16.0f / 9.0f, 0.1f, 200.0f ),
+        glm::vec2( 1920.0f, 1080.0f ) );
+
+    lights.begin();
+    for ( nile::usize i = 0; i < state.size(); ++i ) {
+      PointLightData light;
+      light.position = glm::vec4( side( state.rng() ), side( state.rng() ) * 0.5f,
+                                  depth( state.rng() ), range( state.rng() ) );
+      lights.add( light );
+    }
+  }
+
+  glm::mat4 view() {
+    return glm::lookAt( glm::vec3( 0.0f ), glm::vec3( 0.0f, 0.0f, -1.0f ),
+                        glm::vec3( 0.0f, 1.0f, 0.0f ) );
+  }
+
+}    // namespace
+
+NILE_BENCHMARK( "renderer/clustered_lights", "assign_packed" ) {
+  ClusteredLights lights;
+  fill( state, lights );
+  lights.setThreads( 1 );
+  const auto camera = view();
+
+  state.measure( lights.size(), [&] { lights.assign( camera ); } );
+  nile::bench::doNotOptimize( lights.getStats().entries );
+}
+
+NILE_BENCHMARK( "renderer/clustered_lights", "assign_scalar" ) {
+  ClusteredLights lights;
+  fill( state, lights );
+  lights.setThreads( 1 );
+  const auto camera = view();
+
+  state.measure( lights.size(), [&] { lights.assignScalar( camera ); } );
+  nile::bench::doNotOptimize( lights.getStats().entries );
+}
+
+// Packed, the lights are split among the hardware threads
+NILE_BENCHMARK( "renderer/clustered_lights", "assign_threads" ) {
+  ClusteredLights lights;
+  fill( state, lights );
+  const auto camera = view();
+
+  state.measure( lights.size(), [&] { lights.assign( camera ); } );
+  nile::bench::doNotOptimize( lights.getStats().entries );
+}
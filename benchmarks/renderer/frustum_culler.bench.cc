@@ -0,0 +1,55 @@
+#include "../bench.hh"
+
+#include <Nile/math/frustum.hh>
+#include <Nile/renderer/frustum_culler.hh>
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <random>
+
+using nile::AABB;
+using nile::Frustum;
+using nile::FrustumCuller;
+using nile::bench::State;
+
+namespace {
+
+  // Boxes scattered around a perspective camera, roughly a tenth of them is visible
+  void fill( State &state, FrustumCuller &culler ) {
+    std::uniform_real_distribution<float> position( -500.0f, 500.0f );
+    std::uniform_real_distribution<float> size( 0.5f, 4.0f );
+
+    culler.begin();
+    for ( nile::usize i = 0; i < state.size(); ++i ) {
+      const glm::vec3 center( position( state.rng() ), position( state.rng() ),
+                              position( state.rng() ) );
+      const glm::vec3 extents( size( state.rng() ) );
+      culler.add( AABB {center - extents, center + extents} );
+    }
+  }
+
+  Frustum frustum() {
+    const auto projection = glm::perspective( glm::radians( 45.0f ), 16.0f / 9.0f, 0.1f, 500.0f );
+    const auto view = glm::lookAt( glm::vec3( 0.0f ), glm::vec3( 0.0f, 0.0f, -1.0f ),
+                                   glm::vec3( 0.0f, 1.0f, 0.0f ) );
+    return Frustum::fromMatrix( projection * view );
+  }
+
+}    // namespace
+
+NILE_BENCHMARK( "renderer/frustum_culler", "cull_packed" ) {
+  FrustumCuller culler;
+  fill( state, culler );
+  const auto planes = frustum();
+
+  state.measure( culler.size(), [&] { culler.cull( planes ); } );
+  nile::bench::doNotOptimize( culler.getStats().visible );
+}
+
+NILE_BENCHMARK( "renderer/frustum_culler", "cull_scalar" ) {
+  FrustumCuller culler;
+  fill( state, culler );
+  const auto planes = frustum();
+
+  state.measure( culler.size(), [&] { culler.cullScalar( planes ); } );
+  nile::bench::doNotOptimize( culler.getStats().visible );
+}
@@ -0,0 +1,60 @@
+#include "../bench.hh"
+
+#include <Nile/renderer/render_queue.hh>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using nile::makeRenderKey;
+using nile::RenderLayer;
+using nile::RenderPass;
+using nile::SortItem;
+using nile::u32;
+using nile::usize;
+using nile::bench::State;
+
+namespace {
+
+  // A scene with a handful of programs and materials, a quarter of it transparent
+  std::vector<SortItem> generateKeys( State &state ) {
+    std::uniform_int_distribution<u32> program( 1, 8 );
+    std::uniform_int_distribution<u32> material( 0, 63 );
+    std::uniform_real_distribution<float> depth( 0.1f, 1000.0f );
+    std::uniform_int_distribution<u32> pass( 0, 3 );
+
+    std::vector<SortItem> items( state.size() );
+    for ( u32 i = 0; i < items.size(); ++i ) {
+      const auto renderPass =
+          pass( state.rng() ) == 0 ? RenderPass::TRANSPARENT : RenderPass::OPAQUE;
+      items[ i ].key = makeRenderKey( RenderLayer::WORLD, renderPass, program( state.rng() ),
+                                      material( state.rng() ), depth( state.rng() ) );
+      items[ i ].index = i;
+    }
+    return items;
+  }
+
+}    // namespace
+
+NILE_BENCHMARK( "renderer/render_queue", "radix_sort" ) {
+  const auto keys = generateKeys( state );
+  auto items = keys;
+  std::vector<SortItem> scratch;
+
+  // Grow the scratch buffer outside of the timed region, the queue reuses it every frame
+  nile::radixSort( items, scratch );
+  items = keys;
+
+  state.measure( items.size(), [&] { nile::radixSort( items, scratch ); } );
+  nile::bench::doNotOptimize( items.front().index );
+}
+
+NILE_BENCHMARK( "renderer/render_queue", "std_sort" ) {
+  auto items = generateKeys( state );
+
+  state.measure( items.size(), [&] {
+    std::sort( items.begin(), items.end(),
+               []( const auto &a, const auto &b ) { return a.key < b.key; } );
+  } );
+  nile::bench::doNotOptimize( items.front().index );
+}
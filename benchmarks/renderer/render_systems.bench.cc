@@ -0,0 +1,155 @@
+#include "../bench.hh"
+
+#include <Nile/core/settings.hh>
+#include <Nile/ecs/components/mesh_component.hh>
+#include <Nile/ecs/components/renderable.hh>
+#include <Nile/ecs/components/sprite.hh>
+#include <Nile/ecs/components/transform.hh>
+#include <Nile/ecs/ecs_coordinator.hh>
+#include <Nile/renderer/null_renderer.hh>
+#include <Nile/renderer/render_queue.hh>
+#include <Nile/renderer/rendering_system.hh>
+#include <Nile/renderer/shaderset.hh>
+#include <Nile/renderer/sprite_rendering_system.hh>
+#include <Nile/renderer/stream_buffer.hh>
+#include <Nile/renderer/texture2d.hh>
+
+#include <memory>
+#include <random>
+
+using nile::Coordinator;
+using nile::MeshComponent;
+using nile::NullRenderer;
+using nile::Renderable;
+using nile::RenderingSystem;
+using nile::Settings;
+using nile::ShaderSet;
+using nile::Signature;
+using nile::SpriteComponent;
+using nile::SpriteRenderingSystem;
+using nile::Texture2D;
+using nile::Transform;
+using nile::u32;
+using nile::usize;
+using nile::bench::State;
+
+// The render systems run on the null GL ( nile_null_gl ), every GL call only updates a
+// counter, so the time is the CPU cost of our submission
+
+namespace {
+
+  constexpr usize TEXTURES_COUNT = 8;
+
+  std::shared_ptr<NullRenderer> makeRenderer() {
+    auto settings = std::make_shared<Settings>(
+        Settings::Builder {}.setWidth( 1280 ).setHeight( 720 ).build() );
+    auto renderer = std::make_shared<NullRenderer>( settings );
+    renderer->init();
+    return renderer;
+  }
+
+  std::shared_ptr<Coordinator> makeCoordinator() {
+    auto coordinator = std::make_shared<Coordinator>();
+    coordinator->init();
+    coordinator->registerComponent<Transform>();
+    coordinator->registerComponent<Renderable>();
+    return coordinator;
+  }
+
+  Transform randomTransform( State &state ) {
+    std::uniform_real_distribution<float> position( -500.0f, 500.0f );
+    return Transform( glm::vec3( position( state.rng() ), position( state.rng() ), -1.0f ),
+                      glm::vec3( 16.0f ) );
+  }
+
+  // Same frame as the X11 host, the first one creates the GL objects and grows the buffers
+  void measureFrame( State &state, NullRenderer &renderer, Coordinator &coordinator ) {
+    auto frame = [ & ] {
+      renderer.submitFrame();
+      coordinator.render( 0.0f );
+      renderer.getStreamBuffer()->flush();
+      renderer.getRenderQueue()->execute( *renderer.getStateCache() );
+      renderer.endFrame();
+    };
+
+    frame();
+    state.measure( state.size(), frame );
+
+    nile::bench::doNotOptimize( renderer.getLastFrameStats().draws );
+  }
+
+}    // namespace
+
+NILE_BENCHMARK( "renderer/render_systems", "sprites" ) {
+  auto renderer = makeRenderer();
+  auto coordinator = makeCoordinator();
+  coordinator->registerComponent<SpriteComponent>();
+
+  auto shader = std::make_shared<ShaderSet>( 1, "", "", "" );
+  coordinator->registerSystem<SpriteRenderingSystem>(
+      coordinator, renderer->getStateCache(), renderer->getRenderQueue(),
+      renderer->getStreamBuffer(), shader );
+
+  Signature signature;
+  signature.set( coordinator->getComponentType<Transform>() );
+  signature.set( coordinator->getComponentType<Renderable>() );
+  signature.set( coordinator->getComponentType<SpriteComponent>() );
+  coordinator->setSystemSignature<SpriteRenderingSystem>( signature );
+  coordinator->createSystems();
+
+  std::shared_ptr<Texture2D> textures[ TEXTURES_COUNT ];
+  for ( auto &texture : textures )
+    texture = std::make_shared<Texture2D>();
+
+  std::uniform_int_distribution<usize> texture( 0, TEXTURES_COUNT - 1 );
+  for ( usize i = 0; i < state.size(); ++i ) {
+    const auto entity = coordinator->createEntity();
+    coordinator->addComponent<Transform>( entity, randomTransform( state ) );
+    coordinator->addComponent<Renderable>( entity, Renderable() );
+    coordinator->addComponent<SpriteComponent>(
+        entity, SpriteComponent( textures[ texture( state.rng() ) ] ) );
+  }
+
+  measureFrame( state, *renderer, *coordinator );
+}
+
+NILE_BENCHMARK( "renderer/render_systems", "meshes" ) {
+  auto renderer = makeRenderer();
+  auto coordinator = makeCoordinator();
+  coordinator->registerComponent<MeshComponent>();
+
+  auto shader = std::make_shared<ShaderSet>( 1, "", "", "" );
+  coordinator->registerSystem<RenderingSystem>( coordinator, renderer->getStateCache(),
+                                                renderer->getRenderQueue(),
+                                                renderer->getStreamBuffer(), shader );
+
+  Signature signature;
+  signature.set( coordinator->getComponentType<Transform>() );
+  signature.set( coordinator->getComponentType<Renderable>() );
+  signature.set( coordinator->getComponentType<MeshComponent>() );
+  coordinator->setSystemSignature<RenderingSystem>( signature );
+  coordinator->createSystems();
+
+  // A few distinct quads, the instances of each one are drawn as a group
+  constexpr u32 GEOMETRIES = 16;
+  MeshComponent meshes[ GEOMETRIES ];
+  for ( u32 g = 0; g < GEOMETRIES; ++g ) {
+    for ( u32 i = 0; i < 4; ++i ) {
+      meshes[ g ].vertices.push_back(
+          {{( i & 1 ) + g, i >> 1, 0.0f}, {0.0f, 0.0f, 1.0f}, {i & 1, i >> 1}} );
+    }
+    meshes[ g ].indices = {0, 1, 3, 0, 3, 2};
+  }
+
+  std::uniform_int_distribution<u32> geometry( 0, GEOMETRIES - 1 );
+  for ( usize i = 0; i < state.size(); ++i ) {
+    const auto entity = coordinator->createEntity();
+    coordinator->addComponent<Transform>( entity, randomTransform( state ) );
+    Renderable renderable;
+    renderable.blend = false;
+    coordinator->addComponent<Renderable>( entity, renderable );
+    coordinator->addComponent<MeshComponent>( entity, meshes[ geometry( state.rng() ) ] );
+  }
+
+  measureFrame( state, *renderer, *coordinator );
+}
@@ -0,0 +1,76 @@
+#include "../bench.hh"
+
+#include <Nile/ecs/components/transform.hh>
+#include <Nile/renderer/sprite_batch.hh>
+
+#include <random>
+#include <vector>
+
+using nile::ShaderSet;
+using nile::SpriteBatch;
+using nile::Texture2D;
+using nile::Transform;
+using nile::usize;
+using nile::bench::State;
+
+namespace {
+
+  constexpr usize TEXTURES_COUNT = 8;
+
+  // Only the CPU side of the batch is measured, shaders and textures are used as
+  // grouping keys and never dereferenced
+  template <typename T>
+  T *fakeHandle( std::uintptr_t id ) {
+    return reinterpret_cast<T *>( ( id + 1 ) * 64 );
+  }
+
+  struct SpriteData {
+    Transform transform;
+    Texture2D *texture;
+  };
+
+  std::vector<SpriteData> generateSprites( State &state, bool rotated ) {
+    std::uniform_real_distribution<float> position( -500.0f, 500.0f );
+    std::uniform_real_distribution<float> angle( 0.0f, 360.0f );
+    std::uniform_int_distribution<usize> texture( 0, TEXTURES_COUNT - 1 );
+
+    std::vector<SpriteData> sprites( state.size() );
+    for ( auto &sprite : sprites ) {
+      sprite.transform.position =
+          glm::vec3( position( state.rng() ), position( state.rng() ), 0.0f );
+      sprite.transform.scale = glm::vec3( 16.0f );
+      if ( rotated )
+        sprite.transform.zRotation = angle( state.rng() );
+      sprite.texture = fakeHandle<Texture2D>( texture( state.rng() ) );
+    }
+    return sprites;
+  }
+
+  void run( State &state, bool rotated ) {
+    const auto sprites = generateSprites( state, rotated );
+    auto *shader = fakeHandle<ShaderSet>( TEXTURES_COUNT );
+
+    SpriteBatch batch;
+    auto frame = [&] {
+      batch.begin();
+      for ( const auto &sprite : sprites )
+        batch.submit( shader, sprite.texture, sprite.transform, glm::vec3( 1.0f ), true );
+      batch.end();
+    };
+
+    // The first frame grows the internal buffers, measure the steady state
+    frame();
+    state.measure( sprites.size(), frame );
+
+    nile::bench::doNotOptimize( batch.getStats().drawCalls );
+  }
+
+}    // namespace
+
+NILE_BENCHMARK( "renderer/sprite_batch", "build_axis_aligned" ) {
+  run( state, false );
+}
+
+NILE_BENCHMARK( "renderer/sprite_batch", "build_rotated" ) {
+  run( state, true );
+}
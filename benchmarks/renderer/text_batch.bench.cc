@@ -0,0 +1,77 @@
+#include "../bench.hh"
+
+#include <Nile/renderer/glyph_atlas.hh>
+#include <Nile/renderer/text_batch.hh>
+
+#include <string>
+#include <vector>
+
+using nile::GlyphAtlas;
+using nile::TextBatch;
+using nile::u32;
+using nile::u8;
+using nile::usize;
+using nile::bench::State;
+
+namespace {
+
+  // Label texts, one per entity, "label <n>: 0000"
+  std::vector<std::string> generateLabels( usize count ) {
+    std::vector<std::string> labels( count );
+    for ( usize i = 0; i < count; ++i )
+      labels[ i ] = "label " + std::to_string( i ) + ": 0000";
+    return labels;
+  }
+
+  // Only the CPU side of the batch is measured, the atlas is never uploaded
+  void fillAtlas( GlyphAtlas &atlas ) {
+    const std::vector<u8> pixels( 8 * 12, 255 );
+    for ( u32 c = 33; c < 127; ++c )
+      atlas.addGlyph( c, 8, 12, 8, pixels.data(), glm::ivec2( 0, 12 ), 10 << 6 );
+    atlas.setAscent( 12 );
+  }
+
+  // `changing` labels out of every 100 get a new string each frame
+  void run( State &state, usize changing ) {
+    GlyphAtlas atlas( 256, 16 );
+    fillAtlas( atlas );
+
+    auto labels = generateLabels( state.size() );
+    TextBatch batch;
+    u32 counter = 0;
+
+    auto frame = [&] {
+      batch.begin();
+      for ( usize i = 0; i < labels.size(); ++i ) {
+        if ( i % 100 < changing ) {
+          auto &label = labels[ i ];
+          label[ label.size() - 1 ] = static_cast<char>( '0' + counter % 10 );
+        }
+        batch.submit( static_cast<u32>( i ), &atlas, labels[ i ],
+                      glm::vec3( 0.0f, static_cast<float>( i ), 0.0f ), glm::vec3( 1.0f ),
+                      glm::vec3( 1.0f ) );
+      }
+      batch.end();
+      ++counter;
+    };
+
+    // The first frame lays out every label, measure the steady state
+    frame();
+    state.measure( labels.size(), frame );
+
+    nile::bench::doNotOptimize( batch.getStats().glyphs );
+  }
+
+}    // namespace
+
+NILE_BENCHMARK( "renderer/text_batch", "static_labels" ) {
+  run( state, 0 );
+}
+
+NILE_BENCHMARK( "renderer/text_batch", "one_percent_changing" ) {
+  run( state, 1 );
+}
+
+NILE_BENCHMARK( "renderer/text_batch", "all_changing" ) {
+  run( state, 100 );
+}
@@ -0,0 +1,161 @@
+#include "../bench.hh"
+
+#include <Nile/scene/scene_graph.hh>
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <random>
+#include <vector>
+
+using nile::AABB;
+using nile::Entity;
+using nile::f32;
+using nile::i32;
+using nile::RayHit;
+using nile::SceneGraph;
+using nile::usize;
+using nile::bench::State;
+
+namespace {
+
+  constexpr usize QUERIES = 1000;
+
+  // Objects spread over a world that grows with their count, so the density stays the same
+  struct Scene {
+    SceneGraph graph;
+    std::vector<AABB> bounds;
+    std::vector<i32> proxies;
+    f32 extent;
+  };
+
+  AABB randomBox( State &state, f32 extent ) {
+    std::uniform_real_distribution<f32> position( -extent, extent );
+    std::uniform_real_distribution<f32> size( 0.5f, 2.0f );
+    const glm::vec3 center( position( state.rng() ), position( state.rng() ),
+                            position( state.rng() ) );
+    return {center - glm::vec3( size( state.rng() ) ), center + glm::vec3( size( state.rng() ) )};
+  }
+
+  void generate( State &state, Scene &scene ) {
+    scene.extent = 10.0f * std::cbrt( static_cast<f32>( state.size() ) );
+    scene.bounds.resize( state.size() );
+    for ( auto &bounds : scene.bounds )
+      bounds = randomBox( state, scene.extent );
+  }
+
+  void populate( State &state, Scene &scene ) {
+    generate( state, scene );
+    for ( usize i = 0; i < scene.bounds.size(); ++i )
+      scene.proxies.push_back(
+          scene.graph.createProxy( scene.bounds[ i ], static_cast<Entity>( i + 1 ) ) );
+  }
+
+  std::vector<glm::vec3> randomPoints( State &state, f32 extent ) {
+    std::uniform_real_distribution<f32> position( -extent, extent );
+    std::vector<glm::vec3> points( QUERIES );
+    for ( auto &point : points )
+      point =
+          glm::vec3( position( state.rng() ), position( state.rng() ), position( state.rng() ) );
+    return points;
+  }
+
+}    // namespace
+
+NILE_BENCHMARK( "scene/scene_graph", "insert" ) {
+  Scene scene;
+  generate( state, scene );
+
+  state.measure( scene.bounds.size(), [&] {
+    for ( usize i = 0; i < scene.bounds.size(); ++i )
+      scene.graph.createProxy( scene.bounds[ i ], static_cast<Entity>( i + 1 ) );
+  } );
+  nile::bench::doNotOptimize( scene.graph.getHeight() );
+}
+
+// Every object moves a little each frame, most of them stay inside of their fat bounds
+NILE_BENCHMARK( "scene/scene_graph", "move_all" ) {
+  Scene scene;
+  populate( state, scene );
+
+  std::uniform_real_distribution<f32> step( -0.2f, 0.2f );
+  std::vector<glm::vec3> steps( scene.bounds.size() );
+  for ( auto &displacement : steps )
+    displacement = glm::vec3( step( state.rng() ), step( state.rng() ), step( state.rng() ) );
+
+  usize reinserted = 0;
+  state.measure( scene.bounds.size() * 10, [&] {
+    for ( int frame = 0; frame < 10; ++frame ) {
+      for ( usize i = 0; i < scene.bounds.size(); ++i ) {
+        auto &bounds = scene.bounds[ i ];
+        bounds = {bounds.min + steps[ i ], bounds.max + steps[ i ]};
+        reinserted += scene.graph.moveProxy( scene.proxies[ i ], bounds, steps[ i ] );
+      }
+    }
+  } );
+  nile::bench::doNotOptimize( reinserted );
+}
+
+NILE_BENCHMARK( "scene/scene_graph", "query_aabb" ) {
+  Scene scene;
+  populate( state, scene );
+  const auto points = randomPoints( state, scene.extent );
+
+  usize found = 0;
+  state.measure( QUERIES, [&] {
+    for ( const auto &point : points ) {
+      scene.graph.query( AABB {point - glm::vec3( 10.0f ), point + glm::vec3( 10.0f )},
+                         [&]( Entity, i32 ) {
+                           ++found;
+                           return true;
+                         } );
+    }
+  } );
+  nile::bench::doNotOptimize( found );
+}
+
+NILE_BENCHMARK( "scene/scene_graph", "query_frustum" ) {
+  Scene scene;
+  populate( state, scene );
+
+  const auto frustum = nile::Frustum::fromMatrix(
+      glm::perspective( glm::radians( 45.0f ), 16.0f / 9.0f, 0.1f, 100.0f ) *
+      glm::lookAt( glm::vec3( 0.0f ), glm::vec3( 0.0f, 0.0f, -1.0f ),
+                   glm::vec3( 0.0f, 1.0f, 0.0f ) ) );
+
+  usize found = 0;
+  state.measure( 1, [&] {
+    scene.graph.query( frustum, [&]( Entity, i32 ) {
+      ++found;
+      return true;
+    } );
+  } );
+  nile::bench::doNotOptimize( found );
+}
+
+NILE_BENCHMARK( "scene/scene_graph", "raycast" ) {
+  Scene scene;
+  populate( state, scene );
+  const auto points = randomPoints( state, scene.extent );
+
+  usize hits = 0;
+  state.measure( QUERIES, [&] {
+    RayHit hit;
+    for ( usize i = 0; i < points.size(); ++i )
+      hits += scene.graph.raycast( points[ i ], points[ ( i + 1 ) % points.size() ] - points[ i ],
+                                   scene.extent, hit );
+  } );
+  nile::bench::doNotOptimize( hits );
+}
+
+NILE_BENCHMARK( "scene/scene_graph", "nearest" ) {
+  Scene scene;
+  populate( state, scene );
+  const auto points = randomPoints( state, scene.extent );
+
+  usize hits = 0;
+  state.measure( QUERIES, [&] {
+    RayHit hit;
+    for ( const auto &point : points )
+      hits += scene.graph.nearest( point, scene.extent, hit );
+  } );
+  nile::bench::doNotOptimize( hits );
+}
@@ -6,18 +6,35 @@
 
 #include <SDL2/SDL.h>
 
+#include <cstdlib>
 #include <memory>
-
-int main() {
-
-  auto settings = nile::Settings::Builder {}
-                      .setWidth( 1920 )
-                      .setHeight( 920 )
-                      .setTitle( "Nile Engine | Debugging " )
-                      .setDebugMode( true )
-                      .setWindowFlags( SDL_WINDOW_OPENGL | SDL_WINDOW_SHOWN )
-                      .setProgramMode(nile::ProgramMode::EDITOR_MODE)
-                      .build();
+#include <string>
+
+// Usage: Platformer [--headless] [--frames N] [--capture frame.png]
+// e.g. Platformer --headless --frames 300 --capture golden.png on a server without a display
+int main( int argc, char **argv ) {
+
+  auto builder = nile::Settings::Builder {}
+                     .setWidth( 1920 )
+                     .setHeight( 920 )
+                     .setTitle( "Nile Engine | Debugging " )
+                     .setDebugMode( true )
+                     .setWindowFlags( SDL_WINDOW_OPENGL | SDL_WINDOW_SHOWN )
+                     .setProgramMode( nile::ProgramMode::EDITOR_MODE );
+
+  for ( int i = 1; i < argc; ++i ) {
+    const std::string arg = argv[ i ];
+    if ( arg == "--headless" )
+      builder.setHeadless( true );
+    else if ( arg == "--frames" && i + 1 < argc )
+      builder.setFrameLimit( static_cast<nile::u32>( std::strtoul( argv[ ++i ], nullptr, 10 ) ) );
+    else if ( arg == "--capture" && i + 1 < argc )
+      builder.setCapturePath( argv[ ++i ] );
+    else
+      std::cerr << "Unknown argument: " << arg << std::endl;
+  }
+
+  auto settings = builder.build();
 
   nile::X11::Boostrap bootstrap( std::make_shared<nile::Settings>( settings ) );
 
@@ -1,8 +1,8 @@
 #version 330 core
 out vec4 FragColor;
 
-uniform vec3 objectColor;
+in vec4 Color;
 
 void main() {
-  FragColor = vec4( objectColor, 1.0 );
+  FragColor = vec4( Color.rgb, 1.0 );
 }
@@ -2,12 +2,22 @@
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec3 aNormal;
 layout (location = 2) in vec2 aTexCoords;
+// Per instance data, streamed by the RenderingSystem
+layout (location = 3) in mat4 aModel;
+layout (location = 7) in vec4 aColor;
 
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+out vec4 Color;
+
+// Filled once per frame by the engine
+layout( std140 ) uniform Camera {
+  mat4 view;
+  mat4 projection;
+  mat4 viewProjection;
+  vec4 viewPosition;
+};
 
 void main()
 {
-    gl_Position = projection * view * model * vec4(aPos, 1.0);
+    Color = aColor;
+    gl_Position = viewProjection * aModel * vec4(aPos, 1.0);
 } 
@@ -1,8 +1,8 @@
 #version 330 core
 
+in vec4 line_color;
 out vec4 color;
-uniform vec3 primitive_color;
 
 void main() {
-  color = vec4(primitive_color, 1.0f);
+  color = line_color;
 }
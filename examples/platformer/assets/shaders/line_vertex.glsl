@@ -1,11 +1,20 @@
 #version 330 core
 
-layout( location = 0 ) in vec2 vertex;
+// Debug lines, already in world space ( see DebugDraw )
+layout( location = 0 ) in vec3 vertex;
+layout( location = 1 ) in vec4 vertex_color;
 
-uniform mat4 model;
-uniform mat4 projection;
+out vec4 line_color;
 
-void main() {
+// Filled once per frame by the engine
+layout( std140 ) uniform Camera {
+  mat4 view;
+  mat4 projection;
+  mat4 viewProjection;
+  vec4 viewPosition;
+};
 
-  gl_Position = projection * model * vec4( vertex.xy, 0.0, 1.0f);
+void main() {
+  line_color = vertex_color;
+  gl_Position = viewProjection * vec4( vertex, 1.0f );
 }
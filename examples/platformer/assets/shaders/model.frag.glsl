@@ -4,10 +4,7 @@ out vec4 FragColor;
 in vec2 TexCoords;
 in vec3 Normal;
 in vec3 FragPos;
-
-uniform vec3 objectColor;
-uniform vec3 lightColor;
-uniform vec3 viewPos;
+in vec4 Color;
 
 struct Material {
   sampler2D ambient1;
@@ -16,66 +13,114 @@ struct Material {
   float shininess;
 };
 
+// std140 blocks filled once per frame by the engine ( see frame_uniforms.hh ),
+// vec3 values are stored as vec4
 struct DirectionalLight {
-  vec3 direction;
-  vec3 ambient;
-  vec3 diffuse;
-  vec3 specular;
+  vec4 direction;
+  vec4 ambient;
+  vec4 diffuse;
+  vec4 specular;
 };
 
 struct PointLight {
-  vec3 position;
-
-  // used for the attenuation
-  float constant;
-  float linear;
-  float quadratic;
+  // xyz - position, w - range
+  vec4 position;
+  vec4 ambient;
+  vec4 diffuse;
+  vec4 specular;
+  // used for the attenuation: constant, linear, quadratic
+  vec4 attenuation;
+};
 
-  vec3 ambient;
-  vec3 diffuse;
-  vec3 specular;
+layout( std140 ) uniform Camera {
+  mat4 view;
+  mat4 projection;
+  mat4 viewProjection;
+  vec4 viewPosition;
 };
 
-#define NR_OF_POINT_LIGHTS 4
+layout( std140 ) uniform Lights {
+  DirectionalLight directionalLight;
+  // xyz - number of clusters along x, y and depth, w - number of point lights
+  uvec4 clusterGrid;
+  // near, far, slice scale, slice bias
+  vec4 clusterDepth;
+  // xy - size of a cluster in pixels
+  vec4 clusterSize;
+};
 
-uniform DirectionalLight directionalLight;
-uniform PointLight pointLights[NR_OF_POINT_LIGHTS];
+// Clustered point light lists ( see clustered_lights.hh ), the bindings match
+// the texture units of ClusteredLights
+layout( binding = 13 ) uniform samplerBuffer pointLightData;
+layout( binding = 14 ) uniform usamplerBuffer lightClusters;
+layout( binding = 15 ) uniform usamplerBuffer lightIndices;
 
 uniform Material material;
 
+uint clusterIndex() {
+
+  // Depth slices are exponential, slice = log( depth ) * scale + bias. Orthographic
+  // projections have no slices ( scale 0 ), their lights are all in the first one
+  uint slice = 0u;
+  if ( clusterDepth.z != 0.0 ) {
+    float depth = max( -( view * vec4( FragPos, 1.0 ) ).z, clusterDepth.x );
+    slice = uint( max( log( depth ) * clusterDepth.z + clusterDepth.w, 0.0 ) );
+  }
+
+  uvec3 cluster = min( uvec3( uvec2( gl_FragCoord.xy / clusterSize.xy ), slice ),
+                       clusterGrid.xyz - 1u );
+
+  return cluster.x + clusterGrid.x * ( cluster.y + clusterGrid.y * cluster.z );
+}
+
+PointLight fetchPointLight( int index ) {
+  int texel = index * 5;
+
+  PointLight light;
+  light.position = texelFetch( pointLightData, texel );
+  light.ambient = texelFetch( pointLightData, texel + 1 );
+  light.diffuse = texelFetch( pointLightData, texel + 2 );
+  light.specular = texelFetch( pointLightData, texel + 3 );
+  light.attenuation = texelFetch( pointLightData, texel + 4 );
+  return light;
+}
+
 vec4 calcDirLight( DirectionalLight light, vec3 normal, vec3 viewDir );
 vec4 calcPointLight( PointLight light, vec3 normal, vec3 fragPos, vec3 viewDir );
 
 void main() {
 
   vec3 normal = normalize( Normal );
-  vec3 viewDirection = normalize( viewPos - FragPos );
+  vec3 viewDirection = normalize( viewPosition.xyz - FragPos );
 
   vec4 result = calcDirLight( directionalLight, normal, viewDirection );
 
-  for ( int i = 0; i < NR_OF_POINT_LIGHTS; i++) {
-    result += calcPointLight( pointLights[i], normal, FragPos, viewDirection );
+  // Only the lights that reach the cluster of the fragment
+  uvec2 cluster = texelFetch( lightClusters, int( clusterIndex() ) ).xy;
+  for ( uint i = 0u; i < cluster.y; i++ ) {
+    int light = int( texelFetch( lightIndices, int( cluster.x + i ) ).x );
+    result += calcPointLight( fetchPointLight( light ), normal, FragPos, viewDirection );
   }
 
-  FragColor = vec4( result );
+  FragColor = result * Color;
 }
 
 vec4 calcDirLight( DirectionalLight light, vec3 normal, vec3 viewDir ) {
 
   // We negate the light.direction, because we want specifie the light to point */
   // from the light source towards the fragment */
-  vec3 lightDirection = normalize( -light.direction );
+  vec3 lightDirection = normalize( -light.direction.xyz );
 
   float diff = max( dot( normal, lightDirection ), 0.0 );
   vec3 reflectDirecion = reflect( -lightDirection, normal );
   float spec = pow( max( dot( viewDir, reflectDirecion ), 0.0 ), material.shininess );
 
 
-  vec4 ambient = vec4( light.ambient, 1.0 ) * texture( material.ambient1, TexCoords );
-  vec4 diffuse = vec4( light.diffuse, 1.0 ) * diff * texture( material.diffuse1, TexCoords );
+  vec4 ambient = vec4( light.ambient.rgb, 1.0 ) * texture( material.ambient1, TexCoords );
+  vec4 diffuse = vec4( light.diffuse.rgb, 1.0 ) * diff * texture( material.diffuse1, TexCoords );
 
 
-  vec4 specular = vec4( light.specular, 1.0 ) * spec * texture( material.specular1, TexCoords );
+  vec4 specular = vec4( light.specular.rgb, 1.0 ) * spec * texture( material.specular1, TexCoords );
 
 
   return ( ambient + diffuse + specular );
@@ -84,23 +129,28 @@ vec4 calcDirLight( DirectionalLight light, vec3 normal, vec3 viewDir ) {
 vec4 calcPointLight( PointLight light, vec3 normal, vec3 fragPos, vec3 viewDir ) {
 
 
-  vec3 lightDir = normalize( light.position - fragPos );
+  vec3 lightDir = normalize( light.position.xyz - fragPos );
 
   float diff = max( dot( normal, lightDir ), 0.0 );
   vec3 reflectDirecion = reflect( -lightDir, normal );
   float spec = pow( max( dot( viewDir, reflectDirecion ), 0.0 ), material.shininess );
 
   // attenuation
-  float distance = length( light.position - fragPos );
-  float attenuation = 1.0 / ( light.constant + light.linear * distance +
-                              light.quadratic * ( distance * distance ) );
+  float distance = length( light.position.xyz - fragPos );
+  float attenuation = 1.0 / ( light.attenuation.x + light.attenuation.y * distance +
+                              light.attenuation.z * ( distance * distance ) );
+
+  // Fade out towards the range, the light is not in the lists of the clusters past it
+  float falloff = clamp( 1.0 - pow( distance / light.position.w, 4.0 ), 0.0, 1.0 );
+  attenuation *= falloff * falloff;
 
-  vec4 ambient = vec4( light.ambient, 1.0 ) * texture( material.ambient1, TexCoords );
-  vec4 diffuse = vec4( light.diffuse, 1.0 ) * diff * texture( material.diffuse1, TexCoords );
+  vec4 ambient = vec4( light.ambient.rgb, 1.0 ) * texture( material.ambient1, TexCoords );
+  vec4 diffuse = vec4( light.diffuse.rgb, 1.0 ) * diff * texture( material.diffuse1, TexCoords );
 
 
-  vec4 specular = vec4( light.specular, 1.0 ) * spec * texture( material.specular1, TexCoords );
+  vec4 specular = vec4( light.specular.rgb, 1.0 ) * spec * texture( material.specular1, TexCoords );
 
+  ambient *= attenuation;
   diffuse *= attenuation;
   specular *= attenuation;
 
@@ -2,21 +2,30 @@
 layout( location = 0 ) in vec3 aPos;
 layout( location = 1 ) in vec3 aNormal;
 layout( location = 2 ) in vec2 aTexCoords;
+// Per instance data, streamed by the RenderingSystem
+layout( location = 3 ) in mat4 aModel;
+layout( location = 7 ) in vec4 aColor;
 
 out vec2 TexCoords;
 out vec3 Normal;
 out vec3 FragPos;
+out vec4 Color;
 
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+// Filled once per frame by the engine
+layout( std140 ) uniform Camera {
+  mat4 view;
+  mat4 projection;
+  mat4 viewProjection;
+  vec4 viewPosition;
+};
 
 void main() {
   TexCoords = aTexCoords;
+  Color = aColor;
   // @fix: this is costly operation
   // it's a better to calculate the normal matrix in the CPU
   // and send it to the shaders via uniform object
-  Normal = mat3( transpose( inverse( model ) ) ) * aNormal;
-  FragPos = vec3( model * vec4( aPos, 1.0 ) );
-  gl_Position = projection * view * model * vec4( aPos, 1.0 );
+  Normal = mat3( transpose( inverse( aModel ) ) ) * aNormal;
+  FragPos = vec3( aModel * vec4( aPos, 1.0 ) );
+  gl_Position = viewProjection * aModel * vec4( aPos, 1.0 );
 }
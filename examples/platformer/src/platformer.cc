@@ -9,6 +9,7 @@
 #include <Nile/ecs/components/camera_component.hh>
 #include <Nile/ecs/components/font_component.hh>
 #include <Nile/ecs/components/mesh_component.hh>
+#include <Nile/ecs/components/point_light.hh>
 #include <Nile/ecs/components/primitive.hh>
 #include <Nile/ecs/components/relationship.hh>
 #include <Nile/ecs/components/renderable.hh>
@@ -16,12 +17,16 @@
 #include <Nile/ecs/components/transform.hh>
 #include <Nile/log/log.hh>
 #include <Nile/math/utils.hh>
+#include <Nile/renderer/base_renderer.hh>
 #include <Nile/renderer/font.hh>
+#include <Nile/renderer/frame_uniforms.hh>
+#include <Nile/renderer/gpu_profiler.hh>
 #include <Nile/renderer/model.hh>
 #include <Nile/renderer/texture2d.hh>
 
 #include <cstdio>
 #include <iterator>
+#include <map>
 #include <memory>
 
 namespace platformer {
@@ -80,6 +85,7 @@ namespace platformer {
     // this->draw_windows();
     this->draw_text_font();
     this->draw_micro_subscene();
+    this->setup_lights();
     // this->draw_point_lights();
     // this->draw_pizza_box();
     // this->draw_sprites_test();
@@ -87,96 +93,33 @@ namespace platformer {
 
   void Platformer::draw( f32 deltaTime ) noexcept {}
 
-  void Platformer::update( f32 deltaTime ) noexcept {
+  void Platformer::setup_lights() noexcept {
 
-    this->process_mouse_events( deltaTime );
-    this->process_keyboard_events( deltaTime );
-    this->process_mouse_scrolling_events( deltaTime );
+    // Material is the same for every mesh drawn with the model shader
+    assets_manager_->getAsset<ShaderSet>( "model_shader" )
+        ->use()
+        .SetFloat( "material.shininess", 32.0f );
 
-    auto &camera_component = ecs_coordinator_->getComponent<CameraComponent>( camera_entity_ );
-    auto &c_transform = ecs_coordinator_->getComponent<Transform>( camera_entity_ );
-    auto &c_camera = ecs_coordinator_->getComponent<CameraComponent>( camera_entity_ );
+    auto uniforms = renderer_->getFrameUniforms();
 
+    DirectionalLightData directional;
+    directional.direction = glm::vec4( -0.2f, -1.0f, -0.3f, 0.0f );
+    directional.ambient = glm::vec4( 0.02f );
+    directional.diffuse = glm::vec4( 0.1f );
+    directional.specular = glm::vec4( 0.5f );
+    uniforms->setDirectionalLight( directional );
 
-    glm::mat4 view =
-        Math::lookAt( c_transform.position, c_transform.position + camera_component.cameraFront,
-                      camera_component.cameraUp );
-    glm::mat4 projection = glm::perspective( glm::radians( c_camera.fieldOfView ),
-                                             static_cast<f32>( settings_->getWidth() ) /
-                                                 static_cast<f32>( settings_->getHeight() ),
-                                             c_camera.near, c_camera.far );
+    // Point lights are the PointLight components of the lamps ( see draw_micro_subscene )
+  }
 
-    // We set projection matrix to the object that are "moving"
-    // since the camera is static, and we shift the world
+  void Platformer::update( f32 deltaTime ) noexcept {
 
-    assets_manager_->getAsset<ShaderSet>( "line_shader" )
-        ->use()
-        .SetMatrix4( "projection", projection );
-
-    auto model_shader = assets_manager_->getAsset<ShaderSet>( "model_shader" );
-    model_shader->use();
-    model_shader->SetMatrix4( "view", view );
-    model_shader->SetMatrix4( "projection", projection );
-    model_shader->SetVector3f( "lightColor", default_light_color_ );
-    model_shader->SetFloat( "material.shininess", 32.0f );
-
-    // Point light 1
-    model_shader->SetVector3f( "pointLights[0].position", point_lights_positions_[ 0 ] );
-    model_shader->SetVector3f( "pointLights[0].ambient", 0.2f, 0.2f, 0.2f );
-    model_shader->SetVector3f( "pointLights[0].diffuse", 0.7f, 0.7f, 0.7f );
-    model_shader->SetVector3f( "pointLights[0].specular", 0.6f, 0.6f, 0.6f );
-    model_shader->SetFloat( "pointLights[0].constant", 1.0f );
-    model_shader->SetFloat( "pointLights[0].linear", 0.045f );
-    model_shader->SetFloat( "pointLights[0].quadratic", 0.0075f );
-
-    // Point light 2
-    model_shader->SetVector3f( "pointLights[1].position", point_lights_positions_[ 1 ] );
-    model_shader->SetVector3f( "pointLights[1].ambient", 0.2f, 0.2f, 0.2f );
-    model_shader->SetVector3f( "pointLights[1].diffuse", 0.7f, 0.7f, 0.7f );
-    model_shader->SetVector3f( "pointLights[1].specular", 0.6f, 0.6f, 0.6f );
-    model_shader->SetFloat( "pointLights[1].constant", 1.0f );
-    model_shader->SetFloat( "pointLights[1].linear", 0.045f );
-    model_shader->SetFloat( "pointLights[1].quadratic", 0.0075f );
-
-    // Point light 3
-    model_shader->SetVector3f( "pointLights[2].position", point_lights_positions_[ 2 ] );
-    model_shader->SetVector3f( "pointLights[2].ambient", 0.2f, 0.2f, 0.2f );
-    model_shader->SetVector3f( "pointLights[2].diffuse", 0.7f, 0.7f, 0.7f );
-    model_shader->SetVector3f( "pointLights[2].specular", 0.6f, 0.6f, 0.6f );
-    model_shader->SetFloat( "pointLights[2].constant", 1.0f );
-    model_shader->SetFloat( "pointLights[2].linear", 0.045f );
-    model_shader->SetFloat( "pointLights[2].quadratic", 0.0075f );
-
-    // Point light 4
-    model_shader->SetVector3f( "pointLights[3].position", point_lights_positions_[ 3 ] );
-    model_shader->SetVector3f( "pointLights[3].ambient", 0.2f, 0.2f, 0.2f );
-    model_shader->SetVector3f( "pointLights[3].diffuse", 0.7f, 0.7f, 0.7f );
-    model_shader->SetVector3f( "pointLights[3].specular", 0.6f, 0.6f, 0.6f );
-    model_shader->SetFloat( "pointLights[3].constant", 1.0f );
-    model_shader->SetFloat( "pointLights[3].linear", 0.045f );
-    model_shader->SetFloat( "pointLights[3].quadratic", 0.0075f );
-
-    // Point light 5
-    model_shader->SetVector3f( "pointLights[4].position", point_lights_positions_[ 4 ] );
-    model_shader->SetVector3f( "pointLight[4].ambient", 0.2f, 0.2f, 0.2f );
-    model_shader->SetVector3f( "pointLight[4].diffuse", 0.2f, 0.2f, 0.2f );
-    model_shader->SetVector3f( "pointLight[4].specular", 0.6f, 0.6f, 0.6f );
-    model_shader->SetFloat( "pointLight[4].constant", 1.0f );
-    model_shader->SetFloat( "pointLight[4].linear", 0.045f );
-    model_shader->SetFloat( "pointLight[4].quadratic", 0.0075f );
-
-    model_shader->SetVector3f( "directionalLight.direction", -0.2f, -1.0f, -0.3f );
-    model_shader->SetVector3f( "directionalLight.ambient", 0.02f, 0.02f, 0.02f );
-    model_shader->SetVector3f( "directionalLight.diffuse", 0.1f, 0.1f, 0.1f );
-    model_shader->SetVector3f( "directionalLight.specular", 0.5f, 0.5f, 0.5f );
-
-    model_shader->SetVector3f( "viewPos", c_transform.position );
-
-    assets_manager_->getAsset<ShaderSet>( "lamp_shader" )
-        ->use()
-        .SetMatrix4( "projection", projection );
+    this->process_mouse_events( deltaTime );
+    this->process_keyboard_events( deltaTime );
+    this->process_mouse_scrolling_events( deltaTime );
 
-    assets_manager_->getAsset<ShaderSet>( "lamp_shader" )->use().SetMatrix4( "view", view );
+    // Camera and lights reach the shaders through the engine uniform blocks, the
+    // CameraSystem uploads them once per frame
 
     // TODO(stel): Maybe we can handle better this?
     // every time we recreate new std::string
@@ -184,6 +127,15 @@ namespace platformer {
     auto &fps_text_component = ecs_coordinator_->getComponent<FontComponent>( fps_text_entity_ );
     fps_text_component.text = std::string( fps_text_buffer_.get() );
 
+    // Top level scopes of the frame and the passes of the scene, a few frames old
+    gpu_text_ = "@gpu:";
+    for ( const auto &timing : renderer_->getGpuProfiler()->getResults() ) {
+      char scope[ 48 ];
+      snprintf( scope, sizeof( scope ), " %s %.2fms", timing.name, timing.milliseconds );
+      gpu_text_ += scope;
+    }
+    ecs_coordinator_->getComponent<FontComponent>( gpu_text_entity_ ).text = gpu_text_;
+
     glCheckError();
   }
 
@@ -302,6 +254,7 @@ namespace platformer {
           mesh.vertices = i.verticies;
           mesh.textures = i.textures;
           mesh.indices = i.indices;
+          mesh.bounds = i.bounds;
 
           Renderable renderable;
           renderable.color = glm::vec3( 1.0f, 1.0f, 1.0f );
@@ -340,6 +293,7 @@ namespace platformer {
         "container_model",
         assets_manager_->createBuilder<Model>( assets_manager_ )
             .setModelPath( FileSystem::getPath( "assets/models/container/container.obj" ) )
+            .setVertexFormat( VertexFormat::PACKED )
             .build() );
 
     auto model_mesh = model->meshes;
@@ -359,9 +313,11 @@ namespace platformer {
         transform.yRotation = 90.0f;
 
         MeshComponent mesh;
-        mesh.vertices = i.verticies;
+        mesh.packedVertices = i.packedVertices;
+        mesh.quantization = i.quantization;
         mesh.textures = i.textures;
         mesh.indices = i.indices;
+        mesh.bounds = i.bounds;
 
         Renderable renderable;
         renderable.color = glm::vec3( 1.0f, 1.0f, 1.0f );
@@ -372,17 +328,26 @@ namespace platformer {
     }
   }
 
+  void Platformer::build_sprite_atlas() noexcept {
+
+    if ( !sprite_atlas_.getPages().empty() )
+      return;
+
+    BenchmarkTimer timer( "build_sprite_atlas()" );
+
+    sprite_atlas_.addFile( "grass", FileSystem::getPath( "assets/textures/grass.png" ) );
+    sprite_atlas_.addFile( "window", FileSystem::getPath( "assets/textures/window.png" ) );
+    sprite_atlas_.build();
+  }
+
   void Platformer::draw_grass() noexcept {
 
     BenchmarkTimer timer( "draw_grass()" );
 
-    auto grass_texture = assets_manager_->loadAsset<Texture2D>(
-        "grass", FileSystem::getPath( "assets/textures/grass.png" ) );
-
-    grass_texture->setParameter( nile::TextureTargetParams::TEXTURE_WRAP_S,
-                                 nile::TextureParams::CLAMP_TO_EDGE );
-    grass_texture->setParameter( nile::TextureTargetParams::TEXTURE_WRAP_T,
-                                 nile::TextureParams::CLAMP_TO_EDGE );
+    this->build_sprite_atlas();
+    const auto *grass = sprite_atlas_.getRegion( "grass" );
+    if ( !grass )
+      return;
 
     const i32 offset_x = 60;
     const i32 offset_z = 20;
@@ -403,8 +368,7 @@ namespace platformer {
       // Background
       ecs_coordinator_->addComponent<Transform>( test_entity_, transform );
       ecs_coordinator_->addComponent<Renderable>( test_entity_, renderable );
-      ecs_coordinator_->addComponent<SpriteComponent>( test_entity_,
-                                                       SpriteComponent( grass_texture ) );
+      ecs_coordinator_->addComponent<SpriteComponent>( test_entity_, SpriteComponent( *grass ) );
     }
   }
 
@@ -412,8 +376,10 @@ namespace platformer {
 
     BenchmarkTimer timer( "draw_windows()" );
 
-    auto window_texture = assets_manager_->loadAsset<Texture2D>(
-        "window", FileSystem::getPath( "assets/textures/window.png" ) );
+    this->build_sprite_atlas();
+    const auto *window = sprite_atlas_.getRegion( "window" );
+    if ( !window )
+      return;
 
     auto camera_transform = ecs_coordinator_->getComponent<Transform>( camera_entity_ );
 
@@ -443,7 +409,7 @@ namespace platformer {
       // Background
       ecs_coordinator_->addComponent<Transform>( entity, transform );
       ecs_coordinator_->addComponent<Renderable>( entity, renderable );
-      ecs_coordinator_->addComponent<SpriteComponent>( entity, SpriteComponent( window_texture ) );
+      ecs_coordinator_->addComponent<SpriteComponent>( entity, SpriteComponent( *window ) );
     }
   }
 
@@ -478,6 +444,7 @@ namespace platformer {
       mesh.vertices = i.verticies;
       mesh.textures = i.textures;
       mesh.indices = i.indices;
+      mesh.bounds = i.bounds;
 
       Renderable renderable;
       renderable.color = glm::vec3( 1.0f, 1.0f, 1.0f );
@@ -512,6 +479,15 @@ namespace platformer {
     ecs_coordinator_->addComponent<Transform>( fps_text_entity_, transform );
     ecs_coordinator_->addComponent<Renderable>( fps_text_entity_, renderable );
     ecs_coordinator_->addComponent<FontComponent>( fps_text_entity_, font );
+
+    // GPU timings, one line above the fps
+    gpu_text_entity_ = ecs_coordinator_->createEntity();
+    font.text = "@gpu:";
+    transform.position.y += 24.0f;
+
+    ecs_coordinator_->addComponent<Transform>( gpu_text_entity_, transform );
+    ecs_coordinator_->addComponent<Renderable>( gpu_text_entity_, renderable );
+    ecs_coordinator_->addComponent<FontComponent>( gpu_text_entity_, font );
   }
 
   void Platformer::draw_point_lights() noexcept {
@@ -538,6 +514,7 @@ namespace platformer {
       mesh.vertices = i.verticies;
       mesh.textures = i.textures;
       mesh.indices = i.indices;
+      mesh.bounds = i.bounds;
 
       Renderable renderable;
       renderable.color = glm::vec3( 1.0f, 1.0f, 1.0f );
@@ -608,6 +585,7 @@ namespace platformer {
       mesh.vertices = i.verticies;
       mesh.textures = i.textures;
       mesh.indices = i.indices;
+      mesh.bounds = i.bounds;
 
       Renderable renderable;
       renderable.color = glm::vec3( 1.0f, 1.0f, 1.0f );
@@ -655,6 +633,7 @@ namespace platformer {
         mesh.vertices = i.verticies;
         mesh.textures = i.textures;
         mesh.indices = i.indices;
+        mesh.bounds = i.bounds;
 
         Renderable renderable;
         renderable.color = glm::vec3( 1.0f, 1.0f, 1.0f );
@@ -691,6 +670,7 @@ namespace platformer {
         mesh.vertices = i.verticies;
         mesh.textures = i.textures;
         mesh.indices = i.indices;
+        mesh.bounds = i.bounds;
 
         Renderable renderable;
         renderable.color = glm::vec3( 1.0f, 1.0f, 1.0f );
@@ -701,6 +681,14 @@ namespace platformer {
         ecs_coordinator_->addComponent<Renderable>( lamp_entity_, renderable );
         ecs_coordinator_->addComponent<MeshComponent>( lamp_entity_, mesh );
       }
+
+      // One light above every container, shining from the lamp
+      PointLight light;
+      light.ambient = glm::vec3( 0.2f );
+      light.diffuse = glm::vec3( 0.7f );
+      light.specular = glm::vec3( 0.6f );
+      light.attenuation = glm::vec3( 1.0f, 0.045f, 0.0075f );
+      ecs_coordinator_->addComponent<PointLight>( lamp_entity_, light );
     }
   }
 
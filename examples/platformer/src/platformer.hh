@@ -10,11 +10,13 @@
 #include <Nile/ecs/ecs_coordinator.hh>
 #include <Nile/experimental/asset/asset_manager_helper.hh>
 #include <Nile/platform/game_host.hh>
+#include <Nile/renderer/texture_atlas.hh>
 
 #include <GL/glew.h>
 #include <glm/gtc/matrix_transform.hpp>
 
 #include <memory>
+#include <string>
 
 namespace platformer {
 
@@ -40,11 +42,17 @@ namespace platformer {
     nile::Entity sprite_entity_;
     nile::Entity test_entity_;
     nile::Entity fps_text_entity_;
+    nile::Entity gpu_text_entity_;
+    // Reused every frame for the GPU timings
+    std::string gpu_text_;
+    // Grass and windows share a page, so they are drawn together
+    nile::TextureAtlas sprite_atlas_;
 
     void draw_stone_tiles() noexcept;
     void draw_nano_model() noexcept;
     void draw_textured_floor() noexcept;
     void draw_containers() noexcept;
+    void build_sprite_atlas() noexcept;
     void draw_grass() noexcept;
     void draw_windows() noexcept;
     void draw_text_font() noexcept;
@@ -52,6 +60,7 @@ namespace platformer {
     void draw_sprites_test() noexcept;
     void draw_pizza_box() noexcept;
     void draw_micro_subscene() noexcept;
+    void setup_lights() noexcept;
 
     void process_keyboard_events( f32 dt ) noexcept;
     void process_mouse_events( f32 dt ) noexcept;
@@ -63,7 +72,6 @@ namespace platformer {
     bool first_mouse_entry_ = true;
     glm::ivec2 mouse_position_;
 
-    glm::vec3 default_light_color_ { 1.0f, 1.0f, 1.0f };
 
     std::vector<glm::vec3> point_lights_positions_;
 
@@ -0,0 +1,53 @@
+/* ================================================================================
+$File: glyph_atlas_builder.hh
+$Date: $
+$Revision: $
+$Creator: Rostislav Orestis Stelmach
+$Notice: $
+================================================================================ */
+
+#pragma once
+
+#include "Nile/asset/builder/asset_builder.hh"
+#include "Nile/core/types.hh"
+#include "Nile/renderer/glyph_atlas.hh"
+
+#include <memory>
+#include <string>
+
+namespace nile {
+  class AssetManager;
+  struct Font;
+}    // namespace nile
+
+namespace nile::AssetBuilder {
+
+  // Rasterizes the ASCII glyphs of a font with FreeType into a GlyphAtlas. Atlases are
+  // stored in the AssetManager under "<family> <style>@<pixel size>", building an atlas
+  // that already exists returns the stored one without touching FreeType.
+  template <>
+  class Builder<GlyphAtlas> final {
+  private:
+    std::shared_ptr<nile::AssetManager> m_assetManager;
+    std::shared_ptr<Font> m_font;
+    u32 m_pixelSize = 18;
+
+    std::shared_ptr<GlyphAtlas> rasterize( const std::string &assetName ) noexcept;
+
+  public:
+    Builder( const std::shared_ptr<nile::AssetManager> &assetManager ) noexcept;
+    Builder( Builder && ) = default;
+    Builder( const Builder & ) = default;
+    Builder &operator=( Builder && ) = default;
+    Builder &operator=( const Builder & ) = default;
+
+    Builder &setFont( const std::shared_ptr<Font> &font ) noexcept;
+    Builder &setPixelSize( u32 pixelSize ) noexcept;
+
+    // Name under which the atlas of the current font and size is stored
+    [[nodiscard]] std::string getAssetName() const noexcept;
+
+    [[nodiscard]] std::shared_ptr<GlyphAtlas> build() noexcept;
+  };
+
+}    // namespace nile::AssetBuilder
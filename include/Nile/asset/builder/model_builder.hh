@@ -6,6 +6,7 @@
 #include "Nile/renderer/mesh.hh"
 #include "Nile/renderer/model.hh"
 #include "Nile/renderer/texture2d.hh"
+#include "Nile/renderer/vertex_format.hh"
 
 #include "assimp/Importer.hpp"
 #include "assimp/postprocess.h"
@@ -45,6 +46,8 @@ namespace nile::AssetBuilder {
   private:
     std::string m_directoryName;
     std::string m_path;
+    VertexFormat m_vertexFormat = VertexFormat::FLOAT;
+    bool m_optimizeMeshes = true;
 
     std::vector<Mesh> m_meshes;
     std::shared_ptr<nile::AssetManager> m_assetManager;
@@ -65,6 +68,14 @@ namespace nile::AssetBuilder {
 
     Builder &setModelPath( std::string_view path ) noexcept;
 
+    // PACKED halves the vertex memory, the quantization error of every mesh is logged
+    // and kept in Mesh::quantizationError
+    Builder &setVertexFormat( VertexFormat format ) noexcept;
+
+    // Reorders the triangles and vertices of every mesh for the vertex cache, overdraw
+    // and vertex fetch ( see MeshOptimizer ), the metrics before and after are logged
+    Builder &setOptimizeMeshes( bool optimize ) noexcept;
+
     [[nodiscard]] std::shared_ptr<Model> build() noexcept;
   };
 
@@ -8,16 +8,22 @@
 namespace nile {
 
   class Coordinator;
+  class FrameUniforms;
+  class RenderQueue;
   class Settings;
 
   class CameraSystem : public System {
   private:
     std::shared_ptr<Coordinator> ecs_coordinator_;
     std::shared_ptr<Settings> settings_;
+    std::shared_ptr<RenderQueue> render_queue_;
+    std::shared_ptr<FrameUniforms> frame_uniforms_;
 
   public:
     CameraSystem( const std::shared_ptr<Coordinator> &coordinator,
-                  const std::shared_ptr<Settings>& settings ) noexcept;
+                  const std::shared_ptr<Settings>& settings,
+                  const std::shared_ptr<RenderQueue> &queue,
+                  const std::shared_ptr<FrameUniforms> &uniforms ) noexcept;
     void create() noexcept;
     void update( f32 dt ) noexcept;
     void destroy() noexcept;
@@ -0,0 +1,49 @@
+/* ================================================================================
+$File: parallel.hh
+$Date: $
+$Revision: $
+$Creator: Rostislav Orestis Stelmach
+$Notice: $
+================================================================================ */
+
+#pragma once
+
+#include "Nile/core/types.hh"
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+// @brief:
+// parallelFor splits [ 0, count ) into contiguous slices and runs each one on its own
+// std::thread, the calling thread takes the first slice and waits for the others.
+// Threads are started on every call, so callers only split work that is worth it
+// ( the rows of the large mip levels, the lights of a crowded frame ).
+
+namespace nile {
+
+  [[nodiscard]] inline u32 hardwareThreads() noexcept {
+    return std::max( 1u, std::thread::hardware_concurrency() );
+  }
+
+  // Calls function( begin, end ) on threads contiguous slices of [ 0, count )
+  template <typename Function>
+  void parallelFor( u32 count, u32 threads, const Function &function ) noexcept {
+    threads = std::clamp( threads, 1u, std::max( count, 1u ) );
+    if ( threads == 1 ) {
+      function( 0u, count );
+      return;
+    }
+
+    std::vector<std::thread> workers;
+    workers.reserve( threads - 1 );
+    const u32 slice = ( count + threads - 1 ) / threads;
+    for ( u32 begin = slice; begin < count; begin += slice )
+      workers.emplace_back( function, begin, std::min( begin + slice, count ) );
+    function( 0u, std::min( slice, count ) );
+
+    for ( auto &worker : workers )
+      worker.join();
+  }
+
+}    // namespace nile
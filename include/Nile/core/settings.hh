@@ -25,13 +25,24 @@ namespace nile {
     // Window title
     std::string m_windowTitle;
     ProgramMode m_programMode;
-
+    // Render offscreen through EGL, without a window or a display
+    bool m_headless;
+    // Frames to run before the host returns, 0 runs until the window is closed
+    u32 m_frameLimit;
+    // PNG the headless renderer writes the last frame to, empty for none
+    std::string m_capturePath;
+    // Frame time in milliseconds the scene render scale adapts to, 0 keeps the scale at 1
+    f32 m_frameTimeBudget;
+    // Lowest render scale the frame time budget can pick
+    f32 m_minRenderScale;
 
   public:
     class Builder;
 
     Settings( u32 width, u32 height, u32 windowFlags, bool m_debugMode, const std::string &title,
-              ProgramMode programMode ) noexcept;
+              ProgramMode programMode, bool headless = false, u32 frameLimit = 0,
+              const std::string &capturePath = {}, f32 frameTimeBudget = 0.0f,
+              f32 minRenderScale = 0.5f ) noexcept;
     ~Settings() noexcept;
 
     // Setters
@@ -63,6 +74,26 @@ namespace nile {
     [[nodiscard]] inline ProgramMode getProgramMode() const noexcept {
       return m_programMode;
     }
+
+    [[nodiscard]] inline bool getHeadless() const noexcept {
+      return m_headless;
+    }
+
+    [[nodiscard]] inline u32 getFrameLimit() const noexcept {
+      return m_frameLimit;
+    }
+
+    [[nodiscard]] inline const std::string &getCapturePath() const noexcept {
+      return m_capturePath;
+    }
+
+    [[nodiscard]] inline f32 getFrameTimeBudget() const noexcept {
+      return m_frameTimeBudget;
+    }
+
+    [[nodiscard]] inline f32 getMinRenderScale() const noexcept {
+      return m_minRenderScale;
+    }
   };
 
   class Settings::Builder {
@@ -73,6 +104,11 @@ namespace nile {
     bool m_debugMode = false;
     ProgramMode m_programMode = ProgramMode::EDITOR_MODE;
     std::string m_windowTitle {};
+    bool m_headless = false;
+    u32 m_frameLimit = 0;
+    std::string m_capturePath {};
+    f32 m_frameTimeBudget = 0.0f;
+    f32 m_minRenderScale = 0.5f;
 
   public:
     Builder &setWidth( u32 width ) noexcept {
@@ -105,9 +141,35 @@ namespace nile {
       return *this;
     }
 
+    Builder &setHeadless( bool flag ) noexcept {
+      this->m_headless = flag;
+      return *this;
+    }
+
+    Builder &setFrameLimit( u32 frames ) noexcept {
+      this->m_frameLimit = frames;
+      return *this;
+    }
+
+    Builder &setCapturePath( const std::string &path ) noexcept {
+      this->m_capturePath = path;
+      return *this;
+    }
+
+    Builder &setFrameTimeBudget( f32 milliseconds ) noexcept {
+      this->m_frameTimeBudget = milliseconds;
+      return *this;
+    }
+
+    Builder &setMinRenderScale( f32 scale ) noexcept {
+      this->m_minRenderScale = scale;
+      return *this;
+    }
+
     Settings build() const noexcept {
       return Settings( m_width, m_height, m_windowFlags, m_debugMode, m_windowTitle,
-                       m_programMode );
+                       m_programMode, m_headless, m_frameLimit, m_capturePath,
+                       m_frameTimeBudget, m_minRenderScale );
     }
   };
 
@@ -12,20 +12,37 @@ $Notice: $
 #include "Nile/ecs/ecs_system.hh"
 
 #include <memory>
+#include <vector>
+
+// @brief:
+// TransformSystem keeps the world space bounds of the meshes in sync with their
+// transforms, the render systems cull with them. Every mesh is also a proxy in
+// the SceneGraph, moved along with its bounds and removed with the entity.
 
 namespace nile {
 
   class Coordinator;
+  class SceneGraph;
   
   class TransformSystem : public System {
   public:
-    TransformSystem(const std::shared_ptr<Coordinator>& coordinator);
+    TransformSystem( const std::shared_ptr<Coordinator> &coordinator,
+                     const std::shared_ptr<SceneGraph> &scene ) noexcept;
 
     void create();
-    void update();
+    void update( f32 dt );
     void render();
   private:
     std::shared_ptr<Coordinator> ecs_coordinator_;
+    std::shared_ptr<SceneGraph> scene_graph_;
+
+    // Scene graph proxy of every entity, indexed by the entity
+    std::vector<i32> proxy_by_entity_;
+    // Frame in which the entity was updated the last time, entities that were not
+    // updated in the current frame left the system and their proxy is removed
+    std::vector<u32> last_update_;
+    std::vector<Entity> tracked_;
+    u32 frame_ = 0;
 
   };
 
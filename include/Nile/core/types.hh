@@ -21,7 +21,7 @@ namespace nile {
   using u8 = uint8_t;
   using u16 = uint16_t;
   using u32 = uint32_t;
-  using u64 = uint32_t;
+  using u64 = uint64_t;
   using f32 = float;
   using f64 = double;
   using usize = std::size_t;
@@ -33,8 +33,13 @@ namespace nile {
   using ComponentType = std::uint8_t;
 
 
+  // Can be raised at configure time with the NILE_MAX_ENTITIES cache variable
+#if !defined( NILE_MAX_ENTITIES )
+#define NILE_MAX_ENTITIES 32768
+#endif
+
   namespace ecs {
-    constexpr Entity MAX_ENTITIES = 32768;
+    constexpr Entity MAX_ENTITIES = NILE_MAX_ENTITIES;
     constexpr ComponentType MAX_COMPONENTS = 64;
     constexpr Entity null = 0;
   }    // namespace ecs
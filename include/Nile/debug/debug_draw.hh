@@ -0,0 +1,143 @@
+/* ================================================================================
+$File: debug_draw.hh
+$Date: $
+$Revision: $
+$Creator: Rostislav Orestis Stelmach
+$Notice: $
+================================================================================ */
+
+#pragma once
+
+#include "Nile/core/helper.hh"
+#include "Nile/core/types.hh"
+#include "Nile/math/bounds.hh"
+
+#include <glm/glm.hpp>
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+// @brief:
+// DebugDraw is an immediate mode API for debug geometry. Lines, boxes, spheres,
+// frustums and text can be added from anywhere ( and from any thread ) during the
+// frame, they are only kept until the next draw. Everything is turned into colored
+// lines, written into the StreamBuffer with one allocation and drawn with a single
+// packet.
+// Text uses a built-in segment font, so it needs no font asset. It faces the camera,
+// its lines are built in prepare() once the view direction is known.
+// Without NILE_DEBUG_DRAW ( release builds ) line(), box(), ... and text() are empty
+// inline functions. The line buffer, addLine(), prepare() and draw() are there in every
+// build, the Primitive entities are drawn through them.
+// Usage: line(), box(), ... at any time, prepare() and draw() once per frame.
+
+namespace nile {
+
+  class GLStateCache;
+  class RenderQueue;
+  class StreamBuffer;
+
+  // Debug line vertex, matches the line shader ( 0 - position, 1 - color )
+  struct DebugVertex {
+    glm::vec3 position;
+    // RGBA8, normalized
+    u32 color;
+  };
+
+  struct DebugDrawStats {
+    u32 lines = 0;
+    u32 texts = 0;
+    u32 drawCalls = 0;
+    usize uploadedBytes = 0;
+  };
+
+  class DebugDraw {
+  public:
+    // Segments of the circles of a sphere
+    static constexpr u32 SPHERE_SEGMENTS = 24;
+
+  private:
+    struct Text {
+      glm::vec3 position;
+      std::string text;
+      u32 color;
+      f32 size;
+    };
+
+    // Filled by the callers, guarded by m_mutex
+    std::mutex m_mutex;
+    std::vector<DebugVertex> m_pending;
+    std::vector<Text> m_pendingTexts;
+
+    // Lines of the frame, moved out of the pending buffers by prepare()
+    std::vector<DebugVertex> m_vertices;
+    std::vector<Text> m_texts;
+
+    DebugDrawStats m_stats;
+
+    // OpenGL objects are created lazily on the first draw
+    u32 m_vao = 0;
+    // Stream buffer the vertex attributes of m_vao point at
+    u32 m_vertexBuffer = 0;
+
+    void push( const DebugVertex *vertices, usize count ) noexcept;
+    void addText( const Text &text, const glm::vec3 &right, const glm::vec3 &up ) noexcept;
+    void bindVertexBuffer( GLStateCache &state, u32 buffer ) noexcept;
+
+  public:
+    DebugDraw() noexcept = default;
+    ~DebugDraw() noexcept;
+
+    NILE_DISABLE_COPY( DebugDraw )
+    NILE_DISABLE_MOVE( DebugDraw )
+
+    // A line that is drawn in release builds too, for geometry of the game
+    void addLine( const glm::vec3 &begin, const glm::vec3 &end, const glm::vec3 &color ) noexcept;
+
+    // Takes the lines added so far and builds the lines of the texts, does not issue any
+    // OpenGL calls. Lines added after it go to the next frame.
+    void prepare( const glm::vec3 &viewDirection ) noexcept;
+
+    // Writes the lines into the stream buffer and submits them with one packet
+    void draw( RenderQueue &queue, GLStateCache &state, StreamBuffer &stream,
+               u32 program ) noexcept;
+
+#if defined( NILE_DEBUG_DRAW )
+    void line( const glm::vec3 &begin, const glm::vec3 &end, const glm::vec3 &color ) noexcept;
+
+    void box( const AABB &bounds, const glm::vec3 &color ) noexcept;
+
+    // Unit cube ( -0.5 .. 0.5 ) transformed by the matrix
+    void box( const glm::mat4 &transform, const glm::vec3 &color ) noexcept;
+
+    // Three circles, one around every axis
+    void sphere( const glm::vec3 &center, f32 radius, const glm::vec3 &color ) noexcept;
+
+    // Frustum of an OpenGL ( -1 .. 1 clip depth ) view-projection matrix
+    void frustum( const glm::mat4 &viewProjection, const glm::vec3 &color ) noexcept;
+
+    // Text with its bottom-left corner at the position, size is the height of a letter.
+    // Only letters, digits and a few symbols have a glyph, the rest are left blank.
+    void text( const glm::vec3 &position, const std::string &text, const glm::vec3 &color,
+               f32 size = 1.0f ) noexcept;
+#else
+    void line( const glm::vec3 &, const glm::vec3 &, const glm::vec3 & ) noexcept {}
+    void box( const AABB &, const glm::vec3 & ) noexcept {}
+    void box( const glm::mat4 &, const glm::vec3 & ) noexcept {}
+    void sphere( const glm::vec3 &, f32, const glm::vec3 & ) noexcept {}
+    void frustum( const glm::mat4 &, const glm::vec3 & ) noexcept {}
+    void text( const glm::vec3 &, const std::string &, const glm::vec3 &, f32 = 1.0f ) noexcept {}
+#endif
+
+    // Counters of the last prepared frame
+    [[nodiscard]] const DebugDrawStats &getStats() const noexcept {
+      return m_stats;
+    }
+
+    // Vertices built by prepare(), two per line
+    [[nodiscard]] const std::vector<DebugVertex> &getVertices() const noexcept {
+      return m_vertices;
+    }
+  };
+
+}    // namespace nile
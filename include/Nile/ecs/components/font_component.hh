@@ -1,23 +1,23 @@
 #pragma once
 
 #include "Nile/core/types.hh"
-#include "Nile/utils/font_character.hh"
 
-#include <map>
 #include <memory>
 #include <string>
 
 namespace nile {
 
   class Font;
+  class GlyphAtlas;
 
   struct FontComponent {
     std::shared_ptr<Font> font;
-    std::map<char, FontCharacter> characters;
+    // Glyphs of the font at fontSize, shared with every entity that uses the same pair.
+    // Filled by the FontRenderingSystem, reset it after replacing the font.
+    std::shared_ptr<GlyphAtlas> atlas;
     std::string text;
     u32 fontSize {18};
-    u32 vao;
-    u32 vbo;
+    // Size of the text in pixels, updated by the FontRenderingSystem
     u32 width {1};
     u32 height {1};
   };
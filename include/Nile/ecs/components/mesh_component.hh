@@ -1,6 +1,8 @@
 #pragma once
 
 #include "Nile/core/types.hh"
+#include "Nile/math/bounds.hh"
+#include "Nile/renderer/vertex_format.hh"
 #include "Nile/utils/vertex.hh"
 
 #include <memory>
@@ -12,11 +14,19 @@ namespace nile {
 
   struct MeshComponent {
     std::vector<Vertex> vertices;
+    // Used instead of the vertices when not empty, copied from a packed Mesh
+    std::vector<PackedVertex> packedVertices;
+    VertexQuantization quantization;
     std::vector<u32> indices;
     std::vector<std::shared_ptr<Texture2D>> textures;
-    u32 vbo;
-    u32 vao;
-    u32 ebo;
+    // Filled by the RenderingSystem, index + 1 of the geometry in its MeshPool. The
+    // geometry is shared between all the entities with identical vertices and indices.
+    u32 geometry = 0;
+    // Local space bounds, copied from the imported Mesh or computed from the
+    // vertices by the TransformSystem when left empty
+    AABB bounds;
+    // World space bounds, updated by the TransformSystem every frame
+    AABB worldBounds;
   };
 
 }    // namespace nile
@@ -0,0 +1,29 @@
+/* ================================================================================
+$File: point_light.hh
+$Date: $
+$Revision: $
+$Creator: Rostislav Orestis Stelmach
+$Notice: $
+================================================================================ */
+
+#pragma once
+
+#include "Nile/core/types.hh"
+
+#include <glm/glm.hpp>
+
+namespace nile {
+
+  // Point light placed at the position of the entity Transform, drawn by the
+  // LightingSystem through the clustered light lists
+  struct PointLight {
+    glm::vec3 ambient {0.05f};
+    glm::vec3 diffuse {0.8f};
+    glm::vec3 specular {1.0f};
+    // Constant, linear and quadratic attenuation factors
+    glm::vec3 attenuation {1.0f, 0.09f, 0.032f};
+    // Distance past which the light has no effect, computed from the attenuation when 0
+    f32 range = 0.0f;
+  };
+
+}    // namespace nile
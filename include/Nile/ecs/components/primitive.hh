@@ -5,16 +5,13 @@
 
 namespace nile {
 
+  // Line in the local space of the entity, drawn through the DebugDraw every frame, in
+  // release builds too
   struct Primitive {
     // line begin x/y
     glm::vec2 begin {0.0f};
     // line end x/y
     glm::vec2 end {1.0f};
-    // line width
-    f32 lineWidth {1.0f};
-    u32 vao;
-    // vertex buffer object
-    u32 vbo;
   };
 
 }    // namespace nile
@@ -1,5 +1,8 @@
 #pragma once
 
+#include "Nile/renderer/texture_atlas.hh"
+
+#include <glm/glm.hpp>
 #include <memory>
 
 namespace nile {
@@ -11,7 +14,15 @@ namespace nile {
         : texture( nullptr ) {}
     SpriteComponent( std::shared_ptr<Texture2D> &tex )
         : texture( tex ) {}
+    // Sprites of the same atlas page are drawn together
+    SpriteComponent( const AtlasRegion &region )
+        : texture( region.texture )
+        , uvMin( region.uvMin )
+        , uvMax( region.uvMax ) {}
     std::shared_ptr<Texture2D> texture;
+    // Part of the texture the quad shows
+    glm::vec2 uvMin {0.0f};
+    glm::vec2 uvMax {1.0f};
   };
 
 }    // namespace nile
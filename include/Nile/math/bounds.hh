@@ -0,0 +1,62 @@
+/* ================================================================================
+$File: bounds.hh
+$Date: $
+$Revision: $
+$Creator: Rostislav Orestis Stelmach
+$Notice: $
+================================================================================ */
+
+#pragma once
+
+#include "Nile/core/types.hh"
+#include "Nile/utils/vertex.hh"
+
+#include <glm/glm.hpp>
+#include <limits>
+#include <vector>
+
+namespace nile {
+
+  // Axis aligned bounding box, a default constructed box is empty ( min > max )
+  // and grows with every point added to it
+  struct AABB {
+    glm::vec3 min {std::numeric_limits<f32>::max()};
+    glm::vec3 max {std::numeric_limits<f32>::lowest()};
+
+    [[nodiscard]] bool isValid() const noexcept {
+      return min.x <= max.x && min.y <= max.y && min.z <= max.z;
+    }
+
+    [[nodiscard]] glm::vec3 center() const noexcept {
+      return ( min + max ) * 0.5f;
+    }
+
+    [[nodiscard]] glm::vec3 extents() const noexcept {
+      return ( max - min ) * 0.5f;
+    }
+
+    void expand( const glm::vec3 &point ) noexcept {
+      min = glm::min( min, point );
+      max = glm::max( max, point );
+    }
+  };
+
+  struct BoundingSphere {
+    glm::vec3 center {0.0f};
+    f32 radius = 0.0f;
+  };
+
+  namespace Math {
+
+    [[nodiscard]] AABB computeBounds( const std::vector<Vertex> &vertices ) noexcept;
+
+    // Sphere around the box, not the tightest one but good enough for culling
+    [[nodiscard]] BoundingSphere computeSphere( const AABB &bounds ) noexcept;
+
+    // Box that encloses the transformed box, transforms the center and the
+    // extents instead of the eight corners
+    [[nodiscard]] AABB transformBounds( const AABB &bounds, const glm::mat4 &matrix ) noexcept;
+
+  }    // namespace Math
+
+}    // namespace nile
@@ -0,0 +1,39 @@
+/* ================================================================================
+$File: frustum.hh
+$Date: $
+$Revision: $
+$Creator: Rostislav Orestis Stelmach
+$Notice: $
+================================================================================ */
+
+#pragma once
+
+#include "Nile/core/types.hh"
+#include "Nile/math/bounds.hh"
+
+#include <array>
+#include <glm/glm.hpp>
+
+namespace nile {
+
+  // Six planes ( xyz - normal pointing inside, w - distance ) of a view frustum.
+  // The default frustum contains everything, so nothing is culled until a camera
+  // sets a real one.
+  struct Frustum {
+    enum Plane : u32 { LEFT = 0, RIGHT, BOTTOM, TOP, NEAR, FAR, COUNT };
+
+    std::array<glm::vec4, COUNT> planes {
+        glm::vec4 {0.0f, 0.0f, 0.0f, 1.0f}, glm::vec4 {0.0f, 0.0f, 0.0f, 1.0f},
+        glm::vec4 {0.0f, 0.0f, 0.0f, 1.0f}, glm::vec4 {0.0f, 0.0f, 0.0f, 1.0f},
+        glm::vec4 {0.0f, 0.0f, 0.0f, 1.0f}, glm::vec4 {0.0f, 0.0f, 0.0f, 1.0f}};
+
+    // Extracts the planes from an OpenGL ( -1 .. 1 clip depth ) view-projection matrix
+    [[nodiscard]] static Frustum fromMatrix( const glm::mat4 &viewProjection ) noexcept;
+
+    // Conservative test, boxes near the corners of the frustum may pass
+    [[nodiscard]] bool intersects( const AABB &bounds ) const noexcept;
+
+    [[nodiscard]] bool intersects( const BoundingSphere &sphere ) const noexcept;
+  };
+
+}    // namespace nile
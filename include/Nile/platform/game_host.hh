@@ -17,6 +17,7 @@ namespace nile {
   class InputManager;
   class AssetManager;
   class Coordinator;
+  class SceneGraph;
 
   class GameHost {
   protected:
@@ -32,6 +33,7 @@ namespace nile {
     [[nodiscard]] virtual std::shared_ptr<InputManager> get_input_manager() const noexcept = 0;
     [[nodiscard]] virtual std::shared_ptr<AssetManager> get_asset_manager() const noexcept = 0;
     [[nodiscard]] virtual std::shared_ptr<Coordinator> get_ecs_coordinator() const noexcept = 0;
+    [[nodiscard]] virtual std::shared_ptr<SceneGraph> get_scene_graph() const noexcept = 0;
   };
 
 }    // namespace nile
@@ -36,6 +36,7 @@ namespace nile {
       [[nodiscard]] std::shared_ptr<InputManager> get_input_manager() const noexcept override;
       [[nodiscard]] std::shared_ptr<AssetManager> get_asset_manager() const noexcept override;
       [[nodiscard]] std::shared_ptr<Coordinator> get_ecs_coordinator() const noexcept override;
+      [[nodiscard]] std::shared_ptr<SceneGraph> get_scene_graph() const noexcept override;
     };
 
   }    // namespace X11
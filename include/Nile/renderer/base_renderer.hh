@@ -10,8 +10,17 @@ $Notice: $
 
 #include <SDL2/SDL.h>
 
+#include <memory>
+
 namespace nile {
 
+  class DebugDraw;
+  class FrameUniforms;
+  class GpuProfiler;
+  class GLStateCache;
+  class RenderQueue;
+  class StreamBuffer;
+
   class BaseRenderer {
   public:
     virtual ~BaseRenderer() noexcept;
@@ -24,6 +33,18 @@ namespace nile {
 
     virtual SDL_Window *getWindow() noexcept = 0;
     virtual SDL_GLContext getContext() const noexcept = 0;
+    // OpenGL state shared by all the render systems
+    virtual std::shared_ptr<GLStateCache> getStateCache() const noexcept = 0;
+    // Draw packets of the render systems, executed once per frame
+    virtual std::shared_ptr<RenderQueue> getRenderQueue() const noexcept = 0;
+    // Camera and light uniform buffers shared by all the shaders
+    virtual std::shared_ptr<FrameUniforms> getFrameUniforms() const noexcept = 0;
+    // Per frame allocator of dynamic geometry, flushed before the queue is executed
+    virtual std::shared_ptr<StreamBuffer> getStreamBuffer() const noexcept = 0;
+    // Immediate mode debug lines, boxes, spheres and text, drawn with the next frame
+    virtual std::shared_ptr<DebugDraw> getDebugDraw() const noexcept = 0;
+    // GPU time of the scopes of the frame, the whole frame is measured as "frame"
+    virtual std::shared_ptr<GpuProfiler> getGpuProfiler() const noexcept = 0;
   };
 
 }    // namespace nile
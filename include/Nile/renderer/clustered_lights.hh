@@ -0,0 +1,214 @@
+/* ================================================================================
+$File: clustered_lights.hh
+$Date: $
+$Revision: $
+$Creator: Rostislav Orestis Stelmach
+$Notice: $
+================================================================================ */
+
+#pragma once
+
+#include "Nile/core/helper.hh"
+#include "Nile/core/types.hh"
+
+#include <glm/glm.hpp>
+
+#include <vector>
+
+// @brief:
+// ClusteredLights splits the view frustum into a grid of clusters ( screen tiles times
+// depth slices, the slices grow exponentially with the distance ) and finds the point
+// lights that reach every cluster. The fragment shader picks its cluster from the
+// window position and the view depth, so it only shades the lights of that cluster
+// instead of every light of the scene.
+// Cluster bounds are view space boxes, rebuilt only when the projection changes. The
+// boxes are packed one array per coordinate, so a light sphere is tested against
+// four clusters of a row at once with SSE ( the scalar loop is used everywhere else ).
+// Crowded frames split the lights among worker threads, each one fills its own entries.
+// The light lists are compacted into one index array, with an offset and a count per
+// cluster. Lights, cluster ranges and indices are uploaded into texture buffers.
+// Usage: setProjection(), begin(), add() the lights of the frame, assign() with the
+// view matrix, then upload() and bind() when drawing.
+//
+// GLSL side ( see model.frag.glsl ):
+//
+//   samplerBuffer  - RGBA32F, 5 texels per light ( PointLightData )
+//   usamplerBuffer - RG32UI, offset and count of the light indices of every cluster
+//   usamplerBuffer - R32UI, light indices
+//   cluster = x + CLUSTERS_X * ( y + CLUSTERS_Y * z )
+
+namespace nile {
+
+  class GLStateCache;
+
+  // Light as it is stored in the light buffer, one RGBA32F texel per member
+  struct PointLightData {
+    // xyz - world space position, w - range
+    glm::vec4 position {0.0f};
+    glm::vec4 ambient {0.0f};
+    glm::vec4 diffuse {0.0f};
+    glm::vec4 specular {0.0f};
+    // x - constant, y - linear, z - quadratic
+    glm::vec4 attenuation {1.0f, 0.0f, 0.0f, 0.0f};
+  };
+
+  static_assert( sizeof( PointLightData ) == 5 * 16, "PointLightData has to be 5 texels" );
+
+  struct ClusteredLightsStats {
+    u32 lights = 0;
+    // Lights that reach at least one cluster
+    u32 visibleLights = 0;
+    // Light indices written to the cluster lists
+    u32 entries = 0;
+    // Entries dropped because a cluster was full
+    u32 droppedEntries = 0;
+    u32 maxPerCluster = 0;
+    usize uploadedBytes = 0;
+  };
+
+  class ClusteredLights {
+  public:
+    static constexpr u32 CLUSTERS_X = 16;
+    static constexpr u32 CLUSTERS_Y = 9;
+    static constexpr u32 CLUSTERS_Z = 24;
+    static constexpr u32 CLUSTER_COUNT = CLUSTERS_X * CLUSTERS_Y * CLUSTERS_Z;
+
+    // Bounds the work of a fragment, the lights past it are dropped from the cluster
+    static constexpr u32 MAX_LIGHTS_PER_CLUSTER = 128;
+
+    // Fewer lights are assigned on the calling thread
+    static constexpr u32 PARALLEL_LIGHTS = 512;
+
+    // Texture units of the light buffers, above the ones used by the materials
+    static constexpr u32 LIGHTS_UNIT = 13;
+    static constexpr u32 CLUSTERS_UNIT = 14;
+    static constexpr u32 INDICES_UNIT = 15;
+
+  private:
+    struct Entry {
+      u32 cluster;
+      u32 light;
+    };
+
+    // Entries of a contiguous range of lights, one per worker
+    struct Bin {
+      std::vector<Entry> entries;
+      u32 visibleLights = 0;
+    };
+
+    // View space cluster bounds, padded so a row can always be read four at a time
+    std::vector<f32> m_minX;
+    std::vector<f32> m_minY;
+    std::vector<f32> m_minZ;
+    std::vector<f32> m_maxX;
+    std::vector<f32> m_maxY;
+    std::vector<f32> m_maxZ;
+
+    glm::mat4 m_projection {0.0f};
+    glm::vec2 m_viewport {0.0f};
+    bool m_perspective = false;
+    f32 m_near = 0.0f;
+    f32 m_far = 0.0f;
+    // slice = log( depth ) * m_sliceScale + m_sliceBias
+    f32 m_sliceScale = 0.0f;
+    f32 m_sliceBias = 0.0f;
+
+    std::vector<PointLightData> m_lights;
+
+    // Worker threads of assign(), 0 picks the hardware concurrency
+    u32 m_threads = 0;
+
+    std::vector<Bin> m_bins;
+    // Offset and count of every cluster, interleaved like the RG32UI texels
+    std::vector<u32> m_clusters;
+    std::vector<u32> m_indices;
+
+    ClusteredLightsStats m_stats;
+
+    // OpenGL objects are created lazily by the first upload, one buffer and one
+    // texture per light buffer ( lights, clusters, indices )
+    u32 m_buffers[ 3 ] = {0, 0, 0};
+    u32 m_textures[ 3 ] = {0, 0, 0};
+
+    void buildClusters() noexcept;
+    [[nodiscard]] u32 slice( f32 depth ) const noexcept;
+    void assignLights( const glm::mat4 &view, bool simd ) noexcept;
+    void assignRange( const glm::mat4 &view, u32 begin, u32 end, bool simd, Bin &bin ) noexcept;
+    void testRow( u32 row, u32 first, u32 last, const glm::vec3 &center, f32 radius, u32 light,
+                  bool simd, std::vector<Entry> &entries ) const noexcept;
+    void compact() noexcept;
+
+  public:
+    ClusteredLights() noexcept = default;
+    ~ClusteredLights() noexcept;
+
+    NILE_DISABLE_COPY( ClusteredLights )
+    NILE_DISABLE_MOVE( ClusteredLights )
+
+    // Rebuilds the cluster bounds when the projection or the viewport changed. Lights
+    // are not culled with an orthographic projection, every light reaches every cluster.
+    void setProjection( const glm::mat4 &projection, const glm::vec2 &viewport ) noexcept;
+
+    void begin() noexcept;
+
+    // Lights with a range of 0 are ignored
+    void add( const PointLightData &light ) noexcept;
+
+    // Fills the cluster lists from the lights added since begin()
+    void assign( const glm::mat4 &view ) noexcept;
+
+    // Same as assign(), without SIMD, used to validate it
+    void assignScalar( const glm::mat4 &view ) noexcept;
+
+    // 1 assigns every light on the calling thread
+    void setThreads( u32 threads ) noexcept {
+      m_threads = threads;
+    }
+
+    // Uploads the lights and the cluster lists, needs an OpenGL context
+    void upload() noexcept;
+
+    // Binds the texture buffers to their units
+    void bind( GLStateCache &state ) const noexcept;
+
+    // Distance at which the light falls below 1/256 of its intensity
+    [[nodiscard]] static f32 computeRange( const glm::vec3 &attenuation, f32 intensity ) noexcept;
+
+    [[nodiscard]] static u32 clusterIndex( u32 x, u32 y, u32 z ) noexcept {
+      return x + CLUSTERS_X * ( y + CLUSTERS_Y * z );
+    }
+
+    // Lights of the cluster are m_indices[ offset, offset + count )
+    [[nodiscard]] u32 getClusterOffset( u32 cluster ) const noexcept {
+      return m_clusters[ cluster * 2 ];
+    }
+
+    [[nodiscard]] u32 getClusterCount( u32 cluster ) const noexcept {
+      return m_clusters[ cluster * 2 + 1 ];
+    }
+
+    [[nodiscard]] const std::vector<u32> &getIndices() const noexcept {
+      return m_indices;
+    }
+
+    // x - near, y - far, z - slice scale, w - slice bias, all 0 for orthographic projections
+    [[nodiscard]] glm::vec4 getDepthParameters() const noexcept {
+      return glm::vec4( m_near, m_far, m_sliceScale, m_sliceBias );
+    }
+
+    // Size of a cluster in pixels
+    [[nodiscard]] glm::vec2 getClusterSize() const noexcept {
+      return m_viewport / glm::vec2( CLUSTERS_X, CLUSTERS_Y );
+    }
+
+    [[nodiscard]] u32 size() const noexcept {
+      return static_cast<u32>( m_lights.size() );
+    }
+
+    // Counters of the last assign() and upload()
+    [[nodiscard]] const ClusteredLightsStats &getStats() const noexcept {
+      return m_stats;
+    }
+  };
+
+}    // namespace nile
@@ -9,29 +9,56 @@ $Notice: $
 #pragma once
 
 #include "Nile/ecs/ecs_system.hh"
+#include "Nile/renderer/text_batch.hh"
+#include "Nile/renderer/uniform_handle.hh"
 #include <memory>
 
+// @brief:
+// FontRenderingSystem draws the FontComponent texts through a TextBatch. The glyph
+// quads of a text are cached until its text, font or transform changes, and all the
+// texts that share a glyph atlas are drawn with one draw call.
+
 namespace nile {
 
+  class AssetManager;
   class ShaderSet;
   class Settings;
   class Coordinator;
+  class GLStateCache;
+  class RenderQueue;
+  struct FontComponent;
 
   class FontRenderingSystem : public System {
   private:
     void init_rendering_data() noexcept;
+    void load_atlas( FontComponent &font ) noexcept;
     std::shared_ptr<Coordinator> ecs_coordinator_;
     std::shared_ptr<Settings> settings_;
+    std::shared_ptr<GLStateCache> gl_state_;
+    std::shared_ptr<RenderQueue> render_queue_;
+    std::shared_ptr<AssetManager> assets_manager_;
     std::shared_ptr<ShaderSet> font_shader_;
+    TextBatch text_batch_;
+
+    UniformHandle projection_uniform_;
+    UniformHandle text_uniform_;
 
   public:
     FontRenderingSystem( const std::shared_ptr<Coordinator> &coordinator,
                          const std::shared_ptr<Settings> &settings,
+                         const std::shared_ptr<GLStateCache> &state,
+                         const std::shared_ptr<RenderQueue> &queue,
+                         const std::shared_ptr<AssetManager> &assetManager,
                          const std::shared_ptr<ShaderSet> &shader ) noexcept;
     void create() noexcept;
     void destroy() noexcept;
     void update( float dt ) noexcept;
     void render( float dt ) noexcept;
+
+    // Counters of the last rendered frame
+    [[nodiscard]] const TextBatchStats &getStats() const noexcept {
+      return text_batch_.getStats();
+    }
   };
 
 }    // namespace nile
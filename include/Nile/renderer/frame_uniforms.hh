@@ -0,0 +1,133 @@
+/* ================================================================================
+$File: frame_uniforms.hh
+$Date: $
+$Revision: $
+$Creator: Rostislav Orestis Stelmach
+$Notice: $
+================================================================================ */
+
+#pragma once
+
+#include "Nile/core/helper.hh"
+#include "Nile/core/types.hh"
+
+#include <glm/glm.hpp>
+
+// @brief:
+// FrameUniforms owns the uniform buffers with the data every shader of the frame
+// shares: the camera block and the light block. The CPU copies below follow the
+// std140 layout, so they are uploaded as they are. Both buffers stay bound to fixed
+// binding points, every program built by the ShaderSet builder has its "Camera" and
+// "Lights" blocks pointed at them, so one upload per frame serves all the shaders.
+// The CameraSystem fills the camera block and uploads. The directional light is set by
+// the game, the LightingSystem writes the cluster grid of the point lights ( see
+// clustered_lights.hh ), the block is only uploaded again after one of them changes.
+//
+// GLSL side:
+//
+//   layout( std140 ) uniform Camera {
+//     mat4 view; mat4 projection; mat4 viewProjection; vec4 viewPosition;
+//   };
+//   struct DirectionalLight { vec4 direction; vec4 ambient; vec4 diffuse; vec4 specular; };
+//   layout( std140 ) uniform Lights {
+//     DirectionalLight directionalLight;
+//     uvec4 clusterGrid;  // xyz - clusters along x, y and depth, w - point lights
+//     vec4 clusterDepth;  // near, far, slice scale, slice bias
+//     vec4 clusterSize;   // xy - size of a cluster in pixels
+//   };
+
+namespace nile {
+
+  // Binding points of the engine uniform blocks
+  enum class UniformBinding : u32 { CAMERA = 0, LIGHTS = 1 };
+
+  struct CameraBlock {
+    glm::mat4 view {1.0f};
+    glm::mat4 projection {1.0f};
+    glm::mat4 viewProjection {1.0f};
+    // xyz - camera position in world space
+    glm::vec4 viewPosition {0.0f};
+  };
+
+  // vec3 members are stored as vec4, std140 aligns them to 16 bytes anyway
+  struct DirectionalLightData {
+    glm::vec4 direction {0.0f, -1.0f, 0.0f, 0.0f};
+    glm::vec4 ambient {0.0f};
+    glm::vec4 diffuse {0.0f};
+    glm::vec4 specular {0.0f};
+  };
+
+  struct LightBlock {
+    DirectionalLightData directionalLight;
+    // xyz - number of clusters along x, y and depth, w - number of point lights
+    glm::uvec4 clusterGrid {0};
+    // x - near, y - far, z/w - slice scale and bias, slice = log( depth ) * z + w
+    glm::vec4 clusterDepth {0.0f};
+    // xy - size of a cluster in pixels
+    glm::vec4 clusterSize {1.0f};
+  };
+
+  static_assert( sizeof( CameraBlock ) == 3 * 64 + 16, "CameraBlock does not match std140" );
+  static_assert( sizeof( LightBlock ) == 64 + 3 * 16, "LightBlock does not match std140" );
+
+  struct FrameUniformsStats {
+    // Buffer updates issued during the last upload()
+    u32 uploads = 0;
+    usize uploadedBytes = 0;
+  };
+
+  class FrameUniforms {
+  private:
+    CameraBlock m_camera;
+    LightBlock m_lights;
+
+    bool m_cameraDirty = true;
+    bool m_lightsDirty = true;
+
+    FrameUniformsStats m_stats;
+
+    // OpenGL objects are created lazily by the first upload
+    u32 m_cameraBuffer = 0;
+    u32 m_lightBuffer = 0;
+
+  public:
+    FrameUniforms() noexcept = default;
+    ~FrameUniforms() noexcept;
+
+    NILE_DISABLE_COPY( FrameUniforms )
+    NILE_DISABLE_MOVE( FrameUniforms )
+
+    void setCamera( const glm::mat4 &view, const glm::mat4 &projection,
+                    const glm::vec3 &position ) noexcept;
+
+    void setDirectionalLight( const DirectionalLightData &light ) noexcept;
+
+    // Cluster grid the point light lists of the frame were built for
+    void setClusters( const glm::uvec4 &grid, const glm::vec4 &depth,
+                      const glm::vec2 &size ) noexcept;
+
+    // Uploads the blocks that changed since the last upload, needs an OpenGL context
+    void upload() noexcept;
+
+    // Points the "Camera" and "Lights" blocks of the program, if it has them, at the
+    // engine binding points
+    static void bindUniformBlocks( u32 program ) noexcept;
+
+    [[nodiscard]] const CameraBlock &getCamera() const noexcept {
+      return m_camera;
+    }
+
+    [[nodiscard]] const LightBlock &getLights() const noexcept {
+      return m_lights;
+    }
+
+    [[nodiscard]] u32 getPointLightCount() const noexcept {
+      return m_lights.clusterGrid.w;
+    }
+
+    [[nodiscard]] const FrameUniformsStats &getStats() const noexcept {
+      return m_stats;
+    }
+  };
+
+}    // namespace nile
@@ -0,0 +1,72 @@
+/* ================================================================================
+$File: frustum_culler.hh
+$Date: $
+$Revision: $
+$Creator: Rostislav Orestis Stelmach
+$Notice: $
+================================================================================ */
+
+#pragma once
+
+#include "Nile/core/types.hh"
+#include "Nile/math/bounds.hh"
+#include "Nile/math/frustum.hh"
+
+#include <vector>
+
+// @brief:
+// FrustumCuller tests a batch of world space boxes against the frustum of the camera.
+// The boxes are packed into one array per coordinate, so four of them are tested
+// against a plane at once with SSE ( the scalar loop is used everywhere else ).
+// Usage: begin(), add() the boxes of the frame, cull() once and then ask
+// isVisible() with the index returned by add().
+
+namespace nile {
+
+  struct CullingStats {
+    u32 tested = 0;
+    u32 visible = 0;
+    u32 culled = 0;
+  };
+
+  class FrustumCuller {
+  private:
+    // Packed box coordinates, padded to a multiple of four
+    std::vector<f32> m_minX;
+    std::vector<f32> m_minY;
+    std::vector<f32> m_minZ;
+    std::vector<f32> m_maxX;
+    std::vector<f32> m_maxY;
+    std::vector<f32> m_maxZ;
+
+    std::vector<u8> m_visible;
+    u32 m_count = 0;
+
+    CullingStats m_stats;
+
+  public:
+    void begin() noexcept;
+
+    // Boxes that are not valid ( e.g. meshes without bounds yet ) are always visible
+    u32 add( const AABB &bounds ) noexcept;
+
+    void cull( const Frustum &frustum ) noexcept;
+
+    // Same as cull(), without SIMD, used to validate it
+    void cullScalar( const Frustum &frustum ) noexcept;
+
+    [[nodiscard]] bool isVisible( u32 index ) const noexcept {
+      return m_visible[ index ] != 0;
+    }
+
+    [[nodiscard]] u32 size() const noexcept {
+      return m_count;
+    }
+
+    // Counters of the last cull()
+    [[nodiscard]] const CullingStats &getStats() const noexcept {
+      return m_stats;
+    }
+  };
+
+}    // namespace nile
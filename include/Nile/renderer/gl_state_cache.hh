@@ -0,0 +1,95 @@
+/* ================================================================================
+$File: gl_state_cache.hh
+$Date: $
+$Revision: $
+$Creator: Rostislav Orestis Stelmach
+$Notice: $
+================================================================================ */
+
+#pragma once
+
+#include "Nile/core/helper.hh"
+#include "Nile/core/types.hh"
+
+#include <array>
+
+// @brief:
+// GLStateCache shadows the OpenGL state that the render systems change all the time
+// ( program, vertex array, textures per unit, blend, face culling, depth test and
+// depth writes ) and skips the calls that would not change anything.
+// It only knows about the changes that go through it. Code that touches the same
+// state directly has to call invalidate() afterwards, the renderer does that at the
+// beginning of every frame, so raw calls made outside of the systems are safe.
+
+namespace nile {
+
+  struct GLStateStats {
+    // Calls that reached OpenGL
+    u32 issuedCalls = 0;
+    // Calls skipped because the state was already set
+    u32 avoidedCalls = 0;
+  };
+
+  class GLStateCache {
+  private:
+    // Texture units tracked by the cache, binds to higher units are always issued
+    static constexpr u32 MAX_TEXTURE_UNITS = 16;
+
+    // Value of a shadowed state that is not known, forces the next call
+    static constexpr u32 UNKNOWN = ~0u;
+
+    enum class Toggle : u8 { DISABLED, ENABLED, UNKNOWN };
+
+    u32 m_program = UNKNOWN;
+    u32 m_vertexArray = UNKNOWN;
+    u32 m_activeUnit = UNKNOWN;
+    std::array<u32, MAX_TEXTURE_UNITS> m_textures;
+
+    Toggle m_blend = Toggle::UNKNOWN;
+    Toggle m_cullFace = Toggle::UNKNOWN;
+    Toggle m_depthTest = Toggle::UNKNOWN;
+    Toggle m_depthWrite = Toggle::UNKNOWN;
+
+    GLStateStats m_frameStats;
+    GLStateStats m_lastFrameStats;
+
+    void activeTexture( u32 unit ) noexcept;
+    void setCapability( Toggle &shadow, u32 capability, bool enabled ) noexcept;
+
+  public:
+    GLStateCache() noexcept;
+
+    NILE_DISABLE_COPY( GLStateCache )
+    NILE_DISABLE_MOVE( GLStateCache )
+
+    // Forget everything that is shadowed, the next call of every kind is issued
+    void invalidate() noexcept;
+
+    // Invalidates the cache and starts counting the calls of a new frame
+    void beginFrame() noexcept;
+
+    void useProgram( u32 program ) noexcept;
+    void bindVertexArray( u32 vertexArray ) noexcept;
+    // Binds a GL_TEXTURE_2D texture to the given texture unit
+    void bindTexture( u32 unit, u32 texture ) noexcept;
+    // Binds a GL_TEXTURE_BUFFER texture to the given texture unit, only the active unit
+    // is shadowed, buffer textures are bound a few times per frame
+    void bindTextureBuffer( u32 unit, u32 texture ) noexcept;
+
+    void setBlend( bool enabled ) noexcept;
+    void setCullFace( bool enabled ) noexcept;
+    void setDepthTest( bool enabled ) noexcept;
+    void setDepthWrite( bool enabled ) noexcept;
+
+    // Counters of the frame in progress
+    [[nodiscard]] const GLStateStats &getFrameStats() const noexcept {
+      return m_frameStats;
+    }
+
+    // Counters of the last complete frame
+    [[nodiscard]] const GLStateStats &getLastFrameStats() const noexcept {
+      return m_lastFrameStats;
+    }
+  };
+
+}    // namespace nile
@@ -0,0 +1,122 @@
+/* ================================================================================
+$File: glyph_atlas.hh
+$Date: $
+$Revision: $
+$Creator: Rostislav Orestis Stelmach
+$Notice: $
+================================================================================ */
+
+#pragma once
+
+#include "Nile/asset/asset.hh"
+#include "Nile/core/helper.hh"
+#include "Nile/core/types.hh"
+
+#include <glm/glm.hpp>
+
+#include <array>
+#include <vector>
+
+// @brief:
+// GlyphAtlas keeps the rasterized glyphs of one font at one pixel size packed into a
+// single GL_RED texture. Glyphs are packed on shelves ( rows as high as their tallest
+// glyph ), the atlas width is fixed and its height grows while glyphs are added.
+// Packing is done on the CPU, the texture is created only by upload().
+// Atlases are created by AssetBuilder::Builder<GlyphAtlas> and are shared through the
+// AssetManager by every text entity that uses the same font and size.
+
+namespace nile {
+
+  // This struct represents a font glyph, a region of the atlas texture with the
+  // metrics needed to place it on the baseline
+  struct Glyph {
+    // Size of the glyph bitmap in pixels
+    glm::ivec2 size {0};
+    // Offset from the pen position to the left/top of the glyph
+    glm::ivec2 bearing {0};
+    // Offset to advance to the next glyph, in 1/64 pixels
+    u32 advance = 0;
+    // Texture coordinates of the top-left and the bottom-right corner
+    glm::vec2 uvMin {0.0f};
+    glm::vec2 uvMax {0.0f};
+  };
+
+  class GlyphAtlas : public Asset {
+  public:
+    // Glyphs are stored by codepoint, the atlas covers ASCII
+    static constexpr u32 GLYPH_COUNT = 128;
+    // Empty texels left between the glyphs, so linear filtering does not bleed
+    static constexpr u32 PADDING = 1;
+
+  private:
+    std::array<Glyph, GLYPH_COUNT> m_glyphs {};
+
+    // Atlas texels, one byte per texel, m_width * m_height
+    std::vector<u8> m_pixels;
+    u32 m_width = 0;
+    u32 m_height = 0;
+
+    // Next free position of the current shelf
+    u32 m_penX = PADDING;
+    u32 m_shelfY = PADDING;
+    u32 m_shelfHeight = 0;
+
+    u32 m_pixelSize = 0;
+    // Distance from the top of the line to the baseline
+    i32 m_ascent = 0;
+
+    u32 m_textureId = 0;
+
+  public:
+    GlyphAtlas( u32 width, u32 pixelSize ) noexcept;
+    ~GlyphAtlas() noexcept;
+
+    NILE_DISABLE_COPY( GlyphAtlas )
+    NILE_DISABLE_MOVE( GlyphAtlas )
+
+    // Copies the glyph bitmap into the atlas. `pitch` is the length of one bitmap row in
+    // bytes. Returns false if the codepoint is out of range or the glyph is wider than
+    // the atlas.
+    bool addGlyph( u32 codepoint, u32 width, u32 rows, i32 pitch, const u8 *bitmap,
+                   const glm::ivec2 &bearing, u32 advance ) noexcept;
+
+    void setAscent( i32 ascent ) noexcept {
+      m_ascent = ascent;
+    }
+
+    // Creates the texture from the packed texels and turns the glyph rectangles into
+    // texture coordinates, needs an OpenGL context. The atlas is read only afterwards.
+    void upload() noexcept;
+
+    // Glyphs outside of the atlas are drawn as '?'
+    [[nodiscard]] const Glyph &getGlyph( u32 codepoint ) const noexcept {
+      return m_glyphs[ codepoint < GLYPH_COUNT ? codepoint : '?' ];
+    }
+
+    [[nodiscard]] u32 getTextureId() const noexcept {
+      return m_textureId;
+    }
+
+    [[nodiscard]] u32 getWidth() const noexcept {
+      return m_width;
+    }
+
+    // Power of two height that holds every shelf
+    [[nodiscard]] u32 getHeight() const noexcept {
+      return m_height;
+    }
+
+    [[nodiscard]] u32 getPixelSize() const noexcept {
+      return m_pixelSize;
+    }
+
+    [[nodiscard]] i32 getAscent() const noexcept {
+      return m_ascent;
+    }
+
+    [[nodiscard]] const std::vector<u8> &getPixels() const noexcept {
+      return m_pixels;
+    }
+  };
+
+}    // namespace nile
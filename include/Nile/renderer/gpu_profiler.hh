@@ -0,0 +1,126 @@
+/* ================================================================================
+$File: gpu_profiler.hh
+$Date: $
+$Revision: $
+$Creator: Rostislav Orestis Stelmach
+$Notice: $
+================================================================================ */
+
+#pragma once
+
+#include "Nile/core/helper.hh"
+#include "Nile/core/types.hh"
+
+#include <vector>
+
+// @brief:
+// GpuProfiler measures the GPU time of named scopes of the frame. Every scope writes
+// a GL_TIMESTAMP query when it begins and one when it ends, so scopes can be nested
+// ( GL_TIME_ELAPSED queries can't ), e.g. the passes of the render queue inside the scene.
+// The queries live in a ring of FRAMES frames. A frame is read back when its slot is
+// reused, FRAMES - 1 frames later, and only if all its queries are available, so the
+// profiler never waits for the GPU. Frames that are still in flight are dropped.
+// Timer queries are core since OpenGL 3.3, Mesa's llvmpipe implements them as well.
+// Usage: beginFrame(), begin() / end() pairs ( or a ScopedTiming ) and endFrame() once
+// per frame, getResults() returns the scopes of the last frame that was read back.
+
+namespace nile {
+
+  struct GpuTiming {
+    // Names are not copied, they have to outlive the profiler ( e.g. string literals )
+    const char *name;
+    // Nesting level, 0 for the top level scopes
+    u32 depth;
+    f32 milliseconds;
+  };
+
+  struct GpuProfilerStats {
+    // Frames whose queries were not available yet when their slot was reused
+    u32 droppedFrames = 0;
+    // Scopes past MAX_SCOPES, they are not measured
+    u32 overflows = 0;
+    bool supported = false;
+  };
+
+  class GpuProfiler {
+  public:
+    // Frames in flight, results are FRAMES - 1 frames old
+    static constexpr u32 FRAMES = 4;
+    static constexpr u32 MAX_SCOPES = 32;
+
+    class ScopedTiming {
+    private:
+      GpuProfiler &m_profiler;
+
+    public:
+      ScopedTiming( GpuProfiler &profiler, const char *name ) noexcept
+          : m_profiler( profiler ) {
+        m_profiler.begin( name );
+      }
+
+      ~ScopedTiming() noexcept {
+        m_profiler.end();
+      }
+
+      NILE_DISABLE_COPY( ScopedTiming )
+      NILE_DISABLE_MOVE( ScopedTiming )
+    };
+
+  private:
+    struct Marker {
+      const char *name;
+      u32 depth;
+      bool closed;
+    };
+
+    struct Frame {
+      std::vector<Marker> markers;
+      // Begin and end query of every marker
+      u32 queries[ MAX_SCOPES * 2 ] = {};
+      bool pending = false;
+    };
+
+    Frame m_frames[ FRAMES ];
+    u32 m_current = 0;
+
+    // Markers that are still open, ~0u for the ones past MAX_SCOPES
+    std::vector<u32> m_open;
+    bool m_inFrame = false;
+    bool m_created = false;
+
+    std::vector<GpuTiming> m_results;
+    GpuProfilerStats m_stats;
+
+    void create() noexcept;
+    void collect( Frame &frame ) noexcept;
+
+  public:
+    GpuProfiler() noexcept = default;
+    ~GpuProfiler() noexcept;
+
+    NILE_DISABLE_COPY( GpuProfiler )
+    NILE_DISABLE_MOVE( GpuProfiler )
+
+    // Reads back the oldest frame of the ring and starts a new one
+    void beginFrame() noexcept;
+
+    // Closes the scopes that are still open
+    void endFrame() noexcept;
+
+    void begin( const char *name ) noexcept;
+    void end() noexcept;
+
+    // Scopes of the last frame that was read back, in the order they began
+    [[nodiscard]] const std::vector<GpuTiming> &getResults() const noexcept {
+      return m_results;
+    }
+
+    // Time of the first scope with that name in the last frame read back, 0 when missing
+    [[nodiscard]] f32 getTime( const char *name ) const noexcept;
+
+    [[nodiscard]] const GpuProfilerStats &getStats() const noexcept {
+      return m_stats;
+    }
+  };
+
+}    // namespace nile
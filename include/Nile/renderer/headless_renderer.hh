@@ -0,0 +1,105 @@
+/* ================================================================================
+$File: headless_renderer.hh
+$Date: $
+$Revision: $
+$Creator: Rostislav Orestis Stelmach
+$Notice: $
+================================================================================ */
+
+#pragma once
+
+#include "Nile/core/types.hh"
+#include "Nile/renderer/base_renderer.hh"
+#include <SDL2/SDL.h>
+
+#include <memory>
+#include <string>
+
+// @brief:
+// HeadlessRenderer renders without a window or a display, for CI and batch benchmarks.
+// The context comes from EGL: Mesa's surfaceless platform when it is there ( llvmpipe on
+// a server without X ), the default display otherwise. A pbuffer of the window size
+// stands in for the window, so the render graph of the host draws the scene target and
+// blits it to the "screen" exactly like with OpenGLRenderer, only nothing is presented.
+// captureFrame() reads the pbuffer back and writes it as a PNG, e.g. to compare against
+// golden images. When the settings have a frame limit and a capture path, the last frame
+// is captured by endFrame().
+
+namespace nile {
+
+  class Settings;
+
+  class HeadlessRenderer : public BaseRenderer {
+  private:
+    std::shared_ptr<Settings> m_settings;
+    // EGLDisplay, EGLSurface and EGLContext, EGL is kept out of the header
+    void *m_display = nullptr;
+    void *m_surface = nullptr;
+    void *m_context = nullptr;
+
+    std::shared_ptr<GLStateCache> m_stateCache;
+    std::shared_ptr<RenderQueue> m_renderQueue;
+    std::shared_ptr<FrameUniforms> m_frameUniforms;
+    std::shared_ptr<StreamBuffer> m_streamBuffer;
+    std::shared_ptr<DebugDraw> m_debugDraw;
+    std::shared_ptr<GpuProfiler> m_gpuProfiler;
+
+    // Frames ended so far
+    u32 m_frame = 0;
+
+    // Initialize SDL ( timer and events only ) and the EGL display
+    void initRenderer() noexcept override;
+    // Create the pbuffer and the OpenGL context
+    void initWindow() noexcept override;
+
+  public:
+    explicit HeadlessRenderer( std::shared_ptr<Settings> settings ) noexcept;
+    ~HeadlessRenderer() noexcept;
+    void init() noexcept override;
+    void submitFrame() noexcept override;
+    // Ends the frame without presenting it, captures it if it was the last one
+    void endFrame() noexcept override;
+    void destroy() noexcept override;
+
+    // Writes the default framebuffer as an RGBA PNG, returns false on failure
+    bool captureFrame( const std::string &path ) const noexcept;
+
+    // There is no window
+    inline SDL_Window *getWindow() noexcept override {
+      return nullptr;
+    }
+
+    inline SDL_GLContext getContext() const noexcept override {
+      return m_context;
+    }
+
+    inline std::shared_ptr<GLStateCache> getStateCache() const noexcept override {
+      return m_stateCache;
+    }
+
+    inline std::shared_ptr<RenderQueue> getRenderQueue() const noexcept override {
+      return m_renderQueue;
+    }
+
+    inline std::shared_ptr<FrameUniforms> getFrameUniforms() const noexcept override {
+      return m_frameUniforms;
+    }
+
+    inline std::shared_ptr<StreamBuffer> getStreamBuffer() const noexcept override {
+      return m_streamBuffer;
+    }
+
+    inline std::shared_ptr<DebugDraw> getDebugDraw() const noexcept override {
+      return m_debugDraw;
+    }
+
+    inline std::shared_ptr<GpuProfiler> getGpuProfiler() const noexcept override {
+      return m_gpuProfiler;
+    }
+
+    [[nodiscard]] inline u32 getFrameCount() const noexcept {
+      return m_frame;
+    }
+  };
+
+}    // namespace nile
@@ -0,0 +1,63 @@
+/* ================================================================================
+$File: lighting_system.hh
+$Date: $
+$Revision: $
+$Creator: Rostislav Orestis Stelmach
+$Notice: $
+================================================================================ */
+
+#pragma once
+
+#include "Nile/core/types.hh"
+#include "Nile/ecs/ecs_system.hh"
+#include "Nile/renderer/clustered_lights.hh"
+
+#include <memory>
+
+// @brief:
+// LightingSystem collects the PointLight entities every frame and assigns them to the
+// clusters of the camera frustum ( see ClusteredLights ). The light lists are uploaded
+// and bound to their texture units before the render queue is executed, the cluster
+// grid is written into the "Lights" uniform block.
+// It reads the camera from FrameUniforms, so it has to render after the CameraSystem
+// has updated.
+
+namespace nile {
+
+  class Coordinator;
+  class FrameUniforms;
+  class GLStateCache;
+  class Settings;
+
+  class LightingSystem : public System {
+  private:
+    std::shared_ptr<Coordinator> ecs_coordinator_;
+    std::shared_ptr<Settings> settings_;
+    std::shared_ptr<GLStateCache> gl_state_;
+    std::shared_ptr<FrameUniforms> frame_uniforms_;
+
+    ClusteredLights clusters_;
+    // Size of the scene target in pixels, the clusters are tiles of gl_FragCoord
+    glm::vec2 viewport_;
+
+  public:
+    LightingSystem( const std::shared_ptr<Coordinator> &coordinator,
+                    const std::shared_ptr<Settings> &settings,
+                    const std::shared_ptr<GLStateCache> &state,
+                    const std::shared_ptr<FrameUniforms> &uniforms ) noexcept;
+
+    void create() noexcept;
+    void render( f32 dt ) noexcept;
+
+    // The window size by default, the host sets the render size of a scaled scene target
+    void setViewport( const glm::vec2 &viewport ) noexcept {
+      viewport_ = viewport;
+    }
+
+    // Counters of the last rendered frame
+    [[nodiscard]] const ClusteredLightsStats &getStats() const noexcept {
+      return clusters_.getStats();
+    }
+  };
+
+}    // namespace nile
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "Nile/core/types.hh"
+#include "Nile/math/bounds.hh"
+#include "Nile/renderer/vertex_format.hh"
 #include "Nile/utils/vertex.hh"
 
 #include <memory>
@@ -16,14 +18,28 @@ namespace nile {
           std::vector<std::shared_ptr<Texture2D>> t_textures ) noexcept
         : verticies( std::move( t_vertices ) )
         , indices( std::move( t_indices ) )
-        , textures( std::move( t_textures ) ) {}
+        , textures( std::move( t_textures ) )
+        , bounds( Math::computeBounds( verticies ) )
+        , sphere( Math::computeSphere( bounds ) ) {}
 
     u32 vao;
     u32 vbo;
     u32 ebo;
 
+    // Empty once the mesh has been packed
     std::vector<Vertex> verticies;
+    // Filled by pack(), the quantization box is derived from the bounds
+    std::vector<PackedVertex> packedVertices;
+    VertexQuantization quantization;
+    QuantizationError quantizationError;
     std::vector<u32> indices;
     std::vector<std::shared_ptr<Texture2D>> textures;
+
+    // Local space bounding volumes, computed once at import
+    AABB bounds;
+    BoundingSphere sphere;
+
+    // Converts the vertices into the packed format and releases the float ones
+    void pack() noexcept;
   };
 }    // namespace nile
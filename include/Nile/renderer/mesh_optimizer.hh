@@ -0,0 +1,68 @@
+/* ================================================================================
+$File: mesh_optimizer.hh
+$Date: $
+$Revision: $
+$Creator: Rostislav Orestis Stelmach
+$Notice: $
+================================================================================ */
+
+#pragma once
+
+#include "Nile/core/types.hh"
+#include "Nile/utils/vertex.hh"
+
+#include <vector>
+
+// @brief:
+// MeshOptimizer reorders the triangles and vertices of an indexed triangle list at
+// import time, the mesh stays the same, only the order changes:
+// - optimizeVertexCache() orders the triangles for the post-transform vertex cache
+//   ( Forsyth's linear-speed algorithm )
+// - optimizeOverdraw() splits the cache friendly order into clusters and draws the ones
+//   facing outwards first, so less of the hidden surface gets shaded
+// - optimizeVertexFetch() stores the vertices in the order they are first used
+// The analyze functions measure the result: ACMR ( vertex shader runs per triangle ),
+// ATVR ( vertex shader runs per vertex, 1 is the best ) and the overdraw estimated by
+// rasterizing the mesh in software from the six axis directions.
+// Usage: optimizeVertexCache(), optimizeOverdraw() and then optimizeVertexFetch().
+
+namespace nile {
+
+  struct MeshQuality {
+    f32 acmr = 0.0f;
+    f32 atvr = 0.0f;
+    // Shaded pixels per covered pixel
+    f32 overdraw = 0.0f;
+  };
+
+  namespace MeshOptimizer {
+
+    // FIFO cache the analysis simulates, a conservative size for current GPUs
+    constexpr u32 ANALYSIS_CACHE_SIZE = 16;
+    // Resolution of the views the overdraw is estimated with
+    constexpr u32 OVERDRAW_RESOLUTION = 256;
+
+    void optimizeVertexCache( std::vector<u32> &indices, usize vertexCount ) noexcept;
+
+    // Expects the indices to be optimized for the vertex cache already
+    void optimizeOverdraw( std::vector<u32> &indices,
+                           const std::vector<Vertex> &vertices ) noexcept;
+
+    // Unused vertices are removed
+    void optimizeVertexFetch( std::vector<Vertex> &vertices, std::vector<u32> &indices ) noexcept;
+
+    [[nodiscard]] MeshQuality analyzeVertexCache( const std::vector<u32> &indices,
+                                                  usize vertexCount,
+                                                  u32 cacheSize = ANALYSIS_CACHE_SIZE ) noexcept;
+
+    // Counter-clockwise triangles are front facing, back faces are culled
+    [[nodiscard]] f32 analyzeOverdraw( const std::vector<Vertex> &vertices,
+                                       const std::vector<u32> &indices ) noexcept;
+
+    // Both analyses at once
+    [[nodiscard]] MeshQuality analyze( const std::vector<Vertex> &vertices,
+                                       const std::vector<u32> &indices ) noexcept;
+
+  }    // namespace MeshOptimizer
+
+}    // namespace nile
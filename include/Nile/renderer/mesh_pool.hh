@@ -0,0 +1,93 @@
+/* ================================================================================
+$File: mesh_pool.hh
+$Date: $
+$Revision: $
+$Creator: Rostislav Orestis Stelmach
+$Notice: $
+================================================================================ */
+
+#pragma once
+
+#include "Nile/core/helper.hh"
+#include "Nile/core/types.hh"
+#include "Nile/utils/vertex.hh"
+
+#include <vector>
+
+// @brief:
+// MeshPool keeps the geometry of static meshes in one shared vertex buffer and one
+// shared index buffer, so every mesh can be drawn from the same vertex array with its
+// own first index and base vertex ( e.g. by glMultiDrawElementsIndirect ).
+// Meshes are only appended, the pool never frees them. When a buffer is full it is
+// replaced by a bigger one and the old content is copied on the GPU, the buffer ids
+// change, so the users compare them with the ones their vertex arrays point at.
+// All the meshes of a pool have the same vertex format, one pool per format.
+
+namespace nile {
+
+  // Place of a mesh inside the shared buffers
+  struct MeshRange {
+    u32 firstIndex = 0;
+    u32 indexCount = 0;
+    // Added to the indices, the first vertex of the mesh
+    i32 baseVertex = 0;
+    u32 vertexCount = 0;
+  };
+
+  struct MeshPoolStats {
+    u32 meshes = 0;
+    u32 vertices = 0;
+    u32 indices = 0;
+    // Times one of the buffers had to be reallocated
+    u32 grows = 0;
+  };
+
+  class MeshPool {
+  public:
+    // Initial capacity, so small scenes never reallocate
+    static constexpr u32 MIN_VERTICES = 64 * 1024;
+    static constexpr u32 MIN_INDICES = 3 * MIN_VERTICES;
+
+  private:
+    usize m_vertexSize;
+    u32 m_vertexBuffer = 0;
+    u32 m_indexBuffer = 0;
+    u32 m_vertexCapacity = 0;
+    u32 m_indexCapacity = 0;
+
+    MeshPoolStats m_stats;
+
+    static void grow( u32 &buffer, u32 &capacity, u32 required, usize elementSize,
+                      usize usedBytes ) noexcept;
+
+  public:
+    explicit MeshPool( usize vertexSize = sizeof( Vertex ) ) noexcept;
+    ~MeshPool() noexcept;
+
+    NILE_DISABLE_COPY( MeshPool )
+    NILE_DISABLE_MOVE( MeshPool )
+
+    // Uploads the mesh at the end of the buffers, needs an OpenGL context
+    [[nodiscard]] MeshRange add( const void *vertices, u32 vertexCount,
+                                 const std::vector<u32> &indices ) noexcept;
+
+    template <typename VertexType>
+    [[nodiscard]] MeshRange add( const std::vector<VertexType> &vertices,
+                                 const std::vector<u32> &indices ) noexcept {
+      return this->add( vertices.data(), static_cast<u32>( vertices.size() ), indices );
+    }
+
+    [[nodiscard]] u32 getVertexBuffer() const noexcept {
+      return m_vertexBuffer;
+    }
+
+    [[nodiscard]] u32 getIndexBuffer() const noexcept {
+      return m_indexBuffer;
+    }
+
+    [[nodiscard]] const MeshPoolStats &getStats() const noexcept {
+      return m_stats;
+    }
+  };
+
+}    // namespace nile
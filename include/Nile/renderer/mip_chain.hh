@@ -0,0 +1,82 @@
+/* ================================================================================
+$File: mip_chain.hh
+$Date: $
+$Revision: $
+$Creator: Rostislav Orestis Stelmach
+$Notice: $
+================================================================================ */
+
+#pragma once
+
+#include "Nile/core/types.hh"
+
+#include <vector>
+
+// @brief:
+// MipChain builds the full mip chain of an RGBA8 image on the CPU, down to 1x1, at load
+// time. Each level is filtered from the one above it, kept in floats so the rounding
+// doesn't add up down the chain:
+// - Colors are averaged in linear space ( srgb ), averaging the sRGB values darkens
+//   the mips. Normal maps and other data textures are filtered as they are.
+// - Colors are weighted by their alpha, transparent texels don't bleed into the edges of
+//   a sprite.
+// - KAISER is a Kaiser windowed sinc, sharper than the BOX 2x2 average.
+// - Textures that repeat ( wrap ) are filtered across their edges, others are clamped.
+// Filtering is separable, 4 channels at once with SSE, and the rows of the large levels
+// are split among worker threads.
+
+namespace nile {
+
+  enum class MipFilter : u8 { BOX = 0, KAISER };
+
+  struct MipChainOptions {
+    MipFilter filter = MipFilter::KAISER;
+    bool srgb = true;
+    bool wrap = true;
+    // Worker threads for the large levels, 0 picks the hardware concurrency
+    u32 threads = 0;
+  };
+
+  struct MipLevel {
+    u32 width = 0;
+    u32 height = 0;
+    // Byte offset of the level in the pixels of the chain
+    usize offset = 0;
+  };
+
+  class MipChain {
+  public:
+    static constexpr u32 CHANNELS = 4;
+    // Levels smaller than this are filtered on the calling thread
+    static constexpr u32 PARALLEL_TEXELS = 128 * 128;
+
+  private:
+    std::vector<u8> m_pixels;
+    std::vector<MipLevel> m_levels;
+
+  public:
+    // Levels of a full chain, e.g. 9 for 256x64
+    [[nodiscard]] static u32 levelCount( u32 width, u32 height ) noexcept;
+
+    // Copies the image into level 0 and builds the levels below it
+    void build( const u8 *rgba, u32 width, u32 height,
+                const MipChainOptions &options = {} ) noexcept;
+
+    [[nodiscard]] u32 getLevelCount() const noexcept {
+      return static_cast<u32>( m_levels.size() );
+    }
+
+    [[nodiscard]] const MipLevel &getLevel( u32 level ) const noexcept {
+      return m_levels[ level ];
+    }
+
+    [[nodiscard]] const u8 *getData( u32 level ) const noexcept {
+      return m_pixels.data() + m_levels[ level ].offset;
+    }
+
+    // Bytes of level 0, and of the levels below it
+    [[nodiscard]] usize getBaseBytes() const noexcept;
+    [[nodiscard]] usize getMipBytes() const noexcept;
+  };
+
+}    // namespace nile
@@ -0,0 +1,124 @@
+/* ================================================================================
+$File: null_renderer.hh
+$Date: $
+$Revision: $
+$Creator: Rostislav Orestis Stelmach
+$Notice: $
+================================================================================ */
+
+#pragma once
+
+#include "Nile/core/types.hh"
+#include "Nile/renderer/base_renderer.hh"
+#include <SDL2/SDL.h>
+
+#include <memory>
+
+// @brief:
+// NullRenderer runs the render systems without a context or a driver, so benchmarks
+// measure the CPU cost of our submission alone and CI can assert limits such as the
+// number of draws of a scene. It comes with null_gl.cc, which defines the OpenGL and
+// GLEW entry points the engine uses as functions that only count what they were asked
+// to do. Both live in the nile_null_gl object library, not in nile_static: a benchmark
+// or a test links those objects and every GL call of the process lands in NullGLStats.
+// The null GL reports OpenGL 4.3 with timer queries and multi draw indirect, so the
+// desktop paths are the ones measured. Buffers have no memory behind them and can't be
+// mapped, so StreamBuffer uploads with glBufferSubData and the streamed bytes are counted.
+
+namespace nile {
+
+  class Settings;
+
+  struct NullGLStats {
+    // Every GL call
+    u32 calls = 0;
+    // Draw calls, a multi draw counts once
+    u32 draws = 0;
+    // Draws the GPU would run, the commands of a multi draw count one by one
+    u32 drawCommands = 0;
+    // Capabilities, blend / depth / polygon state, viewport, program, vertex array and
+    // attribute setup, active texture unit and framebuffer bindings
+    u32 stateChanges = 0;
+    u32 uniformSets = 0;
+    u32 textureBinds = 0;
+    // Bindings of buffers to a target or to an indexed binding point
+    u32 bufferBinds = 0;
+    // Bytes sent to buffers by glBufferData / glBufferSubData / glBufferStorage, and
+    // copied between them with glCopyBufferSubData
+    u64 bufferBytes = 0;
+  };
+
+  namespace NullGL {
+
+    // GL is a global API, so are its counters. They grow until they are reset.
+    [[nodiscard]] const NullGLStats &getStats() noexcept;
+    void resetStats() noexcept;
+
+  }    // namespace NullGL
+
+  class NullRenderer : public BaseRenderer {
+  private:
+    std::shared_ptr<Settings> m_settings;
+
+    std::shared_ptr<GLStateCache> m_stateCache;
+    std::shared_ptr<RenderQueue> m_renderQueue;
+    std::shared_ptr<FrameUniforms> m_frameUniforms;
+    std::shared_ptr<StreamBuffer> m_streamBuffer;
+    std::shared_ptr<DebugDraw> m_debugDraw;
+    std::shared_ptr<GpuProfiler> m_gpuProfiler;
+
+    // Calls between the last submitFrame() and endFrame()
+    NullGLStats m_lastFrameStats;
+
+    void initRenderer() noexcept override;
+    void initWindow() noexcept override;
+
+  public:
+    explicit NullRenderer( std::shared_ptr<Settings> settings ) noexcept;
+    ~NullRenderer() noexcept;
+    void init() noexcept override;
+    // Resets the counters of the null GL
+    void submitFrame() noexcept override;
+    // Keeps the counters of the frame
+    void endFrame() noexcept override;
+    void destroy() noexcept override;
+
+    // There is neither a window nor a context
+    inline SDL_Window *getWindow() noexcept override {
+      return nullptr;
+    }
+
+    inline SDL_GLContext getContext() const noexcept override {
+      return nullptr;
+    }
+
+    inline std::shared_ptr<GLStateCache> getStateCache() const noexcept override {
+      return m_stateCache;
+    }
+
+    inline std::shared_ptr<RenderQueue> getRenderQueue() const noexcept override {
+      return m_renderQueue;
+    }
+
+    inline std::shared_ptr<FrameUniforms> getFrameUniforms() const noexcept override {
+      return m_frameUniforms;
+    }
+
+    inline std::shared_ptr<StreamBuffer> getStreamBuffer() const noexcept override {
+      return m_streamBuffer;
+    }
+
+    inline std::shared_ptr<DebugDraw> getDebugDraw() const noexcept override {
+      return m_debugDraw;
+    }
+
+    inline std::shared_ptr<GpuProfiler> getGpuProfiler() const noexcept override {
+      return m_gpuProfiler;
+    }
+
+    [[nodiscard]] inline const NullGLStats &getLastFrameStats() const noexcept {
+      return m_lastFrameStats;
+    }
+  };
+
+}    // namespace nile
@@ -25,6 +25,13 @@ namespace nile {
     // The main SDL window
     SDL_Window *m_window = nullptr;
     SDL_GLContext m_glContext;
+    // Shadow of the OpenGL state, invalidated at the beginning of every frame
+    std::shared_ptr<GLStateCache> m_stateCache;
+    std::shared_ptr<RenderQueue> m_renderQueue;
+    std::shared_ptr<FrameUniforms> m_frameUniforms;
+    std::shared_ptr<StreamBuffer> m_streamBuffer;
+    std::shared_ptr<DebugDraw> m_debugDraw;
+    std::shared_ptr<GpuProfiler> m_gpuProfiler;
 
     // The main bool flag that keeps the main loop runing
     bool m_isRunning = false;
@@ -51,6 +58,30 @@ namespace nile {
     inline SDL_GLContext getContext() const noexcept override {
       return m_glContext;
     }
+
+    inline std::shared_ptr<GLStateCache> getStateCache() const noexcept override {
+      return m_stateCache;
+    }
+
+    inline std::shared_ptr<RenderQueue> getRenderQueue() const noexcept override {
+      return m_renderQueue;
+    }
+
+    inline std::shared_ptr<FrameUniforms> getFrameUniforms() const noexcept override {
+      return m_frameUniforms;
+    }
+
+    inline std::shared_ptr<StreamBuffer> getStreamBuffer() const noexcept override {
+      return m_streamBuffer;
+    }
+
+    inline std::shared_ptr<DebugDraw> getDebugDraw() const noexcept override {
+      return m_debugDraw;
+    }
+
+    inline std::shared_ptr<GpuProfiler> getGpuProfiler() const noexcept override {
+      return m_gpuProfiler;
+    }
   };
 
 }    // namespace nile
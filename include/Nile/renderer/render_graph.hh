@@ -0,0 +1,217 @@
+/* ================================================================================
+$File: render_graph.hh
+$Date: $
+$Revision: $
+$Creator: Rostislav Orestis Stelmach
+$Notice: $
+================================================================================ */
+
+#pragma once
+
+#include "Nile/core/helper.hh"
+#include "Nile/core/types.hh"
+#include "Nile/renderer/render_target_pool.hh"
+
+#include <functional>
+#include <glm/glm.hpp>
+#include <vector>
+
+// @brief:
+// RenderGraph describes the frame as passes that declare the render targets they read
+// and the one they write, instead of binding and clearing framebuffers by hand.
+// compile() culls the passes nothing on screen depends on ( the roots are the passes
+// that write BACKBUFFER or have side effects ), finds when each transient target is
+// first and last used and lets targets of the same description share one framebuffer
+// when their lifetimes don't overlap. execute() takes the framebuffers from a
+// RenderTargetPool, binds a framebuffer and sets the viewport only when they change,
+// clears a target once before the first pass that writes it and binds the targets a
+// pass reads to the texture units 0, 1, ... in the order they were declared.
+// A shadow or a post process pass is one more addPass() with its reads and its write.
+// Passes run in the order they were added, one target per pass, no MRT.
+// The graph is compiled again when a pass is added or a target changes its size.
+
+namespace nile {
+
+  class GLStateCache;
+  class GpuProfiler;
+  class RenderGraph;
+
+  // Handle of a target in the graph
+  using RenderResource = u32;
+
+  struct RenderClear {
+    bool color = false;
+    bool depth = false;
+    glm::vec4 colorValue {0.0f, 0.0f, 0.0f, 1.0f};
+    f32 depthValue = 1.0f;
+  };
+
+  class RenderPassContext {
+  private:
+    RenderGraph &m_graph;
+    GLStateCache &m_state;
+    u32 m_width;
+    u32 m_height;
+
+  public:
+    RenderPassContext( RenderGraph &graph, GLStateCache &state, u32 width, u32 height ) noexcept
+        : m_graph( graph ), m_state( state ), m_width( width ), m_height( height ) {}
+
+    NILE_DISABLE_COPY( RenderPassContext )
+    NILE_DISABLE_MOVE( RenderPassContext )
+
+    [[nodiscard]] GLStateCache &getState() noexcept {
+      return m_state;
+    }
+
+    // Size of the target the pass writes, the viewport is already set to it
+    [[nodiscard]] u32 getWidth() const noexcept {
+      return m_width;
+    }
+
+    [[nodiscard]] u32 getHeight() const noexcept {
+      return m_height;
+    }
+
+    // Color texture of a target, the depth texture of depth only targets
+    [[nodiscard]] u32 getTexture( RenderResource resource ) const noexcept;
+
+    // Depth texture of a target, 0 when its depth is a renderbuffer
+    [[nodiscard]] u32 getDepthTexture( RenderResource resource ) const noexcept;
+
+    // Draws a triangle that covers the target, the vertex shader builds it from
+    // gl_VertexID ( see fullscreen_vertex.glsl )
+    void drawFullscreen() noexcept;
+  };
+
+  class RenderPassBuilder {
+  private:
+    RenderGraph &m_graph;
+    u32 m_pass;
+
+  public:
+    RenderPassBuilder( RenderGraph &graph, u32 pass ) noexcept : m_graph( graph ), m_pass( pass ) {}
+
+    // Bound to the next free texture unit while the pass runs
+    RenderPassBuilder &read( RenderResource resource ) noexcept;
+
+    // The target the pass draws into, a second call replaces it
+    RenderPassBuilder &write( RenderResource resource ) noexcept;
+
+    // The pass is never culled, e.g. it reads pixels back or updates the game
+    RenderPassBuilder &setSideEffects() noexcept;
+  };
+
+  struct RenderGraphStats {
+    u32 passes = 0;
+    u32 culledPasses = 0;
+    // Transient targets used by the passes that run
+    u32 resources = 0;
+    // Framebuffers they were aliased onto
+    u32 targets = 0;
+    usize targetBytes = 0;
+    // Memory saved by aliasing
+    usize aliasedBytes = 0;
+    // Per frame
+    u32 framebufferBinds = 0;
+    u32 clears = 0;
+  };
+
+  class RenderGraph {
+  public:
+    using ExecuteFunction = std::function<void( RenderPassContext & )>;
+
+    // The default framebuffer, imported, it is never pooled or aliased
+    static constexpr RenderResource BACKBUFFER = 0;
+
+    // Framebuffers alive at the same time, the pool keeps twice as many so the targets
+    // of the previous size survive a resolution change
+    static constexpr u32 MAX_TARGETS = 8;
+
+  private:
+    friend class RenderPassBuilder;
+    friend class RenderPassContext;
+
+    static constexpr u32 NONE = ~0u;
+
+    struct Resource {
+      // Must outlive the graph, like the names of the GpuProfiler
+      const char *name;
+      RenderTargetDesc desc;
+      RenderClear clear;
+      // Filled by compile()
+      u32 firstPass = NONE;
+      u32 lastPass = NONE;
+      u32 instance = 0;
+      // Filled by execute()
+      const RenderTarget *target = nullptr;
+    };
+
+    struct Pass {
+      const char *name;
+      ExecuteFunction execute;
+      std::vector<RenderResource> reads;
+      RenderResource output = NONE;
+      bool sideEffects = false;
+      // Filled by compile()
+      bool culled = true;
+    };
+
+    std::vector<Resource> m_resources;
+    std::vector<Pass> m_passes;
+    RenderTargetPool m_pool;
+
+    // Core profiles draw nothing without a vertex array, even an empty one
+    u32 m_emptyVertexArray = 0;
+    bool m_dirty = true;
+    bool m_compiled = false;
+
+    RenderGraphStats m_stats;
+
+    [[nodiscard]] bool isTarget( RenderResource resource ) const noexcept {
+      return resource != BACKBUFFER && resource < m_resources.size();
+    }
+
+  public:
+    RenderGraph() noexcept;
+    ~RenderGraph() noexcept;
+
+    NILE_DISABLE_COPY( RenderGraph )
+    NILE_DISABLE_MOVE( RenderGraph )
+
+    RenderResource createTarget( const char *name, const RenderTargetDesc &desc,
+                                 const RenderClear &clear = {} ) noexcept;
+
+    // Works for BACKBUFFER too
+    void setClear( RenderResource resource, const RenderClear &clear ) noexcept;
+
+    void setTargetSize( RenderResource resource, u32 width, u32 height ) noexcept;
+    void setBackbufferSize( u32 width, u32 height ) noexcept;
+
+    // name must outlive the graph
+    RenderPassBuilder addPass( const char *name, ExecuteFunction execute ) noexcept;
+
+    // Removes the passes and the targets, the pool keeps its framebuffers
+    void clear() noexcept;
+
+    // Called by execute() when something changed, false when the graph can't run
+    bool compile() noexcept;
+
+    void execute( GLStateCache &state, GpuProfiler *profiler = nullptr ) noexcept;
+
+    // False for unknown passes, valid after compile()
+    [[nodiscard]] bool isCulled( const char *name ) const noexcept;
+
+    // Framebuffer of a target in the last frame, nullptr if it wasn't used
+    [[nodiscard]] const RenderTarget *getTarget( RenderResource resource ) const noexcept;
+
+    [[nodiscard]] const RenderTargetPool &getPool() const noexcept {
+      return m_pool;
+    }
+
+    [[nodiscard]] const RenderGraphStats &getStats() const noexcept {
+      return m_stats;
+    }
+  };
+
+}    // namespace nile
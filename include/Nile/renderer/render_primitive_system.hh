@@ -5,19 +5,36 @@
 
 #include <memory>
 
+// @brief:
+// RenderPrimitiveSystem adds the line of every Primitive entity to the DebugDraw and
+// draws everything the DebugDraw collected during the frame. The lines go through
+// DebugDraw::addLine(), which release builds keep, so Primitive entities don't depend on
+// NILE_DEBUG_DRAW. Lines follow their transform, nothing is baked into GPU buffers.
+
 namespace nile {
 
   class Coordinator;
+  class DebugDraw;
+  class GLStateCache;
+  class RenderQueue;
   class ShaderSet;
+  class StreamBuffer;
 
   class RenderPrimitiveSystem : public System {
   private:
-    void init_rendering_data() noexcept;
     std::shared_ptr<Coordinator> ecs_coordinator_;
+    std::shared_ptr<GLStateCache> gl_state_;
+    std::shared_ptr<RenderQueue> render_queue_;
+    std::shared_ptr<StreamBuffer> stream_buffer_;
+    std::shared_ptr<DebugDraw> debug_draw_;
     std::shared_ptr<ShaderSet> primitive_shader_;
 
   public:
     RenderPrimitiveSystem( const std::shared_ptr<Coordinator> &coordinator,
+                           const std::shared_ptr<GLStateCache> &state,
+                           const std::shared_ptr<RenderQueue> &queue,
+                           const std::shared_ptr<StreamBuffer> &stream,
+                           const std::shared_ptr<DebugDraw> &debugDraw,
                            const std::shared_ptr<ShaderSet> &shader ) noexcept;
     void create() noexcept;
     void destroy() noexcept;
@@ -0,0 +1,170 @@
+/* ================================================================================
+$File: render_queue.hh
+$Date: $
+$Revision: $
+$Creator: Rostislav Orestis Stelmach
+$Notice: $
+================================================================================ */
+
+#pragma once
+
+#include "Nile/core/helper.hh"
+#include "Nile/core/types.hh"
+#include "Nile/math/frustum.hh"
+
+#include <glm/glm.hpp>
+#include <vector>
+
+// @brief:
+// RenderQueue collects the draw packets of all the render systems during the frame.
+// Every packet carries a 64-bit sort key, the queue radix sorts the keys and
+// executes the packets in that order, so the draw order doesn't depend on the
+// order of the entities and state changes are grouped together.
+//
+// Layout of the key, from the most significant bit:
+//   opaque:      layer (8) | pass (2) | program (14) | material (16) | depth (24)
+//   transparent: layer (8) | pass (2) | inverted depth (24) | program (14) | material (16)
+// Opaque packets are sorted by state and then front to back, transparent packets
+// back to front. Program and material are only used for ordering and may be
+// truncated, the packet itself keeps the real state.
+
+namespace nile {
+
+  class GLStateCache;
+  class GpuProfiler;
+  struct DrawPacket;
+
+  enum class RenderLayer : u8 { WORLD = 0, OVERLAY = 1 };
+
+  enum class RenderPass : u8 { OPAQUE = 0, TRANSPARENT = 1 };
+
+  enum class PrimitiveType : u8 { TRIANGLES, LINES };
+
+  // Builds the sort key of a packet, depth is the distance along the view direction
+  [[nodiscard]] u64 makeRenderKey( RenderLayer layer, RenderPass pass, u32 program, u32 material,
+                                   f32 depth ) noexcept;
+
+  [[nodiscard]] inline RenderLayer renderKeyLayer( u64 key ) noexcept {
+    return static_cast<RenderLayer>( key >> 56 );
+  }
+
+  [[nodiscard]] inline RenderPass renderKeyPass( u64 key ) noexcept {
+    return static_cast<RenderPass>( ( key >> 54 ) & 0x3 );
+  }
+
+  struct SortItem {
+    u64 key;
+    u32 index;
+  };
+
+  // Stable LSD radix sort by key, 8 bits per pass. Passes where all the keys share
+  // the same byte are skipped. scratch is resized as needed and can be reused.
+  void radixSort( std::vector<SortItem> &items, std::vector<SortItem> &scratch ) noexcept;
+
+  // Sets up and draws whatever the generic packet can't express ( extra uniforms,
+  // more textures, several draw calls ). Program, blend, vertex array and texture
+  // of the packet are already bound when it is called.
+  using DrawCallback = void ( * )( const DrawPacket &packet, GLStateCache &state );
+
+  struct DrawPacket {
+    u64 key = 0;
+    u32 program = 0;
+    u32 vertexArray = 0;
+    // Bound to the texture unit 0 when not zero
+    u32 texture = 0;
+    // First index ( or vertex for non indexed packets ) and the number of them
+    u32 first = 0;
+    u32 count = 0;
+    // Added to the indices of indexed packets, e.g. the vertex offset of a StreamBuffer
+    // allocation
+    i32 baseVertex = 0;
+    u32 instances = 1;
+    PrimitiveType primitive = PrimitiveType::TRIANGLES;
+    bool indexed = true;
+    bool cullFace = false;
+
+    // Replaces the generic draw when set
+    DrawCallback callback = nullptr;
+    void *userData = nullptr;
+    u32 userIndex = 0;
+  };
+
+  struct RenderQueueStats {
+    u32 packets = 0;
+    u32 opaquePackets = 0;
+    u32 transparentPackets = 0;
+    u32 callbacks = 0;
+  };
+
+  class RenderQueue {
+  private:
+    std::vector<DrawPacket> m_packets;
+    std::vector<SortItem> m_order;
+    std::vector<SortItem> m_scratch;
+
+    glm::vec3 m_viewPosition {0.0f};
+    glm::vec3 m_viewDirection {0.0f, 0.0f, -1.0f};
+    Frustum m_frustum;
+
+    RenderQueueStats m_stats;
+
+  public:
+    RenderQueue() noexcept = default;
+
+    NILE_DISABLE_COPY( RenderQueue )
+    NILE_DISABLE_MOVE( RenderQueue )
+
+    // Camera used to compute the depth of the packets, set by the CameraSystem
+    void setView( const glm::vec3 &position, const glm::vec3 &direction ) noexcept;
+
+    [[nodiscard]] const glm::vec3 &getViewPosition() const noexcept {
+      return m_viewPosition;
+    }
+
+    [[nodiscard]] const glm::vec3 &getViewDirection() const noexcept {
+      return m_viewDirection;
+    }
+
+    // Frustum the render systems cull against, set by the CameraSystem
+    void setFrustum( const Frustum &frustum ) noexcept {
+      m_frustum = frustum;
+    }
+
+    [[nodiscard]] const Frustum &getFrustum() const noexcept {
+      return m_frustum;
+    }
+
+    // Distance of the point along the view direction, points behind the camera are at 0
+    [[nodiscard]] f32 viewDepth( const glm::vec3 &position ) const noexcept {
+      return glm::max( glm::dot( position - m_viewPosition, m_viewDirection ), 0.0f );
+    }
+
+    void submit( const DrawPacket &packet ) noexcept {
+      m_packets.push_back( packet );
+    }
+
+    // Sorts the packets submitted so far, does not issue any OpenGL calls
+    void sort() noexcept;
+
+    // Sorts and draws all the packets, then clears the queue. With a profiler every
+    // layer and pass is measured as a scope of its own.
+    void execute( GLStateCache &state, GpuProfiler *profiler = nullptr ) noexcept;
+
+    void clear() noexcept;
+
+    [[nodiscard]] const std::vector<DrawPacket> &getPackets() const noexcept {
+      return m_packets;
+    }
+
+    // Indices into getPackets() in draw order, valid after sort()
+    [[nodiscard]] const std::vector<SortItem> &getOrder() const noexcept {
+      return m_order;
+    }
+
+    // Counters of the last executed frame
+    [[nodiscard]] const RenderQueueStats &getStats() const noexcept {
+      return m_stats;
+    }
+  };
+
+}    // namespace nile
@@ -0,0 +1,110 @@
+/* ================================================================================
+$File: render_target_pool.hh
+$Date: $
+$Revision: $
+$Creator: Rostislav Orestis Stelmach
+$Notice: $
+================================================================================ */
+
+#pragma once
+
+#include "Nile/core/helper.hh"
+#include "Nile/core/types.hh"
+
+#include <vector>
+
+// @brief:
+// RenderTargetPool owns the framebuffers the scene is rendered into: a color texture
+// and a depth / stencil attachment each, described by a RenderTargetDesc ( an RGB
+// texture and a renderbuffer by default ). acquire() returns the target of the asked
+// description, and creates it if there is none yet. Targets alive at the same time with
+// the same description are told apart by their instance, see RenderGraph.
+// The pool keeps the capacity most recently used targets, so a render scale going back
+// and forth between two steps doesn't reallocate every frame. The least recently used
+// target is deleted to make room, clear() deletes them all, e.g. when the window is
+// resized.
+
+namespace nile {
+
+  // NONE makes a depth only target, e.g. a shadow map
+  enum class RenderTargetFormat : u8 { NONE = 0, RGB8, RGBA8, RGBA16F };
+
+  // A texture when the depth is sampled later, a renderbuffer otherwise
+  enum class RenderTargetDepth : u8 { NONE = 0, RENDERBUFFER, TEXTURE };
+
+  struct RenderTargetDesc {
+    u32 width = 0;
+    u32 height = 0;
+    RenderTargetFormat format = RenderTargetFormat::RGB8;
+    RenderTargetDepth depth = RenderTargetDepth::RENDERBUFFER;
+
+    [[nodiscard]] bool operator==( const RenderTargetDesc &other ) const noexcept {
+      return width == other.width && height == other.height && format == other.format &&
+             depth == other.depth;
+    }
+
+    // GPU memory of a target of this description
+    [[nodiscard]] usize getBytes() const noexcept;
+  };
+
+  struct RenderTarget {
+    u32 framebuffer = 0;
+    // Color texture, 0 for depth only targets
+    u32 color = 0;
+    // Renderbuffer or texture, as the description asks
+    u32 depthStencil = 0;
+    u32 width = 0;
+    u32 height = 0;
+    RenderTargetFormat format = RenderTargetFormat::RGB8;
+    RenderTargetDepth depth = RenderTargetDepth::RENDERBUFFER;
+    u32 instance = 0;
+    // acquire() call that last returned the target
+    u64 lastUsed = 0;
+  };
+
+  struct RenderTargetPoolStats {
+    u32 allocations = 0;
+    u32 releases = 0;
+    // Targets alive in the pool
+    u32 targets = 0;
+  };
+
+  class RenderTargetPool {
+  public:
+    static constexpr u32 CAPACITY = 4;
+
+  private:
+    std::vector<RenderTarget> m_targets;
+    u32 m_capacity;
+    u64 m_acquisitions = 0;
+
+    RenderTargetPoolStats m_stats;
+
+    void create( RenderTarget &target, const RenderTargetDesc &desc, u32 instance ) noexcept;
+    void release( RenderTarget &target ) noexcept;
+
+  public:
+    explicit RenderTargetPool( u32 capacity = CAPACITY ) noexcept;
+    ~RenderTargetPool() noexcept;
+
+    NILE_DISABLE_COPY( RenderTargetPool )
+    NILE_DISABLE_MOVE( RenderTargetPool )
+
+    // The reference stays valid until the target is evicted by another one or cleared
+    const RenderTarget &acquire( const RenderTargetDesc &desc, u32 instance = 0 ) noexcept;
+
+    // An RGB target with a depth / stencil renderbuffer
+    const RenderTarget &acquire( u32 width, u32 height ) noexcept;
+
+    void clear() noexcept;
+
+    [[nodiscard]] u32 getCapacity() const noexcept {
+      return m_capacity;
+    }
+
+    [[nodiscard]] const RenderTargetPoolStats &getStats() const noexcept {
+      return m_stats;
+    }
+  };
+
+}    // namespace nile
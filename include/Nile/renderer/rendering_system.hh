@@ -10,25 +10,206 @@ $Notice: $
 
 #include "Nile/core/types.hh"
 #include "Nile/ecs/ecs_system.hh"
+#include "Nile/renderer/frustum_culler.hh"
+#include "Nile/renderer/mesh_pool.hh"
+#include "Nile/renderer/uniform_handle.hh"
+#include "Nile/renderer/vertex_format.hh"
 
+#include <glm/glm.hpp>
 #include <memory>
+#include <unordered_map>
+#include <vector>
+
+// @brief:
+// RenderingSystem draws meshes with automatic instancing. Entities that share
+// the same geometry, material ( shader and textures ) and blend flag form one
+// instancing group.
+// Identical geometry ( compared by content ) is uploaded only once, into the shared
+// buffers of the MeshPool, so every mesh is drawn from a single vertex array.
+// Packed meshes ( see vertex_format.hh ) have a pool and a vertex array of their own,
+// their dequantization is folded into the model matrix of the instances.
+// The instances of all the groups live in one instance buffer, every group owns a
+// range of it and uploads the range only when its instances changed.
+// Opaque groups that share a material are drawn together, one indirect command per
+// group, with a single glMultiDrawElementsIndirect ( a loop of base instance draws
+// without ARB_multi_draw_indirect ). The commands are written into the StreamBuffer.
+// Blended groups are drawn one by one, ordered by the average depth of their instances.
+// Entities whose world bounds ( see TransformSystem ) are outside of the camera frustum
+// are skipped before they are grouped.
+// Shaders used by this system read the model matrix from the vertex attributes
+// 3-6 and the color of the renderable from the attribute 7, instead of uniforms. The
+// base instance of the command selects the range of the group.
 
 namespace nile {
 
   class Coordinator;
+  class GLStateCache;
+  class RenderQueue;
   class ShaderSet;
+  class StreamBuffer;
+  class Texture2D;
+  struct DrawPacket;
+  struct MeshComponent;
+  struct Renderable;
+  struct Transform;
+
+  // Per instance data, streamed into the instance buffer of the group
+  struct MeshInstance {
+    glm::mat4 model;
+    glm::vec4 color;
+  };
+
+  // Layout of GL_DRAW_INDIRECT_BUFFER commands for glMultiDrawElementsIndirect
+  struct DrawElementsIndirectCommand {
+    u32 count;
+    u32 instanceCount;
+    u32 firstIndex;
+    i32 baseVertex;
+    u32 baseInstance;
+  };
+
+  struct RenderingStats {
+    u32 groups = 0;
+    u32 instances = 0;
+    // Indirect commands, one per visible group
+    u32 commands = 0;
+    // Calls that went to the driver, one per material with multi draw indirect
+    u32 drawCalls = 0;
+    // Groups whose instances were reused from the previous frame
+    u32 residentGroups = 0;
+    usize uploadedBytes = 0;
+  };
 
   class RenderingSystem : public System {
   private:
+    struct Geometry {
+      u64 hash;
+      VertexFormat format;
+      MeshRange range;
+      // Applied to the model matrix of the instances of packed meshes
+      glm::mat4 dequantize;
+    };
+
+    struct Material {
+      ShaderSet *shader;
+      std::vector<Texture2D *> textures;
+      // material.* sampler of every texture, resolved once
+      std::vector<UniformHandle> samplers;
+    };
+
+    struct InstanceGroup {
+      u32 geometry;
+      u32 material;
+      bool blend;
+
+      // Range of the instance buffer owned by the group, in instances
+      u32 first = 0;
+      u32 capacity = 0;
+
+      // Instances of the current frame, compared against the previous one
+      // to find out if the group needs to be uploaded again
+      std::vector<MeshInstance> instances;
+      u32 count = 0;
+      bool dirty = true;
+      // Sum of the view depth of the instances of the current frame
+      f32 depth = 0.0f;
+      // Batch the group is drawn with this frame
+      u32 batch = 0;
+    };
+
+    // Commands drawn by one packet, all of them use the same material
+    struct Batch {
+      u32 material;
+      VertexFormat format;
+      u32 firstCommand;
+      u32 commandCount;
+      bool blend;
+      f32 depth;
+      u32 instances;
+    };
+
     std::shared_ptr<Coordinator> ecs_coordinator_;
+    std::shared_ptr<GLStateCache> gl_state_;
+    std::shared_ptr<RenderQueue> render_queue_;
+    std::shared_ptr<StreamBuffer> stream_buffer_;
     std::shared_ptr<ShaderSet> shader_;
-    void init_rendering_data() noexcept;
+
+    // One vertex array per vertex format. The buffers it points at are remembered,
+    // so it is updated when the MeshPool or the instance buffer changes.
+    struct VertexArray {
+      u32 vao = 0;
+      u32 vertexBuffer = 0;
+      u32 indexBuffer = 0;
+      u32 instanceBuffer = 0;
+    };
+
+    MeshPool mesh_pools_[ VERTEX_FORMAT_COUNT ] = {MeshPool {sizeof( Vertex )},
+                                                   MeshPool {sizeof( PackedVertex )}};
+    VertexArray vertex_arrays_[ VERTEX_FORMAT_COUNT ];
+    std::vector<Geometry> geometries_;
+    std::unordered_multimap<u64, u32> geometry_by_hash_;
+
+    std::vector<Material> materials_;
+    std::unordered_multimap<u64, u32> material_by_hash_;
+
+    std::vector<InstanceGroup> groups_;
+    std::unordered_multimap<u64, u32> group_by_hash_;
+
+    std::vector<Batch> batches_;
+    // Batch of every material and vertex format this frame, opaque groups only
+    std::vector<u32> batch_by_material_;
+    std::vector<DrawElementsIndirectCommand> commands_;
+
+    u32 instance_buffer_ = 0;
+    // Capacity of instance_buffer_ in instances
+    u32 instance_capacity_ = 0;
+
+    // Buffer and offset of the indirect commands of this frame
+    u32 indirect_buffer_ = 0;
+    usize indirect_offset_ = 0;
+    bool multi_draw_indirect_ = false;
+
+    RenderingStats stats_;
+    FrustumCuller culler_;
+
+    static bool material_matches( const Material &material, const ShaderSet *shader,
+                                  const MeshComponent &mesh ) noexcept;
+
+    void register_geometry( MeshComponent &mesh ) noexcept;
+    u32 find_or_create_material( const MeshComponent &mesh, ShaderSet *shader ) noexcept;
+    u32 find_or_create_group( const MeshComponent &mesh, ShaderSet *shader, bool blend ) noexcept;
+    void layout_instances() noexcept;
+    void upload_instances( InstanceGroup &group ) noexcept;
+    void build_batches() noexcept;
+    void update_vertex_array( VertexFormat format ) noexcept;
+
+    // Render queue callback, binds the textures of the batch and draws its commands
+    static void draw_batch( const DrawPacket &packet, GLStateCache &state ) noexcept;
 
   public:
     RenderingSystem( const std::shared_ptr<Coordinator> &coordinator,
+                     const std::shared_ptr<GLStateCache> &state,
+                     const std::shared_ptr<RenderQueue> &queue,
+                     const std::shared_ptr<StreamBuffer> &stream,
                      const std::shared_ptr<ShaderSet> &shader ) noexcept;
+    ~RenderingSystem() noexcept;
+
     void create() noexcept;
     void update( float dt ) noexcept;
     void render( float dt ) noexcept;
+
+    // Counters of the last rendered frame
+    [[nodiscard]] const RenderingStats &getStats() const noexcept {
+      return stats_;
+    }
+
+    [[nodiscard]] const CullingStats &getCullingStats() const noexcept {
+      return culler_.getStats();
+    }
+
+    [[nodiscard]] const MeshPoolStats &
+    getMeshPoolStats( VertexFormat format = VertexFormat::FLOAT ) const noexcept {
+      return mesh_pools_[ static_cast<u32>( format ) ].getStats();
+    }
   };
 }    // namespace nile
@@ -0,0 +1,76 @@
+/* ================================================================================
+$File: resolution_scaler.hh
+$Date: $
+$Revision: $
+$Creator: Rostislav Orestis Stelmach
+$Notice: $
+================================================================================ */
+
+#pragma once
+
+#include "Nile/core/types.hh"
+
+// @brief:
+// ResolutionScaler picks the render scale of the scene framebuffer from the frame time,
+// to keep the frame within a budget. The cost of the scene is roughly proportional to
+// its pixel count ( scale squared ), so when the smoothed frame time is over budget the
+// scale drops at once to the one expected to fit. It only grows back one STEP at a time,
+// after GROW_FRAMES frames well under budget, so it doesn't oscillate.
+// Scales are multiples of STEP, so the render targets come in a few sizes that a
+// RenderTargetPool can keep around. After a change the next SETTLE_FRAMES samples are
+// ignored, the GPU timings of the old scale are still coming in.
+// A budget of 0 disables it, the scale stays at 1.
+
+namespace nile {
+
+  struct ResolutionScalerStats {
+    // Smoothed frame time in milliseconds
+    f32 frameTime = 0.0f;
+    u32 decreases = 0;
+    u32 increases = 0;
+  };
+
+  class ResolutionScaler {
+  public:
+    static constexpr f32 STEP = 0.05f;
+    // Weight of a new sample in the smoothed frame time
+    static constexpr f32 SMOOTHING = 0.1f;
+    // The scale grows only when the frame takes less than this fraction of the budget
+    static constexpr f32 HEADROOM = 0.8f;
+    static constexpr u32 GROW_FRAMES = 30;
+    static constexpr u32 SETTLE_FRAMES = 8;
+
+  private:
+    f32 m_budget;
+    f32 m_minScale;
+    f32 m_scale = 1.0f;
+
+    f32 m_frameTime = 0.0f;
+    u32 m_framesUnderBudget = 0;
+    u32 m_settleFrames = 0;
+
+    ResolutionScalerStats m_stats;
+
+    void setScale( f32 scale ) noexcept;
+
+  public:
+    explicit ResolutionScaler( f32 budgetMilliseconds = 0.0f, f32 minScale = 0.5f ) noexcept;
+
+    // Feeds the time of a frame in milliseconds, samples <= 0 ( e.g. no GPU timings yet )
+    // are ignored. Returns the scale of the next frame.
+    f32 update( f32 frameTime ) noexcept;
+
+    [[nodiscard]] f32 getScale() const noexcept {
+      return m_scale;
+    }
+
+    [[nodiscard]] f32 getBudget() const noexcept {
+      return m_budget;
+    }
+
+    [[nodiscard]] const ResolutionScalerStats &getStats() const noexcept {
+      return m_stats;
+    }
+  };
+
+}    // namespace nile
@@ -10,8 +10,12 @@ $Notice: $
 
 #include "Nile/asset/asset.hh"
 #include "Nile/log/log.hh"
+#include "Nile/renderer/uniform_handle.hh"
 
 #include <glm/glm.hpp>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
 
 #if defined( TOOLS_ENABLED )
 #include <chrono>
@@ -22,6 +26,11 @@ $Notice: $
 // coposed at least of 2 shaders ( vertex and fragment ), geometry shader is
 // optional, thous the name ShaderSet.
 // Keeps track of ProgramID, also we set Uniform Variable though this object
+//
+// Locations of the active uniforms are read once after linking, so setting a
+// uniform by name is a hash lookup instead of a glGetUniformLocation call.
+// Systems that set the same uniforms every frame should fetch a UniformHandle
+// once ( in create() ) and use the handle overloads of the setters.
 
 namespace nile {
 
@@ -59,7 +68,24 @@ namespace nile {
     std::string m_fShaderPath;
     std::string m_gShaderPath;
 
+    // Active uniforms of the linked program. The keys point into m_uniformNames,
+    // so looking up a const char * does not allocate.
+    std::string m_uniformNames;
+    std::unordered_map<std::string_view, i32> m_uniformLocations;
+
+    // Uniforms requested through getUniformHandle, resolved again on every reload
+    struct UniformSlot {
+      std::string name;
+      i32 location;
+    };
+    std::vector<UniformSlot> m_uniformSlots;
+
     void setProgramId( u32 id ) noexcept;
+    void introspectUniforms() noexcept;
+
+    i32 getLocation( UniformHandle handle ) const noexcept {
+      return handle.index < m_uniformSlots.size() ? m_uniformSlots[ handle.index ].location : -1;
+    }
 
   public:
     explicit ShaderSet( u32 id, const std::string &vShaderPath, const std::string &fShaderPath,
@@ -74,6 +100,13 @@ namespace nile {
       return *m_programId;
     }
 
+    // Location of an active uniform, or -1 when the program doesn't use it
+    i32 getUniformLocation( const char *name ) const noexcept;
+
+    // Returns the same handle for the same name. Unknown names still get a valid handle,
+    // setting it is a no-op until a reloaded program starts using the uniform.
+    UniformHandle getUniformHandle( const char *name ) noexcept;
+
 #ifdef TOOLS_ENABLED
 
     void setFileSize( const FileSize &fileSizes ) noexcept {
@@ -106,6 +139,17 @@ namespace nile {
     void SetVector4f( const char *name, const glm::vec4 &value, bool useShader = false ) noexcept;
     void SetMatrix4( const char *name, const glm::mat4 &matrix, bool useShader = false ) noexcept;
 
+    void SetFloat( UniformHandle handle, f32 value, bool useShader = false ) noexcept;
+    void SetInteger( UniformHandle handle, i32 value, bool useShader = false ) noexcept;
+    void SetVector2f( UniformHandle handle, const glm::vec2 &value,
+                      bool useShader = false ) noexcept;
+    void SetVector3f( UniformHandle handle, const glm::vec3 &value,
+                      bool useShader = false ) noexcept;
+    void SetVector4f( UniformHandle handle, const glm::vec4 &value,
+                      bool useShader = false ) noexcept;
+    void SetMatrix4( UniformHandle handle, const glm::mat4 &matrix,
+                     bool useShader = false ) noexcept;
+
     std::string getVshaderPath() const noexcept;
     std::string getFShaderPath() const noexcept;
     std::string getGShaderPath() const noexcept;
@@ -0,0 +1,171 @@
+/* ================================================================================
+$File: sprite_batch.hh
+$Date: $
+$Revision: $
+$Creator: Rostislav Orestis Stelmach
+$Notice: $
+================================================================================ */
+
+#pragma once
+
+#include "Nile/core/helper.hh"
+#include "Nile/core/types.hh"
+#include "Nile/renderer/frustum_culler.hh"
+#include "Nile/renderer/render_queue.hh"
+
+#include <glm/glm.hpp>
+#include <unordered_map>
+#include <vector>
+
+// @brief:
+// SpriteBatch collects sprites during the frame, transforms their quads on the CPU
+// and writes them into one allocation of the engine StreamBuffer. Sprites are ordered by a render
+// queue sort key: opaque sprites by ( shader, texture ) and front to back, blended
+// sprites back to front. Runs of sprites that share ( blend, shader, texture ) in
+// that order become one batch, submitted to the RenderQueue as one packet.
+// Sprites outside of the frustum are dropped in end(), before they are sorted.
+// Sorting is done in end() and does not touch OpenGL, so the draw call counters
+// are available without a context as well.
+
+namespace nile {
+
+  class GLStateCache;
+  class ShaderSet;
+  class StreamBuffer;
+  class Texture2D;
+  struct Transform;
+
+  // Quad vertex written by the batcher, matches the layout of the model shader
+  // ( 0 - position, 1 - normal, 2 - uv, 7 - color ). The model matrix attributes
+  // ( 3 - 6 ) are fed with an identity matrix, since the quads are pre-transformed.
+  struct SpriteVertex {
+    glm::vec3 position;
+    glm::vec3 normal;
+    glm::vec2 uv;
+    // RGBA8, normalized
+    u32 color;
+  };
+
+  struct SpriteBatchStats {
+    u32 sprites = 0;
+    // Submitted sprites that were outside of the frustum
+    u32 culled = 0;
+    u32 batches = 0;
+    u32 drawCalls = 0;
+    usize uploadedBytes = 0;
+  };
+
+  class SpriteBatch {
+  private:
+    struct Key {
+      ShaderSet *shader;
+      Texture2D *texture;
+      bool blend;
+
+      bool operator==( const Key &other ) const noexcept {
+        return shader == other.shader && texture == other.texture && blend == other.blend;
+      }
+    };
+
+    struct KeyHash {
+      usize operator()( const Key &key ) const noexcept;
+    };
+
+    struct Sprite {
+      glm::vec3 origin;
+      glm::vec3 axisX;
+      glm::vec3 axisY;
+      glm::vec3 normal;
+      // xy - uv of the ( 0, 0 ) corner, zw - of the ( 1, 1 ) corner
+      glm::vec4 uv;
+      f32 depth;
+      u32 color;
+      u32 key;
+    };
+
+    struct Batch {
+      Key key;
+      // Render queue key of the first sprite of the batch
+      u64 sortKey;
+      u32 firstQuad;
+      u32 quadCount;
+    };
+
+    // Sprites submitted during this frame, in submission order
+    std::vector<Sprite> m_sprites;
+
+    // Distinct keys seen this frame, sprites reference them by index
+    std::vector<Key> m_keys;
+    std::unordered_map<Key, u32, KeyHash> m_keyLookup;
+    u32 m_lastKey = 0;
+
+    std::vector<Batch> m_batches;
+    std::vector<SpriteVertex> m_vertices;
+
+    std::vector<SortItem> m_order;
+    std::vector<SortItem> m_scratch;
+
+    glm::vec3 m_viewPosition {0.0f};
+    glm::vec3 m_viewDirection {0.0f, 0.0f, -1.0f};
+
+    // World bounds of the submitted sprites, in submission order
+    FrustumCuller m_culler;
+    Frustum m_frustum;
+
+    SpriteBatchStats m_stats;
+
+    // OpenGL objects are created lazily on the first draw
+    u32 m_vao = 0;
+    u32 m_ebo = 0;
+    u32 m_identityVbo = 0;
+
+    // Stream buffer the vertex attributes of m_vao point at
+    u32 m_vertexBuffer = 0;
+
+    // Capacity of the index buffer in quads
+    u32 m_capacity = 0;
+
+    void reserveGpuBuffers( GLStateCache &state, u32 quads ) noexcept;
+    void bindVertexBuffer( GLStateCache &state, u32 buffer ) noexcept;
+
+  public:
+    SpriteBatch() noexcept = default;
+    ~SpriteBatch() noexcept;
+
+    NILE_DISABLE_COPY( SpriteBatch )
+    NILE_DISABLE_MOVE( SpriteBatch )
+
+    // Camera used to order the sprites by depth, stays the same until changed
+    void setView( const glm::vec3 &position, const glm::vec3 &direction ) noexcept;
+
+    // Sprites outside of the frustum are not drawn, stays the same until changed
+    void setFrustum( const Frustum &frustum ) noexcept {
+      m_frustum = frustum;
+    }
+
+    void begin() noexcept;
+
+    // Submit an unit quad ( (0,0) - (1,1) in local space ) transformed by the transform
+    // component, the z scale is ignored as in the sprite rendering system.
+    // The uvs of its corners span uvMin - uvMax, e.g. a region of an atlas page
+    void submit( ShaderSet *shader, Texture2D *texture, const Transform &transform,
+                 const glm::vec3 &color, bool blend, const glm::vec2 &uvMin = glm::vec2( 0.0f ),
+                 const glm::vec2 &uvMax = glm::vec2( 1.0f ) ) noexcept;
+
+    // Sort and group the sprites and write the vertices, does not issue any OpenGL calls
+    void end() noexcept;
+
+    // Write the vertices into the stream buffer and submit one packet per batch
+    void draw( RenderQueue &queue, GLStateCache &state, StreamBuffer &stream ) noexcept;
+
+    [[nodiscard]] const SpriteBatchStats &getStats() const noexcept {
+      return m_stats;
+    }
+
+    // Vertices written by the last end(), four per visible sprite, ordered by batches
+    [[nodiscard]] const std::vector<SpriteVertex> &getVertices() const noexcept {
+      return m_vertices;
+    }
+  };
+
+}    // namespace nile
@@ -8,6 +8,7 @@ $Notice: $
 #pragma once
 
 #include "Nile/ecs/ecs_system.hh"
+#include "Nile/renderer/sprite_batch.hh"
 
 #include <memory>
 
@@ -17,26 +18,42 @@ $Notice: $
 // transformable
 // renderable
 // and has sprite ( texture ) //TODO(stel): maybe get better name for this component?
+// Sprites are not drawn one by one, they go through the SpriteBatch which
+// emits one draw call per ( blend, shader, texture ) group. Sprites outside of the
+// camera frustum are culled by the batch.
 
 namespace nile {
 
   class ShaderSet;
   class Coordinator;
+  class GLStateCache;
+  class RenderQueue;
+  class StreamBuffer;
 
   class SpriteRenderingSystem : public System {
   private:
-    void init_rendering_data() noexcept;
     std::shared_ptr<Coordinator> ecs_coordinator_;
+    std::shared_ptr<GLStateCache> gl_state_;
+    std::shared_ptr<RenderQueue> render_queue_;
+    std::shared_ptr<StreamBuffer> stream_buffer_;
     std::shared_ptr<ShaderSet> sprite_shader_;
-    u32 quad_vao_;
+    SpriteBatch sprite_batch_;
 
   public:
     SpriteRenderingSystem( const std::shared_ptr<Coordinator> &coordinator,
+                           const std::shared_ptr<GLStateCache> &state,
+                           const std::shared_ptr<RenderQueue> &queue,
+                           const std::shared_ptr<StreamBuffer> &stream,
                            const std::shared_ptr<ShaderSet> &shader ) noexcept;
     void create() noexcept;
     void destroy() noexcept;
     void update( float dt ) noexcept;
     void render( float dt ) noexcept;
+
+    // Counters of the last rendered frame
+    [[nodiscard]] const SpriteBatchStats &getStats() const noexcept {
+      return sprite_batch_.getStats();
+    }
   };
 
 }    // namespace nile
@@ -0,0 +1,128 @@
+/* ================================================================================
+$File: stream_buffer.hh
+$Date: $
+$Revision: $
+$Creator: Rostislav Orestis Stelmach
+$Notice: $
+================================================================================ */
+
+#pragma once
+
+#include "Nile/core/helper.hh"
+#include "Nile/core/types.hh"
+
+#include <vector>
+
+// @brief:
+// StreamBuffer is the engine wide allocator for geometry that is rewritten every frame.
+// It is one vertex buffer split into FRAMES regions, every frame sub-allocates from
+// its own region, so the CPU writes one region while the GPU still reads the ones of
+// the previous frames. A fence is placed at the end of every frame and waited for
+// before its region is used again.
+// With ARB_buffer_storage the buffer is mapped once ( persistent and coherent ) and
+// allocations point straight into it. Without it allocations are written into a CPU
+// copy that flush() uploads into orphaned storage once per frame.
+// A frame that needs more than its region grows the buffer, the old one is deleted
+// once the frames that used it are done.
+// Usage: beginFrame(), allocate() and write, flush() before the draws are executed,
+// endFrame() after them.
+
+namespace nile {
+
+  struct StreamAllocation {
+    // Write pointer, the data has to be written before the next allocate()
+    void *data = nullptr;
+    u32 buffer = 0;
+    // Offset from the beginning of the buffer in bytes
+    usize offset = 0;
+
+    [[nodiscard]] bool isValid() const noexcept {
+      return data != nullptr;
+    }
+  };
+
+  struct StreamBufferStats {
+    u32 allocations = 0;
+    usize allocatedBytes = 0;
+    // Frames that had to wait for the GPU before writing their region
+    u32 waits = 0;
+    bool persistent = false;
+  };
+
+  class StreamBuffer {
+  public:
+    // Frames the CPU may run ahead of the GPU
+    static constexpr u32 FRAMES = 3;
+    static constexpr usize DEFAULT_REGION_SIZE = 4 * 1024 * 1024;
+
+  private:
+    struct Retired {
+      u32 buffer;
+      void *fence;
+    };
+
+    usize m_regionSize;
+    bool m_allowPersistent;
+    bool m_persistent = false;
+
+    u32 m_buffer = 0;
+    // Mapping of the whole buffer, persistent mode only
+    u8 *m_mapped = nullptr;
+    // CPU copy of the region, uploaded by flush() when the buffer can't be mapped
+    std::vector<u8> m_staging;
+
+    u32 m_region = 0;
+    usize m_head = 0;
+    bool m_inFrame = false;
+
+    // GLsync of every region, null when the region is free
+    void *m_fences[ FRAMES ] = {nullptr, nullptr, nullptr};
+    std::vector<Retired> m_retired;
+
+    StreamBufferStats m_stats;
+
+    void create() noexcept;
+    void destroy() noexcept;
+    void grow( usize required ) noexcept;
+    void waitRegion() noexcept;
+    void deleteRetired() noexcept;
+
+  public:
+    // Region size is the amount of data one frame can write before the buffer grows.
+    // Persistent mapping can be turned off, e.g. to test the orphaning path.
+    explicit StreamBuffer( usize regionSize = DEFAULT_REGION_SIZE,
+                           bool allowPersistent = true ) noexcept;
+    ~StreamBuffer() noexcept;
+
+    NILE_DISABLE_COPY( StreamBuffer )
+    NILE_DISABLE_MOVE( StreamBuffer )
+
+    // Moves to the next region, waits until the GPU is done with it. Needs an OpenGL
+    // context, the buffer is created by the first frame.
+    void beginFrame() noexcept;
+
+    // Space for `bytes` bytes, the offset is a multiple of `alignment` ( e.g. the vertex
+    // size, so the offset can be turned into a base vertex )
+    [[nodiscard]] StreamAllocation allocate( usize bytes, usize alignment = 16 ) noexcept;
+
+    // Uploads the data written this frame, does nothing for a mapped buffer
+    void flush() noexcept;
+
+    // Fences the region of the frame, called after its draws were submitted
+    void endFrame() noexcept;
+
+    [[nodiscard]] usize getRegionSize() const noexcept {
+      return m_regionSize;
+    }
+
+    [[nodiscard]] bool isPersistent() const noexcept {
+      return m_persistent;
+    }
+
+    // Counters of the frame in progress
+    [[nodiscard]] const StreamBufferStats &getStats() const noexcept {
+      return m_stats;
+    }
+  };
+
+}    // namespace nile
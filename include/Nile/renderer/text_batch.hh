@@ -0,0 +1,130 @@
+/* ================================================================================
+$File: text_batch.hh
+$Date: $
+$Revision: $
+$Creator: Rostislav Orestis Stelmach
+$Notice: $
+================================================================================ */
+
+#pragma once
+
+#include "Nile/core/helper.hh"
+#include "Nile/core/types.hh"
+#include "Nile/renderer/render_queue.hh"
+
+#include <glm/glm.hpp>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// @brief:
+// TextBatch keeps the glyph quads of every text it has seen, keyed by an id ( the
+// entity ). The quads of a text are only laid out again when its string, atlas,
+// position, scale or color changes. Texts that share a glyph atlas are written next
+// to each other into one vertex buffer and drawn with a single packet, the buffer is
+// uploaded only on the frames when some text changed, appeared or disappeared.
+// Layout is done in end() and does not touch OpenGL.
+
+namespace nile {
+
+  class GLStateCache;
+  class GlyphAtlas;
+
+  // Text vertex, matches the font shader ( 0 - position and uv, 1 - color )
+  struct TextVertex {
+    glm::vec2 position;
+    glm::vec2 uv;
+    // RGBA8, normalized
+    u32 color;
+  };
+
+  struct TextBatchStats {
+    u32 texts = 0;
+    // Texts that had to be laid out this frame
+    u32 rebuilt = 0;
+    u32 glyphs = 0;
+    u32 batches = 0;
+    u32 drawCalls = 0;
+    usize uploadedBytes = 0;
+  };
+
+  class TextBatch {
+  private:
+    struct Text {
+      std::string text;
+      const GlyphAtlas *atlas = nullptr;
+      glm::vec2 position {0.0f};
+      glm::vec2 scale {1.0f};
+      u32 color = 0;
+      // Width and height of the laid out text
+      glm::vec2 extents {0.0f};
+      std::vector<TextVertex> vertices;
+      // Last frame the text was submitted in
+      u32 frame = 0;
+    };
+
+    struct Batch {
+      const GlyphAtlas *atlas;
+      u32 firstQuad;
+      u32 quadCount;
+    };
+
+    std::unordered_map<u32, Text> m_texts;
+
+    // Ids of the texts submitted this frame and the last frame, in submission order
+    std::vector<u32> m_submitted;
+    std::vector<u32> m_previous;
+
+    std::vector<Batch> m_batches;
+    std::vector<TextVertex> m_vertices;
+
+    u32 m_frame = 0;
+    // Set when m_vertices changed and has to be uploaded again
+    bool m_dirty = false;
+
+    TextBatchStats m_stats;
+
+    // OpenGL objects are created lazily on the first draw
+    u32 m_vao = 0;
+    u32 m_vbo = 0;
+    u32 m_ebo = 0;
+
+    // Capacity of the GPU buffers in quads
+    u32 m_capacity = 0;
+
+    static void layout( Text &text ) noexcept;
+    void reserveGpuBuffers( GLStateCache &state, u32 quads ) noexcept;
+
+  public:
+    TextBatch() noexcept = default;
+    ~TextBatch() noexcept;
+
+    NILE_DISABLE_COPY( TextBatch )
+    NILE_DISABLE_MOVE( TextBatch )
+
+    void begin() noexcept;
+
+    // Submit the text with its top-left corner at the position, the z components of the
+    // position and the scale are ignored. Returns the width and height of the text.
+    glm::vec2 submit( u32 id, const GlyphAtlas *atlas, const std::string &text,
+                      const glm::vec3 &position, const glm::vec3 &scale,
+                      const glm::vec3 &color ) noexcept;
+
+    // Forget the cached texts that were not submitted and group the rest by atlas,
+    // does not issue any OpenGL calls
+    void end() noexcept;
+
+    // Upload the vertices if they changed and submit one packet per atlas to the queue
+    void draw( RenderQueue &queue, GLStateCache &state, u32 program, u64 key ) noexcept;
+
+    [[nodiscard]] const TextBatchStats &getStats() const noexcept {
+      return m_stats;
+    }
+
+    // Vertices written by end(), four per glyph, ordered by batches
+    [[nodiscard]] const std::vector<TextVertex> &getVertices() const noexcept {
+      return m_vertices;
+    }
+  };
+
+}    // namespace nile
@@ -14,6 +14,9 @@ $Notice: $
 
 namespace nile {
 
+  class MipChain;
+  struct CompressedImage;
+
   // Texture2D is able to store and configure texture in OpenGL.
   // It also hosts utility funcitons for easy managment.
 
@@ -82,6 +85,13 @@ namespace nile {
     }
   }
 
+  // Texture memory of every generated texture, to see what the mip chains cost
+  struct TextureMemoryStats {
+    u32 textures = 0;
+    usize baseBytes = 0;
+    usize mipBytes = 0;
+  };
+
   class Texture2D : public Asset {
   private:
     // Holds the ID of the texture object, used for all texture operations to
@@ -104,12 +114,27 @@ namespace nile {
 
     TextureType m_textureType = TextureType::DIFFUSE;
 
+    u32 m_levels = 0;
+    usize m_baseBytes = 0;
+    usize m_mipBytes = 0;
+
+    static TextureMemoryStats s_memoryStats;
+
+    void setMemory( u32 levels, usize baseBytes, usize mipBytes ) noexcept;
+
   public:
     Texture2D() noexcept;
 
     // Generates texture from image data
     void generate( u32 width, u32 height, unsigned char *data ) noexcept;
 
+    // Uploads every level of the chain and samples it trilinear, the image format is RGBA
+    void generate( const MipChain &chain ) noexcept;
+
+    // Uploads the blocks of every level as they are, or decodes them to RGBA8 when the
+    // driver can't sample the format
+    void generate( const CompressedImage &image ) noexcept;
+
     // Binds the texture as the current active GL_TEXTURE_2D texture object
     void bind() const noexcept;
 
@@ -133,6 +158,23 @@ namespace nile {
       return m_textureType;
     }
 
+    [[nodiscard]] inline u32 getLevelCount() const noexcept {
+      return m_levels;
+    }
+
+    // Bytes of level 0, and of the mip levels below it
+    [[nodiscard]] inline usize getBaseBytes() const noexcept {
+      return m_baseBytes;
+    }
+
+    [[nodiscard]] inline usize getMipBytes() const noexcept {
+      return m_mipBytes;
+    }
+
+    [[nodiscard]] static const TextureMemoryStats &getMemoryStats() noexcept {
+      return s_memoryStats;
+    }
+
     // Setters
     void setInternalFormat( u32 format ) noexcept {
       m_internalFormat = format;
@@ -0,0 +1,119 @@
+/* ================================================================================
+$File: texture_atlas.hh
+$Date: $
+$Revision: $
+$Creator: Rostislav Orestis Stelmach
+$Notice: $
+================================================================================ */
+
+#pragma once
+
+#include "Nile/core/helper.hh"
+#include "Nile/core/types.hh"
+
+#include <glm/glm.hpp>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// @brief:
+// TextureAtlas packs many small images into a few shared texture pages at load time
+// ( with the rect packer bundled with imgui ), so sprites with different images still
+// share a texture and the SpriteBatch draws them together.
+// Images are added with add() / addFile() and packed by build(). Every image is
+// surrounded by PADDING texels that repeat its edges, linear filtering and the first
+// mip levels don't pick up the neighbours. A page is the smallest power of two the
+// images fit in, up to the maximal page size, the rest goes to the next page.
+// getRegion() returns the page of an image and where it is on the page in UVs.
+
+namespace nile {
+
+  class Texture2D;
+
+  struct AtlasRegion {
+    std::shared_ptr<Texture2D> texture;
+    glm::vec2 uvMin {0.0f};
+    glm::vec2 uvMax {1.0f};
+  };
+
+  // Where an image is on its page, in texels, without the padding
+  struct AtlasPlacement {
+    u32 page = 0;
+    u32 x = 0;
+    u32 y = 0;
+    u32 width = 0;
+    u32 height = 0;
+  };
+
+  struct TextureAtlasStats {
+    u32 images = 0;
+    u32 pages = 0;
+    // Texels of the images, padding included, per texel of the pages
+    f32 occupancy = 0.0f;
+  };
+
+  class TextureAtlas {
+  public:
+    static constexpr u32 MAX_PAGE_SIZE = 2048;
+    static constexpr u32 MIN_PAGE_SIZE = 64;
+    static constexpr u32 PADDING = 4;
+
+  private:
+    struct Image {
+      std::string name;
+      u32 width;
+      u32 height;
+      std::vector<u8> pixels;
+    };
+
+    struct Page {
+      u32 size;
+      std::vector<u8> pixels;
+    };
+
+    u32 m_maxPageSize;
+
+    // Added since the last build()
+    std::vector<Image> m_images;
+
+    std::vector<std::shared_ptr<Texture2D>> m_pages;
+    std::unordered_map<std::string, AtlasPlacement> m_placements;
+    std::unordered_map<std::string, AtlasRegion> m_regions;
+
+    TextureAtlasStats m_stats;
+    u64 m_packedTexels = 0;
+    u64 m_pageTexels = 0;
+
+    // Packs as many of the images as fit into one page, they are removed from images
+    Page packPage( std::vector<Image> &images ) noexcept;
+
+  public:
+    explicit TextureAtlas( u32 maxPageSize = MAX_PAGE_SIZE ) noexcept;
+
+    NILE_DISABLE_COPY( TextureAtlas )
+
+    // Copies an RGBA8 image, rows from the bottom up as for glTexImage2D. Fails when the
+    // image doesn't fit a page or the name is taken
+    bool add( const std::string &name, const u8 *rgba, u32 width, u32 height ) noexcept;
+
+    // Loads an image file, flipped as the texture loader does
+    bool addFile( const std::string &name, const std::string &filePath ) noexcept;
+
+    // Packs the images added since the last build into new pages and uploads them
+    void build() noexcept;
+
+    // nullptr for unknown names and images not built yet
+    [[nodiscard]] const AtlasRegion *getRegion( const std::string &name ) const noexcept;
+    [[nodiscard]] const AtlasPlacement *getPlacement( const std::string &name ) const noexcept;
+
+    [[nodiscard]] const std::vector<std::shared_ptr<Texture2D>> &getPages() const noexcept {
+      return m_pages;
+    }
+
+    [[nodiscard]] const TextureAtlasStats &getStats() const noexcept {
+      return m_stats;
+    }
+  };
+
+}    // namespace nile
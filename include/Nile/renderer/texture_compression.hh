@@ -0,0 +1,76 @@
+/* ================================================================================
+$File: texture_compression.hh
+$Date: $
+$Revision: $
+$Creator: Rostislav Orestis Stelmach
+$Notice: $
+================================================================================ */
+
+#pragma once
+
+#include "Nile/core/types.hh"
+
+#include <string>
+#include <vector>
+
+// @brief:
+// Pre-compressed textures, loaded from DDS and KTX ( version 1 ) containers with all of
+// their mip levels and uploaded as they are with glCompressedTexImage2D. A 4K BC7 map
+// takes 16 MB instead of 64 MB and needs no decoding at load time.
+// Formats: BC1 ( DXT1 ), BC3 ( DXT5 ), BC5 ( RGTC2, two channel normal maps ), BC7 and
+// ETC2 RGB / RGBA ( with EAC alpha ). sRGB variants are read as their linear
+// counterparts, the engine doesn't sample sRGB textures.
+// When the driver lacks a format, decode() transcodes the levels to RGBA8 on the CPU.
+// The blocks are uploaded as stored, so the containers are expected to start with the
+// bottom row, as the image loader flips the other files ( e.g. texconv -vflip,
+// toktx --lower_left_maps_to_s0t0 ).
+
+namespace nile {
+
+  enum class CompressedFormat : u8 { BC1 = 0, BC3, BC5, BC7, ETC2_RGB, ETC2_RGBA };
+
+  struct CompressedLevel {
+    u32 width = 0;
+    u32 height = 0;
+    // Bytes of the level in the data of the image
+    usize offset = 0;
+    usize size = 0;
+  };
+
+  struct CompressedImage {
+    CompressedFormat format = CompressedFormat::BC1;
+    std::vector<u8> data;
+    std::vector<CompressedLevel> levels;
+  };
+
+  namespace TextureCompression {
+
+    // Every format has 4x4 blocks
+    constexpr u32 BLOCK_SIZE = 4;
+
+    // Largest width or height parse() accepts, the GL 4.x minimum of GL_MAX_TEXTURE_SIZE
+    constexpr u32 MAX_DIMENSION = 16384;
+
+    [[nodiscard]] u32 blockBytes( CompressedFormat format ) noexcept;
+    [[nodiscard]] u32 glInternalFormat( CompressedFormat format ) noexcept;
+    [[nodiscard]] const char *formatName( CompressedFormat format ) noexcept;
+
+    // True for the file extensions parse() understands
+    [[nodiscard]] bool isContainer( const std::string &filePath ) noexcept;
+
+    // Reads a DDS or a KTX container, the levels are copied into the image
+    bool parse( const u8 *data, usize size, CompressedImage &image ) noexcept;
+    bool load( const std::string &filePath, CompressedImage &image ) noexcept;
+
+    // Whether the current context samples the format, needs a context
+    [[nodiscard]] bool isSupported( CompressedFormat format ) noexcept;
+
+    // Decodes one block to 4x4 RGBA8 texels, row by row
+    void decodeBlock( CompressedFormat format, const u8 *block, u8 *rgba ) noexcept;
+
+    // Decodes a level to width x height RGBA8 texels, in the row order of the blocks
+    void decode( const CompressedImage &image, u32 level, u8 *rgba ) noexcept;
+
+  }    // namespace TextureCompression
+
+}    // namespace nile
@@ -0,0 +1,28 @@
+/* ================================================================================
+$File: uniform_handle.hh
+$Date: $
+$Revision: $
+$Creator: Rostislav Orestis Stelmach
+$Notice: $
+================================================================================ */
+
+#pragma once
+
+#include "Nile/core/types.hh"
+
+namespace nile {
+
+  // Pre-resolved uniform of a ShaderSet, returned by ShaderSet::getUniformHandle.
+  // It is an index into the shader's own table of requested uniforms and not an
+  // OpenGL location, so it stays valid when the program is hot reloaded.
+  struct UniformHandle {
+    static constexpr u32 INVALID = ~0u;
+
+    u32 index = INVALID;
+
+    [[nodiscard]] bool isValid() const noexcept {
+      return index != INVALID;
+    }
+  };
+
+}    // namespace nile
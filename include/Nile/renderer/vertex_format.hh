@@ -0,0 +1,69 @@
+/* ================================================================================
+$File: vertex_format.hh
+$Date: $
+$Revision: $
+$Creator: Rostislav Orestis Stelmach
+$Notice: $
+================================================================================ */
+
+#pragma once
+
+#include "Nile/core/types.hh"
+#include "Nile/math/bounds.hh"
+#include "Nile/utils/vertex.hh"
+
+#include <glm/glm.hpp>
+#include <vector>
+
+// @brief:
+// Compact vertex format for imported meshes. A PackedVertex stores the position as
+// 16-bit unsigned normalized coordinates inside the quantization box of its mesh, the
+// normal as GL_INT_2_10_10_10_REV and the uv as half floats, 16 bytes instead of 32.
+// The box is a cube ( one scale for all the axes ), so the dequantization is a translate
+// and a uniform scale. It is folded into the model matrix of the instances, the shaders
+// read packed vertices exactly like the float ones and the normals stay unaffected.
+
+namespace nile {
+
+  enum class VertexFormat : u8 { FLOAT = 0, PACKED };
+
+  constexpr u32 VERTEX_FORMAT_COUNT = 2;
+
+  struct VertexQuantization {
+    // Minimum corner and size of the quantization cube
+    glm::vec3 offset {0.0f};
+    f32 scale = 1.0f;
+
+    // Maps the normalized position of a packed vertex back into the mesh space
+    [[nodiscard]] glm::mat4 dequantizeMatrix() const noexcept;
+  };
+
+  // Largest error of the decoded vertices of a mesh
+  struct QuantizationError {
+    // Distance in mesh space units
+    f32 position = 0.0f;
+    // Angle in degrees
+    f32 normal = 0.0f;
+    // Per component, in texture coordinates
+    f32 uv = 0.0f;
+  };
+
+  namespace Math {
+
+    [[nodiscard]] VertexQuantization computeQuantization( const AABB &bounds ) noexcept;
+
+    [[nodiscard]] PackedVertex packVertex( const Vertex &vertex,
+                                           const VertexQuantization &quantization ) noexcept;
+
+    // Same decoding as the vertex fetch of OpenGL ( 4.2+ signed normalized rules )
+    [[nodiscard]] Vertex unpackVertex( const PackedVertex &vertex,
+                                       const VertexQuantization &quantization ) noexcept;
+
+    // Packs all the vertices and decodes them back to measure the error
+    QuantizationError packVertices( const std::vector<Vertex> &vertices,
+                                    const VertexQuantization &quantization,
+                                    std::vector<PackedVertex> &packed ) noexcept;
+
+  }    // namespace Math
+
+}    // namespace nile
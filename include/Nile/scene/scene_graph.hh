@@ -1,6 +1,187 @@
-#pragma once 
+/* ================================================================================
+$File: scene_graph.hh
+$Date: $
+$Revision: $
+$Creator: Rostislav Orestis Stelmach
+$Notice: $
+================================================================================ */
+
+#pragma once
+
+#include "Nile/core/helper.hh"
+#include "Nile/core/types.hh"
+#include "Nile/math/bounds.hh"
+#include "Nile/math/frustum.hh"
+#include "Nile/scene/scene_node.hh"
+
+#include <glm/glm.hpp>
+#include <vector>
+
+// @brief:
+// SceneGraph is the spatial index of the scene, a dynamic AABB tree. Every object is
+// a leaf ( proxy ) with enlarged ( fat ) bounds, so objects that move a little stay
+// where they are in the tree. Objects that leave their fat bounds are removed and
+// inserted again, which costs O( log n ) since the tree is kept balanced with
+// rotations.
+// The TransformSystem keeps the meshes of the ECS in the tree, culling, picking and
+// gameplay code use the queries below. Queries are not thread safe, they share a
+// traversal stack.
 
 namespace nile {
 
+  struct RayHit {
+    Entity entity = ecs::null;
+    i32 proxy = NULL_NODE;
+    // Distance along the normalized ray direction
+    f32 distance = 0.0f;
+  };
+
+  class SceneGraph {
+  private:
+    std::vector<SceneNode> m_nodes;
+    i32 m_root = NULL_NODE;
+    i32 m_freeList = NULL_NODE;
+    u32 m_proxyCount = 0;
+
+    // How much the fat bounds are larger than the object
+    f32 m_margin;
+
+    mutable std::vector<i32> m_stack;
+
+    struct InsertCandidate {
+      i32 index;
+      // Growth of the ancestors if the leaf is inserted below the node
+      f32 inheritedCost;
+    };
+    std::vector<InsertCandidate> m_candidates;
+
+    i32 allocateNode() noexcept;
+    void freeNode( i32 node ) noexcept;
+
+    void insertLeaf( i32 leaf ) noexcept;
+    void removeLeaf( i32 leaf ) noexcept;
+
+    // Rotates the subtree if its children heights differ by more than one,
+    // returns the new root of the subtree
+    i32 balance( i32 node ) noexcept;
+
+    i32 validateNode( i32 node ) const noexcept;
+
+  public:
+    explicit SceneGraph( f32 margin = 0.1f ) noexcept;
+
+    NILE_DISABLE_COPY( SceneGraph )
+
+    // Adds an object, returns the proxy used to move and remove it
+    i32 createProxy( const AABB &bounds, Entity entity ) noexcept;
+
+    void destroyProxy( i32 proxy ) noexcept;
+
+    // Updates the bounds of an object. The fat bounds are stretched in the direction
+    // of the displacement, so objects moving that way stay longer in them.
+    // Returns true when the object had to be inserted again.
+    bool moveProxy( i32 proxy, const AABB &bounds, const glm::vec3 &displacement ) noexcept;
+
+    [[nodiscard]] Entity getEntity( i32 proxy ) const noexcept {
+      return m_nodes[ proxy ].entity;
+    }
+
+    [[nodiscard]] const AABB &getFatBounds( i32 proxy ) const noexcept {
+      return m_nodes[ proxy ].bounds;
+    }
+
+    [[nodiscard]] const AABB &getBounds( i32 proxy ) const noexcept {
+      return m_nodes[ proxy ].objectBounds;
+    }
+
+    [[nodiscard]] u32 size() const noexcept {
+      return m_proxyCount;
+    }
+
+    [[nodiscard]] i32 getHeight() const noexcept {
+      return m_root == NULL_NODE ? 0 : m_nodes[ m_root ].height;
+    }
+
+    // Checks the structure and heights of the whole tree ( slow, for tests )
+    [[nodiscard]] bool validate() const noexcept;
+
+    // Calls fn( entity, proxy ) for every object whose fat bounds overlap the box,
+    // the query stops when fn returns false
+    template <typename F>
+    void query( const AABB &bounds, F &&fn ) const noexcept;
+
+    // Same as above, for objects whose fat bounds intersect the frustum
+    template <typename F>
+    void query( const Frustum &frustum, F &&fn ) const noexcept;
+
+    // Closest object whose bounds are hit by the ray, direction doesn't need to
+    // be normalized
+    bool raycast( const glm::vec3 &origin, const glm::vec3 &direction, f32 maxDistance,
+                  RayHit &hit ) const noexcept;
+
+    // Object whose bounds are the closest to the point, within maxDistance
+    bool nearest( const glm::vec3 &point, f32 maxDistance, RayHit &hit ) const noexcept;
+  };
+
+  namespace Math {
+
+    [[nodiscard]] inline bool overlaps( const AABB &a, const AABB &b ) noexcept {
+      return a.min.x <= b.max.x && a.max.x >= b.min.x && a.min.y <= b.max.y &&
+             a.max.y >= b.min.y && a.min.z <= b.max.z && a.max.z >= b.min.z;
+    }
+
+  }    // namespace Math
+
+  template <typename F>
+  void SceneGraph::query( const AABB &bounds, F &&fn ) const noexcept {
+    if ( m_root == NULL_NODE )
+      return;
+
+    m_stack.clear();
+    m_stack.push_back( m_root );
+
+    while ( !m_stack.empty() ) {
+      const auto &node = m_nodes[ m_stack.back() ];
+      const auto index = m_stack.back();
+      m_stack.pop_back();
+
+      if ( !Math::overlaps( node.bounds, bounds ) )
+        continue;
+
+      if ( node.isLeaf() ) {
+        if ( !fn( node.entity, index ) )
+          return;
+      } else {
+        m_stack.push_back( node.left );
+        m_stack.push_back( node.right );
+      }
+    }
+  }
+
+  template <typename F>
+  void SceneGraph::query( const Frustum &frustum, F &&fn ) const noexcept {
+    if ( m_root == NULL_NODE )
+      return;
+
+    m_stack.clear();
+    m_stack.push_back( m_root );
+
+    while ( !m_stack.empty() ) {
+      const auto &node = m_nodes[ m_stack.back() ];
+      const auto index = m_stack.back();
+      m_stack.pop_back();
+
+      if ( !frustum.intersects( node.bounds ) )
+        continue;
+
+      if ( node.isLeaf() ) {
+        if ( !fn( node.entity, index ) )
+          return;
+      } else {
+        m_stack.push_back( node.left );
+        m_stack.push_back( node.right );
+      }
+    }
+  }
 
-}
+}    // namespace nile
@@ -1,5 +1,42 @@
-#pragma once 
+/* ================================================================================
+$File: scene_node.hh
+$Date: $
+$Revision: $
+$Creator: Rostislav Orestis Stelmach
+$Notice: $
+================================================================================ */
+
+#pragma once
+
+#include "Nile/core/types.hh"
+#include "Nile/math/bounds.hh"
 
 namespace nile {
 
-}
+  constexpr i32 NULL_NODE = -1;
+
+  // Node of the SceneGraph tree. Leaves hold one object ( proxy ), inner nodes
+  // the union of the bounds of their children. Nodes live in one array and
+  // reference each other by index.
+  struct SceneNode {
+    // Enlarged bounds of the object for leaves, so small moves don't touch the tree
+    AABB bounds;
+    // Exact bounds of the object, only set for leaves
+    AABB objectBounds;
+
+    // Next free node while the node is in the free list
+    i32 parent = NULL_NODE;
+    i32 left = NULL_NODE;
+    i32 right = NULL_NODE;
+
+    // Leaves are at 0, free nodes at -1
+    i32 height = -1;
+
+    Entity entity = ecs::null;
+
+    [[nodiscard]] bool isLeaf() const noexcept {
+      return left == NULL_NODE;
+    }
+  };
+
+}    // namespace nile
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "Nile/core/types.hh"
+
 #include <glm/glm.hpp>
 
 namespace nile {
@@ -10,4 +12,16 @@ namespace nile {
     glm::vec2 uv;
   };
 
+  // Half the size of Vertex, see vertex_format.hh for the encoding
+  struct PackedVertex {
+    // Normalized position inside the quantization box, the fourth one is padding
+    u16 position[ 4 ];
+    // GL_INT_2_10_10_10_REV, signed normalized
+    u32 normal;
+    // Half floats
+    u16 uv[ 2 ];
+  };
+
+  static_assert( sizeof( PackedVertex ) == 16, "PackedVertex must stay 16 bytes" );
+
 }    // namespace nile
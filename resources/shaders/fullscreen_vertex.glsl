@@ -0,0 +1,14 @@
+#version 330 core
+
+// One triangle that covers the screen, built from the vertex index, no vertex buffer
+// ( RenderPassContext::drawFullscreen )
+
+out vec2 TexCoords;
+
+void main() {
+
+  vec2 uv = vec2( ( gl_VertexID << 1 ) & 2, gl_VertexID & 2 );
+  TexCoords = uv;
+  gl_Position = vec4( uv * 2.0 - 1.0, 0.0, 1.0 );
+
+}
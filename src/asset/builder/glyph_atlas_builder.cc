@@ -0,0 +1,98 @@
+/* ================================================================================
+$File: glyph_atlas_builder.cc
+$Date: $
+$Revision: $
+$Creator: Rostislav Orestis Stelmach
+$Notice: $
+================================================================================ */
+
+#include "Nile/asset/builder/glyph_atlas_builder.hh"
+#include "Nile/asset/asset_manager.hh"
+#include "Nile/log/log.hh"
+#include "Nile/renderer/font.hh"
+
+#include <spdlog/spdlog.h>
+
+namespace nile::AssetBuilder {
+
+  namespace {
+
+    // Atlas width that fits roughly 16 glyphs of the given size in a row
+    u32 atlasWidth( u32 pixelSize ) noexcept {
+      u32 width = 128;
+      while ( width < pixelSize * 16 && width < 4096 )
+        width <<= 1;
+      return width;
+    }
+
+  }    // namespace
+
+  Builder<GlyphAtlas>::Builder( const std::shared_ptr<nile::AssetManager> &assetManager ) noexcept
+      : m_assetManager( assetManager ) {}
+
+  Builder<GlyphAtlas> &Builder<GlyphAtlas>::setFont( const std::shared_ptr<Font> &font ) noexcept {
+    m_font = font;
+    return *this;
+  }
+
+  Builder<GlyphAtlas> &Builder<GlyphAtlas>::setPixelSize( u32 pixelSize ) noexcept {
+    m_pixelSize = pixelSize;
+    return *this;
+  }
+
+  std::string Builder<GlyphAtlas>::getAssetName() const noexcept {
+    const auto *face = m_font ? m_font->fontFace : nullptr;
+    const std::string family = face && face->family_name ? face->family_name : "unknown";
+    const std::string style = face && face->style_name ? face->style_name : "";
+    return family + " " + style + "@" + std::to_string( m_pixelSize );
+  }
+
+  [[nodiscard]] std::shared_ptr<GlyphAtlas> Builder<GlyphAtlas>::build() noexcept {
+
+    if ( !m_font || !m_font->fontFace ) {
+      log::error( "Cannot build a glyph atlas without a loaded font\n" );
+      return nullptr;
+    }
+
+    const auto assetName = getAssetName();
+
+    if ( m_assetManager->isAssetExist( assetName ) )
+      return m_assetManager->getAsset<GlyphAtlas>( assetName );
+
+    return m_assetManager->storeAsset<GlyphAtlas>( assetName, rasterize( assetName ) );
+  }
+
+  std::shared_ptr<GlyphAtlas> Builder<GlyphAtlas>::rasterize(
+      const std::string &assetName ) noexcept {
+
+    auto face = m_font->fontFace;
+    FT_Set_Pixel_Sizes( face, 0, m_pixelSize );
+
+    auto atlas = std::make_shared<GlyphAtlas>( atlasWidth( m_pixelSize ), m_pixelSize );
+    atlas->setAssetName( assetName );
+
+    for ( u32 c = 0; c < GlyphAtlas::GLYPH_COUNT; ++c ) {
+
+      // Load character glyph
+      if ( FT_Load_Char( face, c, FT_LOAD_RENDER ) ) {
+        log::error( "Faild to load glyph [%c]\n", c );
+        continue;
+      }
+
+      const auto *glyph = face->glyph;
+      atlas->addGlyph( c, glyph->bitmap.width, glyph->bitmap.rows, glyph->bitmap.pitch,
+                       glyph->bitmap.buffer, glm::ivec2( glyph->bitmap_left, glyph->bitmap_top ),
+                       static_cast<u32>( glyph->advance.x ) );
+    }
+
+    // Text is placed relative to the top of the capital letters
+    atlas->setAscent( atlas->getGlyph( 'H' ).bearing.y );
+    atlas->upload();
+
+    spdlog::debug( "Glyph atlas \"{}\" has been created ( {}x{} ).", assetName,
+                   atlas->getWidth(), atlas->getHeight() );
+
+    return atlas;
+  }
+
+}    // namespace nile::AssetBuilder
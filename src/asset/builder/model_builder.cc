@@ -1,6 +1,7 @@
 #include "Nile/asset/builder/model_builder.hh"
 #include "Nile/core/assert.hh"
 #include "Nile/debug/benchmark_timer.hh"
+#include "Nile/renderer/mesh_optimizer.hh"
 
 #include <spdlog/spdlog.h>
 
@@ -122,7 +123,33 @@ namespace nile::AssetBuilder {
       textures.insert( textures.end(), heightMaps.begin(), heightMaps.end() );
     }
 
-    return Mesh( vertices, indices, textures );
+    if ( m_optimizeMeshes ) {
+      const auto before = MeshOptimizer::analyze( vertices, indices );
+
+      MeshOptimizer::optimizeVertexCache( indices, vertices.size() );
+      MeshOptimizer::optimizeOverdraw( indices, vertices );
+      MeshOptimizer::optimizeVertexFetch( vertices, indices );
+
+      const auto after = MeshOptimizer::analyze( vertices, indices );
+      spdlog::debug( "Mesh \"{}\" optimized, ACMR {:.3f} -> {:.3f}, ATVR {:.3f} -> {:.3f}, "
+                     "overdraw {:.3f} -> {:.3f}",
+                     mesh->mName.C_Str(), before.acmr, after.acmr, before.atvr, after.atvr,
+                     before.overdraw, after.overdraw );
+    }
+
+    Mesh result( vertices, indices, textures );
+
+    if ( m_vertexFormat == VertexFormat::PACKED ) {
+      result.pack();
+      const auto &error = result.quantizationError;
+      spdlog::debug( "Mesh \"{}\" packed, {} -> {} bytes, max error: position {}, normal {} "
+                     "degrees, uv {}",
+                     mesh->mName.C_Str(), vertices.size() * sizeof( Vertex ),
+                     result.packedVertices.size() * sizeof( PackedVertex ), error.position,
+                     error.normal, error.uv );
+    }
+
+    return result;
   }
 
   std::vector<std::shared_ptr<Texture2D>>
@@ -150,6 +177,16 @@ namespace nile::AssetBuilder {
     return *this;
   }
 
+  Builder<Model> &Builder<Model>::setVertexFormat( VertexFormat format ) noexcept {
+    m_vertexFormat = format;
+    return *this;
+  }
+
+  Builder<Model> &Builder<Model>::setOptimizeMeshes( bool optimize ) noexcept {
+    m_optimizeMeshes = optimize;
+    return *this;
+  }
+
   [[nodiscard]] std::shared_ptr<Model> Builder<Model>::build() noexcept {
     ASSERT_M( !m_path.empty(), "Model path is empty!" );
     this->loadModel();
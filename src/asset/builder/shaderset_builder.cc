@@ -9,6 +9,7 @@ $Notice: $
 #include "Nile/asset/builder/shaderset_builder.hh"
 #include "Nile/core/assert.hh"
 #include "Nile/core/file_system.hh"
+#include "Nile/renderer/frame_uniforms.hh"
 
 #include <GL/glew.h>
 #include <spdlog/spdlog.h>
@@ -175,6 +176,9 @@ namespace nile::AssetBuilder {
     glLinkProgram( program_id );
 
     checkForCompileErrors( program_id, ShaderType::PROGRAM );
+
+    // Engine uniform blocks ( camera, lights ) are shared by every program
+    FrameUniforms::bindUniformBlocks( program_id );
     // Delete the shaders as they're linked into our program now and no longer necessery
     glDeleteShader( sVertex );
     glDeleteShader( sFragment );
@@ -8,20 +8,59 @@ $Notice: $
 
 #include "Nile/asset/subsystem/texture_loader.hh"
 #include "Nile/log/log.hh"
+#include "Nile/renderer/mip_chain.hh"
 #include "Nile/renderer/texture2d.hh"
+#include "Nile/renderer/texture_compression.hh"
 
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
 #include <GL/glew.h>
 
+#include <algorithm>
+#include <cctype>
+
 
 namespace nile {
 
+  namespace {
+
+    // Normal maps hold vectors, not colors, they are filtered without the sRGB curve
+    bool isLinearData( const std::string &filePath ) noexcept {
+      std::string name = filePath.substr( filePath.find_last_of( "/\\" ) + 1 );
+      std::transform( name.begin(), name.end(), name.begin(),
+                      []( unsigned char c ) { return static_cast<char>( std::tolower( c ) ); } );
+      return name.find( "normal" ) != std::string::npos;
+    }
+
+  }    // namespace
+
   std::shared_ptr<Texture2D>
   AssetLoader<Texture2D>::operator()( const std::string &assetName,
                                       const std::string &filePath ) noexcept {
 
     auto texture = std::make_shared<Texture2D>();
+
+    // Pre-compressed containers bring their own mip levels
+    if ( TextureCompression::isContainer( filePath ) ) {
+      CompressedImage image;
+      if ( TextureCompression::load( filePath, image ) ) {
+        texture->generate( image );
+        log::print( "Texture { %s }: %s %ux%u, %u levels, %zu KiB + %zu KiB of mips%s\n",
+                    filePath.data(), TextureCompression::formatName( image.format ),
+                    image.levels[ 0 ].width, image.levels[ 0 ].height,
+                    texture->getLevelCount(), texture->getBaseBytes() / 1024,
+                    texture->getMipBytes() / 1024,
+                    TextureCompression::isSupported( image.format ) ? ""
+                                                                    : ", transcoded to RGBA8" );
+      } else {
+        log::error( "Failed to load texture { %s }\n", filePath.data() );
+      }
+
+      texture->setAssetName( assetName );
+      texture->setFileName( filePath );
+      return texture;
+    }
+
     const auto alpha = true;
 
     if ( alpha ) {
@@ -41,9 +80,19 @@ namespace nile {
 
     if ( !image ) {
       log::error( "Failed to load texture { %s }\n", filePath.data() );
-    }
+      texture->generate( width, height, image );
+    } else {
+      MipChainOptions options;
+      options.srgb = !isLinearData( filePath );
+
+      MipChain chain;
+      chain.build( image, static_cast<u32>( width ), static_cast<u32>( height ), options );
+      texture->generate( chain );
 
-    texture->generate( width, height, image );
+      log::print( "Texture { %s }: %dx%d, %u levels, %zu KiB + %zu KiB of mips\n",
+                  filePath.data(), width, height, chain.getLevelCount(),
+                  chain.getBaseBytes() / 1024, chain.getMipBytes() / 1024 );
+    }
     stbi_image_free( image );
 
     texture->setAssetName( assetName );
@@ -3,6 +3,10 @@
 #include "Nile/ecs/components/camera_component.hh"
 #include "Nile/ecs/components/transform.hh"
 #include "Nile/ecs/ecs_coordinator.hh"
+#include "Nile/math/frustum.hh"
+#include "Nile/math/utils.hh"
+#include "Nile/renderer/frame_uniforms.hh"
+#include "Nile/renderer/render_queue.hh"
 #include <glm/gtc/matrix_transform.hpp>
 
 #include <spdlog/spdlog.h>
@@ -10,9 +14,13 @@
 namespace nile {
 
   CameraSystem::CameraSystem( const std::shared_ptr<Coordinator> &coordinator,
-                              const std::shared_ptr<Settings> &settings ) noexcept
+                              const std::shared_ptr<Settings> &settings,
+                              const std::shared_ptr<RenderQueue> &queue,
+                              const std::shared_ptr<FrameUniforms> &uniforms ) noexcept
       : ecs_coordinator_( coordinator )
-      , settings_( settings ) {}
+      , settings_( settings )
+      , render_queue_( queue )
+      , frame_uniforms_( uniforms ) {}
 
   void CameraSystem::create() noexcept {
 
@@ -68,7 +76,32 @@ namespace nile {
             glm::cross( cameraComponent.cameraRight, cameraComponent.cameraFront ) );
         cameraComponent.shouldCameraUpdate = false;
       }
+
+      // The render queue orders packets by their depth from the camera
+      render_queue_->setView( transform.position, cameraComponent.cameraFront );
+
+      // The projection is rebuilt since the field of view may change at any time.
+      // Orthographic cameras draw the world without a view matrix.
+      glm::mat4 view( 1.0f );
+      if ( cameraComponent.projectionType == ProjectionType::PERSPECTIVE ) {
+        cameraComponent.projectionMatrix =
+            glm::perspective( glm::radians( cameraComponent.fieldOfView ),
+                              static_cast<f32>( settings_->getWidth() ) /
+                                  static_cast<f32>( settings_->getHeight() ),
+                              cameraComponent.near, cameraComponent.far );
+        cameraComponent.viewMatrix =
+            Math::lookAt( transform.position, transform.position + cameraComponent.cameraFront,
+                          cameraComponent.cameraUp );
+        view = cameraComponent.viewMatrix;
+      }
+      render_queue_->setFrustum( Frustum::fromMatrix( cameraComponent.projectionMatrix * view ) );
+
+      // Shaders read the camera from the camera uniform block, the scene has one camera
+      frame_uniforms_->setCamera( view, cameraComponent.projectionMatrix, transform.position );
     }
+
+    // One upload per frame, shared by every shader that declares the blocks
+    frame_uniforms_->upload();
   }
 
   void CameraSystem::destroy() noexcept {}
@@ -11,13 +11,20 @@ $Notice: $
 namespace nile {
 
   Settings::Settings( u32 width, u32 height, u32 flags, bool debugMode, const std::string &title,
-                      ProgramMode programMode ) noexcept
+                      ProgramMode programMode, bool headless, u32 frameLimit,
+                      const std::string &capturePath, f32 frameTimeBudget,
+                      f32 minRenderScale ) noexcept
       : m_width( width )
       , m_height( height )
       , m_windowFlags( flags )
       , m_debugMode( debugMode )
       , m_windowTitle( title )
-      , m_programMode( programMode ) {}
+      , m_programMode( programMode )
+      , m_headless( headless )
+      , m_frameLimit( frameLimit )
+      , m_capturePath( capturePath )
+      , m_frameTimeBudget( frameTimeBudget )
+      , m_minRenderScale( minRenderScale ) {}
 
   Settings::~Settings() noexcept {}
 
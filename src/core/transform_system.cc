@@ -7,23 +7,46 @@ $Notice: $
 ================================================================================ */
 
 #include "Nile/core/transform_system.hh"
-#include "Nile/ecs/components/relationship.hh"
+#include "Nile/ecs/components/mesh_component.hh"
 #include "Nile/ecs/components/transform.hh"
 #include "Nile/ecs/ecs_coordinator.hh"
+#include "Nile/math/bounds.hh"
+#include "Nile/scene/scene_graph.hh"
 
+#include <glm/gtc/matrix_transform.hpp>
 #include <spdlog/spdlog.h>
 
 namespace nile {
 
-  TransformSystem::TransformSystem( const std::shared_ptr<Coordinator> &coordinator )
-      : ecs_coordinator_( coordinator ) {}
+  namespace {
+
+    // Same model matrix as the one the RenderingSystem draws the mesh with
+    glm::mat4 modelMatrix( const Transform &transform ) noexcept {
+      glm::mat4 model = glm::mat4 {1.0f};
+      model = glm::translate( model, transform.position );
+      model =
+          glm::rotate( model, glm::radians( transform.xRotation ), glm::vec3( 1.0f, 0.0f, 0.0f ) );
+      model =
+          glm::rotate( model, glm::radians( transform.yRotation ), glm::vec3( 0.0f, 1.0f, 0.0f ) );
+      model =
+          glm::rotate( model, glm::radians( transform.zRotation ), glm::vec3( 0.0f, 0.0f, 1.0f ) );
+      return glm::scale( model, transform.scale );
+    }
+
+  }    // namespace
+
+  TransformSystem::TransformSystem( const std::shared_ptr<Coordinator> &coordinator,
+                                    const std::shared_ptr<SceneGraph> &scene ) noexcept
+      : ecs_coordinator_( coordinator )
+      , scene_graph_( scene )
+      , proxy_by_entity_( ecs::MAX_ENTITIES, NULL_NODE )
+      , last_update_( ecs::MAX_ENTITIES, 0 ) {}
 
   void TransformSystem::create() {
     spdlog::info(
         "ECS TransformSystem has been registered to ECS manager and created successfully." );
 
     for ( const auto &entity : entities_ ) {
-      [[maybe_unused]] auto &relationship = ecs_coordinator_->getComponent<Relationship>( entity );
       [[maybe_unused]] auto &transform = ecs_coordinator_->getComponent<Transform>( entity );
 
       spdlog::debug( "entity: {0} - [x: {1},  y: {2}, z:{3}]", entity, transform.position.x,
@@ -31,11 +54,52 @@ namespace nile {
     }
   }
 
-  void TransformSystem::update() {
+  void TransformSystem::update( f32 dt ) {
+
+    ++frame_;
 
     for ( const auto &entity : entities_ ) {
-      [[maybe_unused]] auto &relationship = ecs_coordinator_->getComponent<Relationship>( entity );
-      [[maybe_unused]] auto &transform = ecs_coordinator_->getComponent<Transform>( entity );
+      auto &transform = ecs_coordinator_->getComponent<Transform>( entity );
+      auto &mesh = ecs_coordinator_->getComponent<MeshComponent>( entity );
+
+      // Meshes that were not created from an imported model, packed ones fall back
+      // to their quantization box
+      if ( !mesh.bounds.isValid() && mesh.vertices.empty() && !mesh.packedVertices.empty() ) {
+        mesh.bounds.expand( mesh.quantization.offset );
+        mesh.bounds.expand( mesh.quantization.offset + glm::vec3 {mesh.quantization.scale} );
+      } else if ( !mesh.bounds.isValid() ) {
+        mesh.bounds = Math::computeBounds( mesh.vertices );
+      }
+
+      const auto previous = mesh.worldBounds;
+      mesh.worldBounds = Math::transformBounds( mesh.bounds, modelMatrix( transform ) );
+      last_update_[ entity ] = frame_;
+
+      if ( !mesh.worldBounds.isValid() )
+        continue;
+
+      auto &proxy = proxy_by_entity_[ entity ];
+      if ( proxy == NULL_NODE ) {
+        proxy = scene_graph_->createProxy( mesh.worldBounds, entity );
+        tracked_.push_back( entity );
+      } else {
+        scene_graph_->moveProxy( proxy, mesh.worldBounds,
+                                 mesh.worldBounds.center() - previous.center() );
+      }
+    }
+
+    // Entities that were destroyed or lost one of the components
+    for ( usize i = 0; i < tracked_.size(); ) {
+      const auto entity = tracked_[ i ];
+      if ( last_update_[ entity ] == frame_ ) {
+        ++i;
+        continue;
+      }
+
+      scene_graph_->destroyProxy( proxy_by_entity_[ entity ] );
+      proxy_by_entity_[ entity ] = NULL_NODE;
+      tracked_[ i ] = tracked_.back();
+      tracked_.pop_back();
     }
   }
 
@@ -43,4 +107,3 @@ namespace nile {
 
 
 }    // namespace nile
-
@@ -0,0 +1,298 @@
+/* ================================================================================
+$File: debug_draw.cc
+$Date: $
+$Revision: $
+$Creator: Rostislav Orestis Stelmach
+$Notice: $
+================================================================================ */
+
+#include "Nile/debug/debug_draw.hh"
+#include "Nile/renderer/gl_state_cache.hh"
+#include "Nile/renderer/render_queue.hh"
+#include "Nile/renderer/stream_buffer.hh"
+
+#include <GL/glew.h>
+#include <glm/gtc/constants.hpp>
+
+#include <array>
+#include <cctype>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+
+namespace nile {
+
+  DebugDraw::~DebugDraw() noexcept {
+    if ( m_vao )
+      glDeleteVertexArrays( 1, &m_vao );
+  }
+
+  namespace {
+
+    // Corner i of a box has x from bit 0, y from bit 1 and z from bit 2
+    constexpr u32 BOX_EDGES[ 12 ][ 2 ] = {{0, 1}, {2, 3}, {4, 5}, {6, 7}, {0, 2}, {1, 3},
+                                          {4, 6}, {5, 7}, {0, 4}, {1, 5}, {2, 6}, {3, 7}};
+
+    // Segments of the font on a 2x2 cell, x and y of both ends:
+    //
+    //    a   b
+    //  h k l m c
+    //    i   j
+    //  g n o p d
+    //    f   e
+    constexpr f32 SEGMENTS[ 16 ][ 4 ] = {
+        {0.0f, 1.0f, 0.5f, 1.0f},    // a
+        {0.5f, 1.0f, 1.0f, 1.0f},    // b
+        {1.0f, 1.0f, 1.0f, 0.5f},    // c
+        {1.0f, 0.5f, 1.0f, 0.0f},    // d
+        {1.0f, 0.0f, 0.5f, 0.0f},    // e
+        {0.5f, 0.0f, 0.0f, 0.0f},    // f
+        {0.0f, 0.0f, 0.0f, 0.5f},    // g
+        {0.0f, 0.5f, 0.0f, 1.0f},    // h
+        {0.0f, 0.5f, 0.5f, 0.5f},    // i
+        {0.5f, 0.5f, 1.0f, 0.5f},    // j
+        {0.0f, 1.0f, 0.5f, 0.5f},    // k
+        {0.5f, 1.0f, 0.5f, 0.5f},    // l
+        {1.0f, 1.0f, 0.5f, 0.5f},    // m
+        {0.5f, 0.5f, 0.0f, 0.0f},    // n
+        {0.5f, 0.5f, 0.5f, 0.0f},    // o
+        {0.5f, 0.5f, 1.0f, 0.0f},    // p
+    };
+
+    // Segments of the characters from ' ' to '_', lowercase letters use the uppercase ones
+    constexpr const char *GLYPHS[] = {
+        "",           "l",          "hl",         "",           "abhijdeflo", "mn",
+        "",           "l",          "mp",         "kn",         "ijklmnop",   "ijlo",
+        "n",          "ij",         "f",          "mn",         "abcdefghmn", "mcd",
+        "abcjigfe",   "abcdefj",    "hijcd",      "abhijdef",   "abhgfedij",  "abcd",
+        "abcdefghij", "abcdefhij",  "",           "",           "mp",         "ijef",
+        "kn",         "abcjo",      "",           "abcdghij",   "abcdefjlo",  "abefgh",
+        "abcdeflo",   "abefghi",    "abghi",      "abdefghj",   "cdghij",     "abeflo",
+        "cdefg",      "ghimp",      "efgh",       "cdghkm",     "cdghkp",     "abcdefgh",
+        "abcghij",    "abcdefghp",  "abcghijp",   "abhijdef",   "ablo",       "cdefgh",
+        "ghnm",       "cdghnp",     "kmnp",       "kmo",        "abefmn",     "afgh",
+        "kp",         "bcde",       "",           "ef"};
+
+    constexpr char FIRST_GLYPH = ' ';
+    constexpr char LAST_GLYPH = '_';
+
+    static_assert( sizeof( GLYPHS ) / sizeof( GLYPHS[ 0 ] ) == LAST_GLYPH - FIRST_GLYPH + 1,
+                   "Every character from ' ' to '_' needs a glyph" );
+
+    // Width of a letter and distance between letters, relative to the height
+    constexpr f32 GLYPH_WIDTH = 0.6f;
+    constexpr f32 GLYPH_ADVANCE = 0.9f;
+
+    u32 packColor( const glm::vec3 &color ) noexcept {
+      const auto c = glm::clamp( color, 0.0f, 1.0f ) * 255.0f + 0.5f;
+      return static_cast<u32>( c.r ) | ( static_cast<u32>( c.g ) << 8 ) |
+             ( static_cast<u32>( c.b ) << 16 ) | ( 0xffu << 24 );
+    }
+
+#if defined( NILE_DEBUG_DRAW )
+    std::array<DebugVertex, 24> boxLines( const std::array<glm::vec3, 8> &corners,
+                                          u32 color ) noexcept {
+      std::array<DebugVertex, 24> vertices;
+      for ( u32 edge = 0; edge < 12; ++edge ) {
+        vertices[ edge * 2 ] = {corners[ BOX_EDGES[ edge ][ 0 ] ], color};
+        vertices[ edge * 2 + 1 ] = {corners[ BOX_EDGES[ edge ][ 1 ] ], color};
+      }
+      return vertices;
+    }
+#endif
+
+  }    // namespace
+
+  void DebugDraw::push( const DebugVertex *vertices, usize count ) noexcept {
+    std::lock_guard<std::mutex> lock( m_mutex );
+    m_pending.insert( m_pending.end(), vertices, vertices + count );
+  }
+
+  void DebugDraw::addLine( const glm::vec3 &begin, const glm::vec3 &end,
+                           const glm::vec3 &color ) noexcept {
+    const auto packed = packColor( color );
+    const DebugVertex vertices[ 2 ] = {{begin, packed}, {end, packed}};
+    this->push( vertices, 2 );
+  }
+
+#if defined( NILE_DEBUG_DRAW )
+
+  void DebugDraw::line( const glm::vec3 &begin, const glm::vec3 &end,
+                        const glm::vec3 &color ) noexcept {
+    this->addLine( begin, end, color );
+  }
+
+  void DebugDraw::box( const AABB &bounds, const glm::vec3 &color ) noexcept {
+    std::array<glm::vec3, 8> corners;
+    for ( u32 i = 0; i < 8; ++i ) {
+      corners[ i ] = glm::vec3( i & 1 ? bounds.max.x : bounds.min.x,
+                                i & 2 ? bounds.max.y : bounds.min.y,
+                                i & 4 ? bounds.max.z : bounds.min.z );
+    }
+
+    const auto vertices = boxLines( corners, packColor( color ) );
+    this->push( vertices.data(), vertices.size() );
+  }
+
+  void DebugDraw::box( const glm::mat4 &transform, const glm::vec3 &color ) noexcept {
+    std::array<glm::vec3, 8> corners;
+    for ( u32 i = 0; i < 8; ++i ) {
+      const glm::vec4 corner( i & 1 ? 0.5f : -0.5f, i & 2 ? 0.5f : -0.5f, i & 4 ? 0.5f : -0.5f,
+                              1.0f );
+      corners[ i ] = glm::vec3( transform * corner );
+    }
+
+    const auto vertices = boxLines( corners, packColor( color ) );
+    this->push( vertices.data(), vertices.size() );
+  }
+
+  void DebugDraw::sphere( const glm::vec3 &center, f32 radius, const glm::vec3 &color ) noexcept {
+    const auto packed = packColor( color );
+
+    std::array<DebugVertex, SPHERE_SEGMENTS * 2 * 3> vertices;
+    u32 count = 0;
+    for ( u32 axis = 0; axis < 3; ++axis ) {
+      // Circle in the plane of the two other axes
+      const u32 u = ( axis + 1 ) % 3;
+      const u32 v = ( axis + 2 ) % 3;
+
+      for ( u32 segment = 0; segment < SPHERE_SEGMENTS; ++segment ) {
+        for ( u32 end = 0; end < 2; ++end ) {
+          const f32 angle = glm::two_pi<f32>() * static_cast<f32>( segment + end ) /
+                            static_cast<f32>( SPHERE_SEGMENTS );
+          glm::vec3 point = center;
+          point[ u ] += std::cos( angle ) * radius;
+          point[ v ] += std::sin( angle ) * radius;
+          vertices[ count++ ] = {point, packed};
+        }
+      }
+    }
+
+    this->push( vertices.data(), vertices.size() );
+  }
+
+  void DebugDraw::frustum( const glm::mat4 &viewProjection, const glm::vec3 &color ) noexcept {
+    const auto inverse = glm::inverse( viewProjection );
+
+    std::array<glm::vec3, 8> corners;
+    for ( u32 i = 0; i < 8; ++i ) {
+      const glm::vec4 ndc( i & 1 ? 1.0f : -1.0f, i & 2 ? 1.0f : -1.0f, i & 4 ? 1.0f : -1.0f,
+                           1.0f );
+      const auto corner = inverse * ndc;
+      corners[ i ] = glm::vec3( corner ) / corner.w;
+    }
+
+    const auto vertices = boxLines( corners, packColor( color ) );
+    this->push( vertices.data(), vertices.size() );
+  }
+
+  void DebugDraw::text( const glm::vec3 &position, const std::string &text,
+                        const glm::vec3 &color, f32 size ) noexcept {
+    std::lock_guard<std::mutex> lock( m_mutex );
+    m_pendingTexts.push_back( {position, text, packColor( color ), size} );
+  }
+
+#endif
+
+  void DebugDraw::prepare( const glm::vec3 &viewDirection ) noexcept {
+
+    {
+      // The buffers of the last frame are reused for the next one
+      std::lock_guard<std::mutex> lock( m_mutex );
+      m_vertices.swap( m_pending );
+      m_pending.clear();
+      m_texts.swap( m_pendingTexts );
+      m_pendingTexts.clear();
+    }
+
+    // Texts lie in the plane facing the camera, up is kept towards +y
+    auto right = glm::cross( viewDirection, glm::vec3( 0.0f, 1.0f, 0.0f ) );
+    right = glm::dot( right, right ) > 1e-6f ? glm::normalize( right )
+                                             : glm::vec3( 1.0f, 0.0f, 0.0f );
+    const auto up = glm::normalize( glm::cross( right, viewDirection ) );
+
+    for ( const auto &text : m_texts )
+      this->addText( text, right, up );
+
+    m_stats = DebugDrawStats {};
+    m_stats.lines = static_cast<u32>( m_vertices.size() / 2 );
+    m_stats.texts = static_cast<u32>( m_texts.size() );
+  }
+
+  void DebugDraw::addText( const Text &text, const glm::vec3 &right,
+                           const glm::vec3 &up ) noexcept {
+
+    const auto width = right * ( text.size * GLYPH_WIDTH );
+    const auto height = up * text.size;
+    auto origin = text.position;
+
+    for ( const char character : text.text ) {
+      const auto upper =
+          static_cast<char>( std::toupper( static_cast<unsigned char>( character ) ) );
+
+      if ( upper >= FIRST_GLYPH && upper <= LAST_GLYPH ) {
+        for ( const char *segment = GLYPHS[ upper - FIRST_GLYPH ]; *segment; ++segment ) {
+          const auto *ends = SEGMENTS[ *segment - 'a' ];
+          m_vertices.push_back( {origin + width * ends[ 0 ] + height * ends[ 1 ], text.color} );
+          m_vertices.push_back( {origin + width * ends[ 2 ] + height * ends[ 3 ], text.color} );
+        }
+      }
+
+      origin += right * ( text.size * GLYPH_ADVANCE );
+    }
+  }
+
+  void DebugDraw::draw( RenderQueue &queue, GLStateCache &state, StreamBuffer &stream,
+                        u32 program ) noexcept {
+
+    if ( m_vertices.empty() )
+      return;
+
+    if ( !m_vao )
+      glGenVertexArrays( 1, &m_vao );
+
+    // Aligned to the vertex size, so the offset is a whole number of vertices
+    const auto bytes = m_vertices.size() * sizeof( DebugVertex );
+    const auto allocation = stream.allocate( bytes, sizeof( DebugVertex ) );
+    if ( !allocation.isValid() )
+      return;
+
+    std::memcpy( allocation.data, m_vertices.data(), bytes );
+    this->bindVertexBuffer( state, allocation.buffer );
+
+    DrawPacket packet;
+    packet.key = makeRenderKey( RenderLayer::WORLD, RenderPass::OPAQUE, program, 0, 0.0f );
+    packet.program = program;
+    packet.vertexArray = m_vao;
+    packet.first = static_cast<u32>( allocation.offset / sizeof( DebugVertex ) );
+    packet.count = static_cast<u32>( m_vertices.size() );
+    packet.primitive = PrimitiveType::LINES;
+    packet.indexed = false;
+    queue.submit( packet );
+
+    m_stats.drawCalls = 1;
+    m_stats.uploadedBytes = bytes;
+  }
+
+  void DebugDraw::bindVertexBuffer( GLStateCache &state, u32 buffer ) noexcept {
+
+    // The stream buffer only changes when it grows
+    if ( buffer == m_vertexBuffer )
+      return;
+
+    state.bindVertexArray( m_vao );
+    glBindBuffer( GL_ARRAY_BUFFER, buffer );
+
+    glEnableVertexAttribArray( 0 );
+    glVertexAttribPointer( 0, 3, GL_FLOAT, GL_FALSE, sizeof( DebugVertex ),
+                           ( void * )offsetof( DebugVertex, position ) );
+
+    glEnableVertexAttribArray( 1 );
+    glVertexAttribPointer( 1, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof( DebugVertex ),
+                           ( void * )offsetof( DebugVertex, color ) );
+
+    glBindBuffer( GL_ARRAY_BUFFER, 0 );
+    m_vertexBuffer = buffer;
+  }
+
+}    // namespace nile
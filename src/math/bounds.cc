@@ -0,0 +1,42 @@
+/* ================================================================================
+$File: bounds.cc
+$Date: $
+$Revision: $
+$Creator: Rostislav Orestis Stelmach
+$Notice: $
+================================================================================ */
+
+#include "Nile/math/bounds.hh"
+
+namespace nile::Math {
+
+  AABB computeBounds( const std::vector<Vertex> &vertices ) noexcept {
+    AABB bounds;
+    for ( const auto &vertex : vertices )
+      bounds.expand( vertex.position );
+    return bounds;
+  }
+
+  BoundingSphere computeSphere( const AABB &bounds ) noexcept {
+    if ( !bounds.isValid() )
+      return {};
+    return {bounds.center(), glm::length( bounds.extents() )};
+  }
+
+  AABB transformBounds( const AABB &bounds, const glm::mat4 &matrix ) noexcept {
+    if ( !bounds.isValid() )
+      return bounds;
+
+    const auto center = glm::vec3( matrix * glm::vec4( bounds.center(), 1.0f ) );
+    const auto extents = bounds.extents();
+
+    // Every world axis gets the absolute contribution of the local extents
+    const glm::vec3 worldExtents =
+        glm::abs( glm::vec3( matrix[ 0 ] ) ) * extents.x +
+        glm::abs( glm::vec3( matrix[ 1 ] ) ) * extents.y +
+        glm::abs( glm::vec3( matrix[ 2 ] ) ) * extents.z;
+
+    return {center - worldExtents, center + worldExtents};
+  }
+
+}    // namespace nile::Math
@@ -0,0 +1,58 @@
+/* ================================================================================
+$File: frustum.cc
+$Date: $
+$Revision: $
+$Creator: Rostislav Orestis Stelmach
+$Notice: $
+================================================================================ */
+
+#include "Nile/math/frustum.hh"
+
+namespace nile {
+
+  Frustum Frustum::fromMatrix( const glm::mat4 &viewProjection ) noexcept {
+
+    // glm matrices are column major, take the rows
+    const auto row = [&]( u32 i ) {
+      return glm::vec4( viewProjection[ 0 ][ i ], viewProjection[ 1 ][ i ],
+                        viewProjection[ 2 ][ i ], viewProjection[ 3 ][ i ] );
+    };
+
+    Frustum frustum;
+    frustum.planes[ LEFT ] = row( 3 ) + row( 0 );
+    frustum.planes[ RIGHT ] = row( 3 ) - row( 0 );
+    frustum.planes[ BOTTOM ] = row( 3 ) + row( 1 );
+    frustum.planes[ TOP ] = row( 3 ) - row( 1 );
+    frustum.planes[ NEAR ] = row( 3 ) + row( 2 );
+    frustum.planes[ FAR ] = row( 3 ) - row( 2 );
+
+    for ( auto &plane : frustum.planes ) {
+      const auto length = glm::length( glm::vec3( plane ) );
+      if ( length > 0.0f )
+        plane /= length;
+    }
+
+    return frustum;
+  }
+
+  bool Frustum::intersects( const AABB &bounds ) const noexcept {
+    for ( const auto &plane : planes ) {
+      // The corner furthest along the plane normal
+      const glm::vec3 corner( plane.x >= 0.0f ? bounds.max.x : bounds.min.x,
+                              plane.y >= 0.0f ? bounds.max.y : bounds.min.y,
+                              plane.z >= 0.0f ? bounds.max.z : bounds.min.z );
+      if ( glm::dot( glm::vec3( plane ), corner ) + plane.w < 0.0f )
+        return false;
+    }
+    return true;
+  }
+
+  bool Frustum::intersects( const BoundingSphere &sphere ) const noexcept {
+    for ( const auto &plane : planes ) {
+      if ( glm::dot( glm::vec3( plane ), sphere.center ) + plane.w < -sphere.radius )
+        return false;
+    }
+    return true;
+  }
+
+}    // namespace nile
@@ -18,9 +18,11 @@ $Notice: $
 #include "Nile/core/timer.hh"
 #include "Nile/core/transform_system.hh"
 #include "Nile/debug/benchmark_timer.hh"
+#include "Nile/debug/debug_draw.hh"
 #include "Nile/ecs/components/camera_component.hh"
 #include "Nile/ecs/components/font_component.hh"
 #include "Nile/ecs/components/mesh_component.hh"
+#include "Nile/ecs/components/point_light.hh"
 #include "Nile/ecs/components/primitive.hh"
 #include "Nile/ecs/components/relationship.hh"
 #include "Nile/ecs/components/renderable.hh"
@@ -30,12 +32,20 @@ $Notice: $
 #include "Nile/experimental/asset/asset_manager_helper.hh"
 #include "Nile/renderer/base_renderer.hh"
 #include "Nile/renderer/font_rendering_system.hh"
-#include "Nile/renderer/opengl_framebuffer.hh"
+#include "Nile/renderer/gl_state_cache.hh"
+#include "Nile/renderer/gpu_profiler.hh"
+#include "Nile/renderer/headless_renderer.hh"
+#include "Nile/renderer/lighting_system.hh"
 #include "Nile/renderer/opengl_renderer.hh"
+#include "Nile/renderer/render_graph.hh"
 #include "Nile/renderer/render_primitive_system.hh"
+#include "Nile/renderer/render_queue.hh"
 #include "Nile/renderer/rendering_system.hh"
+#include "Nile/renderer/resolution_scaler.hh"
 #include "Nile/renderer/sprite_rendering_system.hh"
+#include "Nile/renderer/stream_buffer.hh"
 #include "Nile/renderer/texture2d.hh"
+#include "Nile/scene/scene_graph.hh"
 #include "spdlog/common.h"
 
 #include <GL/glew.h>
@@ -43,6 +53,8 @@ $Notice: $
 #include <spdlog/sinks/basic_file_sink.h>
 #include <spdlog/spdlog.h>
 
+#include <algorithm>
+#include <cmath>
 #include <thread>
 
 namespace nile::X11 {
@@ -52,12 +64,17 @@ namespace nile::X11 {
     // Just to keep things orginized
     void initializ_ecs_subsystems() noexcept;
 
-    std::unique_ptr<OpenglFramebuffer> frame_buffer_;
+    // Scene pass into a scaled target, then the screen pass that blits it
+    RenderGraph render_graph_;
+    RenderResource scene_target_ = RenderGraph::BACKBUFFER;
+    // Render scale of the scene target, from the frame time budget of the settings
+    ResolutionScaler resolution_scaler_;
 
     std::shared_ptr<RenderingSystem> rendering_system_;
     std::shared_ptr<SpriteRenderingSystem> sprite_rendering_system_;
     std::shared_ptr<RenderPrimitiveSystem> rendering_primitive_system_;
     std::shared_ptr<FontRenderingSystem> font_rendering_system_;
+    std::shared_ptr<LightingSystem> lighting_system_;
     std::shared_ptr<TransformSystem> transform_system_;
 
     std::shared_ptr<AssetManagerHelper> assets_manager_helper_;
@@ -77,10 +94,12 @@ namespace nile::X11 {
     std::shared_ptr<InputManager> input_manager;
     std::shared_ptr<AssetManager> assets_manager;
     std::shared_ptr<Coordinator> ecs_coordinator;
+    std::shared_ptr<SceneGraph> scene_graph;
   };
 
   GameHostX11::Impl::Impl( const std::shared_ptr<Settings> &settings ) noexcept
-      : settings( settings ) {
+      : resolution_scaler_( settings->getFrameTimeBudget(), settings->getMinRenderScale() )
+      , settings( settings ) {
 
     // @IMPORTANT FIX(stel): correct the orrder of creation and initialization
     // of systems and subsystems ESPECIALLY RENDERING SYSTEM
@@ -94,16 +113,25 @@ namespace nile::X11 {
     ( input_manager ) ? spdlog::info( "input_manager has been created!" )
                       : spdlog::critical( "Engine has failed to create input_manager!" );
 
-    renderer = std::make_shared<OpenGLRenderer>( settings );
+    // Headless renders offscreen through EGL, e.g. on CI servers without a display
+    if ( settings->getHeadless() )
+      renderer = std::make_shared<HeadlessRenderer>( settings );
+    else
+      renderer = std::make_shared<OpenGLRenderer>( settings );
     renderer->init();
 
     ( renderer ) ? spdlog::info( "OpenGL Renderer has been created and initialized!" )
                  : spdlog::critical( "Engine has failed to create OpenGL Renderer!" );
 
-    frame_buffer_ = std::make_unique<OpenglFramebuffer>( settings );
-    frame_buffer_->prepareQuad();
-    ( frame_buffer_ ) ? spdlog::info( "OpenGL Frambuffer has been created and initialized!" )
-                      : spdlog::critical( "Engine has failed to create OpenGL Framebuffer!" );
+    RenderTargetDesc scene_desc;
+    scene_desc.width = settings->getWidth();
+    scene_desc.height = settings->getHeight();
+    RenderClear scene_clear;
+    scene_clear.color = true;
+    scene_clear.depth = true;
+    scene_clear.colorValue = glm::vec4( 0.1f, 0.1f, 0.1f, 1.0f );
+    scene_target_ = render_graph_.createTarget( "scene", scene_desc, scene_clear );
+    render_graph_.setBackbufferSize( settings->getWidth(), settings->getHeight() );
 
 
     assets_manager = std::make_shared<AssetManager>();
@@ -151,7 +179,7 @@ namespace nile::X11 {
     framebuffer_screen_shader_ = assets_manager->storeAsset<ShaderSet>(
         "fb_screen_shader", assets_manager->createBuilder<ShaderSet>()
                                 .setVertexPath( FileSystem::getBinaryDir() +
-                                                "/resources/shaders/screen_fb_vertex.glsl" )
+                                                "/resources/shaders/fullscreen_vertex.glsl" )
                                 .setFragmentPath( FileSystem::getBinaryDir() +
                                                   "/resources/shaders/screen_fb_fragment.glsl" )
                                 .build() );
@@ -171,31 +199,46 @@ namespace nile::X11 {
     ecs_coordinator->registerComponent<MeshComponent>();
     ecs_coordinator->registerComponent<FontComponent>();
     ecs_coordinator->registerComponent<Relationship>();
+    ecs_coordinator->registerComponent<PointLight>();
 
     // Output some logs to know which components has been registered by the engine
     spdlog::info( "Registered ECS components by the engine: "
                   "[ Transform, Renderable, SpriteComponent, CameraComponent, Primitive, "
-                  "MeshComponent, FontComponent, Renletionship ]" );
+                  "MeshComponent, FontComponent, Renletionship, PointLight ]" );
+
+    const auto gl_state = renderer->getStateCache();
+    const auto render_queue = renderer->getRenderQueue();
+    const auto stream_buffer = renderer->getStreamBuffer();
 
     rendering_system_ = ecs_coordinator->registerSystem<RenderingSystem>(
-        ecs_coordinator, assets_manager->getAsset<ShaderSet>( "model_shader" ) );
+        ecs_coordinator, gl_state, render_queue, stream_buffer,
+        assets_manager->getAsset<ShaderSet>( "model_shader" ) );
 
     sprite_rendering_system_ = ecs_coordinator->registerSystem<SpriteRenderingSystem>(
-        ecs_coordinator, assets_manager->getAsset<ShaderSet>( "model_shader" ) );
+        ecs_coordinator, gl_state, render_queue, stream_buffer,
+        assets_manager->getAsset<ShaderSet>( "model_shader" ) );
 
     rendering_primitive_system_ = ecs_coordinator->registerSystem<RenderPrimitiveSystem>(
-        ecs_coordinator, assets_manager->getAsset<ShaderSet>( "line_shader" ) );
+        ecs_coordinator, gl_state, render_queue, stream_buffer, renderer->getDebugDraw(),
+        assets_manager->getAsset<ShaderSet>( "line_shader" ) );
 
     font_rendering_system_ = ecs_coordinator->registerSystem<FontRenderingSystem>(
-        ecs_coordinator, settings, assets_manager->getAsset<ShaderSet>( "font_shader" ) );
+        ecs_coordinator, settings, gl_state, render_queue, assets_manager,
+        assets_manager->getAsset<ShaderSet>( "font_shader" ) );
+
+    scene_graph = std::make_shared<SceneGraph>();
+    transform_system_ =
+        ecs_coordinator->registerSystem<TransformSystem>( ecs_coordinator, scene_graph );
 
-    transform_system_ = ecs_coordinator->registerSystem<TransformSystem>( ecs_coordinator );
+    auto cameraSystem = ecs_coordinator->registerSystem<CameraSystem>(
+        ecs_coordinator, settings, render_queue, renderer->getFrameUniforms() );
 
-    auto cameraSystem = ecs_coordinator->registerSystem<CameraSystem>( ecs_coordinator, settings );
+    lighting_system_ = ecs_coordinator->registerSystem<LightingSystem>(
+        ecs_coordinator, settings, gl_state, renderer->getFrameUniforms() );
 
     spdlog::info(
         "Registered ECS systems by the engine: "
-        "[ SpriteRenderingSystem, RenderingPrimitiveSystem, RenderingSystem, CameraSystem, TransformSystem ]" );
+        "[ SpriteRenderingSystem, RenderingPrimitiveSystem, RenderingSystem, CameraSystem, TransformSystem, LightingSystem ]" );
 
     Signature sprite_signature;
     sprite_signature.set( ecs_coordinator->getComponentType<Transform>() );
@@ -228,9 +271,14 @@ namespace nile::X11 {
 
     Signature transform_signature;
     transform_signature.set( ecs_coordinator->getComponentType<Transform>() );
-    transform_signature.set( ecs_coordinator->getComponentType<Relationship>() );
+    transform_signature.set( ecs_coordinator->getComponentType<MeshComponent>() );
     ecs_coordinator->setSystemSignature<TransformSystem>( transform_signature );
 
+    Signature lighting_signature;
+    lighting_signature.set( ecs_coordinator->getComponentType<Transform>() );
+    lighting_signature.set( ecs_coordinator->getComponentType<PointLight>() );
+    ecs_coordinator->setSystemSignature<LightingSystem>( lighting_signature );
+
   }
 
   GameHostX11::Impl::~Impl() noexcept {}
@@ -239,6 +287,15 @@ namespace nile::X11 {
 
     game.initialize();
     ecs_coordinator->createSystems();
+
+    // The game has loaded its textures by now
+    const auto &texture_memory = Texture2D::getMemoryStats();
+    spdlog::info( "Textures: {}, {:.2f} MiB, mip chains {:.2f} MiB ( +{:.0f}% )",
+                  texture_memory.textures, texture_memory.baseBytes / ( 1024.0 * 1024.0 ),
+                  texture_memory.mipBytes / ( 1024.0 * 1024.0 ),
+                  texture_memory.baseBytes ? 100.0 * texture_memory.mipBytes /
+                                                 texture_memory.baseBytes
+                                           : 0.0 );
     f64 lastStep = SDL_GetTicks();
 
     // draw wireframe
@@ -246,41 +303,95 @@ namespace nile::X11 {
 
     // u32 frame = 0;
 
-    while ( !input_manager->shouldClose() ) {
-
-      //  log::print("[%d]\n", frame++);
+    const auto gl_state = renderer->getStateCache();
+    const auto render_queue = renderer->getRenderQueue();
+    const auto stream_buffer = renderer->getStreamBuffer();
+    const auto gpu_profiler = renderer->getGpuProfiler();
 
-      f64 currentStep = SDL_GetTicks();
-      f64 delta = currentStep - lastStep;    // elapsed time
+    // Benchmarks and golden image runs stop after a fixed number of frames
+    const auto frame_limit = settings->getFrameLimit();
+    const f64 first_step = lastStep;
+    u32 frames = 0;
 
-      input_manager->update( delta );
+    f64 delta = 0.0;
 
-      // @fix(stel) : move all of these framebuffer related stuff
-      // to the framebuffer class
-      renderer->submitFrame();
-      frame_buffer_->bind();
-      glEnable( GL_DEPTH_TEST );
-      glClearColor( 0.1f, 0.1f, 0.1f, 1.0f );
-      //     glClearColor( 0.635f, 0.851f, 0.808f, 1.0f );
-      glClear( GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT );
+    const auto scene_pass = [ & ]( RenderPassContext &pass ) {
+      lighting_system_->setViewport( glm::vec2( pass.getWidth(), pass.getHeight() ) );
+      pass.getState().setDepthTest( true );
 
       ecs_coordinator->update( delta );
+      // Render systems only submit packets, they are sorted and drawn here
       ecs_coordinator->render( delta );
+      stream_buffer->flush();
+      render_queue->execute( pass.getState(), gpu_profiler.get() );
 
       game.update( delta );
+    };
+
+    const auto screen_pass = [ this ]( RenderPassContext &pass ) {
+      auto &state = pass.getState();
+      state.setDepthTest( false );
+      state.useProgram( framebuffer_screen_shader_->getProgramId() );
+      state.setBlend( true );
+      state.setCullFace( false );
+      pass.drawFullscreen();
+    };
+
+    // The game updates in the scene pass, it runs even if nothing reads the target.
+    // renderer->submitFrame() clears the screen, the screen pass covers it anyway
+    render_graph_.addPass( "scene", scene_pass ).write( scene_target_ ).setSideEffects();
+    render_graph_.addPass( "screen blit", screen_pass )
+        .read( scene_target_ )
+        .write( RenderGraph::BACKBUFFER );
+
+    u32 screen_width = settings->getWidth();
+    u32 screen_height = settings->getHeight();
 
-      frame_buffer_->unbind();
-      glDisable( GL_DEPTH_TEST );
-      glClearColor( 1.0f, 1.0f, 1.0f, 1.0f );
-      glClear( GL_COLOR_BUFFER_BIT );
+    while ( !input_manager->shouldClose() && ( frame_limit == 0 || frames < frame_limit ) ) {
 
-      framebuffer_screen_shader_->use();
-      frame_buffer_->submitFrame();
+      //  log::print("[%d]\n", frame++);
+
+      f64 currentStep = SDL_GetTicks();
+      delta = currentStep - lastStep;    // elapsed time
+
+      input_manager->update( delta );
+
+      // The scene target follows the window and the render scale
+      if ( auto *window = renderer->getWindow() ) {
+        int width = 0;
+        int height = 0;
+        SDL_GL_GetDrawableSize( window, &width, &height );
+        if ( width > 0 && height > 0 ) {
+          screen_width = static_cast<u32>( width );
+          screen_height = static_cast<u32>( height );
+        }
+      }
+
+      // GPU time of the frame when timer queries work, a few frames late, else CPU time
+      const f32 frame_time = gpu_profiler->getStats().supported
+                                 ? gpu_profiler->getTime( "frame" )
+                                 : static_cast<f32>( delta );
+      const f32 render_scale = resolution_scaler_.update( frame_time );
+      render_graph_.setBackbufferSize( screen_width, screen_height );
+      render_graph_.setTargetSize(
+          scene_target_,
+          std::max( 1u, static_cast<u32>( std::lround( screen_width * render_scale ) ) ),
+          std::max( 1u, static_cast<u32>( std::lround( screen_height * render_scale ) ) ) );
+
+      renderer->submitFrame();
+      render_graph_.execute( *gl_state, gpu_profiler.get() );
       renderer->endFrame();
 
       program_mode_ = settings->getProgramMode();
 
       lastStep = currentStep;
+      ++frames;
+    }
+
+    if ( frame_limit != 0 ) {
+      const f64 elapsed = SDL_GetTicks() - first_step;
+      spdlog::info( "{} frames in {} ms, {:.3f} ms per frame", frames, elapsed,
+                    frames ? elapsed / frames : 0.0 );
     }
   }
 
@@ -316,4 +427,8 @@ namespace nile::X11 {
     return this->impl->ecs_coordinator;
   }
 
+  [[nodiscard]] std::shared_ptr<SceneGraph> GameHostX11::get_scene_graph() const noexcept {
+    return this->impl->scene_graph;
+  }
+
 }    // namespace nile::X11
@@ -0,0 +1,410 @@
+/* ================================================================================
+$File: clustered_lights.cc
+$Date: $
+$Revision: $
+$Creator: Rostislav Orestis Stelmach
+$Notice: $
+================================================================================ */
+
+#include "Nile/renderer/clustered_lights.hh"
+#include "Nile/core/parallel.hh"
+#include "Nile/renderer/gl_state_cache.hh"
+
+#include <GL/glew.h>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#if defined( __SSE__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 1 )
+#define NILE_CLUSTER_SSE 1
+#include <xmmintrin.h>
+#endif
+
+namespace nile {
+
+  namespace {
+
+    constexpr u32 LANES = 4;
+
+    // Lights darker than one step of an 8 bit channel are not visible
+    constexpr f32 CUTOFF = 1.0f / 256.0f;
+
+    enum LightBuffer : u32 { LIGHTS = 0, CLUSTERS = 1, INDICES = 2 };
+
+    void uploadBuffer( u32 buffer, usize bytes, const void *data ) noexcept {
+      glBindBuffer( GL_TEXTURE_BUFFER, buffer );
+      // Orphan the storage of the last frame, the lists are rewritten every frame.
+      // Empty lists still get a few bytes, so the texture always has storage.
+      glBufferData( GL_TEXTURE_BUFFER, std::max<usize>( bytes, 16 ), nullptr, GL_STREAM_DRAW );
+      if ( bytes > 0 )
+        glBufferSubData( GL_TEXTURE_BUFFER, 0, bytes, data );
+    }
+
+    // Range of tiles covered by [ lo, hi ] in normalized device coordinates, false if
+    // the range is outside of the screen
+    bool tileRange( f32 lo, f32 hi, u32 tiles, u32 &first, u32 &last ) noexcept {
+      if ( hi < -1.0f || lo > 1.0f )
+        return false;
+
+      const auto tile = [ tiles ]( f32 ndc ) {
+        const f32 t = ( std::clamp( ndc, -1.0f, 1.0f ) + 1.0f ) * 0.5f * tiles;
+        return std::min( static_cast<u32>( t ), tiles - 1 );
+      };
+
+      first = tile( lo );
+      last = tile( hi );
+      return true;
+    }
+
+    // Distance from the center to a box along one axis, zero inside of the slab
+    f32 axisDistance( f32 lo, f32 hi, f32 center ) noexcept {
+      return std::max( lo - center, 0.0f ) + std::max( center - hi, 0.0f );
+    }
+
+#if defined( NILE_CLUSTER_SSE )
+    __m128 axisDistance( const f32 *lo, const f32 *hi, __m128 center ) noexcept {
+      const __m128 zero = _mm_setzero_ps();
+      return _mm_add_ps( _mm_max_ps( _mm_sub_ps( _mm_loadu_ps( lo ), center ), zero ),
+                         _mm_max_ps( _mm_sub_ps( center, _mm_loadu_ps( hi ) ), zero ) );
+    }
+#endif
+
+  }    // namespace
+
+  ClusteredLights::~ClusteredLights() noexcept {
+    if ( m_buffers[ LIGHTS ] ) {
+      glDeleteTextures( 3, m_textures );
+      glDeleteBuffers( 3, m_buffers );
+    }
+  }
+
+  void ClusteredLights::setProjection( const glm::mat4 &projection,
+                                       const glm::vec2 &viewport ) noexcept {
+    if ( projection == m_projection && viewport == m_viewport )
+      return;
+
+    m_projection = projection;
+    m_viewport = viewport;
+
+    // Perspective projections copy -z into w, orthographic ones leave w alone
+    m_perspective = projection[ 2 ][ 3 ] != 0.0f;
+
+    if ( m_perspective ) {
+      m_near = projection[ 3 ][ 2 ] / ( projection[ 2 ][ 2 ] - 1.0f );
+      m_far = projection[ 3 ][ 2 ] / ( projection[ 2 ][ 2 ] + 1.0f );
+
+      // Slice z starts at near * ( far / near ) ^ ( z / CLUSTERS_Z )
+      const f32 logRatio = std::log( m_far / m_near );
+      m_sliceScale = CLUSTERS_Z / logRatio;
+      m_sliceBias = -( CLUSTERS_Z * std::log( m_near ) ) / logRatio;
+    } else {
+      m_near = m_far = m_sliceScale = m_sliceBias = 0.0f;
+    }
+
+    this->buildClusters();
+  }
+
+  void ClusteredLights::buildClusters() noexcept {
+
+    const usize padded = CLUSTER_COUNT + LANES - 1;
+    for ( auto *coordinates : {&m_minX, &m_minY, &m_minZ, &m_maxX, &m_maxY, &m_maxZ} )
+      coordinates->assign( padded, 0.0f );
+
+    if ( !m_perspective )
+      return;
+
+    const auto inverse = glm::inverse( m_projection );
+
+    // View space direction through a corner of a tile, scaled to a depth of 1
+    const auto ray = [ &inverse ]( u32 x, u32 y ) {
+      const glm::vec4 ndc( -1.0f + 2.0f * x / CLUSTERS_X, -1.0f + 2.0f * y / CLUSTERS_Y, -1.0f,
+                           1.0f );
+      const auto point = inverse * ndc;
+      return glm::vec3( point ) / -point.z;
+    };
+
+    for ( u32 z = 0; z < CLUSTERS_Z; ++z ) {
+      const f32 nearDepth = m_near * std::pow( m_far / m_near, f32( z ) / CLUSTERS_Z );
+      const f32 farDepth = m_near * std::pow( m_far / m_near, f32( z + 1 ) / CLUSTERS_Z );
+
+      for ( u32 y = 0; y < CLUSTERS_Y; ++y ) {
+        for ( u32 x = 0; x < CLUSTERS_X; ++x ) {
+          glm::vec3 lo( std::numeric_limits<f32>::max() );
+          glm::vec3 hi( std::numeric_limits<f32>::lowest() );
+
+          for ( u32 corner = 0; corner < 4; ++corner ) {
+            const auto direction = ray( x + ( corner & 1 ), y + ( corner >> 1 ) );
+            for ( const auto depth : {nearDepth, farDepth} ) {
+              lo = glm::min( lo, direction * depth );
+              hi = glm::max( hi, direction * depth );
+            }
+          }
+
+          const auto index = clusterIndex( x, y, z );
+          m_minX[ index ] = lo.x;
+          m_minY[ index ] = lo.y;
+          m_minZ[ index ] = lo.z;
+          m_maxX[ index ] = hi.x;
+          m_maxY[ index ] = hi.y;
+          m_maxZ[ index ] = hi.z;
+        }
+      }
+    }
+  }
+
+  u32 ClusteredLights::slice( f32 depth ) const noexcept {
+    const f32 s = std::log( depth ) * m_sliceScale + m_sliceBias;
+    return std::min( static_cast<u32>( std::max( s, 0.0f ) ), CLUSTERS_Z - 1 );
+  }
+
+  void ClusteredLights::begin() noexcept {
+    m_lights.clear();
+  }
+
+  void ClusteredLights::add( const PointLightData &light ) noexcept {
+    if ( light.position.w > 0.0f )
+      m_lights.push_back( light );
+  }
+
+  void ClusteredLights::assign( const glm::mat4 &view ) noexcept {
+    this->assignLights( view, true );
+  }
+
+  void ClusteredLights::assignScalar( const glm::mat4 &view ) noexcept {
+    this->assignLights( view, false );
+  }
+
+  void ClusteredLights::assignLights( const glm::mat4 &view, bool simd ) noexcept {
+
+    m_stats = ClusteredLightsStats {};
+    m_stats.lights = this->size();
+
+    // The lights share nothing until compact(), every worker takes a contiguous range
+    // and the bins are compacted in order, so the lists don't depend on the threads
+    const u32 threads = m_threads ? m_threads : hardwareThreads();
+    const u32 count = this->size();
+    const u32 bins = count >= PARALLEL_LIGHTS ? std::min( threads, count ) : 1;
+
+    m_bins.resize( bins );
+    parallelFor( bins, bins, [ & ]( u32 begin, u32 end ) {
+      for ( u32 bin = begin; bin < end; ++bin ) {
+        const u32 first = static_cast<u32>( u64( count ) * bin / bins );
+        const u32 last = static_cast<u32>( u64( count ) * ( bin + 1 ) / bins );
+        this->assignRange( view, first, last, simd, m_bins[ bin ] );
+      }
+    } );
+
+    for ( const auto &bin : m_bins )
+      m_stats.visibleLights += bin.visibleLights;
+
+    this->compact();
+  }
+
+  void ClusteredLights::assignRange( const glm::mat4 &view, u32 begin, u32 end, bool simd,
+                                     Bin &bin ) noexcept {
+
+    bin.entries.clear();
+    bin.visibleLights = 0;
+
+    const f32 scaleX = m_projection[ 0 ][ 0 ];
+    const f32 scaleY = m_projection[ 1 ][ 1 ];
+    const f32 offsetX = m_projection[ 2 ][ 0 ];
+    const f32 offsetY = m_projection[ 2 ][ 1 ];
+
+    for ( u32 light = begin; light < end; ++light ) {
+
+      // The orthographic shader lookup always lands in the first slice
+      if ( !m_perspective ) {
+        for ( u32 y = 0; y < CLUSTERS_Y; ++y ) {
+          for ( u32 x = 0; x < CLUSTERS_X; ++x )
+            bin.entries.push_back( {clusterIndex( x, y, 0 ), light} );
+        }
+        ++bin.visibleLights;
+        continue;
+      }
+
+      const auto &data = m_lights[ light ];
+      const f32 radius = data.position.w;
+      const glm::vec3 center( view * glm::vec4( glm::vec3( data.position ), 1.0f ) );
+      const f32 depth = -center.z;
+
+      if ( depth + radius < m_near || depth - radius > m_far )
+        continue;
+
+      const f32 zMin = std::max( depth - radius, m_near );
+      const f32 zMax = std::min( depth + radius, m_far );
+
+      // Screen rectangle of the view space box around the sphere, x / depth is the
+      // largest and the smallest at the corners of the box
+      const auto project = [ zMin, zMax ]( f32 c, f32 r, f32 scale, f32 offset, f32 &lo,
+                                           f32 &hi ) {
+        lo = std::min( ( c - r ) / zMin, ( c - r ) / zMax ) * scale - offset;
+        hi = std::max( ( c + r ) / zMin, ( c + r ) / zMax ) * scale - offset;
+      };
+
+      f32 loX, hiX, loY, hiY;
+      project( center.x, radius, scaleX, offsetX, loX, hiX );
+      project( center.y, radius, scaleY, offsetY, loY, hiY );
+
+      u32 firstX, lastX, firstY, lastY;
+      if ( !tileRange( loX, hiX, CLUSTERS_X, firstX, lastX ) ||
+           !tileRange( loY, hiY, CLUSTERS_Y, firstY, lastY ) )
+        continue;
+
+      const auto entries = bin.entries.size();
+      const auto firstZ = this->slice( zMin );
+      const auto lastZ = this->slice( zMax );
+
+      for ( u32 z = firstZ; z <= lastZ; ++z ) {
+        for ( u32 y = firstY; y <= lastY; ++y )
+          this->testRow( clusterIndex( 0, y, z ), firstX, lastX, center, radius, light, simd,
+                         bin.entries );
+      }
+
+      if ( bin.entries.size() != entries )
+        ++bin.visibleLights;
+    }
+  }
+
+  void ClusteredLights::testRow( u32 row, u32 first, u32 last, const glm::vec3 &center,
+                                 f32 radius, u32 light, bool simd,
+                                 std::vector<Entry> &entries ) const noexcept {
+
+    const f32 radius2 = radius * radius;
+
+#if defined( NILE_CLUSTER_SSE )
+    if ( simd ) {
+      const __m128 cx = _mm_set1_ps( center.x );
+      const __m128 cy = _mm_set1_ps( center.y );
+      const __m128 cz = _mm_set1_ps( center.z );
+      const __m128 r2 = _mm_set1_ps( radius2 );
+
+      for ( u32 x = first; x <= last; x += LANES ) {
+        const u32 i = row + x;
+
+        const __m128 dx = axisDistance( &m_minX[ i ], &m_maxX[ i ], cx );
+        const __m128 dy = axisDistance( &m_minY[ i ], &m_maxY[ i ], cy );
+        const __m128 dz = axisDistance( &m_minZ[ i ], &m_maxZ[ i ], cz );
+        const __m128 distance2 = _mm_add_ps(
+            _mm_add_ps( _mm_mul_ps( dx, dx ), _mm_mul_ps( dy, dy ) ), _mm_mul_ps( dz, dz ) );
+
+        // Lanes past the last tile belong to the next row and are masked out
+        const u32 lanes = std::min( LANES, last - x + 1 );
+        const auto mask = static_cast<u32>( _mm_movemask_ps( _mm_cmple_ps( distance2, r2 ) ) );
+        for ( u32 lane = 0; lane < lanes; ++lane ) {
+          if ( mask & ( 1u << lane ) )
+            entries.push_back( {i + lane, light} );
+        }
+      }
+      return;
+    }
+#else
+    ( void )simd;
+#endif
+
+    for ( u32 x = first; x <= last; ++x ) {
+      const u32 i = row + x;
+      const f32 dx = axisDistance( m_minX[ i ], m_maxX[ i ], center.x );
+      const f32 dy = axisDistance( m_minY[ i ], m_maxY[ i ], center.y );
+      const f32 dz = axisDistance( m_minZ[ i ], m_maxZ[ i ], center.z );
+
+      if ( dx * dx + dy * dy + dz * dz <= radius2 )
+        entries.push_back( {i, light} );
+    }
+  }
+
+  void ClusteredLights::compact() noexcept {
+
+    // Counting sort of the entries by cluster, the lights of a cluster stay in the
+    // order they were added
+    m_clusters.assign( CLUSTER_COUNT * 2, 0 );
+    for ( const auto &bin : m_bins ) {
+      for ( const auto &entry : bin.entries )
+        ++m_clusters[ entry.cluster * 2 + 1 ];
+    }
+
+    u32 offset = 0;
+    for ( u32 cluster = 0; cluster < CLUSTER_COUNT; ++cluster ) {
+      const auto count = m_clusters[ cluster * 2 + 1 ];
+      const auto kept = std::min( count, MAX_LIGHTS_PER_CLUSTER );
+
+      m_stats.droppedEntries += count - kept;
+      m_stats.maxPerCluster = std::max( m_stats.maxPerCluster, kept );
+
+      m_clusters[ cluster * 2 ] = offset;
+      // Counted again while the indices are written
+      m_clusters[ cluster * 2 + 1 ] = 0;
+      offset += kept;
+    }
+
+    m_indices.resize( offset );
+    for ( const auto &bin : m_bins ) {
+      for ( const auto &entry : bin.entries ) {
+        auto &count = m_clusters[ entry.cluster * 2 + 1 ];
+        if ( count < MAX_LIGHTS_PER_CLUSTER )
+          m_indices[ m_clusters[ entry.cluster * 2 ] + count++ ] = entry.light;
+      }
+    }
+
+    m_stats.entries = offset;
+  }
+
+  void ClusteredLights::upload() noexcept {
+
+    if ( !m_buffers[ LIGHTS ] ) {
+      glGenBuffers( 3, m_buffers );
+      glGenTextures( 3, m_textures );
+
+      const u32 formats[ 3 ] = {GL_RGBA32F, GL_RG32UI, GL_R32UI};
+      for ( u32 i = 0; i < 3; ++i ) {
+        uploadBuffer( m_buffers[ i ], 0, nullptr );
+        glBindTexture( GL_TEXTURE_BUFFER, m_textures[ i ] );
+        glTexBuffer( GL_TEXTURE_BUFFER, formats[ i ], m_buffers[ i ] );
+      }
+      glBindTexture( GL_TEXTURE_BUFFER, 0 );
+
+      spdlog::debug( "Clustered light buffers have been created." );
+    }
+
+    const usize lightBytes = m_lights.size() * sizeof( PointLightData );
+    const usize clusterBytes = m_clusters.size() * sizeof( u32 );
+    const usize indexBytes = m_indices.size() * sizeof( u32 );
+
+    uploadBuffer( m_buffers[ LIGHTS ], lightBytes, m_lights.data() );
+    uploadBuffer( m_buffers[ CLUSTERS ], clusterBytes, m_clusters.data() );
+    uploadBuffer( m_buffers[ INDICES ], indexBytes, m_indices.data() );
+    glBindBuffer( GL_TEXTURE_BUFFER, 0 );
+
+    m_stats.uploadedBytes = lightBytes + clusterBytes + indexBytes;
+  }
+
+  void ClusteredLights::bind( GLStateCache &state ) const noexcept {
+    state.bindTextureBuffer( LIGHTS_UNIT, m_textures[ LIGHTS ] );
+    state.bindTextureBuffer( CLUSTERS_UNIT, m_textures[ CLUSTERS ] );
+    state.bindTextureBuffer( INDICES_UNIT, m_textures[ INDICES ] );
+  }
+
+  f32 ClusteredLights::computeRange( const glm::vec3 &attenuation, f32 intensity ) noexcept {
+
+    // Solve constant + linear * d + quadratic * d^2 = intensity / CUTOFF
+    const f32 c = attenuation.x - intensity / CUTOFF;
+    const f32 l = attenuation.y;
+    const f32 q = attenuation.z;
+
+    // Never brighter than the cutoff
+    if ( c >= 0.0f )
+      return 0.0f;
+
+    if ( q > 0.0f )
+      return ( -l + std::sqrt( l * l - 4.0f * q * c ) ) / ( 2.0f * q );
+
+    if ( l > 0.0f )
+      return -c / l;
+
+    // No attenuation, the light reaches everything
+    return std::numeric_limits<f32>::max();
+  }
+
+}    // namespace nile
@@ -0,0 +1,117 @@
+/* ================================================================================
+$File: frame_uniforms.cc
+$Date: $
+$Revision: $
+$Creator: Rostislav Orestis Stelmach
+$Notice: $
+================================================================================ */
+
+#include "Nile/renderer/frame_uniforms.hh"
+
+#include <GL/glew.h>
+#include <spdlog/spdlog.h>
+
+#include <cstring>
+
+namespace nile {
+
+  namespace {
+
+    u32 createBuffer( UniformBinding binding, usize size ) noexcept {
+      u32 buffer = 0;
+      glGenBuffers( 1, &buffer );
+      glBindBuffer( GL_UNIFORM_BUFFER, buffer );
+      glBufferData( GL_UNIFORM_BUFFER, size, nullptr, GL_DYNAMIC_DRAW );
+      glBindBuffer( GL_UNIFORM_BUFFER, 0 );
+
+      // Binding points are not touched by anything else, so this is done only once
+      glBindBufferBase( GL_UNIFORM_BUFFER, static_cast<u32>( binding ), buffer );
+      return buffer;
+    }
+
+    void bindBlock( u32 program, const char *name, UniformBinding binding ) noexcept {
+      const auto index = glGetUniformBlockIndex( program, name );
+      if ( index != GL_INVALID_INDEX )
+        glUniformBlockBinding( program, index, static_cast<u32>( binding ) );
+    }
+
+  }    // namespace
+
+  FrameUniforms::~FrameUniforms() noexcept {
+    if ( m_cameraBuffer ) {
+      glDeleteBuffers( 1, &m_cameraBuffer );
+      glDeleteBuffers( 1, &m_lightBuffer );
+    }
+  }
+
+  void FrameUniforms::setCamera( const glm::mat4 &view, const glm::mat4 &projection,
+                                 const glm::vec3 &position ) noexcept {
+    CameraBlock camera;
+    camera.view = view;
+    camera.projection = projection;
+    camera.viewProjection = projection * view;
+    camera.viewPosition = glm::vec4( position, 1.0f );
+
+    // A camera that does not move does not have to be uploaded again
+    if ( std::memcmp( &camera, &m_camera, sizeof( CameraBlock ) ) != 0 ) {
+      m_camera = camera;
+      m_cameraDirty = true;
+    }
+  }
+
+  void FrameUniforms::setDirectionalLight( const DirectionalLightData &light ) noexcept {
+    m_lights.directionalLight = light;
+    m_lightsDirty = true;
+  }
+
+  void FrameUniforms::setClusters( const glm::uvec4 &grid, const glm::vec4 &depth,
+                                   const glm::vec2 &size ) noexcept {
+    const glm::vec4 clusterSize( size, 0.0f, 0.0f );
+
+    // Same grid as the last frame, only the light lists changed
+    if ( grid == m_lights.clusterGrid && depth == m_lights.clusterDepth &&
+         clusterSize == m_lights.clusterSize )
+      return;
+
+    m_lights.clusterGrid = grid;
+    m_lights.clusterDepth = depth;
+    m_lights.clusterSize = clusterSize;
+    m_lightsDirty = true;
+  }
+
+  void FrameUniforms::upload() noexcept {
+
+    m_stats = FrameUniformsStats {};
+
+    if ( !m_cameraBuffer ) {
+      m_cameraBuffer = createBuffer( UniformBinding::CAMERA, sizeof( CameraBlock ) );
+      m_lightBuffer = createBuffer( UniformBinding::LIGHTS, sizeof( LightBlock ) );
+      spdlog::debug( "Frame uniform buffers have been created." );
+    }
+
+    if ( m_cameraDirty ) {
+      glBindBuffer( GL_UNIFORM_BUFFER, m_cameraBuffer );
+      glBufferSubData( GL_UNIFORM_BUFFER, 0, sizeof( CameraBlock ), &m_camera );
+      m_cameraDirty = false;
+      ++m_stats.uploads;
+      m_stats.uploadedBytes += sizeof( CameraBlock );
+    }
+
+    // The block is small, so the whole of it is sent when something changed
+    if ( m_lightsDirty ) {
+      glBindBuffer( GL_UNIFORM_BUFFER, m_lightBuffer );
+      glBufferSubData( GL_UNIFORM_BUFFER, 0, sizeof( LightBlock ), &m_lights );
+      m_lightsDirty = false;
+      ++m_stats.uploads;
+      m_stats.uploadedBytes += sizeof( LightBlock );
+    }
+
+    glBindBuffer( GL_UNIFORM_BUFFER, 0 );
+  }
+
+  void FrameUniforms::bindUniformBlocks( u32 program ) noexcept {
+    bindBlock( program, "Camera", UniformBinding::CAMERA );
+    bindBlock( program, "Lights", UniformBinding::LIGHTS );
+  }
+
+}    // namespace nile
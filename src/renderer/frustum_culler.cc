@@ -0,0 +1,124 @@
+/* ================================================================================
+$File: frustum_culler.cc
+$Date: $
+$Revision: $
+$Creator: Rostislav Orestis Stelmach
+$Notice: $
+================================================================================ */
+
+#include "Nile/renderer/frustum_culler.hh"
+
+#include <limits>
+
+#if defined( __SSE__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 1 )
+#define NILE_CULL_SSE 1
+#include <xmmintrin.h>
+#endif
+
+namespace nile {
+
+  namespace {
+
+    constexpr u32 LANES = 4;
+
+    struct PlaneInputs {
+      const f32 *x;
+      const f32 *y;
+      const f32 *z;
+    };
+
+  }    // namespace
+
+  void FrustumCuller::begin() noexcept {
+    m_minX.clear();
+    m_minY.clear();
+    m_minZ.clear();
+    m_maxX.clear();
+    m_maxY.clear();
+    m_maxZ.clear();
+    m_count = 0;
+  }
+
+  u32 FrustumCuller::add( const AABB &bounds ) noexcept {
+
+    constexpr f32 infinity = std::numeric_limits<f32>::max();
+    const bool valid = bounds.isValid();
+
+    m_minX.push_back( valid ? bounds.min.x : -infinity );
+    m_minY.push_back( valid ? bounds.min.y : -infinity );
+    m_minZ.push_back( valid ? bounds.min.z : -infinity );
+    m_maxX.push_back( valid ? bounds.max.x : infinity );
+    m_maxY.push_back( valid ? bounds.max.y : infinity );
+    m_maxZ.push_back( valid ? bounds.max.z : infinity );
+
+    return m_count++;
+  }
+
+  void FrustumCuller::cull( const Frustum &frustum ) noexcept {
+
+#if defined( NILE_CULL_SSE )
+
+    // Pad with empty boxes at the origin, their results are never read
+    const u32 padded = ( m_count + LANES - 1 ) / LANES * LANES;
+    for ( auto *coordinates : {&m_minX, &m_minY, &m_minZ, &m_maxX, &m_maxY, &m_maxZ} )
+      coordinates->resize( padded, 0.0f );
+
+    m_visible.assign( padded, 0 );
+
+    // The corner furthest along the plane normal is picked per plane, not per box,
+    // since the normal is the same for every box
+    PlaneInputs inputs[ Frustum::COUNT ];
+    for ( u32 p = 0; p < Frustum::COUNT; ++p ) {
+      const auto &plane = frustum.planes[ p ];
+      inputs[ p ] = {plane.x >= 0.0f ? m_maxX.data() : m_minX.data(),
+                     plane.y >= 0.0f ? m_maxY.data() : m_minY.data(),
+                     plane.z >= 0.0f ? m_maxZ.data() : m_minZ.data()};
+    }
+
+    for ( u32 i = 0; i < padded; i += LANES ) {
+      __m128 outside = _mm_setzero_ps();
+
+      for ( u32 p = 0; p < Frustum::COUNT; ++p ) {
+        const auto &plane = frustum.planes[ p ];
+        __m128 distance = _mm_mul_ps( _mm_loadu_ps( inputs[ p ].x + i ), _mm_set1_ps( plane.x ) );
+        distance = _mm_add_ps(
+            distance, _mm_mul_ps( _mm_loadu_ps( inputs[ p ].y + i ), _mm_set1_ps( plane.y ) ) );
+        distance = _mm_add_ps(
+            distance, _mm_mul_ps( _mm_loadu_ps( inputs[ p ].z + i ), _mm_set1_ps( plane.z ) ) );
+        distance = _mm_add_ps( distance, _mm_set1_ps( plane.w ) );
+        outside = _mm_or_ps( outside, _mm_cmplt_ps( distance, _mm_setzero_ps() ) );
+      }
+
+      const auto mask = _mm_movemask_ps( outside );
+      for ( u32 lane = 0; lane < LANES; ++lane )
+        m_visible[ i + lane ] = ( mask & ( 1 << lane ) ) == 0;
+    }
+
+    m_stats = CullingStats {};
+    m_stats.tested = m_count;
+    for ( u32 i = 0; i < m_count; ++i )
+      m_stats.visible += m_visible[ i ];
+    m_stats.culled = m_count - m_stats.visible;
+
+#else
+    this->cullScalar( frustum );
+#endif
+  }
+
+  void FrustumCuller::cullScalar( const Frustum &frustum ) noexcept {
+
+    m_visible.assign( m_count, 0 );
+    m_stats = CullingStats {};
+    m_stats.tested = m_count;
+
+    for ( u32 i = 0; i < m_count; ++i ) {
+      const AABB bounds {{m_minX[ i ], m_minY[ i ], m_minZ[ i ]},
+                         {m_maxX[ i ], m_maxY[ i ], m_maxZ[ i ]}};
+      m_visible[ i ] = frustum.intersects( bounds );
+      m_stats.visible += m_visible[ i ];
+    }
+
+    m_stats.culled = m_count - m_stats.visible;
+  }
+
+}    // namespace nile
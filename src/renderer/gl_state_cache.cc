@@ -0,0 +1,130 @@
+/* ================================================================================
+$File: gl_state_cache.cc
+$Date: $
+$Revision: $
+$Creator: Rostislav Orestis Stelmach
+$Notice: $
+================================================================================ */
+
+#include "Nile/renderer/gl_state_cache.hh"
+
+#include <GL/glew.h>
+
+namespace nile {
+
+  GLStateCache::GLStateCache() noexcept {
+    m_textures.fill( UNKNOWN );
+  }
+
+  void GLStateCache::invalidate() noexcept {
+    m_program = UNKNOWN;
+    m_vertexArray = UNKNOWN;
+    m_activeUnit = UNKNOWN;
+    m_textures.fill( UNKNOWN );
+
+    m_blend = Toggle::UNKNOWN;
+    m_cullFace = Toggle::UNKNOWN;
+    m_depthTest = Toggle::UNKNOWN;
+    m_depthWrite = Toggle::UNKNOWN;
+  }
+
+  void GLStateCache::beginFrame() noexcept {
+    m_lastFrameStats = m_frameStats;
+    m_frameStats = GLStateStats {};
+    this->invalidate();
+  }
+
+  void GLStateCache::useProgram( u32 program ) noexcept {
+    if ( m_program == program ) {
+      ++m_frameStats.avoidedCalls;
+      return;
+    }
+
+    glUseProgram( program );
+    m_program = program;
+    ++m_frameStats.issuedCalls;
+  }
+
+  void GLStateCache::bindVertexArray( u32 vertexArray ) noexcept {
+    if ( m_vertexArray == vertexArray ) {
+      ++m_frameStats.avoidedCalls;
+      return;
+    }
+
+    glBindVertexArray( vertexArray );
+    m_vertexArray = vertexArray;
+    ++m_frameStats.issuedCalls;
+  }
+
+  void GLStateCache::activeTexture( u32 unit ) noexcept {
+    if ( m_activeUnit == unit ) {
+      ++m_frameStats.avoidedCalls;
+      return;
+    }
+
+    glActiveTexture( GL_TEXTURE0 + unit );
+    m_activeUnit = unit;
+    ++m_frameStats.issuedCalls;
+  }
+
+  void GLStateCache::bindTexture( u32 unit, u32 texture ) noexcept {
+    if ( unit < MAX_TEXTURE_UNITS && m_textures[ unit ] == texture ) {
+      ++m_frameStats.avoidedCalls;
+      return;
+    }
+
+    this->activeTexture( unit );
+    glBindTexture( GL_TEXTURE_2D, texture );
+    ++m_frameStats.issuedCalls;
+
+    if ( unit < MAX_TEXTURE_UNITS )
+      m_textures[ unit ] = texture;
+  }
+
+  void GLStateCache::bindTextureBuffer( u32 unit, u32 texture ) noexcept {
+    this->activeTexture( unit );
+    glBindTexture( GL_TEXTURE_BUFFER, texture );
+    ++m_frameStats.issuedCalls;
+  }
+
+  void GLStateCache::setCapability( Toggle &shadow, u32 capability, bool enabled ) noexcept {
+    const auto state = enabled ? Toggle::ENABLED : Toggle::DISABLED;
+    if ( shadow == state ) {
+      ++m_frameStats.avoidedCalls;
+      return;
+    }
+
+    if ( enabled )
+      glEnable( capability );
+    else
+      glDisable( capability );
+
+    shadow = state;
+    ++m_frameStats.issuedCalls;
+  }
+
+  void GLStateCache::setBlend( bool enabled ) noexcept {
+    this->setCapability( m_blend, GL_BLEND, enabled );
+  }
+
+  void GLStateCache::setCullFace( bool enabled ) noexcept {
+    this->setCapability( m_cullFace, GL_CULL_FACE, enabled );
+  }
+
+  void GLStateCache::setDepthTest( bool enabled ) noexcept {
+    this->setCapability( m_depthTest, GL_DEPTH_TEST, enabled );
+  }
+
+  void GLStateCache::setDepthWrite( bool enabled ) noexcept {
+    const auto state = enabled ? Toggle::ENABLED : Toggle::DISABLED;
+    if ( m_depthWrite == state ) {
+      ++m_frameStats.avoidedCalls;
+      return;
+    }
+
+    glDepthMask( enabled ? GL_TRUE : GL_FALSE );
+    m_depthWrite = state;
+    ++m_frameStats.issuedCalls;
+  }
+
+}    // namespace nile
@@ -0,0 +1,131 @@
+/* ================================================================================
+$File: glyph_atlas.cc
+$Date: $
+$Revision: $
+$Creator: Rostislav Orestis Stelmach
+$Notice: $
+================================================================================ */
+
+#include "Nile/renderer/glyph_atlas.hh"
+#include "Nile/log/log.hh"
+
+#include <GL/glew.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+namespace nile {
+
+  namespace {
+
+    u32 nextPowerOfTwo( u32 value ) noexcept {
+      u32 result = 1;
+      while ( result < value )
+        result <<= 1;
+      return result;
+    }
+
+  }    // namespace
+
+  GlyphAtlas::GlyphAtlas( u32 width, u32 pixelSize ) noexcept
+      : m_width( width )
+      , m_pixelSize( pixelSize ) {}
+
+  GlyphAtlas::~GlyphAtlas() noexcept {
+    if ( m_textureId != 0 )
+      glDeleteTextures( 1, &m_textureId );
+  }
+
+  bool GlyphAtlas::addGlyph( u32 codepoint, u32 width, u32 rows, i32 pitch, const u8 *bitmap,
+                             const glm::ivec2 &bearing, u32 advance ) noexcept {
+
+    if ( codepoint >= GLYPH_COUNT )
+      return false;
+
+    if ( m_textureId != 0 ) {
+      log::error( "Glyph [%u] added to an atlas that has already been uploaded\n", codepoint );
+      return false;
+    }
+
+    if ( width + 2 * PADDING > m_width ) {
+      log::error( "Glyph [%u] is %u pixels wide and does not fit into a %u pixels wide atlas\n",
+                  codepoint, width, m_width );
+      return false;
+    }
+
+    auto &glyph = m_glyphs[ codepoint ];
+    glyph.size = glm::ivec2( width, rows );
+    glyph.bearing = bearing;
+    glyph.advance = advance;
+
+    // Glyphs without a bitmap ( e.g space ) only need their metrics
+    if ( width == 0 || rows == 0 ) {
+      glyph.uvMin = glyph.uvMax = glm::vec2( 0.0f );
+      return true;
+    }
+
+    // Start a new shelf when the current one is full
+    if ( m_penX + width + PADDING > m_width ) {
+      m_shelfY += m_shelfHeight + PADDING;
+      m_penX = PADDING;
+      m_shelfHeight = 0;
+    }
+
+    const u32 x = m_penX;
+    const u32 y = m_shelfY;
+
+    m_penX += width + PADDING;
+    m_shelfHeight = std::max( m_shelfHeight, rows );
+
+    const u32 height = nextPowerOfTwo( y + rows + PADDING );
+    if ( height > m_height ) {
+      m_height = height;
+      m_pixels.resize( static_cast<usize>( m_width ) * m_height, 0 );
+    }
+
+    // Negative pitch means the bitmap is stored bottom up, the rows are still
+    // visited from the top
+    for ( u32 row = 0; row < rows; ++row ) {
+      const u8 *source =
+          pitch >= 0 ? bitmap + row * pitch : bitmap + ( rows - 1 - row ) * std::abs( pitch );
+      std::memcpy( &m_pixels[ ( y + row ) * m_width + x ], source, width );
+    }
+
+    // The texture is created from the top row up, so v grows downwards
+    glyph.uvMin = glm::vec2( x, y );
+    glyph.uvMax = glm::vec2( x + width, y + rows );
+
+    return true;
+  }
+
+  void GlyphAtlas::upload() noexcept {
+
+    if ( m_textureId != 0 )
+      return;
+
+    // Texture coordinates are kept in texels until the final size is known
+    const glm::vec2 scale( 1.0f / m_width, 1.0f / std::max( m_height, 1u ) );
+    for ( auto &glyph : m_glyphs ) {
+      glyph.uvMin *= scale;
+      glyph.uvMax *= scale;
+    }
+
+    glGenTextures( 1, &m_textureId );
+
+    // Rows of the atlas are tightly packed
+    glPixelStorei( GL_UNPACK_ALIGNMENT, 1 );
+
+    glBindTexture( GL_TEXTURE_2D, m_textureId );
+    glTexImage2D( GL_TEXTURE_2D, 0, GL_RED, m_width, m_height, 0, GL_RED, GL_UNSIGNED_BYTE,
+                  m_pixels.empty() ? nullptr : m_pixels.data() );
+    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE );
+    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE );
+    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR );
+    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
+    glBindTexture( GL_TEXTURE_2D, 0 );
+
+    glPixelStorei( GL_UNPACK_ALIGNMENT, 4 );
+  }
+
+}    // namespace nile
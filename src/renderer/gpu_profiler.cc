@@ -0,0 +1,155 @@
+/* ================================================================================
+$File: gpu_profiler.cc
+$Date: $
+$Revision: $
+$Creator: Rostislav Orestis Stelmach
+$Notice: $
+================================================================================ */
+
+#include "Nile/renderer/gpu_profiler.hh"
+
+#include <GL/glew.h>
+#include <spdlog/spdlog.h>
+
+#include <cstring>
+
+namespace nile {
+
+  namespace {
+
+    constexpr u32 OVERFLOW_MARKER = ~0u;
+    constexpr u32 QUERY_COUNT = GpuProfiler::MAX_SCOPES * 2;
+
+  }    // namespace
+
+  GpuProfiler::~GpuProfiler() noexcept {
+    if ( !m_created || !m_stats.supported )
+      return;
+
+    for ( auto &frame : m_frames )
+      glDeleteQueries( QUERY_COUNT, frame.queries );
+  }
+
+  void GpuProfiler::create() noexcept {
+    m_created = true;
+    m_stats.supported = GLEW_ARB_timer_query || GLEW_VERSION_3_3;
+
+    if ( !m_stats.supported ) {
+      spdlog::warn( "GpuProfiler: timer queries are not supported, GPU timings are disabled." );
+      return;
+    }
+
+    for ( auto &frame : m_frames ) {
+      glGenQueries( QUERY_COUNT, frame.queries );
+      frame.markers.reserve( MAX_SCOPES );
+    }
+
+    m_open.reserve( MAX_SCOPES );
+    m_results.reserve( MAX_SCOPES );
+  }
+
+  void GpuProfiler::beginFrame() noexcept {
+
+    if ( !m_created )
+      this->create();
+
+    m_current = ( m_current + 1 ) % FRAMES;
+    auto &frame = m_frames[ m_current ];
+
+    if ( frame.pending )
+      this->collect( frame );
+
+    frame.markers.clear();
+    frame.pending = false;
+    m_open.clear();
+    m_inFrame = true;
+  }
+
+  void GpuProfiler::collect( Frame &frame ) noexcept {
+
+    frame.pending = false;
+    const auto queries = static_cast<u32>( frame.markers.size() * 2 );
+
+    // Asking for the result of a query that is not done would block until it is
+    for ( u32 i = 0; i < queries; ++i ) {
+      GLuint available = GL_FALSE;
+      glGetQueryObjectuiv( frame.queries[ i ], GL_QUERY_RESULT_AVAILABLE, &available );
+      if ( !available ) {
+        ++m_stats.droppedFrames;
+        return;
+      }
+    }
+
+    m_results.clear();
+    for ( u32 i = 0; i < frame.markers.size(); ++i ) {
+      const auto &marker = frame.markers[ i ];
+      if ( !marker.closed )
+        continue;
+
+      GLuint64 begin = 0;
+      GLuint64 end = 0;
+      glGetQueryObjectui64v( frame.queries[ i * 2 ], GL_QUERY_RESULT, &begin );
+      glGetQueryObjectui64v( frame.queries[ i * 2 + 1 ], GL_QUERY_RESULT, &end );
+
+      const auto nanoseconds = end > begin ? end - begin : 0;
+      m_results.push_back(
+          {marker.name, marker.depth, static_cast<f32>( static_cast<f64>( nanoseconds ) / 1e6 )} );
+    }
+  }
+
+  void GpuProfiler::endFrame() noexcept {
+
+    if ( !m_inFrame )
+      return;
+
+    while ( !m_open.empty() )
+      this->end();
+
+    m_frames[ m_current ].pending = m_stats.supported && !m_frames[ m_current ].markers.empty();
+    m_inFrame = false;
+  }
+
+  void GpuProfiler::begin( const char *name ) noexcept {
+
+    if ( !m_inFrame || !m_stats.supported )
+      return;
+
+    auto &frame = m_frames[ m_current ];
+    if ( frame.markers.size() == MAX_SCOPES ) {
+      ++m_stats.overflows;
+      m_open.push_back( OVERFLOW_MARKER );
+      return;
+    }
+
+    const auto index = static_cast<u32>( frame.markers.size() );
+    frame.markers.push_back( {name, static_cast<u32>( m_open.size() ), false} );
+    m_open.push_back( index );
+
+    glQueryCounter( frame.queries[ index * 2 ], GL_TIMESTAMP );
+  }
+
+  void GpuProfiler::end() noexcept {
+
+    if ( m_open.empty() )
+      return;
+
+    const auto index = m_open.back();
+    m_open.pop_back();
+
+    if ( index == OVERFLOW_MARKER )
+      return;
+
+    auto &frame = m_frames[ m_current ];
+    frame.markers[ index ].closed = true;
+    glQueryCounter( frame.queries[ index * 2 + 1 ], GL_TIMESTAMP );
+  }
+
+  f32 GpuProfiler::getTime( const char *name ) const noexcept {
+    for ( const auto &timing : m_results ) {
+      if ( std::strcmp( timing.name, name ) == 0 )
+        return timing.milliseconds;
+    }
+    return 0.0f;
+  }
+
+}    // namespace nile
@@ -0,0 +1,228 @@
+/* ================================================================================
+$File: headless_renderer.cc
+$Date: $
+$Revision: $
+$Creator: Rostislav Orestis Stelmach
+$Notice: $
+================================================================================ */
+
+#include "Nile/renderer/headless_renderer.hh"
+
+#include "Nile/core/assert.hh"
+#include "Nile/core/settings.hh"
+#include "Nile/debug/debug_draw.hh"
+#include "Nile/log/log.hh"
+#include "Nile/renderer/frame_uniforms.hh"
+#include "Nile/renderer/gl_state_cache.hh"
+#include "Nile/renderer/gpu_profiler.hh"
+#include "Nile/renderer/render_queue.hh"
+#include "Nile/renderer/stream_buffer.hh"
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <GL/glew.h>
+#include <spdlog/spdlog.h>
+
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include "stb_image_write.h"
+
+#include <vector>
+
+namespace nile {
+
+  namespace {
+
+    // Same context SDL is asked for by OpenGLRenderer, then the oldest one the engine runs on
+    constexpr EGLint CONTEXT_VERSIONS[][ 2 ] = {{4, 2}, {3, 3}};
+
+  }    // namespace
+
+  HeadlessRenderer::HeadlessRenderer( std::shared_ptr<Settings> settings ) noexcept
+      : m_settings( settings )
+      , m_stateCache( std::make_shared<GLStateCache>() )
+      , m_renderQueue( std::make_shared<RenderQueue>() )
+      , m_frameUniforms( std::make_shared<FrameUniforms>() )
+      , m_streamBuffer( std::make_shared<StreamBuffer>() )
+      , m_debugDraw( std::make_shared<DebugDraw>() )
+      , m_gpuProfiler( std::make_shared<GpuProfiler>() ) {}
+
+  HeadlessRenderer::~HeadlessRenderer() noexcept {
+    // Empty Destructor
+  }
+
+  void HeadlessRenderer::initRenderer() noexcept {
+    // SDL still provides the ticks and the ( empty ) event queue of the input manager
+    ASSERT_M( ( SDL_Init( SDL_INIT_TIMER | SDL_INIT_EVENTS ) >= 0 ), "Failed to init SDL" )
+
+    EGLDisplay display = EGL_NO_DISPLAY;
+
+    // The surfaceless platform doesn't need a display server
+    const auto getPlatformDisplay = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(
+        eglGetProcAddress( "eglGetPlatformDisplayEXT" ) );
+    if ( getPlatformDisplay )
+      display = getPlatformDisplay( EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr );
+
+    if ( display == EGL_NO_DISPLAY )
+      display = eglGetDisplay( EGL_DEFAULT_DISPLAY );
+
+    EGLint major = 0;
+    EGLint minor = 0;
+    if ( display == EGL_NO_DISPLAY || !eglInitialize( display, &major, &minor ) ) {
+      log::fatal( "EGL display could not be initialized! EGL Error: 0x%x\n", eglGetError() );
+      return;
+    }
+
+    spdlog::info( "HeadlessRenderer: EGL {}.{} ( {} )", major, minor,
+                  eglQueryString( display, EGL_VENDOR ) );
+    m_display = display;
+  }
+
+  void HeadlessRenderer::initWindow() noexcept {
+
+    if ( !m_display )
+      return;
+
+    const auto width = static_cast<EGLint>( m_settings->getWidth() );
+    const auto height = static_cast<EGLint>( m_settings->getHeight() );
+
+    // clang-format off
+    const EGLint configAttributes[] = {
+      EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+      EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+      EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_BLUE_SIZE, 8, EGL_ALPHA_SIZE, 8,
+      EGL_DEPTH_SIZE, 24, EGL_STENCIL_SIZE, 8,
+      EGL_NONE
+    };
+    // clang-format on
+
+    EGLConfig config = nullptr;
+    EGLint configs = 0;
+    if ( !eglChooseConfig( m_display, configAttributes, &config, 1, &configs ) || !configs ) {
+      log::fatal( "No EGL config with a pbuffer and OpenGL! EGL Error: 0x%x\n", eglGetError() );
+      return;
+    }
+
+    const EGLint surfaceAttributes[] = {EGL_WIDTH, width, EGL_HEIGHT, height, EGL_NONE};
+    m_surface = eglCreatePbufferSurface( m_display, config, surfaceAttributes );
+    if ( m_surface == EGL_NO_SURFACE ) {
+      log::fatal( "EGL pbuffer could not be created! EGL Error: 0x%x\n", eglGetError() );
+      return;
+    }
+
+    eglBindAPI( EGL_OPENGL_API );
+    for ( const auto &version : CONTEXT_VERSIONS ) {
+      // clang-format off
+      const EGLint contextAttributes[] = {
+        EGL_CONTEXT_MAJOR_VERSION, version[ 0 ],
+        EGL_CONTEXT_MINOR_VERSION, version[ 1 ],
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+        EGL_NONE
+      };
+      // clang-format on
+      m_context = eglCreateContext( m_display, config, EGL_NO_CONTEXT, contextAttributes );
+      if ( m_context != EGL_NO_CONTEXT )
+        break;
+    }
+
+    if ( m_context == EGL_NO_CONTEXT ||
+         !eglMakeCurrent( m_display, m_surface, m_surface, m_context ) ) {
+      log::fatal( "OpenGL Context could not be created! EGL Error: 0x%x\n", eglGetError() );
+      return;
+    }
+
+    // GLEW's GLX part fails without an X display, the GL entry points are loaded before it
+    glewExperimental = GL_TRUE;
+    glewInit();
+    glGetError();
+
+    spdlog::info( "HeadlessRenderer: {} ( {} ), {}x{} pbuffer",
+                  reinterpret_cast<const char *>( glGetString( GL_RENDERER ) ),
+                  reinterpret_cast<const char *>( glGetString( GL_VERSION ) ), width, height );
+
+    glViewport( 0, 0, width, height );
+
+    glEnable( GL_DEPTH_TEST );
+    glEnable( GL_STENCIL_TEST );
+    glEnable( GL_BLEND );
+    glDepthFunc( GL_LESS );
+    glBlendFunc( GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA );
+  }
+
+  void HeadlessRenderer::init() noexcept {
+    this->initRenderer();
+    this->initWindow();
+  }
+
+  void HeadlessRenderer::destroy() noexcept {
+    if ( m_display ) {
+      eglMakeCurrent( m_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT );
+      if ( m_context )
+        eglDestroyContext( m_display, m_context );
+      if ( m_surface )
+        eglDestroySurface( m_display, m_surface );
+      eglTerminate( m_display );
+    }
+
+    m_display = nullptr;
+    m_surface = nullptr;
+    m_context = nullptr;
+    SDL_Quit();
+  }
+
+  void HeadlessRenderer::submitFrame() noexcept {
+    // Anything could have changed the state since the last frame
+    m_stateCache->beginFrame();
+    m_streamBuffer->beginFrame();
+    m_gpuProfiler->beginFrame();
+    m_gpuProfiler->begin( "frame" );
+
+    glClearColor( 0.1f, 0.1f, 0.1f, 1.0f );
+    glClear( GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT );
+  }
+
+  void HeadlessRenderer::endFrame() noexcept {
+    // The draws of the frame are submitted, fence its part of the stream buffer
+    m_streamBuffer->endFrame();
+    m_gpuProfiler->end();
+    m_gpuProfiler->endFrame();
+
+    // Nothing to present, swapping a pbuffer has no effect
+    glFlush();
+    ++m_frame;
+
+    const auto &capturePath = m_settings->getCapturePath();
+    if ( m_frame == m_settings->getFrameLimit() && !capturePath.empty() )
+      this->captureFrame( capturePath );
+  }
+
+  bool HeadlessRenderer::captureFrame( const std::string &path ) const noexcept {
+
+    const auto width = m_settings->getWidth();
+    const auto height = m_settings->getHeight();
+    std::vector<u8> pixels( static_cast<usize>( width ) * height * 4 );
+
+    // Framebuffer bindings are not shadowed by the state cache
+    GLint readFramebuffer = 0;
+    glGetIntegerv( GL_READ_FRAMEBUFFER_BINDING, &readFramebuffer );
+    glBindFramebuffer( GL_READ_FRAMEBUFFER, 0 );
+    glReadBuffer( GL_BACK );
+    glPixelStorei( GL_PACK_ALIGNMENT, 1 );
+    glReadPixels( 0, 0, static_cast<GLsizei>( width ), static_cast<GLsizei>( height ), GL_RGBA,
+                  GL_UNSIGNED_BYTE, pixels.data() );
+    glPixelStorei( GL_PACK_ALIGNMENT, 4 );
+    glBindFramebuffer( GL_READ_FRAMEBUFFER, static_cast<GLuint>( readFramebuffer ) );
+
+    // OpenGL rows start at the bottom, PNG rows at the top
+    stbi_flip_vertically_on_write( 1 );
+    const auto written =
+        stbi_write_png( path.c_str(), static_cast<int>( width ), static_cast<int>( height ), 4,
+                        pixels.data(), static_cast<int>( width * 4 ) ) != 0;
+
+    if ( written )
+      spdlog::info( "HeadlessRenderer: frame {} written to {}", m_frame, path );
+    else
+      log::error( "Failed to write the frame to { %s }\n", path.c_str() );
+
+    return written;
+  }
+
+}    // namespace nile
@@ -0,0 +1,84 @@
+/* ================================================================================
+$File: lighting_system.cc
+$Date: $
+$Revision: $
+$Creator: Rostislav Orestis Stelmach
+$Notice: $
+================================================================================ */
+
+#include "Nile/renderer/lighting_system.hh"
+#include "Nile/core/settings.hh"
+#include "Nile/ecs/components/point_light.hh"
+#include "Nile/ecs/components/transform.hh"
+#include "Nile/ecs/ecs_coordinator.hh"
+#include "Nile/renderer/frame_uniforms.hh"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+
+namespace nile {
+
+  namespace {
+
+    f32 maxComponent( const glm::vec3 &v ) noexcept {
+      return std::max( {v.x, v.y, v.z} );
+    }
+
+  }    // namespace
+
+  LightingSystem::LightingSystem( const std::shared_ptr<Coordinator> &coordinator,
+                                  const std::shared_ptr<Settings> &settings,
+                                  const std::shared_ptr<GLStateCache> &state,
+                                  const std::shared_ptr<FrameUniforms> &uniforms ) noexcept
+      : ecs_coordinator_( coordinator )
+      , settings_( settings )
+      , gl_state_( state )
+      , frame_uniforms_( uniforms )
+      , viewport_( settings->getWidth(), settings->getHeight() ) {}
+
+  void LightingSystem::create() noexcept {
+    spdlog::info( "ECS LightingSystem has been registered to ECS manager and created successfully." );
+  }
+
+  void LightingSystem::render( f32 dt ) noexcept {
+
+    const auto &camera = frame_uniforms_->getCamera();
+    clusters_.setProjection( camera.projection, viewport_ );
+
+    clusters_.begin();
+    for ( const auto &entity : entities_ ) {
+      const auto &transform = ecs_coordinator_->getComponent<Transform>( entity );
+      const auto &light = ecs_coordinator_->getComponent<PointLight>( entity );
+
+      // Every term is attenuated, so the brightest one decides how far the light reaches
+      const f32 intensity = std::max(
+          {maxComponent( light.ambient ), maxComponent( light.diffuse ),
+           maxComponent( light.specular )} );
+      const f32 range = light.range > 0.0f
+                            ? light.range
+                            : ClusteredLights::computeRange( light.attenuation, intensity );
+
+      PointLightData data;
+      data.position = glm::vec4( transform.position, range );
+      data.ambient = glm::vec4( light.ambient, 0.0f );
+      data.diffuse = glm::vec4( light.diffuse, 0.0f );
+      data.specular = glm::vec4( light.specular, 0.0f );
+      data.attenuation = glm::vec4( light.attenuation, 0.0f );
+      clusters_.add( data );
+    }
+
+    clusters_.assign( camera.view );
+    clusters_.upload();
+    clusters_.bind( *gl_state_ );
+
+    const glm::uvec4 grid( ClusteredLights::CLUSTERS_X, ClusteredLights::CLUSTERS_Y,
+                           ClusteredLights::CLUSTERS_Z, clusters_.size() );
+    frame_uniforms_->setClusters( grid, clusters_.getDepthParameters(),
+                                  clusters_.getClusterSize() );
+
+    // Only uploads when the grid or the light count changed
+    frame_uniforms_->upload();
+  }
+
+}    // namespace nile
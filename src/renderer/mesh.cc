@@ -2,4 +2,10 @@
 
 namespace nile {
 
-}
+  void Mesh::pack() noexcept {
+    quantization = Math::computeQuantization( bounds );
+    quantizationError = Math::packVertices( verticies, quantization, packedVertices );
+    std::vector<Vertex>().swap( verticies );
+  }
+
+}    // namespace nile
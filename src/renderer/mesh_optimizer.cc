@@ -0,0 +1,438 @@
+/* ================================================================================
+$File: mesh_optimizer.cc
+$Date: $
+$Revision: $
+$Creator: Rostislav Orestis Stelmach
+$Notice: $
+================================================================================ */
+
+#include "Nile/renderer/mesh_optimizer.hh"
+#include "Nile/math/bounds.hh"
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+namespace nile::MeshOptimizer {
+
+  namespace {
+
+    constexpr u32 INVALID = ~0u;
+
+    // Forsyth's parameters, the cache is an LRU one and larger than the simulated FIFO
+    constexpr u32 MAX_CACHE = 32;
+    constexpr f32 CACHE_DECAY_POWER = 1.5f;
+    constexpr f32 LAST_TRIANGLE_SCORE = 0.75f;
+    constexpr f32 VALENCE_BOOST_SCALE = 2.0f;
+    constexpr f32 VALENCE_BOOST_POWER = 0.5f;
+
+    // Scores are looked up, remaining triangles past the table share the last entry
+    constexpr u32 MAX_VALENCE = 64;
+
+    struct ScoreTables {
+      f32 cache[ MAX_CACHE ];
+      f32 valence[ MAX_VALENCE ];
+
+      ScoreTables() noexcept {
+        for ( u32 i = 0; i < MAX_CACHE; ++i ) {
+          if ( i < 3 ) {
+            // Vertices of the last triangle, a bit less so the same triangle
+            // strip is not followed forever
+            cache[ i ] = LAST_TRIANGLE_SCORE;
+          } else {
+            const auto scaled = 1.0f - static_cast<f32>( i - 3 ) / ( MAX_CACHE - 3 );
+            cache[ i ] = std::pow( scaled, CACHE_DECAY_POWER );
+          }
+        }
+
+        valence[ 0 ] = 0.0f;
+        for ( u32 i = 1; i < MAX_VALENCE; ++i )
+          valence[ i ] =
+              VALENCE_BOOST_SCALE * std::pow( static_cast<f32>( i ), -VALENCE_BOOST_POWER );
+      }
+    };
+
+    f32 vertexScore( const ScoreTables &tables, i32 cachePosition, u32 remaining ) noexcept {
+      if ( remaining == 0 )
+        return -1.0f;
+
+      const auto cache = cachePosition >= 0 ? tables.cache[ cachePosition ] : 0.0f;
+      return cache + tables.valence[ std::min( remaining, MAX_VALENCE - 1 ) ];
+    }
+
+    struct Cluster {
+      u32 first;
+      u32 count;
+      f32 sortKey;
+    };
+
+    // Starts of runs of triangles that reuse the FIFO cache, a triangle whose three
+    // vertices all miss can be moved without making the cache worse. The first run always
+    // starts at triangle 0, even if it shares vertices ( e.g. a degenerate triangle )
+    std::vector<u32> hardBoundaries( const std::vector<u32> &indices,
+                                     usize vertexCount ) noexcept {
+      std::vector<u32> boundaries;
+      std::vector<u32> timestamps( vertexCount, 0 );
+      u32 time = ANALYSIS_CACHE_SIZE + 1;
+
+      for ( usize triangle = 0; triangle < indices.size() / 3; ++triangle ) {
+        u32 misses = 0;
+        for ( u32 corner = 0; corner < 3; ++corner ) {
+          const auto vertex = indices[ triangle * 3 + corner ];
+          if ( time - timestamps[ vertex ] > ANALYSIS_CACHE_SIZE ) {
+            timestamps[ vertex ] = time++;
+            ++misses;
+          }
+        }
+
+        if ( triangle == 0 || misses == 3 )
+          boundaries.push_back( static_cast<u32>( triangle ) );
+      }
+
+      return boundaries;
+    }
+
+  }    // namespace
+
+  void optimizeVertexCache( std::vector<u32> &indices, usize vertexCount ) noexcept {
+
+    const auto triangleCount = indices.size() / 3;
+    if ( triangleCount == 0 )
+      return;
+
+    static const ScoreTables tables;
+
+    // Triangles of every vertex, the ones already emitted are moved past the end
+    std::vector<u32> remaining( vertexCount, 0 );
+    for ( const auto index : indices )
+      ++remaining[ index ];
+
+    std::vector<u32> offsets( vertexCount, 0 );
+    std::exclusive_scan( remaining.begin(), remaining.end(), offsets.begin(), 0u );
+
+    std::vector<u32> adjacency( indices.size() );
+    {
+      std::vector<u32> fill( offsets );
+      for ( usize i = 0; i < indices.size(); ++i )
+        adjacency[ fill[ indices[ i ] ]++ ] = static_cast<u32>( i / 3 );
+    }
+
+    std::vector<i32> cachePositions( vertexCount, -1 );
+    std::vector<f32> vertexScores( vertexCount );
+    for ( usize vertex = 0; vertex < vertexCount; ++vertex )
+      vertexScores[ vertex ] = vertexScore( tables, -1, remaining[ vertex ] );
+
+    std::vector<u8> emitted( triangleCount, 0 );
+
+    u32 best = INVALID;
+    f32 bestScore = -1.0f;
+    for ( usize triangle = 0; triangle < triangleCount; ++triangle ) {
+      const auto *corners = &indices[ triangle * 3 ];
+      const auto score = vertexScores[ corners[ 0 ] ] + vertexScores[ corners[ 1 ] ] +
+                         vertexScores[ corners[ 2 ] ];
+      if ( score > bestScore ) {
+        bestScore = score;
+        best = static_cast<u32>( triangle );
+      }
+    }
+
+    std::vector<u32> result;
+    result.reserve( indices.size() );
+
+    u32 cache[ MAX_CACHE + 3 ];
+    u32 cacheSize = 0;
+    // Fallback when none of the cached vertices has a triangle left
+    usize cursor = 0;
+
+    while ( result.size() < indices.size() ) {
+
+      if ( best == INVALID ) {
+        while ( emitted[ cursor ] )
+          ++cursor;
+        best = static_cast<u32>( cursor );
+      }
+
+      const u32 corners[ 3 ] = {indices[ best * 3 ], indices[ best * 3 + 1 ],
+                                indices[ best * 3 + 2 ]};
+      result.insert( result.end(), corners, corners + 3 );
+      emitted[ best ] = 1;
+
+      for ( const auto vertex : corners ) {
+        // Degenerate triangles are listed once per corner
+        auto *begin = &adjacency[ offsets[ vertex ] ];
+        auto *end = begin + remaining[ vertex ];
+        auto *found = std::find( begin, end, best );
+        if ( found != end ) {
+          *found = *( end - 1 );
+          --remaining[ vertex ];
+        }
+      }
+
+      // The emitted triangle goes to the front of the cache
+      u32 updated[ MAX_CACHE + 3 ];
+      u32 updatedSize = 0;
+      for ( const auto vertex : corners ) {
+        if ( std::find( updated, updated + updatedSize, vertex ) == updated + updatedSize )
+          updated[ updatedSize++ ] = vertex;
+      }
+      const auto cornerCount = updatedSize;
+      for ( u32 i = 0; i < cacheSize; ++i ) {
+        const auto vertex = cache[ i ];
+        if ( std::find( updated, updated + cornerCount, vertex ) == updated + cornerCount )
+          updated[ updatedSize++ ] = vertex;
+      }
+
+      for ( u32 i = 0; i < updatedSize; ++i ) {
+        const auto vertex = updated[ i ];
+        cachePositions[ vertex ] = i < MAX_CACHE ? static_cast<i32>( i ) : -1;
+        vertexScores[ vertex ] =
+            vertexScore( tables, cachePositions[ vertex ], remaining[ vertex ] );
+      }
+
+      cacheSize = std::min( updatedSize, MAX_CACHE );
+      std::copy( updated, updated + cacheSize, cache );
+
+      // Only the triangles around the touched vertices changed their score
+      best = INVALID;
+      bestScore = -1.0f;
+      for ( u32 i = 0; i < updatedSize; ++i ) {
+        const auto vertex = updated[ i ];
+        for ( u32 j = 0; j < remaining[ vertex ]; ++j ) {
+          const auto triangle = adjacency[ offsets[ vertex ] + j ];
+          const auto *triangleCorners = &indices[ triangle * 3 ];
+          const auto score = vertexScores[ triangleCorners[ 0 ] ] +
+                             vertexScores[ triangleCorners[ 1 ] ] +
+                             vertexScores[ triangleCorners[ 2 ] ];
+          if ( score > bestScore ) {
+            bestScore = score;
+            best = triangle;
+          }
+        }
+      }
+    }
+
+    indices.swap( result );
+  }
+
+  void optimizeOverdraw( std::vector<u32> &indices,
+                         const std::vector<Vertex> &vertices ) noexcept {
+
+    const auto triangleCount = static_cast<u32>( indices.size() / 3 );
+    if ( triangleCount == 0 )
+      return;
+
+    auto boundaries = hardBoundaries( indices, vertices.size() );
+    // Every triangle belongs to a cluster, the whole buffer is one when nothing splits it
+    if ( boundaries.empty() || boundaries.front() != 0 )
+      boundaries.insert( boundaries.begin(), 0 );
+
+    std::vector<Cluster> clusters;
+    clusters.reserve( boundaries.size() );
+    for ( usize i = 0; i < boundaries.size(); ++i ) {
+      const auto end = i + 1 < boundaries.size() ? boundaries[ i + 1 ] : triangleCount;
+      clusters.push_back( {boundaries[ i ], end - boundaries[ i ], 0.0f} );
+    }
+
+    // Area weighted centroid of the whole mesh
+    glm::vec3 meshCenter {0.0f};
+    f32 meshArea = 0.0f;
+
+    std::vector<glm::vec3> centers( clusters.size() );
+    std::vector<glm::vec3> normals( clusters.size() );
+
+    for ( usize c = 0; c < clusters.size(); ++c ) {
+      glm::vec3 center {0.0f};
+      glm::vec3 normal {0.0f};
+      f32 area = 0.0f;
+
+      for ( u32 t = clusters[ c ].first; t < clusters[ c ].first + clusters[ c ].count; ++t ) {
+        const auto &a = vertices[ indices[ t * 3 ] ].position;
+        const auto &b = vertices[ indices[ t * 3 + 1 ] ].position;
+        const auto &p = vertices[ indices[ t * 3 + 2 ] ].position;
+
+        // Twice the area, the scale doesn't matter
+        const auto cross = glm::cross( b - a, p - a );
+        const auto triangleArea = glm::length( cross );
+
+        center += ( a + b + p ) * ( triangleArea / 3.0f );
+        normal += cross;
+        area += triangleArea;
+      }
+
+      meshCenter += center;
+      meshArea += area;
+
+      centers[ c ] = area > 0.0f ? center / area : center;
+      normals[ c ] = normal;
+    }
+
+    if ( meshArea > 0.0f )
+      meshCenter /= meshArea;
+
+    // Clusters that are far out along their normal are likely in front of the rest
+    for ( usize c = 0; c < clusters.size(); ++c ) {
+      const auto length = glm::length( normals[ c ] );
+      clusters[ c ].sortKey =
+          length > 0.0f ? glm::dot( centers[ c ] - meshCenter, normals[ c ] / length ) : 0.0f;
+    }
+
+    std::stable_sort( clusters.begin(), clusters.end(),
+                      []( const Cluster &a, const Cluster &b ) { return a.sortKey > b.sortKey; } );
+
+    std::vector<u32> result;
+    result.reserve( indices.size() );
+    for ( const auto &cluster : clusters ) {
+      const auto begin = indices.begin() + cluster.first * 3;
+      result.insert( result.end(), begin, begin + cluster.count * 3 );
+    }
+
+    indices.swap( result );
+  }
+
+  void optimizeVertexFetch( std::vector<Vertex> &vertices, std::vector<u32> &indices ) noexcept {
+
+    std::vector<u32> remap( vertices.size(), INVALID );
+    u32 next = 0;
+
+    for ( auto &index : indices ) {
+      if ( remap[ index ] == INVALID )
+        remap[ index ] = next++;
+      index = remap[ index ];
+    }
+
+    std::vector<Vertex> reordered( next );
+    for ( usize vertex = 0; vertex < vertices.size(); ++vertex ) {
+      if ( remap[ vertex ] != INVALID )
+        reordered[ remap[ vertex ] ] = vertices[ vertex ];
+    }
+
+    vertices.swap( reordered );
+  }
+
+  MeshQuality analyzeVertexCache( const std::vector<u32> &indices, usize vertexCount,
+                                  u32 cacheSize ) noexcept {
+    MeshQuality quality;
+
+    const auto triangleCount = indices.size() / 3;
+    if ( triangleCount == 0 )
+      return quality;
+
+    // A vertex is in the FIFO when less than cacheSize misses happened since its own
+    std::vector<u32> timestamps( vertexCount, 0 );
+    std::vector<u8> used( vertexCount, 0 );
+    u32 time = cacheSize + 1;
+    u32 misses = 0;
+    u32 unique = 0;
+
+    for ( const auto index : indices ) {
+      if ( time - timestamps[ index ] > cacheSize ) {
+        timestamps[ index ] = time++;
+        ++misses;
+      }
+
+      unique += used[ index ] ? 0 : 1;
+      used[ index ] = 1;
+    }
+
+    quality.acmr = static_cast<f32>( misses ) / static_cast<f32>( triangleCount );
+    quality.atvr = static_cast<f32>( misses ) / static_cast<f32>( unique );
+    return quality;
+  }
+
+  f32 analyzeOverdraw( const std::vector<Vertex> &vertices,
+                       const std::vector<u32> &indices ) noexcept {
+
+    if ( indices.size() < 3 )
+      return 0.0f;
+
+    const auto bounds = Math::computeBounds( vertices );
+    const auto size = bounds.max - bounds.min;
+    const auto extent = std::max( {size.x, size.y, size.z} );
+    if ( extent <= 0.0f )
+      return 0.0f;
+
+    // Forward and up of the six orthographic views, right is forward x up
+    const glm::vec3 views[ 6 ][ 2 ] = {
+        {{0.0f, 0.0f, -1.0f}, {0.0f, 1.0f, 0.0f}}, {{0.0f, 0.0f, 1.0f}, {0.0f, 1.0f, 0.0f}},
+        {{-1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}}, {{1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}},
+        {{0.0f, -1.0f, 0.0f}, {0.0f, 0.0f, -1.0f}}, {{0.0f, 1.0f, 0.0f}, {0.0f, 0.0f, 1.0f}}};
+
+    constexpr auto resolution = static_cast<i32>( OVERDRAW_RESOLUTION );
+    const auto scale = static_cast<f32>( resolution - 1 ) / extent;
+    const auto center = bounds.center();
+
+    std::vector<f32> depth( OVERDRAW_RESOLUTION * OVERDRAW_RESOLUTION );
+    u64 shaded = 0;
+    u64 covered = 0;
+
+    for ( const auto &view : views ) {
+      const auto &forward = view[ 0 ];
+      const auto &up = view[ 1 ];
+      const auto right = glm::cross( forward, up );
+
+      std::fill( depth.begin(), depth.end(), std::numeric_limits<f32>::max() );
+
+      for ( usize t = 0; t + 2 < indices.size(); t += 3 ) {
+        glm::vec2 screen[ 3 ];
+        f32 z[ 3 ];
+        for ( u32 corner = 0; corner < 3; ++corner ) {
+          const auto position = vertices[ indices[ t + corner ] ].position - center;
+          screen[ corner ] = glm::vec2( glm::dot( position, right ), glm::dot( position, up ) ) *
+                                 scale +
+                             glm::vec2( resolution * 0.5f );
+          z[ corner ] = glm::dot( position, forward );
+        }
+
+        const auto edge = []( const glm::vec2 &a, const glm::vec2 &b, const glm::vec2 &p ) {
+          return ( b.x - a.x ) * ( p.y - a.y ) - ( b.y - a.y ) * ( p.x - a.x );
+        };
+
+        // Back facing and degenerate triangles are culled
+        const auto area = edge( screen[ 0 ], screen[ 1 ], screen[ 2 ] );
+        if ( area <= 0.0f )
+          continue;
+
+        const auto low = glm::min( screen[ 0 ], glm::min( screen[ 1 ], screen[ 2 ] ) );
+        const auto high = glm::max( screen[ 0 ], glm::max( screen[ 1 ], screen[ 2 ] ) );
+        const auto minX = std::max( static_cast<i32>( std::floor( low.x ) ), 0 );
+        const auto minY = std::max( static_cast<i32>( std::floor( low.y ) ), 0 );
+        const auto maxX = std::min( static_cast<i32>( std::ceil( high.x ) ), resolution - 1 );
+        const auto maxY = std::min( static_cast<i32>( std::ceil( high.y ) ), resolution - 1 );
+
+        for ( i32 y = minY; y <= maxY; ++y ) {
+          for ( i32 x = minX; x <= maxX; ++x ) {
+            const glm::vec2 pixel( x + 0.5f, y + 0.5f );
+            const auto w0 = edge( screen[ 1 ], screen[ 2 ], pixel );
+            const auto w1 = edge( screen[ 2 ], screen[ 0 ], pixel );
+            const auto w2 = edge( screen[ 0 ], screen[ 1 ], pixel );
+            if ( w0 < 0.0f || w1 < 0.0f || w2 < 0.0f )
+              continue;
+
+            // Early depth test, only the fragments that pass are shaded
+            const auto fragmentDepth = ( w0 * z[ 0 ] + w1 * z[ 1 ] + w2 * z[ 2 ] ) / area;
+            auto &stored = depth[ y * resolution + x ];
+            if ( fragmentDepth >= stored )
+              continue;
+
+            covered += stored == std::numeric_limits<f32>::max() ? 1 : 0;
+            stored = fragmentDepth;
+            ++shaded;
+          }
+        }
+      }
+    }
+
+    return covered ? static_cast<f32>( shaded ) / static_cast<f32>( covered ) : 0.0f;
+  }
+
+  MeshQuality analyze( const std::vector<Vertex> &vertices,
+                       const std::vector<u32> &indices ) noexcept {
+    auto quality = analyzeVertexCache( indices, vertices.size() );
+    quality.overdraw = analyzeOverdraw( vertices, indices );
+    return quality;
+  }
+
+}    // namespace nile::MeshOptimizer
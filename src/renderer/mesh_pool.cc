@@ -0,0 +1,95 @@
+/* ================================================================================
+$File: mesh_pool.cc
+$Date: $
+$Revision: $
+$Creator: Rostislav Orestis Stelmach
+$Notice: $
+================================================================================ */
+
+#include "Nile/renderer/mesh_pool.hh"
+
+#include <GL/glew.h>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+
+namespace nile {
+
+  MeshPool::MeshPool( usize vertexSize ) noexcept
+      : m_vertexSize( vertexSize ) {}
+
+  MeshPool::~MeshPool() noexcept {
+    glDeleteBuffers( 1, &m_vertexBuffer );
+    glDeleteBuffers( 1, &m_indexBuffer );
+  }
+
+  MeshRange MeshPool::add( const void *vertices, u32 vertexCount,
+                           const std::vector<u32> &indices ) noexcept {
+
+    const auto indexCount = static_cast<u32>( indices.size() );
+
+    if ( m_stats.vertices + vertexCount > m_vertexCapacity ) {
+      m_stats.grows += m_vertexBuffer ? 1 : 0;
+      grow( m_vertexBuffer, m_vertexCapacity,
+            std::max( m_stats.vertices + vertexCount, MIN_VERTICES ), m_vertexSize,
+            m_stats.vertices * m_vertexSize );
+    }
+
+    if ( m_stats.indices + indexCount > m_indexCapacity ) {
+      m_stats.grows += m_indexBuffer ? 1 : 0;
+      grow( m_indexBuffer, m_indexCapacity, std::max( m_stats.indices + indexCount, MIN_INDICES ),
+            sizeof( u32 ), m_stats.indices * sizeof( u32 ) );
+    }
+
+    MeshRange range;
+    range.firstIndex = m_stats.indices;
+    range.indexCount = indexCount;
+    range.baseVertex = static_cast<i32>( m_stats.vertices );
+    range.vertexCount = vertexCount;
+
+    // Both are uploaded through GL_ARRAY_BUFFER, so the index buffer doesn't get attached
+    // to whatever vertex array is bound right now
+    glBindBuffer( GL_ARRAY_BUFFER, m_vertexBuffer );
+    glBufferSubData( GL_ARRAY_BUFFER, m_stats.vertices * m_vertexSize, vertexCount * m_vertexSize,
+                     vertices );
+    glBindBuffer( GL_ARRAY_BUFFER, m_indexBuffer );
+    glBufferSubData( GL_ARRAY_BUFFER, m_stats.indices * sizeof( u32 ), indexCount * sizeof( u32 ),
+                     indices.data() );
+    glBindBuffer( GL_ARRAY_BUFFER, 0 );
+
+    m_stats.vertices += vertexCount;
+    m_stats.indices += indexCount;
+    ++m_stats.meshes;
+
+    return range;
+  }
+
+  void MeshPool::grow( u32 &buffer, u32 &capacity, u32 required, usize elementSize,
+                       usize usedBytes ) noexcept {
+
+    const u32 size = std::max( required, capacity * 2 );
+
+    u32 grown = 0;
+    glGenBuffers( 1, &grown );
+    glBindBuffer( GL_COPY_WRITE_BUFFER, grown );
+    glBufferData( GL_COPY_WRITE_BUFFER, size * elementSize, nullptr, GL_STATIC_DRAW );
+
+    // The old content stays on the GPU
+    if ( buffer && usedBytes ) {
+      glBindBuffer( GL_COPY_READ_BUFFER, buffer );
+      glCopyBufferSubData( GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, usedBytes );
+      glBindBuffer( GL_COPY_READ_BUFFER, 0 );
+    }
+
+    glBindBuffer( GL_COPY_WRITE_BUFFER, 0 );
+
+    // Vertex arrays still pointing at the old buffer keep it alive until they are updated
+    glDeleteBuffers( 1, &buffer );
+
+    spdlog::debug( "MeshPool buffer grows from {} to {} elements", capacity, size );
+
+    buffer = grown;
+    capacity = size;
+  }
+
+}    // namespace nile
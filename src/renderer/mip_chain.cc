@@ -0,0 +1,270 @@
+/* ================================================================================
+$File: mip_chain.cc
+$Date: $
+$Revision: $
+$Creator: Rostislav Orestis Stelmach
+$Notice: $
+================================================================================ */
+
+#include "Nile/renderer/mip_chain.hh"
+#include "Nile/core/parallel.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined( __SSE__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 1 )
+#define NILE_MIP_SSE 1
+#include <xmmintrin.h>
+#endif
+
+namespace nile {
+
+  namespace {
+
+    // Kaiser window of the sinc, in texels of the smaller level ( as in NVTT )
+    constexpr f32 KAISER_WIDTH = 3.0f;
+    constexpr f32 KAISER_ALPHA = 4.0f;
+    constexpr f32 PI = 3.14159265358979f;
+
+    // Entries of the linear to sRGB table, fine enough to round to the nearest 8 bit value
+    constexpr u32 ENCODE_STEPS = 16384;
+
+    // Linear, alpha premultiplied RGBA
+    struct alignas( 16 ) Texel {
+      f32 v[ MipChain::CHANNELS ];
+    };
+
+    // Sources and weights of every texel along one axis, taps entries per texel
+    struct Kernel {
+      u32 taps = 0;
+      std::vector<u32> indices;
+      std::vector<f32> weights;
+    };
+
+    const f32 *decodeTable() noexcept {
+      static const auto table = [] {
+        std::vector<f32> values( 256 );
+        for ( u32 i = 0; i < 256; ++i ) {
+          const f32 c = i / 255.0f;
+          values[ i ] = c <= 0.04045f ? c / 12.92f : std::pow( ( c + 0.055f ) / 1.055f, 2.4f );
+        }
+        return values;
+      }();
+      return table.data();
+    }
+
+    const u8 *encodeTable() noexcept {
+      static const auto table = [] {
+        std::vector<u8> values( ENCODE_STEPS );
+        for ( u32 i = 0; i < ENCODE_STEPS; ++i ) {
+          const f32 c = i / static_cast<f32>( ENCODE_STEPS - 1 );
+          const f32 s = c <= 0.0031308f ? c * 12.92f : 1.055f * std::pow( c, 1.0f / 2.4f ) - 0.055f;
+          values[ i ] = static_cast<u8>( std::lround( s * 255.0f ) );
+        }
+        return values;
+      }();
+      return table.data();
+    }
+
+    // Modified Bessel function of the first kind, order 0
+    f32 bessel0( f32 x ) noexcept {
+      f32 sum = 1.0f;
+      f32 term = 1.0f;
+      for ( u32 k = 1; k < 32 && term > sum * 1e-7f; ++k ) {
+        term *= ( x * 0.5f / k ) * ( x * 0.5f / k );
+        sum += term;
+      }
+      return sum;
+    }
+
+    f32 weight( MipFilter filter, f32 t ) noexcept {
+      t = std::fabs( t );
+      if ( filter == MipFilter::BOX )
+        return t < 0.5f ? 1.0f : ( t == 0.5f ? 0.5f : 0.0f );
+
+      if ( t >= KAISER_WIDTH )
+        return 0.0f;
+      const f32 sinc = t < 1e-5f ? 1.0f : std::sin( PI * t ) / ( PI * t );
+      const f32 r = t / KAISER_WIDTH;
+      return sinc * bessel0( KAISER_ALPHA * std::sqrt( 1.0f - r * r ) ) / bessel0( KAISER_ALPHA );
+    }
+
+    Kernel makeKernel( u32 source, u32 target, MipFilter filter, bool wrap ) noexcept {
+
+      Kernel kernel;
+      if ( source == target ) {
+        kernel.taps = 1;
+        for ( u32 i = 0; i < target; ++i ) {
+          kernel.indices.push_back( i );
+          kernel.weights.push_back( 1.0f );
+        }
+        return kernel;
+      }
+
+      const f32 scale = static_cast<f32>( source ) / target;
+      const f32 support = ( filter == MipFilter::BOX ? 0.5f : KAISER_WIDTH ) * scale;
+      kernel.taps = static_cast<u32>( std::ceil( support * 2.0f ) ) + 1;
+      kernel.indices.resize( static_cast<usize>( target ) * kernel.taps );
+      kernel.weights.resize( static_cast<usize>( target ) * kernel.taps );
+
+      const auto size = static_cast<i64>( source );
+      for ( u32 i = 0; i < target; ++i ) {
+        const f32 center = ( i + 0.5f ) * scale;
+        const auto first = static_cast<i64>( std::floor( center - support ) );
+
+        auto *indices = kernel.indices.data() + static_cast<usize>( i ) * kernel.taps;
+        auto *weights = kernel.weights.data() + static_cast<usize>( i ) * kernel.taps;
+        f32 sum = 0.0f;
+        for ( u32 k = 0; k < kernel.taps; ++k ) {
+          const auto j = first + k;
+          indices[ k ] = static_cast<u32>( wrap ? ( j % size + size ) % size
+                                                : std::clamp<i64>( j, 0, size - 1 ) );
+          weights[ k ] = weight( filter, ( j + 0.5f - center ) / scale );
+          sum += weights[ k ];
+        }
+        for ( u32 k = 0; k < kernel.taps; ++k )
+          weights[ k ] /= sum;
+      }
+      return kernel;
+    }
+
+    // Weighted sum of taps texels, base[ indices[ k ] * stride ]
+    inline Texel convolve( const Texel *base, usize stride, const u32 *indices,
+                           const f32 *weights, u32 taps ) noexcept {
+      Texel result;
+#if defined( NILE_MIP_SSE )
+      __m128 sum = _mm_setzero_ps();
+      for ( u32 k = 0; k < taps; ++k ) {
+        const __m128 texel = _mm_load_ps( base[ indices[ k ] * stride ].v );
+        sum = _mm_add_ps( sum, _mm_mul_ps( texel, _mm_set1_ps( weights[ k ] ) ) );
+      }
+      _mm_store_ps( result.v, sum );
+#else
+      result = Texel {};
+      for ( u32 k = 0; k < taps; ++k ) {
+        const auto &texel = base[ indices[ k ] * stride ];
+        for ( u32 c = 0; c < MipChain::CHANNELS; ++c )
+          result.v[ c ] += texel.v[ c ] * weights[ k ];
+      }
+#endif
+      return result;
+    }
+
+    void decode( const u8 *pixels, Texel *texels, usize count, bool srgb ) noexcept {
+      const auto *table = decodeTable();
+      for ( usize i = 0; i < count; ++i ) {
+        const auto *pixel = pixels + i * MipChain::CHANNELS;
+        const f32 alpha = pixel[ 3 ] / 255.0f;
+        for ( u32 c = 0; c < 3; ++c )
+          texels[ i ].v[ c ] = ( srgb ? table[ pixel[ c ] ] : pixel[ c ] / 255.0f ) * alpha;
+        texels[ i ].v[ 3 ] = alpha;
+      }
+    }
+
+    void encode( const Texel *texels, u8 *pixels, usize count, bool srgb ) noexcept {
+      const auto *table = encodeTable();
+      for ( usize i = 0; i < count; ++i ) {
+        auto *pixel = pixels + i * MipChain::CHANNELS;
+        // The negative lobes of the sinc can overshoot
+        const f32 alpha = std::clamp( texels[ i ].v[ 3 ], 0.0f, 1.0f );
+        for ( u32 c = 0; c < 3; ++c ) {
+          const f32 color =
+              alpha > 0.0f ? std::clamp( texels[ i ].v[ c ] / alpha, 0.0f, 1.0f ) : 0.0f;
+          pixel[ c ] = srgb ? table[ std::lround( color * ( ENCODE_STEPS - 1 ) ) ]
+                            : static_cast<u8>( std::lround( color * 255.0f ) );
+        }
+        pixel[ 3 ] = static_cast<u8>( std::lround( alpha * 255.0f ) );
+      }
+    }
+
+  }    // namespace
+
+  u32 MipChain::levelCount( u32 width, u32 height ) noexcept {
+    u32 levels = 1;
+    for ( u32 size = std::max( width, height ); size > 1; size >>= 1 )
+      ++levels;
+    return levels;
+  }
+
+  void MipChain::build( const u8 *rgba, u32 width, u32 height,
+                        const MipChainOptions &options ) noexcept {
+
+    m_levels.clear();
+    m_pixels.clear();
+    if ( !rgba || width == 0 || height == 0 )
+      return;
+
+    usize bytes = 0;
+    const auto levels = levelCount( width, height );
+    for ( u32 level = 0, w = width, h = height; level < levels; ++level ) {
+      m_levels.push_back( {w, h, bytes} );
+      bytes += static_cast<usize>( w ) * h * CHANNELS;
+      w = std::max( 1u, w >> 1 );
+      h = std::max( 1u, h >> 1 );
+    }
+    m_pixels.resize( bytes );
+    std::memcpy( m_pixels.data(), rgba, static_cast<usize>( width ) * height * CHANNELS );
+
+    const u32 threads = options.threads ? options.threads : hardwareThreads();
+    const bool srgb = options.srgb;
+
+    // The chain is filtered from floats, the 8 bit levels are only written out
+    std::vector<Texel> source( static_cast<usize>( width ) * height );
+    std::vector<Texel> rows;
+    std::vector<Texel> target;
+    decode( rgba, source.data(), source.size(), srgb );
+
+    for ( u32 level = 1; level < levels; ++level ) {
+      const auto &above = m_levels[ level - 1 ];
+      const auto &current = m_levels[ level ];
+      const u32 sw = above.width;
+      const u32 sh = above.height;
+      const u32 dw = current.width;
+      const u32 dh = current.height;
+      const u32 workers = sw * sh >= PARALLEL_TEXELS ? threads : 1;
+
+      const auto horizontal = makeKernel( sw, dw, options.filter, options.wrap );
+      const auto vertical = makeKernel( sh, dh, options.filter, options.wrap );
+
+      // Rows first, sh x dw texels, then the columns of those
+      rows.resize( static_cast<usize>( dw ) * sh );
+      parallelFor( sh, workers, [ & ]( u32 begin, u32 end ) {
+        for ( u32 y = begin; y < end; ++y ) {
+          const auto *row = source.data() + static_cast<usize>( y ) * sw;
+          for ( u32 x = 0; x < dw; ++x ) {
+            const usize tap = static_cast<usize>( x ) * horizontal.taps;
+            rows[ static_cast<usize>( y ) * dw + x ] =
+                convolve( row, 1, horizontal.indices.data() + tap,
+                          horizontal.weights.data() + tap, horizontal.taps );
+          }
+        }
+      } );
+
+      target.resize( static_cast<usize>( dw ) * dh );
+      auto *pixels = m_pixels.data() + current.offset;
+      parallelFor( dh, workers, [ & ]( u32 begin, u32 end ) {
+        for ( u32 y = begin; y < end; ++y ) {
+          const usize tap = static_cast<usize>( y ) * vertical.taps;
+          auto *row = target.data() + static_cast<usize>( y ) * dw;
+          for ( u32 x = 0; x < dw; ++x )
+            row[ x ] = convolve( rows.data() + x, dw, vertical.indices.data() + tap,
+                                 vertical.weights.data() + tap, vertical.taps );
+          encode( row, pixels + static_cast<usize>( y ) * dw * CHANNELS, dw, srgb );
+        }
+      } );
+
+      std::swap( source, target );
+    }
+  }
+
+  usize MipChain::getBaseBytes() const noexcept {
+    return m_levels.empty() ? 0 : static_cast<usize>( m_levels[ 0 ].width ) *
+                                      m_levels[ 0 ].height * CHANNELS;
+  }
+
+  usize MipChain::getMipBytes() const noexcept {
+    return m_pixels.size() - this->getBaseBytes();
+  }
+
+}    // namespace nile
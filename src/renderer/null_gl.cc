@@ -0,0 +1,626 @@
+/* ================================================================================
+$File: null_gl.cc
+$Date: $
+$Revision: $
+$Creator: Rostislav Orestis Stelmach
+$Notice: $
+================================================================================ */
+
+#include "Nile/renderer/null_renderer.hh"
+
+#include <GL/glew.h>
+
+#include <cstdint>
+
+// OpenGL entry points of the engine that only count, see null_renderer.hh.
+// GL 1.1 functions are exported by libGL and declared as functions by GLEW, so they
+// are defined as such. Everything newer is called through the function pointers GLEW
+// loads in glewInit(), those pointers are defined here and point to the null functions.
+// A GL function the engine starts using has to be added here as well, the null build
+// fails to link otherwise.
+
+namespace nile {
+
+  namespace {
+
+    NullGLStats stats;
+
+    // Names of all the objects, 0 is never handed out
+    GLuint lastName = 0;
+
+    // Viewport, returned by glGetIntegerv( GL_VIEWPORT )
+    GLint viewport[ 4 ] = {0, 0, 0, 0};
+
+    void generate( GLsizei n, GLuint *names ) noexcept {
+      ++stats.calls;
+      for ( GLsizei i = 0; i < n; ++i )
+        names[ i ] = ++lastName;
+    }
+
+    void call() noexcept {
+      ++stats.calls;
+    }
+
+    void stateChange() noexcept {
+      ++stats.calls;
+      ++stats.stateChanges;
+    }
+
+    void uniformSet() noexcept {
+      ++stats.calls;
+      ++stats.uniformSets;
+    }
+
+    void draw( u32 commands ) noexcept {
+      ++stats.calls;
+      ++stats.draws;
+      stats.drawCommands += commands;
+    }
+
+    void upload( GLsizeiptr bytes ) noexcept {
+      ++stats.calls;
+      stats.bufferBytes += static_cast<u64>( bytes );
+    }
+
+  }    // namespace
+
+  namespace NullGL {
+
+    const NullGLStats &getStats() noexcept {
+      return stats;
+    }
+
+    void resetStats() noexcept {
+      stats = NullGLStats {};
+    }
+
+  }    // namespace NullGL
+
+}    // namespace nile
+
+using namespace nile;
+
+// GL 1.1
+extern "C" {
+
+void GLAPIENTRY glBindTexture( GLenum, GLuint ) {
+  ++stats.calls;
+  ++stats.textureBinds;
+}
+
+void GLAPIENTRY glBlendFunc( GLenum, GLenum ) {
+  stateChange();
+}
+
+void GLAPIENTRY glClear( GLbitfield ) {
+  call();
+}
+
+void GLAPIENTRY glClearColor( GLfloat, GLfloat, GLfloat, GLfloat ) {
+  stateChange();
+}
+
+void GLAPIENTRY glClearDepth( GLclampd ) {
+  stateChange();
+}
+
+void GLAPIENTRY glDeleteTextures( GLsizei, const GLuint * ) {
+  call();
+}
+
+void GLAPIENTRY glDepthFunc( GLenum ) {
+  stateChange();
+}
+
+void GLAPIENTRY glDepthMask( GLboolean ) {
+  stateChange();
+}
+
+void GLAPIENTRY glDisable( GLenum ) {
+  stateChange();
+}
+
+void GLAPIENTRY glDrawArrays( GLenum, GLint, GLsizei ) {
+  draw( 1 );
+}
+
+void GLAPIENTRY glDrawBuffer( GLenum ) {
+  call();
+}
+
+void GLAPIENTRY glDrawElements( GLenum, GLsizei, GLenum, const void * ) {
+  draw( 1 );
+}
+
+void GLAPIENTRY glEnable( GLenum ) {
+  stateChange();
+}
+
+void GLAPIENTRY glFlush() {
+  call();
+}
+
+void GLAPIENTRY glGenTextures( GLsizei n, GLuint *textures ) {
+  generate( n, textures );
+}
+
+GLenum GLAPIENTRY glGetError() {
+  call();
+  return GL_NO_ERROR;
+}
+
+void GLAPIENTRY glGetIntegerv( GLenum pname, GLint *data ) {
+  call();
+  switch ( pname ) {
+    case GL_VIEWPORT:
+      for ( int i = 0; i < 4; ++i )
+        data[ i ] = viewport[ i ];
+      break;
+    case GL_MAJOR_VERSION:
+      *data = 4;
+      break;
+    case GL_MINOR_VERSION:
+      *data = 3;
+      break;
+    default:
+      *data = 0;
+      break;
+  }
+}
+
+const GLubyte *GLAPIENTRY glGetString( GLenum name ) {
+  call();
+  const char *string = "";
+  switch ( name ) {
+    case GL_VENDOR:
+      string = "Nile";
+      break;
+    case GL_RENDERER:
+      string = "Null OpenGL";
+      break;
+    case GL_VERSION:
+      string = "4.3 Null";
+      break;
+    case GL_SHADING_LANGUAGE_VERSION:
+      string = "4.30";
+      break;
+    default:
+      break;
+  }
+  return reinterpret_cast<const GLubyte *>( string );
+}
+
+void GLAPIENTRY glPixelStorei( GLenum, GLint ) {
+  stateChange();
+}
+
+void GLAPIENTRY glPolygonMode( GLenum, GLenum ) {
+  stateChange();
+}
+
+void GLAPIENTRY glReadBuffer( GLenum ) {
+  stateChange();
+}
+
+// Leaves the pixels as they are, there is nothing to read back
+void GLAPIENTRY glReadPixels( GLint, GLint, GLsizei, GLsizei, GLenum, GLenum, void * ) {
+  call();
+}
+
+void GLAPIENTRY glTexImage2D( GLenum, GLint, GLint, GLsizei, GLsizei, GLint, GLenum, GLenum,
+                              const void * ) {
+  call();
+}
+
+void GLAPIENTRY glTexParameteri( GLenum, GLenum, GLint ) {
+  call();
+}
+
+void GLAPIENTRY glViewport( GLint x, GLint y, GLsizei width, GLsizei height ) {
+  stateChange();
+  viewport[ 0 ] = x;
+  viewport[ 1 ] = y;
+  viewport[ 2 ] = width;
+  viewport[ 3 ] = height;
+}
+
+}    // extern "C"
+
+// Newer than GL 1.1, called through GLEW
+namespace {
+
+  // Buffers
+
+  void GLAPIENTRY nullBindBuffer( GLenum, GLuint ) {
+    ++stats.calls;
+    ++stats.bufferBinds;
+  }
+
+  void GLAPIENTRY nullBindBufferBase( GLenum, GLuint, GLuint ) {
+    ++stats.calls;
+    ++stats.bufferBinds;
+  }
+
+  void GLAPIENTRY nullBufferData( GLenum, GLsizeiptr size, const void *data, GLenum ) {
+    upload( data ? size : 0 );
+  }
+
+  void GLAPIENTRY nullBufferStorage( GLenum, GLsizeiptr size, const void *data, GLbitfield ) {
+    upload( data ? size : 0 );
+  }
+
+  void GLAPIENTRY nullBufferSubData( GLenum, GLintptr, GLsizeiptr size, const void * ) {
+    upload( size );
+  }
+
+  void GLAPIENTRY nullCopyBufferSubData( GLenum, GLenum, GLintptr, GLintptr, GLsizeiptr size ) {
+    upload( size );
+  }
+
+  void GLAPIENTRY nullDeleteBuffers( GLsizei, const GLuint * ) {
+    call();
+  }
+
+  void GLAPIENTRY nullGenBuffers( GLsizei n, GLuint *buffers ) {
+    generate( n, buffers );
+  }
+
+  // There is no memory to map, callers fall back to glBufferSubData
+  void *GLAPIENTRY nullMapBufferRange( GLenum, GLintptr, GLsizeiptr, GLbitfield ) {
+    call();
+    return nullptr;
+  }
+
+  void GLAPIENTRY nullTexBuffer( GLenum, GLenum, GLuint ) {
+    call();
+  }
+
+  // Vertex arrays
+
+  void GLAPIENTRY nullBindVertexArray( GLuint ) {
+    stateChange();
+  }
+
+  void GLAPIENTRY nullDeleteVertexArrays( GLsizei, const GLuint * ) {
+    call();
+  }
+
+  void GLAPIENTRY nullEnableVertexAttribArray( GLuint ) {
+    stateChange();
+  }
+
+  void GLAPIENTRY nullGenVertexArrays( GLsizei n, GLuint *arrays ) {
+    generate( n, arrays );
+  }
+
+  void GLAPIENTRY nullVertexAttribDivisor( GLuint, GLuint ) {
+    stateChange();
+  }
+
+  void GLAPIENTRY nullVertexAttribPointer( GLuint, GLint, GLenum, GLboolean, GLsizei,
+                                           const void * ) {
+    stateChange();
+  }
+
+  // Draws
+
+  void GLAPIENTRY nullDrawArraysInstanced( GLenum, GLint, GLsizei, GLsizei ) {
+    draw( 1 );
+  }
+
+  void GLAPIENTRY nullDrawElementsInstanced( GLenum, GLsizei, GLenum, const void *, GLsizei ) {
+    draw( 1 );
+  }
+
+  void GLAPIENTRY nullDrawElementsInstancedBaseVertex( GLenum, GLsizei, GLenum, const void *,
+                                                       GLsizei, GLint ) {
+    draw( 1 );
+  }
+
+  void GLAPIENTRY nullDrawElementsInstancedBaseVertexBaseInstance( GLenum, GLsizei, GLenum,
+                                                                   const void *, GLsizei, GLint,
+                                                                   GLuint ) {
+    draw( 1 );
+  }
+
+  void GLAPIENTRY nullMultiDrawElementsIndirect( GLenum, GLenum, const void *, GLsizei count,
+                                                 GLsizei ) {
+    draw( static_cast<u32>( count ) );
+  }
+
+  // Textures and framebuffers
+
+  void GLAPIENTRY nullActiveTexture( GLenum ) {
+    stateChange();
+  }
+
+  void GLAPIENTRY nullBindFramebuffer( GLenum, GLuint ) {
+    stateChange();
+  }
+
+  void GLAPIENTRY nullBindRenderbuffer( GLenum, GLuint ) {
+    stateChange();
+  }
+
+  GLenum GLAPIENTRY nullCheckFramebufferStatus( GLenum ) {
+    call();
+    return GL_FRAMEBUFFER_COMPLETE;
+  }
+
+  void GLAPIENTRY nullCompressedTexImage2D( GLenum, GLint, GLenum, GLsizei, GLsizei, GLint,
+                                            GLsizei, const void * ) {
+    call();
+  }
+
+  void GLAPIENTRY nullDeleteFramebuffers( GLsizei, const GLuint * ) {
+    call();
+  }
+
+  void GLAPIENTRY nullDeleteRenderbuffers( GLsizei, const GLuint * ) {
+    call();
+  }
+
+  void GLAPIENTRY nullFramebufferRenderbuffer( GLenum, GLenum, GLenum, GLuint ) {
+    call();
+  }
+
+  void GLAPIENTRY nullFramebufferTexture2D( GLenum, GLenum, GLenum, GLuint, GLint ) {
+    call();
+  }
+
+  void GLAPIENTRY nullGenFramebuffers( GLsizei n, GLuint *framebuffers ) {
+    generate( n, framebuffers );
+  }
+
+  void GLAPIENTRY nullGenRenderbuffers( GLsizei n, GLuint *renderbuffers ) {
+    generate( n, renderbuffers );
+  }
+
+  void GLAPIENTRY nullRenderbufferStorage( GLenum, GLenum, GLsizei, GLsizei ) {
+    call();
+  }
+
+  // Shaders, every shader compiles and every program links
+
+  void GLAPIENTRY nullAttachShader( GLuint, GLuint ) {
+    call();
+  }
+
+  void GLAPIENTRY nullCompileShader( GLuint ) {
+    call();
+  }
+
+  GLuint GLAPIENTRY nullCreateProgram() {
+    call();
+    return ++lastName;
+  }
+
+  GLuint GLAPIENTRY nullCreateShader( GLenum ) {
+    call();
+    return ++lastName;
+  }
+
+  void GLAPIENTRY nullDeleteProgram( GLuint ) {
+    call();
+  }
+
+  void GLAPIENTRY nullDeleteShader( GLuint ) {
+    call();
+  }
+
+  void GLAPIENTRY nullGetActiveUniform( GLuint, GLuint, GLsizei size, GLsizei *length, GLint *count,
+                                        GLenum *type, GLchar *name ) {
+    call();
+    *length = 0;
+    *count = 0;
+    *type = GL_FLOAT;
+    if ( size > 0 )
+      name[ 0 ] = '\0';
+  }
+
+  void GLAPIENTRY nullGetInfoLog( GLuint, GLsizei size, GLsizei *length, GLchar *log ) {
+    call();
+    if ( length )
+      *length = 0;
+    if ( size > 0 )
+      log[ 0 ] = '\0';
+  }
+
+  // Programs have no active uniforms
+  void GLAPIENTRY nullGetProgramiv( GLuint, GLenum pname, GLint *params ) {
+    call();
+    *params = ( pname == GL_LINK_STATUS ) ? GL_TRUE : 0;
+  }
+
+  void GLAPIENTRY nullGetShaderiv( GLuint, GLenum pname, GLint *params ) {
+    call();
+    *params = ( pname == GL_COMPILE_STATUS ) ? GL_TRUE : 0;
+  }
+
+  // Blocks are found, so they are bound like with a real program
+  GLuint GLAPIENTRY nullGetUniformBlockIndex( GLuint, const GLchar * ) {
+    call();
+    return 0;
+  }
+
+  GLint GLAPIENTRY nullGetUniformLocation( GLuint, const GLchar * ) {
+    call();
+    return -1;
+  }
+
+  void GLAPIENTRY nullLinkProgram( GLuint ) {
+    call();
+  }
+
+  void GLAPIENTRY nullShaderSource( GLuint, GLsizei, const GLchar *const *, const GLint * ) {
+    call();
+  }
+
+  void GLAPIENTRY nullUseProgram( GLuint ) {
+    stateChange();
+  }
+
+  // Uniforms
+
+  void GLAPIENTRY nullUniform1f( GLint, GLfloat ) {
+    uniformSet();
+  }
+
+  void GLAPIENTRY nullUniform1i( GLint, GLint ) {
+    uniformSet();
+  }
+
+  void GLAPIENTRY nullUniform2f( GLint, GLfloat, GLfloat ) {
+    uniformSet();
+  }
+
+  void GLAPIENTRY nullUniform3f( GLint, GLfloat, GLfloat, GLfloat ) {
+    uniformSet();
+  }
+
+  void GLAPIENTRY nullUniform4f( GLint, GLfloat, GLfloat, GLfloat, GLfloat ) {
+    uniformSet();
+  }
+
+  void GLAPIENTRY nullUniformBlockBinding( GLuint, GLuint, GLuint ) {
+    uniformSet();
+  }
+
+  void GLAPIENTRY nullUniformMatrix4fv( GLint, GLsizei, GLboolean, const GLfloat * ) {
+    uniformSet();
+  }
+
+  // Queries, all results are available right away and are 0
+
+  void GLAPIENTRY nullDeleteQueries( GLsizei, const GLuint * ) {
+    call();
+  }
+
+  void GLAPIENTRY nullGenQueries( GLsizei n, GLuint *ids ) {
+    generate( n, ids );
+  }
+
+  void GLAPIENTRY nullGetQueryObjectui64v( GLuint, GLenum, GLuint64 *params ) {
+    call();
+    *params = 0;
+  }
+
+  void GLAPIENTRY nullGetQueryObjectuiv( GLuint, GLenum pname, GLuint *params ) {
+    call();
+    *params = ( pname == GL_QUERY_RESULT_AVAILABLE ) ? GL_TRUE : 0;
+  }
+
+  void GLAPIENTRY nullQueryCounter( GLuint, GLenum ) {
+    call();
+  }
+
+  // Syncs, the GPU is always done
+
+  GLenum GLAPIENTRY nullClientWaitSync( GLsync, GLbitfield, GLuint64 ) {
+    call();
+    return GL_ALREADY_SIGNALED;
+  }
+
+  void GLAPIENTRY nullDeleteSync( GLsync ) {
+    call();
+  }
+
+  GLsync GLAPIENTRY nullFenceSync( GLenum, GLbitfield ) {
+    call();
+    return reinterpret_cast<GLsync>( static_cast<uintptr_t>( ++lastName ) );
+  }
+
+}    // namespace
+
+// GLEW
+extern "C" {
+
+GLboolean glewExperimental = GL_FALSE;
+
+GLenum glewInit() {
+  return GLEW_OK;
+}
+
+GLboolean __GLEW_VERSION_3_0 = GL_TRUE;
+GLboolean __GLEW_VERSION_3_3 = GL_TRUE;
+GLboolean __GLEW_VERSION_4_2 = GL_TRUE;
+GLboolean __GLEW_VERSION_4_3 = GL_TRUE;
+GLboolean __GLEW_VERSION_4_4 = GL_FALSE;
+GLboolean __GLEW_ARB_buffer_storage = GL_FALSE;
+GLboolean __GLEW_ARB_multi_draw_indirect = GL_TRUE;
+GLboolean __GLEW_ARB_timer_query = GL_TRUE;
+GLboolean __GLEW_ARB_ES3_compatibility = GL_TRUE;
+GLboolean __GLEW_ARB_texture_compression_bptc = GL_TRUE;
+GLboolean __GLEW_ARB_texture_compression_rgtc = GL_TRUE;
+GLboolean __GLEW_EXT_texture_compression_s3tc = GL_TRUE;
+
+PFNGLACTIVETEXTUREPROC __glewActiveTexture = nullActiveTexture;
+PFNGLATTACHSHADERPROC __glewAttachShader = nullAttachShader;
+PFNGLBINDBUFFERPROC __glewBindBuffer = nullBindBuffer;
+PFNGLBINDBUFFERBASEPROC __glewBindBufferBase = nullBindBufferBase;
+PFNGLBINDFRAMEBUFFERPROC __glewBindFramebuffer = nullBindFramebuffer;
+PFNGLBINDRENDERBUFFERPROC __glewBindRenderbuffer = nullBindRenderbuffer;
+PFNGLBINDVERTEXARRAYPROC __glewBindVertexArray = nullBindVertexArray;
+PFNGLBUFFERDATAPROC __glewBufferData = nullBufferData;
+PFNGLBUFFERSTORAGEPROC __glewBufferStorage = nullBufferStorage;
+PFNGLBUFFERSUBDATAPROC __glewBufferSubData = nullBufferSubData;
+PFNGLCHECKFRAMEBUFFERSTATUSPROC __glewCheckFramebufferStatus = nullCheckFramebufferStatus;
+PFNGLCLIENTWAITSYNCPROC __glewClientWaitSync = nullClientWaitSync;
+PFNGLCOMPILESHADERPROC __glewCompileShader = nullCompileShader;
+PFNGLCOMPRESSEDTEXIMAGE2DPROC __glewCompressedTexImage2D = nullCompressedTexImage2D;
+PFNGLCOPYBUFFERSUBDATAPROC __glewCopyBufferSubData = nullCopyBufferSubData;
+PFNGLCREATEPROGRAMPROC __glewCreateProgram = nullCreateProgram;
+PFNGLCREATESHADERPROC __glewCreateShader = nullCreateShader;
+PFNGLDELETEBUFFERSPROC __glewDeleteBuffers = nullDeleteBuffers;
+PFNGLDELETEFRAMEBUFFERSPROC __glewDeleteFramebuffers = nullDeleteFramebuffers;
+PFNGLDELETEPROGRAMPROC __glewDeleteProgram = nullDeleteProgram;
+PFNGLDELETEQUERIESPROC __glewDeleteQueries = nullDeleteQueries;
+PFNGLDELETERENDERBUFFERSPROC __glewDeleteRenderbuffers = nullDeleteRenderbuffers;
+PFNGLDELETESHADERPROC __glewDeleteShader = nullDeleteShader;
+PFNGLDELETESYNCPROC __glewDeleteSync = nullDeleteSync;
+PFNGLDELETEVERTEXARRAYSPROC __glewDeleteVertexArrays = nullDeleteVertexArrays;
+PFNGLDRAWARRAYSINSTANCEDPROC __glewDrawArraysInstanced = nullDrawArraysInstanced;
+PFNGLDRAWELEMENTSINSTANCEDPROC __glewDrawElementsInstanced = nullDrawElementsInstanced;
+PFNGLDRAWELEMENTSINSTANCEDBASEVERTEXPROC __glewDrawElementsInstancedBaseVertex =
+    nullDrawElementsInstancedBaseVertex;
+PFNGLDRAWELEMENTSINSTANCEDBASEVERTEXBASEINSTANCEPROC
+    __glewDrawElementsInstancedBaseVertexBaseInstance =
+        nullDrawElementsInstancedBaseVertexBaseInstance;
+PFNGLENABLEVERTEXATTRIBARRAYPROC __glewEnableVertexAttribArray = nullEnableVertexAttribArray;
+PFNGLFENCESYNCPROC __glewFenceSync = nullFenceSync;
+PFNGLFRAMEBUFFERRENDERBUFFERPROC __glewFramebufferRenderbuffer = nullFramebufferRenderbuffer;
+PFNGLFRAMEBUFFERTEXTURE2DPROC __glewFramebufferTexture2D = nullFramebufferTexture2D;
+PFNGLGENBUFFERSPROC __glewGenBuffers = nullGenBuffers;
+PFNGLGENFRAMEBUFFERSPROC __glewGenFramebuffers = nullGenFramebuffers;
+PFNGLGENQUERIESPROC __glewGenQueries = nullGenQueries;
+PFNGLGENRENDERBUFFERSPROC __glewGenRenderbuffers = nullGenRenderbuffers;
+PFNGLGENVERTEXARRAYSPROC __glewGenVertexArrays = nullGenVertexArrays;
+PFNGLGETACTIVEUNIFORMPROC __glewGetActiveUniform = nullGetActiveUniform;
+PFNGLGETPROGRAMINFOLOGPROC __glewGetProgramInfoLog = nullGetInfoLog;
+PFNGLGETPROGRAMIVPROC __glewGetProgramiv = nullGetProgramiv;
+PFNGLGETQUERYOBJECTUI64VPROC __glewGetQueryObjectui64v = nullGetQueryObjectui64v;
+PFNGLGETQUERYOBJECTUIVPROC __glewGetQueryObjectuiv = nullGetQueryObjectuiv;
+PFNGLGETSHADERINFOLOGPROC __glewGetShaderInfoLog = nullGetInfoLog;
+PFNGLGETSHADERIVPROC __glewGetShaderiv = nullGetShaderiv;
+PFNGLGETUNIFORMBLOCKINDEXPROC __glewGetUniformBlockIndex = nullGetUniformBlockIndex;
+PFNGLGETUNIFORMLOCATIONPROC __glewGetUniformLocation = nullGetUniformLocation;
+PFNGLLINKPROGRAMPROC __glewLinkProgram = nullLinkProgram;
+PFNGLMAPBUFFERRANGEPROC __glewMapBufferRange = nullMapBufferRange;
+PFNGLMULTIDRAWELEMENTSINDIRECTPROC __glewMultiDrawElementsIndirect =
+    nullMultiDrawElementsIndirect;
+PFNGLQUERYCOUNTERPROC __glewQueryCounter = nullQueryCounter;
+PFNGLRENDERBUFFERSTORAGEPROC __glewRenderbufferStorage = nullRenderbufferStorage;
+PFNGLSHADERSOURCEPROC __glewShaderSource = nullShaderSource;
+PFNGLTEXBUFFERPROC __glewTexBuffer = nullTexBuffer;
+PFNGLUNIFORM1FPROC __glewUniform1f = nullUniform1f;
+PFNGLUNIFORM1IPROC __glewUniform1i = nullUniform1i;
+PFNGLUNIFORM2FPROC __glewUniform2f = nullUniform2f;
+PFNGLUNIFORM3FPROC __glewUniform3f = nullUniform3f;
+PFNGLUNIFORM4FPROC __glewUniform4f = nullUniform4f;
+PFNGLUNIFORMBLOCKBINDINGPROC __glewUniformBlockBinding = nullUniformBlockBinding;
+PFNGLUNIFORMMATRIX4FVPROC __glewUniformMatrix4fv = nullUniformMatrix4fv;
+PFNGLUSEPROGRAMPROC __glewUseProgram = nullUseProgram;
+PFNGLVERTEXATTRIBDIVISORPROC __glewVertexAttribDivisor = nullVertexAttribDivisor;
+PFNGLVERTEXATTRIBPOINTERPROC __glewVertexAttribPointer = nullVertexAttribPointer;
+
+}    // extern "C"
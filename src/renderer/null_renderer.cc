@@ -0,0 +1,77 @@
+/* ================================================================================
+$File: null_renderer.cc
+$Date: $
+$Revision: $
+$Creator: Rostislav Orestis Stelmach
+$Notice: $
+================================================================================ */
+
+#include "Nile/renderer/null_renderer.hh"
+
+#include "Nile/core/settings.hh"
+#include "Nile/debug/debug_draw.hh"
+#include "Nile/renderer/frame_uniforms.hh"
+#include "Nile/renderer/gl_state_cache.hh"
+#include "Nile/renderer/gpu_profiler.hh"
+#include "Nile/renderer/render_queue.hh"
+#include "Nile/renderer/stream_buffer.hh"
+#include <GL/glew.h>
+#include <spdlog/spdlog.h>
+
+namespace nile {
+
+  NullRenderer::NullRenderer( std::shared_ptr<Settings> settings ) noexcept
+      : m_settings( settings )
+      , m_stateCache( std::make_shared<GLStateCache>() )
+      , m_renderQueue( std::make_shared<RenderQueue>() )
+      , m_frameUniforms( std::make_shared<FrameUniforms>() )
+      , m_streamBuffer( std::make_shared<StreamBuffer>() )
+      , m_debugDraw( std::make_shared<DebugDraw>() )
+      , m_gpuProfiler( std::make_shared<GpuProfiler>() ) {}
+
+  NullRenderer::~NullRenderer() noexcept {
+    // Empty Destructor
+  }
+
+  void NullRenderer::initRenderer() noexcept {
+    // Nothing to initialize, the null GL is ready once it is linked
+  }
+
+  void NullRenderer::initWindow() noexcept {
+    glewInit();
+    glViewport( 0, 0, static_cast<GLsizei>( m_settings->getWidth() ),
+                static_cast<GLsizei>( m_settings->getHeight() ) );
+
+    spdlog::info( "NullRenderer: {}, GL calls are counted and not executed",
+                  reinterpret_cast<const char *>( glGetString( GL_RENDERER ) ) );
+  }
+
+  void NullRenderer::init() noexcept {
+    this->initRenderer();
+    this->initWindow();
+  }
+
+  void NullRenderer::destroy() noexcept {}
+
+  void NullRenderer::submitFrame() noexcept {
+    NullGL::resetStats();
+
+    // Same work as OpenGLRenderer, it is part of what is measured
+    m_stateCache->beginFrame();
+    m_streamBuffer->beginFrame();
+    m_gpuProfiler->beginFrame();
+    m_gpuProfiler->begin( "frame" );
+
+    glClearColor( 0.1f, 0.1f, 0.1f, 1.0f );
+    glClear( GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT );
+  }
+
+  void NullRenderer::endFrame() noexcept {
+    m_streamBuffer->endFrame();
+    m_gpuProfiler->end();
+    m_gpuProfiler->endFrame();
+
+    m_lastFrameStats = NullGL::getStats();
+  }
+
+}    // namespace nile
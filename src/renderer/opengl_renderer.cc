@@ -10,7 +10,13 @@ $Notice: $
 
 #include "Nile/core/assert.hh"
 #include "Nile/core/settings.hh"
+#include "Nile/debug/debug_draw.hh"
 #include "Nile/log/log.hh"
+#include "Nile/renderer/frame_uniforms.hh"
+#include "Nile/renderer/gl_state_cache.hh"
+#include "Nile/renderer/gpu_profiler.hh"
+#include "Nile/renderer/render_queue.hh"
+#include "Nile/renderer/stream_buffer.hh"
 #include <GL/glew.h>
 #include <glm/gtc/matrix_transform.hpp>
 #include <vector>
@@ -18,7 +24,13 @@ $Notice: $
 namespace nile {
 
   OpenGLRenderer::OpenGLRenderer( std::shared_ptr<Settings> settings ) noexcept
-      : m_settings( settings ) {}
+      : m_settings( settings )
+      , m_stateCache( std::make_shared<GLStateCache>() )
+      , m_renderQueue( std::make_shared<RenderQueue>() )
+      , m_frameUniforms( std::make_shared<FrameUniforms>() )
+      , m_streamBuffer( std::make_shared<StreamBuffer>() )
+      , m_debugDraw( std::make_shared<DebugDraw>() )
+      , m_gpuProfiler( std::make_shared<GpuProfiler>() ) {}
 
   OpenGLRenderer::~OpenGLRenderer() noexcept {
     // Empty Destructor
@@ -86,6 +98,12 @@ namespace nile {
   }
 
   void OpenGLRenderer::submitFrame() noexcept {
+    // Anything could have changed the state since the last frame
+    m_stateCache->beginFrame();
+    m_streamBuffer->beginFrame();
+    m_gpuProfiler->beginFrame();
+    m_gpuProfiler->begin( "frame" );
+
     if ( m_settings->getDebugMode() ) {
       glClearColor( 0.1f, 0.1f, 0.1f, 1.0f );
     } else {
@@ -95,6 +113,10 @@ namespace nile {
   }
 
   void OpenGLRenderer::endFrame() noexcept {
+    // The draws of the frame are submitted, fence its part of the stream buffer
+    m_streamBuffer->endFrame();
+    m_gpuProfiler->end();
+    m_gpuProfiler->endFrame();
     SDL_GL_SwapWindow( m_window );
   }
 
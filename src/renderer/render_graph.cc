@@ -0,0 +1,375 @@
+/* ================================================================================
+$File: render_graph.cc
+$Date: $
+$Revision: $
+$Creator: Rostislav Orestis Stelmach
+$Notice: $
+================================================================================ */
+
+#include "Nile/renderer/render_graph.hh"
+#include "Nile/log/log.hh"
+#include "Nile/renderer/gl_state_cache.hh"
+#include "Nile/renderer/gpu_profiler.hh"
+
+#include <GL/glew.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace nile {
+
+  u32 RenderPassContext::getTexture( RenderResource resource ) const noexcept {
+    const RenderTarget *target = m_graph.getTarget( resource );
+    if ( !target )
+      return 0;
+    if ( target->color )
+      return target->color;
+    return target->depth == RenderTargetDepth::TEXTURE ? target->depthStencil : 0;
+  }
+
+  u32 RenderPassContext::getDepthTexture( RenderResource resource ) const noexcept {
+    const RenderTarget *target = m_graph.getTarget( resource );
+    return target && target->depth == RenderTargetDepth::TEXTURE ? target->depthStencil : 0;
+  }
+
+  void RenderPassContext::drawFullscreen() noexcept {
+    if ( !m_graph.m_emptyVertexArray )
+      glGenVertexArrays( 1, &m_graph.m_emptyVertexArray );
+    m_state.bindVertexArray( m_graph.m_emptyVertexArray );
+    glDrawArrays( GL_TRIANGLES, 0, 3 );
+  }
+
+  RenderPassBuilder &RenderPassBuilder::read( RenderResource resource ) noexcept {
+    if ( !m_graph.isTarget( resource ) ) {
+      log::error( "RenderGraph: pass { %s } reads a resource that is not a target\n",
+                  m_graph.m_passes[ m_pass ].name );
+      return *this;
+    }
+    m_graph.m_passes[ m_pass ].reads.push_back( resource );
+    m_graph.m_dirty = true;
+    return *this;
+  }
+
+  RenderPassBuilder &RenderPassBuilder::write( RenderResource resource ) noexcept {
+    if ( resource >= m_graph.m_resources.size() ) {
+      log::error( "RenderGraph: pass { %s } writes an unknown resource\n",
+                  m_graph.m_passes[ m_pass ].name );
+      return *this;
+    }
+    m_graph.m_passes[ m_pass ].output = resource;
+    m_graph.m_dirty = true;
+    return *this;
+  }
+
+  RenderPassBuilder &RenderPassBuilder::setSideEffects() noexcept {
+    m_graph.m_passes[ m_pass ].sideEffects = true;
+    m_graph.m_dirty = true;
+    return *this;
+  }
+
+  RenderGraph::RenderGraph() noexcept : m_pool( MAX_TARGETS * 2 ) {
+    this->clear();
+  }
+
+  RenderGraph::~RenderGraph() noexcept {
+    if ( m_emptyVertexArray )
+      glDeleteVertexArrays( 1, &m_emptyVertexArray );
+  }
+
+  RenderResource RenderGraph::createTarget( const char *name, const RenderTargetDesc &desc,
+                                            const RenderClear &clear ) noexcept {
+    Resource resource;
+    resource.name = name;
+    resource.desc = desc;
+    resource.clear = clear;
+    m_resources.push_back( resource );
+    m_dirty = true;
+    return static_cast<RenderResource>( m_resources.size() - 1 );
+  }
+
+  void RenderGraph::setClear( RenderResource resource, const RenderClear &clear ) noexcept {
+    if ( resource < m_resources.size() )
+      m_resources[ resource ].clear = clear;
+  }
+
+  void RenderGraph::setTargetSize( RenderResource resource, u32 width, u32 height ) noexcept {
+    if ( !this->isTarget( resource ) )
+      return;
+
+    auto &desc = m_resources[ resource ].desc;
+    if ( desc.width != width || desc.height != height ) {
+      desc.width = width;
+      desc.height = height;
+      // The targets of the same description changed, so does the aliasing
+      m_dirty = true;
+    }
+  }
+
+  void RenderGraph::setBackbufferSize( u32 width, u32 height ) noexcept {
+    // Not aliased, no need to compile again
+    m_resources[ BACKBUFFER ].desc.width = width;
+    m_resources[ BACKBUFFER ].desc.height = height;
+  }
+
+  RenderPassBuilder RenderGraph::addPass( const char *name, ExecuteFunction execute ) noexcept {
+    Pass pass;
+    pass.name = name;
+    pass.execute = std::move( execute );
+    m_passes.push_back( std::move( pass ) );
+    m_dirty = true;
+    return RenderPassBuilder( *this, static_cast<u32>( m_passes.size() - 1 ) );
+  }
+
+  void RenderGraph::clear() noexcept {
+    Resource backbuffer;
+    backbuffer.name = "backbuffer";
+    if ( !m_resources.empty() )
+      backbuffer = m_resources[ BACKBUFFER ];
+
+    m_resources.clear();
+    m_resources.push_back( backbuffer );
+    m_passes.clear();
+    m_dirty = true;
+    m_compiled = false;
+  }
+
+  bool RenderGraph::compile() noexcept {
+
+    m_dirty = false;
+    m_compiled = false;
+    m_stats = RenderGraphStats {};
+
+    for ( auto &resource : m_resources ) {
+      resource.firstPass = NONE;
+      resource.lastPass = NONE;
+      resource.instance = 0;
+      resource.target = nullptr;
+    }
+
+    // A pass depends on every earlier pass that wrote what it reads, and on the ones that
+    // wrote its target before it, it draws on top of them
+    std::vector<std::vector<u32>> writers( m_resources.size() );
+    std::vector<std::vector<u32>> dependencies( m_passes.size() );
+    std::vector<u32> stack;
+
+    for ( u32 i = 0; i < m_passes.size(); ++i ) {
+      auto &pass = m_passes[ i ];
+      pass.culled = true;
+
+      for ( const auto resource : pass.reads )
+        dependencies[ i ].insert( dependencies[ i ].end(), writers[ resource ].begin(),
+                                  writers[ resource ].end() );
+
+      if ( pass.output != NONE ) {
+        dependencies[ i ].insert( dependencies[ i ].end(), writers[ pass.output ].begin(),
+                                  writers[ pass.output ].end() );
+        writers[ pass.output ].push_back( i );
+      }
+
+      if ( pass.output == BACKBUFFER || pass.sideEffects )
+        stack.push_back( i );
+    }
+
+    while ( !stack.empty() ) {
+      const u32 i = stack.back();
+      stack.pop_back();
+      if ( !m_passes[ i ].culled )
+        continue;
+
+      m_passes[ i ].culled = false;
+      stack.insert( stack.end(), dependencies[ i ].begin(), dependencies[ i ].end() );
+    }
+
+    // Lifetimes of the targets, in passes that run
+    const auto touch = [ this ]( RenderResource resource, u32 pass ) {
+      auto &target = m_resources[ resource ];
+      if ( target.firstPass == NONE )
+        target.firstPass = pass;
+      target.lastPass = pass;
+    };
+
+    for ( u32 i = 0; i < m_passes.size(); ++i ) {
+      const auto &pass = m_passes[ i ];
+      if ( pass.culled ) {
+        ++m_stats.culledPasses;
+        continue;
+      }
+
+      ++m_stats.passes;
+      for ( const auto resource : pass.reads ) {
+        if ( m_resources[ resource ].firstPass == NONE )
+          log::warning( "RenderGraph: pass { %s } reads { %s } before anything writes it\n",
+                        pass.name, m_resources[ resource ].name );
+        touch( resource, i );
+      }
+      if ( pass.output != NONE )
+        touch( pass.output, i );
+    }
+
+    // Targets are given a framebuffer in the order they are first used. A framebuffer of
+    // the same description whose last user ran before is taken over, otherwise one more
+    // instance of that description is needed
+    std::vector<RenderResource> order;
+    for ( RenderResource resource = BACKBUFFER + 1; resource < m_resources.size(); ++resource ) {
+      const auto &target = m_resources[ resource ];
+      if ( target.firstPass == NONE )
+        continue;
+
+      if ( target.desc.width == 0 || target.desc.height == 0 ) {
+        log::error( "RenderGraph: target { %s } has no size\n", target.name );
+        return false;
+      }
+      order.push_back( resource );
+    }
+
+    std::stable_sort( order.begin(), order.end(), [ this ]( RenderResource a, RenderResource b ) {
+      return m_resources[ a ].firstPass < m_resources[ b ].firstPass;
+    } );
+
+    struct Slot {
+      RenderTargetDesc desc;
+      u32 instance;
+      u32 lastPass;
+    };
+    std::vector<Slot> slots;
+    usize resourceBytes = 0;
+
+    for ( const auto resource : order ) {
+      auto &target = m_resources[ resource ];
+      resourceBytes += target.desc.getBytes();
+
+      Slot *free = nullptr;
+      u32 instances = 0;
+      for ( auto &slot : slots ) {
+        if ( !( slot.desc == target.desc ) )
+          continue;
+        ++instances;
+        if ( !free && slot.lastPass < target.firstPass )
+          free = &slot;
+      }
+
+      if ( !free ) {
+        slots.push_back( {target.desc, instances, target.lastPass} );
+        free = &slots.back();
+        m_stats.targetBytes += target.desc.getBytes();
+      }
+
+      free->lastPass = target.lastPass;
+      target.instance = free->instance;
+    }
+
+    m_stats.resources = static_cast<u32>( order.size() );
+    m_stats.targets = static_cast<u32>( slots.size() );
+    m_stats.aliasedBytes = resourceBytes - m_stats.targetBytes;
+
+    if ( m_stats.targets > MAX_TARGETS ) {
+      log::error( "RenderGraph: %u targets are alive at once, %u at most\n", m_stats.targets,
+                  MAX_TARGETS );
+      return false;
+    }
+
+    m_compiled = true;
+    return true;
+  }
+
+  void RenderGraph::execute( GLStateCache &state, GpuProfiler *profiler ) noexcept {
+
+    if ( m_dirty )
+      this->compile();
+
+    m_stats.framebufferBinds = 0;
+    m_stats.clears = 0;
+    if ( !m_compiled )
+      return;
+
+    for ( RenderResource resource = BACKBUFFER + 1; resource < m_resources.size(); ++resource ) {
+      auto &target = m_resources[ resource ];
+      if ( target.firstPass != NONE )
+        target.target = &m_pool.acquire( target.desc, target.instance );
+    }
+
+    const auto &backbuffer = m_resources[ BACKBUFFER ].desc;
+    // Whatever ran before the graph may have bound anything
+    u32 boundFramebuffer = NONE;
+    u32 viewportWidth = NONE;
+    u32 viewportHeight = NONE;
+
+    for ( u32 i = 0; i < m_passes.size(); ++i ) {
+      auto &pass = m_passes[ i ];
+      if ( pass.culled )
+        continue;
+
+      u32 width = backbuffer.width;
+      u32 height = backbuffer.height;
+
+      if ( pass.output != NONE ) {
+        const auto &output = m_resources[ pass.output ];
+        const u32 framebuffer = output.target ? output.target->framebuffer : 0;
+        width = output.desc.width;
+        height = output.desc.height;
+
+        if ( framebuffer != boundFramebuffer ) {
+          glBindFramebuffer( GL_FRAMEBUFFER, framebuffer );
+          boundFramebuffer = framebuffer;
+          ++m_stats.framebufferBinds;
+        }
+
+        if ( width != viewportWidth || height != viewportHeight ) {
+          glViewport( 0, 0, static_cast<GLsizei>( width ), static_cast<GLsizei>( height ) );
+          viewportWidth = width;
+          viewportHeight = height;
+        }
+
+        // The contents of a pooled target are whatever its last user left
+        const auto &clear = output.clear;
+        GLbitfield mask = 0;
+        if ( output.firstPass == i && clear.color &&
+             output.desc.format != RenderTargetFormat::NONE ) {
+          glClearColor( clear.colorValue.r, clear.colorValue.g, clear.colorValue.b,
+                        clear.colorValue.a );
+          mask |= GL_COLOR_BUFFER_BIT;
+        }
+        if ( output.firstPass == i && clear.depth &&
+             output.desc.depth != RenderTargetDepth::NONE ) {
+          state.setDepthWrite( true );
+          glClearDepth( static_cast<GLclampd>( clear.depthValue ) );
+          mask |= GL_DEPTH_BUFFER_BIT;
+        }
+        if ( mask ) {
+          glClear( mask );
+          ++m_stats.clears;
+        }
+      }
+
+      RenderPassContext context( *this, state, width, height );
+      for ( u32 unit = 0; unit < pass.reads.size(); ++unit )
+        state.bindTexture( unit, context.getTexture( pass.reads[ unit ] ) );
+
+      if ( profiler )
+        profiler->begin( pass.name );
+      if ( pass.execute )
+        pass.execute( context );
+      if ( profiler )
+        profiler->end();
+    }
+
+    if ( boundFramebuffer != 0 && boundFramebuffer != NONE ) {
+      glBindFramebuffer( GL_FRAMEBUFFER, 0 );
+      glViewport( 0, 0, static_cast<GLsizei>( backbuffer.width ),
+                  static_cast<GLsizei>( backbuffer.height ) );
+      ++m_stats.framebufferBinds;
+    }
+  }
+
+  bool RenderGraph::isCulled( const char *name ) const noexcept {
+    const auto it = std::find_if( m_passes.begin(), m_passes.end(), [ name ]( const Pass &pass ) {
+      return std::strcmp( pass.name, name ) == 0;
+    } );
+    return it != m_passes.end() && it->culled;
+  }
+
+  const RenderTarget *RenderGraph::getTarget( RenderResource resource ) const noexcept {
+    return this->isTarget( resource ) ? m_resources[ resource ].target : nullptr;
+  }
+
+}    // namespace nile
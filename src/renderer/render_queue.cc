@@ -0,0 +1,188 @@
+/* ================================================================================
+$File: render_queue.cc
+$Date: $
+$Revision: $
+$Creator: Rostislav Orestis Stelmach
+$Notice: $
+================================================================================ */
+
+#include "Nile/renderer/render_queue.hh"
+#include "Nile/renderer/gl_state_cache.hh"
+#include "Nile/renderer/gpu_profiler.hh"
+
+#include <GL/glew.h>
+
+#include <array>
+#include <cstring>
+
+namespace nile {
+
+  namespace {
+
+    constexpr u64 PROGRAM_MASK = ( 1ull << 14 ) - 1;
+    constexpr u64 MATERIAL_MASK = ( 1ull << 16 ) - 1;
+    constexpr u64 DEPTH_MASK = ( 1ull << 24 ) - 1;
+
+    // Profiler scopes of the layers and passes, render systems share them because
+    // their packets are interleaved by the sort
+    constexpr const char *SCOPE_NAMES[ 2 ][ 2 ] = {{"world opaque", "world transparent"},
+                                                  {"overlay opaque", "overlay transparent"}};
+
+    // Bit patterns of non negative floats are ordered like the floats themselves,
+    // keep the 24 most significant bits below the sign
+    u64 depthBits( f32 depth ) noexcept {
+      depth = depth > 0.0f ? depth : 0.0f;
+      u32 bits;
+      std::memcpy( &bits, &depth, sizeof( bits ) );
+      return ( bits >> 7 ) & DEPTH_MASK;
+    }
+
+  }    // namespace
+
+  u64 makeRenderKey( RenderLayer layer, RenderPass pass, u32 program, u32 material,
+                     f32 depth ) noexcept {
+
+    u64 key = static_cast<u64>( layer ) << 56 | static_cast<u64>( pass ) << 54;
+
+    if ( pass == RenderPass::OPAQUE ) {
+      key |= ( program & PROGRAM_MASK ) << 40;
+      key |= ( material & MATERIAL_MASK ) << 24;
+      key |= depthBits( depth );
+    } else {
+      key |= ( DEPTH_MASK - depthBits( depth ) ) << 30;
+      key |= ( program & PROGRAM_MASK ) << 16;
+      key |= material & MATERIAL_MASK;
+    }
+
+    return key;
+  }
+
+  void radixSort( std::vector<SortItem> &items, std::vector<SortItem> &scratch ) noexcept {
+
+    const auto count = items.size();
+    if ( count < 2 )
+      return;
+
+    scratch.resize( count );
+
+    // Histograms of all the bytes in a single pass over the keys
+    std::array<std::array<u32, 256>, 8> histograms {};
+    for ( const auto &item : items ) {
+      for ( u32 pass = 0; pass < 8; ++pass )
+        ++histograms[ pass ][ ( item.key >> ( pass * 8 ) ) & 0xff ];
+    }
+
+    auto *source = &items;
+    auto *destination = &scratch;
+
+    for ( u32 pass = 0; pass < 8; ++pass ) {
+      auto &histogram = histograms[ pass ];
+
+      // Every key has the same byte here, this pass would not move anything
+      const auto shift = pass * 8;
+      if ( histogram[ ( ( *source )[ 0 ].key >> shift ) & 0xff ] == count )
+        continue;
+
+      u32 offset = 0;
+      for ( auto &bucket : histogram ) {
+        const auto size = bucket;
+        bucket = offset;
+        offset += size;
+      }
+
+      for ( const auto &item : *source )
+        ( *destination )[ histogram[ ( item.key >> shift ) & 0xff ]++ ] = item;
+
+      std::swap( source, destination );
+    }
+
+    if ( source != &items )
+      items.swap( scratch );
+  }
+
+  void RenderQueue::setView( const glm::vec3 &position, const glm::vec3 &direction ) noexcept {
+    m_viewPosition = position;
+    m_viewDirection = direction;
+  }
+
+  void RenderQueue::sort() noexcept {
+    m_order.resize( m_packets.size() );
+    for ( u32 i = 0; i < m_packets.size(); ++i )
+      m_order[ i ] = {m_packets[ i ].key, i};
+
+    radixSort( m_order, m_scratch );
+  }
+
+  void RenderQueue::execute( GLStateCache &state, GpuProfiler *profiler ) noexcept {
+
+    this->sort();
+
+    m_stats = RenderQueueStats {};
+    m_stats.packets = static_cast<u32>( m_packets.size() );
+
+    const char *scope = nullptr;
+
+    for ( const auto &item : m_order ) {
+      const auto &packet = m_packets[ item.index ];
+      const bool transparent = renderKeyPass( packet.key ) == RenderPass::TRANSPARENT;
+
+      if ( profiler ) {
+        const bool overlay = renderKeyLayer( packet.key ) != RenderLayer::WORLD;
+        const auto *name = SCOPE_NAMES[ overlay ][ transparent ];
+        if ( name != scope ) {
+          if ( scope )
+            profiler->end();
+          profiler->begin( name );
+          scope = name;
+        }
+      }
+
+      if ( transparent )
+        ++m_stats.transparentPackets;
+      else
+        ++m_stats.opaquePackets;
+
+      state.useProgram( packet.program );
+      state.setBlend( transparent );
+      state.setCullFace( packet.cullFace );
+      state.bindVertexArray( packet.vertexArray );
+      if ( packet.texture )
+        state.bindTexture( 0, packet.texture );
+
+      if ( packet.callback ) {
+        packet.callback( packet, state );
+        ++m_stats.callbacks;
+        continue;
+      }
+
+      const GLenum mode = packet.primitive == PrimitiveType::LINES ? GL_LINES : GL_TRIANGLES;
+      if ( packet.indexed ) {
+        const auto *offset = reinterpret_cast<void *>( packet.first * sizeof( u32 ) );
+        if ( packet.baseVertex != 0 )
+          glDrawElementsInstancedBaseVertex( mode, packet.count, GL_UNSIGNED_INT, offset,
+                                             packet.instances, packet.baseVertex );
+        else if ( packet.instances > 1 )
+          glDrawElementsInstanced( mode, packet.count, GL_UNSIGNED_INT, offset,
+                                   packet.instances );
+        else
+          glDrawElements( mode, packet.count, GL_UNSIGNED_INT, offset );
+      } else {
+        if ( packet.instances > 1 )
+          glDrawArraysInstanced( mode, packet.first, packet.count, packet.instances );
+        else
+          glDrawArrays( mode, packet.first, packet.count );
+      }
+    }
+
+    if ( scope )
+      profiler->end();
+
+    this->clear();
+  }
+
+  void RenderQueue::clear() noexcept {
+    m_packets.clear();
+    m_order.clear();
+  }
+
+}    // namespace nile
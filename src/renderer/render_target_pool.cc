@@ -0,0 +1,176 @@
+/* ================================================================================
+$File: render_target_pool.cc
+$Date: $
+$Revision: $
+$Creator: Rostislav Orestis Stelmach
+$Notice: $
+================================================================================ */
+
+#include "Nile/renderer/render_target_pool.hh"
+#include "Nile/core/assert.hh"
+
+#include <GL/glew.h>
+
+#include <algorithm>
+
+namespace nile {
+
+  usize RenderTargetDesc::getBytes() const noexcept {
+    usize texel = 0;
+    switch ( format ) {
+      case RenderTargetFormat::NONE: texel = 0; break;
+      case RenderTargetFormat::RGB8:
+        // Drivers pad RGB8 to four bytes
+      case RenderTargetFormat::RGBA8: texel = 4; break;
+      case RenderTargetFormat::RGBA16F: texel = 8; break;
+    }
+    if ( depth != RenderTargetDepth::NONE )
+      texel += 4;
+    return static_cast<usize>( width ) * height * texel;
+  }
+
+  RenderTargetPool::RenderTargetPool( u32 capacity ) noexcept
+      : m_capacity( std::max( capacity, 1u ) ) {
+    // Targets are replaced in place, references to them don't move
+    m_targets.reserve( m_capacity );
+  }
+
+  RenderTargetPool::~RenderTargetPool() noexcept {
+    this->clear();
+  }
+
+  void RenderTargetPool::create( RenderTarget &target, const RenderTargetDesc &desc,
+                                 u32 instance ) noexcept {
+
+    target.width = desc.width;
+    target.height = desc.height;
+    target.format = desc.format;
+    target.depth = desc.depth;
+    target.instance = instance;
+
+    const auto width = static_cast<GLsizei>( desc.width );
+    const auto height = static_cast<GLsizei>( desc.height );
+
+    glGenFramebuffers( 1, &target.framebuffer );
+    glBindFramebuffer( GL_FRAMEBUFFER, target.framebuffer );
+
+    if ( desc.format != RenderTargetFormat::NONE ) {
+      glGenTextures( 1, &target.color );
+      glBindTexture( GL_TEXTURE_2D, target.color );
+      switch ( desc.format ) {
+        case RenderTargetFormat::RGBA8:
+          glTexImage2D( GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE,
+                        nullptr );
+          break;
+        case RenderTargetFormat::RGBA16F:
+          glTexImage2D( GL_TEXTURE_2D, 0, GL_RGBA16F, width, height, 0, GL_RGBA, GL_HALF_FLOAT,
+                        nullptr );
+          break;
+        default:
+          glTexImage2D( GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE,
+                        nullptr );
+          break;
+      }
+
+      // Linear filtering is the upscale of the screen pass
+      glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR );
+      glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
+      glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE );
+      glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE );
+      glBindTexture( GL_TEXTURE_2D, 0 );
+
+      glFramebufferTexture2D( GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, target.color,
+                              0 );
+    } else {
+      glDrawBuffer( GL_NONE );
+      glReadBuffer( GL_NONE );
+    }
+
+    if ( desc.depth == RenderTargetDepth::RENDERBUFFER ) {
+      glGenRenderbuffers( 1, &target.depthStencil );
+      glBindRenderbuffer( GL_RENDERBUFFER, target.depthStencil );
+      glRenderbufferStorage( GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height );
+      glFramebufferRenderbuffer( GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER,
+                                 target.depthStencil );
+      glBindRenderbuffer( GL_RENDERBUFFER, 0 );
+    } else if ( desc.depth == RenderTargetDepth::TEXTURE ) {
+      glGenTextures( 1, &target.depthStencil );
+      glBindTexture( GL_TEXTURE_2D, target.depthStencil );
+      glTexImage2D( GL_TEXTURE_2D, 0, GL_DEPTH24_STENCIL8, width, height, 0, GL_DEPTH_STENCIL,
+                    GL_UNSIGNED_INT_24_8, nullptr );
+      glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST );
+      glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST );
+      glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE );
+      glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE );
+      glBindTexture( GL_TEXTURE_2D, 0 );
+      glFramebufferTexture2D( GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_TEXTURE_2D,
+                              target.depthStencil, 0 );
+    }
+
+    ASSERT_M( glCheckFramebufferStatus( GL_FRAMEBUFFER ) == GL_FRAMEBUFFER_COMPLETE,
+              "Failed to create framebuffer, framebuffer is not complete!\n" );
+
+    glBindFramebuffer( GL_FRAMEBUFFER, 0 );
+
+    ++m_stats.allocations;
+    ++m_stats.targets;
+  }
+
+  void RenderTargetPool::release( RenderTarget &target ) noexcept {
+    glDeleteFramebuffers( 1, &target.framebuffer );
+    if ( target.color )
+      glDeleteTextures( 1, &target.color );
+    if ( target.depth == RenderTargetDepth::TEXTURE )
+      glDeleteTextures( 1, &target.depthStencil );
+    else if ( target.depth == RenderTargetDepth::RENDERBUFFER )
+      glDeleteRenderbuffers( 1, &target.depthStencil );
+    target = RenderTarget {};
+
+    ++m_stats.releases;
+    --m_stats.targets;
+  }
+
+  const RenderTarget &RenderTargetPool::acquire( const RenderTargetDesc &desc,
+                                                 u32 instance ) noexcept {
+
+    ++m_acquisitions;
+
+    for ( auto &target : m_targets ) {
+      if ( target.width == desc.width && target.height == desc.height &&
+           target.format == desc.format && target.depth == desc.depth &&
+           target.instance == instance ) {
+        target.lastUsed = m_acquisitions;
+        return target;
+      }
+    }
+
+    RenderTarget *slot = nullptr;
+    if ( m_targets.size() < m_capacity ) {
+      slot = &m_targets.emplace_back();
+    } else {
+      slot = &*std::min_element( m_targets.begin(), m_targets.end(),
+                                 []( const RenderTarget &a, const RenderTarget &b ) {
+                                   return a.lastUsed < b.lastUsed;
+                                 } );
+      this->release( *slot );
+    }
+
+    this->create( *slot, desc, instance );
+    slot->lastUsed = m_acquisitions;
+    return *slot;
+  }
+
+  const RenderTarget &RenderTargetPool::acquire( u32 width, u32 height ) noexcept {
+    RenderTargetDesc desc;
+    desc.width = width;
+    desc.height = height;
+    return this->acquire( desc );
+  }
+
+  void RenderTargetPool::clear() noexcept {
+    for ( auto &target : m_targets )
+      this->release( target );
+    m_targets.clear();
+  }
+
+}    // namespace nile
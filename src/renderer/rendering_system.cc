@@ -4,7 +4,10 @@
 #include "Nile/ecs/components/transform.hh"
 #include "Nile/ecs/ecs_coordinator.hh"
 #include "Nile/log/log.hh"
+#include "Nile/renderer/gl_state_cache.hh"
+#include "Nile/renderer/render_queue.hh"
 #include "Nile/renderer/shaderset.hh"
+#include "Nile/renderer/stream_buffer.hh"
 #include "Nile/renderer/texture2d.hh"
 #include "Nile/utils/vertex.hh"
 
@@ -13,138 +16,540 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <spdlog/spdlog.h>
 
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+
 namespace nile {
 
+  namespace {
+
+    // Vertex attribute locations of the per instance data
+    constexpr u32 INSTANCE_MODEL_LOCATION = 3;
+    constexpr u32 INSTANCE_COLOR_LOCATION = 7;
+
+    constexpr u32 NO_BATCH = ~0u;
+
+    constexpr u64 FNV_OFFSET = 0xcbf29ce484222325ull;
+    constexpr u64 FNV_PRIME = 0x100000001b3ull;
+
+    u64 fnv1a( const void *data, usize size, u64 hash = FNV_OFFSET ) noexcept {
+      const auto *bytes = static_cast<const u8 *>( data );
+      for ( usize i = 0; i < size; ++i ) {
+        hash ^= bytes[ i ];
+        hash *= FNV_PRIME;
+      }
+      return hash;
+    }
+
+    template <typename T>
+    u64 hashCombine( u64 hash, const T &value ) noexcept {
+      return hash ^
+             ( std::hash<T> {}( value ) + 0x9e3779b97f4a7c15ull + ( hash << 6 ) + ( hash >> 2 ) );
+    }
+
+    glm::mat4 modelMatrix( const Transform &transform ) noexcept {
+      glm::mat4 model = glm::mat4 {1.0f};
+      model = glm::translate( model, transform.position );
+      model =
+          glm::rotate( model, glm::radians( transform.xRotation ), glm::vec3( 1.0f, 0.0f, 0.0f ) );
+      model =
+          glm::rotate( model, glm::radians( transform.yRotation ), glm::vec3( 0.0f, 1.0f, 0.0f ) );
+      model =
+          glm::rotate( model, glm::radians( transform.zRotation ), glm::vec3( 0.0f, 0.0f, 1.0f ) );
+      return glm::scale( model, transform.scale );
+    }
+
+  }    // namespace
+
   RenderingSystem::RenderingSystem( const std::shared_ptr<Coordinator> &coordinator,
+                                    const std::shared_ptr<GLStateCache> &state,
+                                    const std::shared_ptr<RenderQueue> &queue,
+                                    const std::shared_ptr<StreamBuffer> &stream,
                                     const std::shared_ptr<ShaderSet> &shader ) noexcept
       : ecs_coordinator_( coordinator )
+      , gl_state_( state )
+      , render_queue_( queue )
+      , stream_buffer_( stream )
       , shader_( shader ) {}
 
+  RenderingSystem::~RenderingSystem() noexcept {
+    for ( const auto &vertex_array : vertex_arrays_ )
+      glDeleteVertexArrays( 1, &vertex_array.vao );
+    glDeleteBuffers( 1, &instance_buffer_ );
+  }
+
   void RenderingSystem::create() noexcept {
-    this->init_rendering_data();
+    multi_draw_indirect_ = GLEW_ARB_multi_draw_indirect || GLEW_VERSION_4_3;
+
     spdlog::info(
         "ECS RenderingSystem has been registered to ECS manager and created successfully." );
+    spdlog::debug( "RenderingSystem: multi draw indirect {}",
+                   multi_draw_indirect_ ? "supported" : "not supported, using a draw loop" );
   }
 
   void RenderingSystem::update( float dt ) noexcept {}
 
   void RenderingSystem::render( float dt ) noexcept {
 
-    glEnable( GL_CULL_FACE );
+    stats_ = RenderingStats {};
+
+    for ( auto &group : groups_ ) {
+      group.count = 0;
+      group.dirty = false;
+      group.depth = 0.0f;
+    }
+
+    // Cull all the meshes at once, the entities are visited in the same order below
+    culler_.begin();
+    for ( const auto &entity : entities_ )
+      culler_.add( ecs_coordinator_->getComponent<MeshComponent>( entity ).worldBounds );
+    culler_.cull( render_queue_->getFrustum() );
+
+    // Gather the instances of every group. Entities are visited in the same order
+    // every frame, so groups that didn't move produce the exact same data.
+    u32 last_group = static_cast<u32>( groups_.size() );
+    u32 cull_index = 0;
 
     for ( const auto &entity : entities_ ) {
 
+      if ( !culler_.isVisible( cull_index++ ) )
+        continue;
+
       auto &mesh = ecs_coordinator_->getComponent<MeshComponent>( entity );
       auto &transform = ecs_coordinator_->getComponent<Transform>( entity );
       auto &renderable = ecs_coordinator_->getComponent<Renderable>( entity );
 
+      if ( ( mesh.vertices.empty() && mesh.packedVertices.empty() ) || mesh.indices.empty() )
+        continue;
+
+      // Entities added after the system has been created are registered lazily
+      if ( mesh.geometry == 0 )
+        this->register_geometry( mesh );
+
       // Allow user to set user-defined shaders
       // if the shaderset is set in the renderable component, then use it
       // otherwise use the default one provided by the rendering system
-      auto shader = ( renderable.shaderSet ) ? renderable.shaderSet : shader_;
+      auto *shader = ( renderable.shaderSet ) ? renderable.shaderSet.get() : shader_.get();
+
+      // Consecutive entities usually belong to the same group
+      if ( last_group == groups_.size() || groups_[ last_group ].geometry != mesh.geometry - 1 ||
+           groups_[ last_group ].blend != renderable.blend ||
+           !material_matches( materials_[ groups_[ last_group ].material ], shader, mesh ) ) {
+        last_group = this->find_or_create_group( mesh, shader, renderable.blend );
+      }
+
+      auto &group = groups_[ last_group ];
+      const auto &geometry = geometries_[ group.geometry ];
+
+      MeshInstance instance {modelMatrix( transform ), glm::vec4( renderable.color, 1.0f )};
+      if ( geometry.format == VertexFormat::PACKED )
+        instance.model *= geometry.dequantize;
+
+      if ( group.count < group.instances.size() ) {
+        auto &previous = group.instances[ group.count ];
+        if ( !group.dirty && std::memcmp( &previous, &instance, sizeof( MeshInstance ) ) != 0 )
+          group.dirty = true;
+        previous = instance;
+      } else {
+        group.instances.push_back( instance );
+        group.dirty = true;
+      }
+      ++group.count;
+      group.depth += render_queue_->viewDepth( transform.position );
+    }
 
-      if ( renderable.blend )
-        glEnable( GL_BLEND );
+    for ( auto &group : groups_ ) {
+      // Fewer instances than the last frame
+      if ( group.count != group.instances.size() ) {
+        group.instances.resize( group.count );
+        group.dirty = true;
+      }
+    }
+
+    this->layout_instances();
+
+    for ( auto &group : groups_ ) {
+      if ( group.count == 0 )
+        continue;
+
+      if ( group.dirty )
+        this->upload_instances( group );
       else
-        glDisable( GL_BLEND );
+        ++stats_.residentGroups;
+
+      ++stats_.groups;
+      stats_.instances += group.count;
+    }
 
-      u32 diffuse_nr = 1;
-      u32 specular_nr = 1;
-      u32 normal_nr = 1;
+    this->build_batches();
+    if ( batches_.empty() )
+      return;
+
+    // Commands of all the batches go to the GPU at once, without multi draw indirect they
+    // are drawn one by one from the CPU copy
+    indirect_buffer_ = 0;
+    if ( multi_draw_indirect_ ) {
+      const auto bytes = commands_.size() * sizeof( DrawElementsIndirectCommand );
+      const auto allocation = stream_buffer_->allocate( bytes, sizeof( u32 ) );
+      if ( allocation.isValid() ) {
+        std::memcpy( allocation.data, commands_.data(), bytes );
+        indirect_buffer_ = allocation.buffer;
+        indirect_offset_ = allocation.offset;
+      }
+    }
 
-      for ( u32 i = 0; i < mesh.textures.size(); i++ ) {
+    for ( u32 format = 0; format < VERTEX_FORMAT_COUNT; ++format )
+      this->update_vertex_array( static_cast<VertexFormat>( format ) );
+
+    stats_.commands = static_cast<u32>( commands_.size() );
+    stats_.drawCalls = indirect_buffer_ ? static_cast<u32>( batches_.size() ) : stats_.commands;
+
+    for ( u32 index = 0; index < batches_.size(); ++index ) {
+      const auto &batch = batches_[ index ];
+      const auto pass = batch.blend ? RenderPass::TRANSPARENT : RenderPass::OPAQUE;
+      const auto program = materials_[ batch.material ].shader->getProgramId();
+
+      DrawPacket packet;
+      packet.key = makeRenderKey( RenderLayer::WORLD, pass, program, batch.material,
+                                  batch.depth / static_cast<f32>( batch.instances ) );
+      packet.program = program;
+      packet.vertexArray = vertex_arrays_[ static_cast<u32>( batch.format ) ].vao;
+      packet.count = batch.commandCount;
+      packet.cullFace = true;
+      packet.callback = &RenderingSystem::draw_batch;
+      packet.userData = this;
+      packet.userIndex = index;
+      render_queue_->submit( packet );
+    }
+  }
 
-        glActiveTexture( GL_TEXTURE0 + i );
+  void RenderingSystem::build_batches() noexcept {
 
-        // @Fixme(stel): replace strings with string_view
-        std::string number;
-        auto type = mesh.textures[ i ]->getTextureType();
+    batches_.clear();
+    commands_.clear();
+    batch_by_material_.assign( materials_.size() * VERTEX_FORMAT_COUNT, NO_BATCH );
 
-        if ( type == TextureType::DIFFUSE )
-          number = std::to_string( diffuse_nr++ );
-        else if ( type == TextureType::SPECULAR )
-          number = std::to_string( specular_nr++ );
-        else if ( type == TextureType::NORMAL )
-          number = std::to_string( normal_nr++ );
+    // Opaque groups of a material share one batch, blended groups get their own to keep
+    // them sorted by depth. Every vertex format is drawn from its own vertex array.
+    for ( auto &group : groups_ ) {
+      if ( group.count == 0 )
+        continue;
 
-        shader->SetInteger( ( "material." + TextureTypeStr( type ) + number ).c_str(), i );
-        mesh.textures[ i ]->bind();
+      const auto format = geometries_[ group.geometry ].format;
+      const auto key = group.material * VERTEX_FORMAT_COUNT + static_cast<u32>( format );
+
+      u32 batch = group.blend ? NO_BATCH : batch_by_material_[ key ];
+      if ( batch == NO_BATCH ) {
+        batch = static_cast<u32>( batches_.size() );
+        batches_.push_back( {group.material, format, 0, 0, group.blend, 0.0f, 0} );
+        if ( !group.blend )
+          batch_by_material_[ key ] = batch;
       }
 
-      shader->use();
+      auto &target = batches_[ batch ];
+      ++target.commandCount;
+      target.depth += group.depth;
+      target.instances += group.count;
+      group.batch = batch;
+    }
 
-      glm::mat4 model = glm::mat4 { 1.0f };
-      model = glm::translate( model, transform.position );
-      model =
-          glm::rotate( model, glm::radians( transform.xRotation ), glm::vec3( 1.0f, 0.0f, 0.0f ) );
-      model =
-          glm::rotate( model, glm::radians( transform.yRotation ), glm::vec3( 0.0f, 1.0f, 0.0f ) );
-      model =
-          glm::rotate( model, glm::radians( transform.zRotation ), glm::vec3( 0.0f, 0.0f, 1.0f ) );
+    // Commands of a batch are consecutive
+    u32 first = 0;
+    for ( auto &batch : batches_ ) {
+      batch.firstCommand = first;
+      first += batch.commandCount;
+      batch.commandCount = 0;
+    }
 
-      model = glm::scale( model, transform.scale );
+    commands_.resize( first );
+    for ( const auto &group : groups_ ) {
+      if ( group.count == 0 )
+        continue;
 
-      shader->SetMatrix4( "model", model );
-      shader->SetVector3f( "objectColor", renderable.color );
+      auto &batch = batches_[ group.batch ];
+      const auto &range = geometries_[ group.geometry ].range;
+      commands_[ batch.firstCommand + batch.commandCount++ ] = {
+          range.indexCount, group.count, range.firstIndex, range.baseVertex, group.first};
+    }
+  }
 
-      glActiveTexture( GL_TEXTURE0 );
+  void RenderingSystem::draw_batch( const DrawPacket &packet, GLStateCache &state ) noexcept {
 
-      glBindVertexArray( mesh.vao );
-      glDrawElements( GL_TRIANGLES, mesh.indices.size(), GL_UNSIGNED_INT, 0 );
-      glBindVertexArray( 0 );
-      glBindTexture( GL_TEXTURE_2D, 0 );
+    const auto *self = static_cast<const RenderingSystem *>( packet.userData );
+    const auto &batch = self->batches_[ packet.userIndex ];
+    const auto &material = self->materials_[ batch.material ];
 
-      if ( renderable.blend )
-        glDisable( GL_BLEND );
-      else
-        glEnable( GL_BLEND );
+    for ( u32 i = 0; i < material.textures.size(); i++ ) {
+      material.shader->SetInteger( material.samplers[ i ], i );
+      state.bindTexture( i, material.textures[ i ]->getID() );
     }
 
-    glDisable( GL_CULL_FACE );
+    if ( self->indirect_buffer_ ) {
+      const auto offset =
+          self->indirect_offset_ + batch.firstCommand * sizeof( DrawElementsIndirectCommand );
+      glBindBuffer( GL_DRAW_INDIRECT_BUFFER, self->indirect_buffer_ );
+      glMultiDrawElementsIndirect( GL_TRIANGLES, GL_UNSIGNED_INT,
+                                   reinterpret_cast<void *>( offset ), batch.commandCount, 0 );
+      glBindBuffer( GL_DRAW_INDIRECT_BUFFER, 0 );
+      return;
+    }
+
+    for ( u32 i = 0; i < batch.commandCount; ++i ) {
+      const auto &command = self->commands_[ batch.firstCommand + i ];
+      glDrawElementsInstancedBaseVertexBaseInstance(
+          GL_TRIANGLES, command.count, GL_UNSIGNED_INT,
+          reinterpret_cast<void *>( command.firstIndex * sizeof( u32 ) ), command.instanceCount,
+          command.baseVertex, command.baseInstance );
+    }
   }
 
-  void RenderingSystem::init_rendering_data() noexcept {
+  void RenderingSystem::register_geometry( MeshComponent &mesh ) noexcept {
+
+    const bool packed = !mesh.packedVertices.empty();
+    const auto format = packed ? VertexFormat::PACKED : VertexFormat::FLOAT;
+    const auto vertex_count = packed ? mesh.packedVertices.size() : mesh.vertices.size();
+    const auto indices_bytes = mesh.indices.size() * sizeof( u32 );
+
+    // Entities created from the same model carry copies of the same vertices,
+    // find out if we already have them on the GPU
+    u64 hash = packed ? fnv1a( mesh.packedVertices.data(), vertex_count * sizeof( PackedVertex ) )
+                      : fnv1a( mesh.vertices.data(), vertex_count * sizeof( Vertex ) );
+    hash = fnv1a( mesh.indices.data(), indices_bytes, hash );
+    if ( packed )
+      hash = fnv1a( &mesh.quantization, sizeof( VertexQuantization ), hash );
+
+    auto [ begin, end ] = geometry_by_hash_.equal_range( hash );
+    for ( auto it = begin; it != end; ++it ) {
+      const auto &candidate = geometries_[ it->second ];
+      if ( candidate.format == format && candidate.range.vertexCount == vertex_count &&
+           candidate.range.indexCount == mesh.indices.size() ) {
+        mesh.geometry = it->second + 1;
+        return;
+      }
+    }
+
+    auto &pool = mesh_pools_[ static_cast<u32>( format ) ];
 
-    for ( const auto &entity : entities_ ) {
+    Geometry geometry;
+    geometry.hash = hash;
+    geometry.format = format;
+    geometry.range = packed ? pool.add( mesh.packedVertices, mesh.indices )
+                            : pool.add( mesh.vertices, mesh.indices );
+    geometry.dequantize = packed ? mesh.quantization.dequantizeMatrix() : glm::mat4 {1.0f};
+    glCheckError();
 
-      auto &mesh = ecs_coordinator_->getComponent<MeshComponent>( entity );
+    const auto index = static_cast<u32>( geometries_.size() );
+    geometries_.push_back( geometry );
+    geometry_by_hash_.emplace( hash, index );
+
+    mesh.geometry = index + 1;
+
+    spdlog::debug( "RenderingSystem: new geometry {} ({} vertices, {} indices, packed: {})", index,
+                   geometry.range.vertexCount, geometry.range.indexCount, packed );
+  }
 
-      glGenVertexArrays( 1, &mesh.vao );
-      glGenBuffers( 1, &mesh.ebo );
-      glGenBuffers( 1, &mesh.vbo );
+  bool RenderingSystem::material_matches( const Material &material, const ShaderSet *shader,
+                                          const MeshComponent &mesh ) noexcept {
+    return material.shader == shader &&
+           std::equal( material.textures.begin(), material.textures.end(), mesh.textures.begin(),
+                       mesh.textures.end(),
+                       []( const Texture2D *a, const auto &b ) { return a == b.get(); } );
+  }
+
+  u32 RenderingSystem::find_or_create_material( const MeshComponent &mesh,
+                                                ShaderSet *shader ) noexcept {
+
+    u64 hash = hashCombine( FNV_OFFSET, shader );
+    for ( const auto &texture : mesh.textures )
+      hash = hashCombine( hash, texture.get() );
+
+    auto [ begin, end ] = material_by_hash_.equal_range( hash );
+    for ( auto it = begin; it != end; ++it ) {
+      if ( material_matches( materials_[ it->second ], shader, mesh ) )
+        return it->second;
+    }
+
+    Material material;
+    material.shader = shader;
+
+    // Samplers are the same for the whole lifetime of the material, so resolve them
+    // only once instead of every frame
+    u32 diffuse_nr = 1;
+    u32 specular_nr = 1;
+    u32 normal_nr = 1;
+
+    for ( const auto &texture : mesh.textures ) {
+      std::string number;
+      auto type = texture->getTextureType();
+
+      if ( type == TextureType::DIFFUSE )
+        number = std::to_string( diffuse_nr++ );
+      else if ( type == TextureType::SPECULAR )
+        number = std::to_string( specular_nr++ );
+      else if ( type == TextureType::NORMAL )
+        number = std::to_string( normal_nr++ );
+
+      material.textures.push_back( texture.get() );
+      const auto name = "material." + TextureTypeStr( type ) + number;
+      material.samplers.push_back( shader->getUniformHandle( name.c_str() ) );
+    }
 
-      glBindVertexArray( mesh.vao );
+    const auto index = static_cast<u32>( materials_.size() );
+    materials_.push_back( std::move( material ) );
+    material_by_hash_.emplace( hash, index );
 
-      // Vertex buffer object
-      glBindBuffer( GL_ARRAY_BUFFER, mesh.vbo );
+    return index;
+  }
+
+  u32 RenderingSystem::find_or_create_group( const MeshComponent &mesh, ShaderSet *shader,
+                                             bool blend ) noexcept {
 
-      glBufferData( GL_ARRAY_BUFFER, mesh.vertices.size() * sizeof( Vertex ), &mesh.vertices[ 0 ],
-                    GL_STATIC_DRAW );
+    const auto geometry = mesh.geometry - 1;
+    const auto material = this->find_or_create_material( mesh, shader );
 
-      // Element buffer object
-      glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, mesh.ebo );
-      glBufferData( GL_ELEMENT_ARRAY_BUFFER, mesh.indices.size() * sizeof( u32 ),
-                    &mesh.indices[ 0 ], GL_STATIC_DRAW );
+    u64 hash = hashCombine( FNV_OFFSET, geometry );
+    hash = hashCombine( hash, material );
+    hash = hashCombine( hash, blend );
+
+    auto [ begin, end ] = group_by_hash_.equal_range( hash );
+    for ( auto it = begin; it != end; ++it ) {
+      const auto &group = groups_[ it->second ];
+      if ( group.geometry == geometry && group.material == material && group.blend == blend )
+        return it->second;
+    }
 
+    InstanceGroup group;
+    group.geometry = geometry;
+    group.material = material;
+    group.blend = blend;
+
+    const auto index = static_cast<u32>( groups_.size() );
+    groups_.push_back( std::move( group ) );
+    group_by_hash_.emplace( hash, index );
+
+    return index;
+  }
+
+  void RenderingSystem::layout_instances() noexcept {
+
+    const bool fits = std::all_of( groups_.begin(), groups_.end(), []( const auto &group ) {
+      return group.count <= group.capacity;
+    } );
+    if ( fits )
+      return;
+
+    // Some group outgrew its range, give every group a new one with some room to grow
+    u32 total = 0;
+    for ( auto &group : groups_ ) {
+      if ( group.count > group.capacity )
+        group.capacity = std::max( group.count, group.capacity + group.capacity / 2 );
+      group.first = total;
+      group.dirty = true;
+      total += group.capacity;
+    }
+
+    if ( total > instance_capacity_ ) {
+      if ( !instance_buffer_ )
+        glGenBuffers( 1, &instance_buffer_ );
+
+      instance_capacity_ = std::max( total, instance_capacity_ + instance_capacity_ / 2 );
+      glBindBuffer( GL_ARRAY_BUFFER, instance_buffer_ );
+      glBufferData( GL_ARRAY_BUFFER, instance_capacity_ * sizeof( MeshInstance ), nullptr,
+                    GL_DYNAMIC_DRAW );
+      glBindBuffer( GL_ARRAY_BUFFER, 0 );
+    }
+  }
+
+  void RenderingSystem::upload_instances( InstanceGroup &group ) noexcept {
+
+    const auto bytes = group.count * sizeof( MeshInstance );
+
+    glBindBuffer( GL_ARRAY_BUFFER, instance_buffer_ );
+    glBufferSubData( GL_ARRAY_BUFFER, group.first * sizeof( MeshInstance ), bytes,
+                     group.instances.data() );
+    glBindBuffer( GL_ARRAY_BUFFER, 0 );
+
+    stats_.uploadedBytes += bytes;
+  }
+
+  void RenderingSystem::update_vertex_array( VertexFormat format ) noexcept {
+
+    const auto &pool = mesh_pools_[ static_cast<u32>( format ) ];
+    auto &vertex_array = vertex_arrays_[ static_cast<u32>( format ) ];
+
+    const auto vertex_buffer = pool.getVertexBuffer();
+    const auto index_buffer = pool.getIndexBuffer();
+
+    // Nothing of this format has been registered yet
+    if ( !vertex_buffer )
+      return;
+
+    if ( vertex_array.vao && vertex_buffer == vertex_array.vertexBuffer &&
+         index_buffer == vertex_array.indexBuffer &&
+         instance_buffer_ == vertex_array.instanceBuffer )
+      return;
+
+    if ( !vertex_array.vao )
+      glGenVertexArrays( 1, &vertex_array.vao );
+
+    gl_state_->bindVertexArray( vertex_array.vao );
+
+    // Shared geometry
+    glBindBuffer( GL_ARRAY_BUFFER, vertex_buffer );
+    glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, index_buffer );
+
+    glEnableVertexAttribArray( 0 );
+    glEnableVertexAttribArray( 1 );
+    glEnableVertexAttribArray( 2 );
+
+    if ( format == VertexFormat::PACKED ) {
+      // Normalized position inside the quantization box, the instance matrix scales it back
+      glVertexAttribPointer( 0, 3, GL_UNSIGNED_SHORT, GL_TRUE, sizeof( PackedVertex ),
+                             ( void * )offsetof( PackedVertex, position ) );
+      // Packed normals need all 4 components, the shader ignores the last one
+      glVertexAttribPointer( 1, 4, GL_INT_2_10_10_10_REV, GL_TRUE, sizeof( PackedVertex ),
+                             ( void * )offsetof( PackedVertex, normal ) );
+      glVertexAttribPointer( 2, 2, GL_HALF_FLOAT, GL_FALSE, sizeof( PackedVertex ),
+                             ( void * )offsetof( PackedVertex, uv ) );
+    } else {
       // Vertex positions
-      glEnableVertexAttribArray( 0 );
       glVertexAttribPointer( 0, 3, GL_FLOAT, GL_FALSE, sizeof( Vertex ), ( void * )0 );
 
       // Vertex Normals
-      glEnableVertexAttribArray( 1 );
       glVertexAttribPointer( 1, 3, GL_FLOAT, GL_FALSE, sizeof( Vertex ),
                              ( void * )offsetof( Vertex, normal ) );
 
       // UV coordinates
-      glEnableVertexAttribArray( 2 );
       glVertexAttribPointer( 2, 2, GL_FLOAT, GL_FALSE, sizeof( Vertex ),
                              ( void * )offsetof( Vertex, uv ) );
+    }
 
-      // Unbind
-      glBindBuffer( GL_ARRAY_BUFFER, 0 );
-      glBindVertexArray( 0 );
-      glCheckError();
+    // Per instance model matrix, one attribute per column. The base instance of every
+    // command points at the range of its group.
+    glBindBuffer( GL_ARRAY_BUFFER, instance_buffer_ );
+    for ( u32 column = 0; column < 4; ++column ) {
+      const auto location = INSTANCE_MODEL_LOCATION + column;
+      glEnableVertexAttribArray( location );
+      glVertexAttribPointer(
+          location, 4, GL_FLOAT, GL_FALSE, sizeof( MeshInstance ),
+          ( void * )( offsetof( MeshInstance, model ) + column * sizeof( glm::vec4 ) ) );
+      glVertexAttribDivisor( location, 1 );
     }
+
+    // Per instance color
+    glEnableVertexAttribArray( INSTANCE_COLOR_LOCATION );
+    glVertexAttribPointer( INSTANCE_COLOR_LOCATION, 4, GL_FLOAT, GL_FALSE, sizeof( MeshInstance ),
+                           ( void * )offsetof( MeshInstance, color ) );
+    glVertexAttribDivisor( INSTANCE_COLOR_LOCATION, 1 );
+
+    glBindBuffer( GL_ARRAY_BUFFER, 0 );
+    glCheckError();
+
+    vertex_array.vertexBuffer = vertex_buffer;
+    vertex_array.indexBuffer = index_buffer;
+    vertex_array.instanceBuffer = instance_buffer_;
   }
 
 }    // namespace nile
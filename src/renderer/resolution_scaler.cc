@@ -0,0 +1,66 @@
+/* ================================================================================
+$File: resolution_scaler.cc
+$Date: $
+$Revision: $
+$Creator: Rostislav Orestis Stelmach
+$Notice: $
+================================================================================ */
+
+#include "Nile/renderer/resolution_scaler.hh"
+
+#include <algorithm>
+#include <cmath>
+
+namespace nile {
+
+  ResolutionScaler::ResolutionScaler( f32 budgetMilliseconds, f32 minScale ) noexcept
+      : m_budget( budgetMilliseconds )
+      , m_minScale( std::clamp( minScale, STEP, 1.0f ) ) {}
+
+  void ResolutionScaler::setScale( f32 scale ) noexcept {
+    // Whole steps, rounded down so a decrease is never smaller than asked for
+    scale = std::floor( scale / STEP + 1e-3f ) * STEP;
+    scale = std::clamp( scale, m_minScale, 1.0f );
+
+    if ( scale < m_scale )
+      ++m_stats.decreases;
+    else if ( scale > m_scale )
+      ++m_stats.increases;
+    else
+      return;
+
+    m_scale = scale;
+    m_frameTime = 0.0f;
+    m_framesUnderBudget = 0;
+    m_settleFrames = SETTLE_FRAMES;
+  }
+
+  f32 ResolutionScaler::update( f32 frameTime ) noexcept {
+
+    if ( m_budget <= 0.0f || frameTime <= 0.0f )
+      return m_scale;
+
+    if ( m_settleFrames > 0 ) {
+      --m_settleFrames;
+      return m_scale;
+    }
+
+    m_frameTime = ( m_frameTime > 0.0f ) ? m_frameTime + ( frameTime - m_frameTime ) * SMOOTHING
+                                         : frameTime;
+    m_stats.frameTime = m_frameTime;
+
+    if ( m_frameTime > m_budget ) {
+      // At least one step down, even when the estimate is within the same step
+      const auto fit = m_scale * std::sqrt( m_budget / m_frameTime );
+      this->setScale( std::min( fit, m_scale - STEP ) );
+    } else if ( m_frameTime < m_budget * HEADROOM ) {
+      if ( ++m_framesUnderBudget >= GROW_FRAMES )
+        this->setScale( m_scale + STEP );
+    } else {
+      m_framesUnderBudget = 0;
+    }
+
+    return m_scale;
+  }
+
+}    // namespace nile
@@ -10,6 +10,7 @@ $Notice: $
 
 #include <GL/glew.h>
 #include <glm/gtc/type_ptr.hpp>
+#include <spdlog/spdlog.h>
 
 namespace nile {
 
@@ -18,7 +19,9 @@ namespace nile {
       : m_programId( new u32( id ) )
       , m_vShaderPath( vShaderPath )
       , m_fShaderPath( fShaderPath )
-      , m_gShaderPath( gShaderPath ) {}
+      , m_gShaderPath( gShaderPath ) {
+    this->introspectUniforms();
+  }
 
   ShaderSet::~ShaderSet() noexcept {
     delete m_programId;
@@ -32,59 +35,114 @@ namespace nile {
   void ShaderSet::SetFloat( const char *name, f32 value, bool useShader ) noexcept {
     if ( useShader )
       this->use();
-    glUniform1f( glGetUniformLocation( *m_programId, name ), value );
+    glUniform1f( this->getUniformLocation( name ), value );
   }
 
   void ShaderSet::SetInteger( const char *name, i32 value, bool useShader ) noexcept {
     if ( useShader )
       this->use();
-    glUniform1i( glGetUniformLocation( *m_programId, name ), value );
+    glUniform1i( this->getUniformLocation( name ), value );
   }
 
   void ShaderSet::SetVector2f( const char *name, f32 x, f32 y, bool useShader ) noexcept {
     if ( useShader )
       this->use();
-    glUniform2f( glGetUniformLocation( *m_programId, name ), x, y );
+    glUniform2f( this->getUniformLocation( name ), x, y );
   }
 
   void ShaderSet::SetVector2f( const char *name, const glm::vec2 &value, bool useShader ) noexcept {
     if ( useShader )
       this->use();
-    glUniform2f( glGetUniformLocation( *m_programId, name ), value.x, value.y );
+    glUniform2f( this->getUniformLocation( name ), value.x, value.y );
   }
 
   void ShaderSet::SetVector3f( const char *name, f32 x, f32 y, f32 z, bool useShader ) noexcept {
     if ( useShader )
       this->use();
-    glUniform3f( glGetUniformLocation( *m_programId, name ), x, y, z );
+    glUniform3f( this->getUniformLocation( name ), x, y, z );
   }
 
   void ShaderSet::SetVector3f( const char *name, const glm::vec3 &value, bool useShader ) noexcept {
     if ( useShader )
       this->use();
-    glUniform3f( glGetUniformLocation( *m_programId, name ), value.x, value.y, value.z );
+    glUniform3f( this->getUniformLocation( name ), value.x, value.y, value.z );
   }
 
   void ShaderSet::SetVector4f( const char *name, f32 x, f32 y, f32 z, f32 w,
                                bool useShader ) noexcept {
     if ( useShader )
       this->use();
-    glUniform4f( glGetUniformLocation( *m_programId, name ), x, y, z, w );
+    glUniform4f( this->getUniformLocation( name ), x, y, z, w );
   }
 
   void ShaderSet::SetVector4f( const char *name, const glm::vec4 &value, bool useShader ) noexcept {
     if ( useShader )
       this->use();
-    glUniform4f( glGetUniformLocation( *m_programId, name ), value.x, value.y, value.z, value.w );
+    glUniform4f( this->getUniformLocation( name ), value.x, value.y, value.z, value.w );
   }
 
   void ShaderSet::SetMatrix4( const char *name, const glm::mat4 &matrix, bool useShader ) noexcept {
     if ( useShader )
       this->use();
-    glUniformMatrix4fv( glGetUniformLocation( *m_programId, name ), 1, GL_FALSE,
+    glUniformMatrix4fv( this->getUniformLocation( name ), 1, GL_FALSE,
                         glm::value_ptr( matrix ) );
   }
 
+  void ShaderSet::SetFloat( UniformHandle handle, f32 value, bool useShader ) noexcept {
+    if ( useShader )
+      this->use();
+    glUniform1f( this->getLocation( handle ), value );
+  }
+
+  void ShaderSet::SetInteger( UniformHandle handle, i32 value, bool useShader ) noexcept {
+    if ( useShader )
+      this->use();
+    glUniform1i( this->getLocation( handle ), value );
+  }
+
+  void ShaderSet::SetVector2f( UniformHandle handle, const glm::vec2 &value,
+                               bool useShader ) noexcept {
+    if ( useShader )
+      this->use();
+    glUniform2f( this->getLocation( handle ), value.x, value.y );
+  }
+
+  void ShaderSet::SetVector3f( UniformHandle handle, const glm::vec3 &value,
+                               bool useShader ) noexcept {
+    if ( useShader )
+      this->use();
+    glUniform3f( this->getLocation( handle ), value.x, value.y, value.z );
+  }
+
+  void ShaderSet::SetVector4f( UniformHandle handle, const glm::vec4 &value,
+                               bool useShader ) noexcept {
+    if ( useShader )
+      this->use();
+    glUniform4f( this->getLocation( handle ), value.x, value.y, value.z, value.w );
+  }
+
+  void ShaderSet::SetMatrix4( UniformHandle handle, const glm::mat4 &matrix,
+                              bool useShader ) noexcept {
+    if ( useShader )
+      this->use();
+    glUniformMatrix4fv( this->getLocation( handle ), 1, GL_FALSE, glm::value_ptr( matrix ) );
+  }
+
+  i32 ShaderSet::getUniformLocation( const char *name ) const noexcept {
+    auto it = m_uniformLocations.find( name );
+    return it != m_uniformLocations.end() ? it->second : -1;
+  }
+
+  UniformHandle ShaderSet::getUniformHandle( const char *name ) noexcept {
+    for ( u32 i = 0; i < m_uniformSlots.size(); ++i ) {
+      if ( m_uniformSlots[ i ].name == name )
+        return UniformHandle {i};
+    }
+
+    m_uniformSlots.push_back( {name, this->getUniformLocation( name )} );
+    return UniformHandle {static_cast<u32>( m_uniformSlots.size() - 1 )};
+  }
+
   std::string ShaderSet::getVshaderPath() const noexcept {
     return m_vShaderPath;
   }
@@ -103,6 +161,77 @@ namespace nile {
 
   void ShaderSet::setProgramId( u32 id ) noexcept {
     *m_programId = id;
+    // Locations of the new program have nothing to do with the old ones
+    this->introspectUniforms();
+  }
+
+  void ShaderSet::introspectUniforms() noexcept {
+
+    m_uniformLocations.clear();
+    m_uniformNames.clear();
+
+    struct Entry {
+      usize offset;
+      usize length;
+      i32 location;
+    };
+    std::vector<Entry> entries;
+
+    auto add = [ this, &entries ]( std::string_view name, i32 location ) {
+      entries.push_back( {m_uniformNames.size(), name.size(), location} );
+      m_uniformNames.append( name );
+    };
+
+    const auto program = *m_programId;
+
+    GLint count = 0;
+    GLint max_length = 0;
+    if ( program != 0 ) {
+      glGetProgramiv( program, GL_ACTIVE_UNIFORMS, &count );
+      glGetProgramiv( program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &max_length );
+    }
+
+    std::vector<char> buffer( static_cast<usize>( max_length ) + 1 );
+
+    for ( GLint i = 0; i < count; ++i ) {
+      GLsizei length = 0;
+      GLint size = 0;
+      GLenum type;
+      glGetActiveUniform( program, static_cast<GLuint>( i ), max_length, &length, &size, &type,
+                          buffer.data() );
+
+      // Members of uniform blocks don't have a location
+      const i32 location = glGetUniformLocation( program, buffer.data() );
+      if ( location < 0 )
+        continue;
+
+      const std::string_view name( buffer.data(), static_cast<usize>( length ) );
+      add( name, location );
+
+      // Arrays of basic types are reported once as "name[0]". Register the bare name
+      // and the rest of the elements, as glGetUniformLocation accepts all of them.
+      if ( size > 1 && name.size() > 3 && name.substr( name.size() - 3 ) == "[0]" ) {
+        const std::string base( name.substr( 0, name.size() - 3 ) );
+        add( base, location );
+        for ( GLint element = 1; element < size; ++element ) {
+          const auto element_name = base + "[" + std::to_string( element ) + "]";
+          add( element_name, glGetUniformLocation( program, element_name.c_str() ) );
+        }
+      }
+    }
+
+    // m_uniformNames doesn't grow anymore, so the views stay valid
+    m_uniformLocations.reserve( entries.size() );
+    for ( const auto &entry : entries ) {
+      m_uniformLocations.emplace(
+          std::string_view( m_uniformNames.data() + entry.offset, entry.length ),
+          entry.location );
+    }
+
+    for ( auto &slot : m_uniformSlots )
+      slot.location = this->getUniformLocation( slot.name.c_str() );
+
+    spdlog::debug( "ShaderSet: program {} has {} active uniforms", program, count );
   }
 
 
@@ -0,0 +1,320 @@
+/* ================================================================================
+$File: sprite_batch.cc
+$Date: $
+$Revision: $
+$Creator: Rostislav Orestis Stelmach
+$Notice: $
+================================================================================ */
+
+#include "Nile/renderer/sprite_batch.hh"
+#include "Nile/ecs/components/transform.hh"
+#include "Nile/renderer/gl_state_cache.hh"
+#include "Nile/renderer/shaderset.hh"
+#include "Nile/renderer/stream_buffer.hh"
+#include "Nile/renderer/texture2d.hh"
+
+#include <GL/glew.h>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <numeric>
+
+namespace nile {
+
+  namespace {
+
+    // Corners of the unit quad, in the same order as the indices below expect them
+    constexpr f32 QUAD_CORNERS[ 4 ][ 2 ] = {
+        {0.0f, 0.0f}, {1.0f, 0.0f}, {1.0f, 1.0f}, {0.0f, 1.0f}};
+
+    // Same winding as the old per-sprite quad
+    constexpr u32 QUAD_INDICES[ 6 ] = {3, 1, 0, 3, 2, 1};
+
+    // Vertex attribute locations shared with the instanced mesh shaders
+    constexpr u32 MODEL_LOCATION = 3;
+    constexpr u32 COLOR_LOCATION = 7;
+
+    // Minimal size of the GPU buffers in quads, so small scenes do not reallocate
+    constexpr u32 MIN_CAPACITY = 1024;
+
+    u32 packColor( const glm::vec3 &color ) noexcept {
+      const auto c = glm::clamp( color, 0.0f, 1.0f ) * 255.0f + 0.5f;
+      return static_cast<u32>( c.r ) | ( static_cast<u32>( c.g ) << 8 ) |
+             ( static_cast<u32>( c.b ) << 16 ) | ( 0xffu << 24 );
+    }
+
+  }    // namespace
+
+  usize SpriteBatch::KeyHash::operator()( const Key &key ) const noexcept {
+    usize hash = std::hash<ShaderSet *> {}( key.shader );
+    hash ^=
+        std::hash<Texture2D *> {}( key.texture ) + 0x9e3779b9 + ( hash << 6 ) + ( hash >> 2 );
+    return hash ^ static_cast<usize>( key.blend );
+  }
+
+  SpriteBatch::~SpriteBatch() noexcept {
+    if ( m_vao ) {
+      glDeleteVertexArrays( 1, &m_vao );
+      glDeleteBuffers( 1, &m_ebo );
+      glDeleteBuffers( 1, &m_identityVbo );
+    }
+  }
+
+  void SpriteBatch::setView( const glm::vec3 &position, const glm::vec3 &direction ) noexcept {
+    m_viewPosition = position;
+    m_viewDirection = direction;
+  }
+
+  void SpriteBatch::begin() noexcept {
+    m_sprites.clear();
+    m_keys.clear();
+    m_keyLookup.clear();
+    m_batches.clear();
+    m_lastKey = 0;
+    m_culler.begin();
+    m_stats = SpriteBatchStats {};
+  }
+
+  void SpriteBatch::submit( ShaderSet *shader, Texture2D *texture, const Transform &transform,
+                            const glm::vec3 &color, bool blend, const glm::vec2 &uvMin,
+                            const glm::vec2 &uvMax ) noexcept {
+
+    const Key key {shader, texture, blend};
+
+    // Consecutive sprites usually share the texture, so try the last key first
+    u32 index = m_lastKey;
+    if ( m_keys.empty() || !( m_keys[ index ] == key ) ) {
+      auto it = m_keyLookup.find( key );
+      if ( it == m_keyLookup.end() ) {
+        index = static_cast<u32>( m_keys.size() );
+        m_keyLookup.emplace( key, index );
+        m_keys.push_back( key );
+      } else {
+        index = it->second;
+      }
+      m_lastKey = index;
+    }
+
+    // Same transformation as the one the sprite renderer used to upload as the model
+    // matrix: translate * rotateX * rotateY * rotateZ * scale( x, y, 1 ).
+    // Only the first two columns ( quad axes ) and the translation are needed.
+    Sprite sprite;
+    sprite.origin = transform.position;
+    sprite.uv = glm::vec4( uvMin, uvMax );
+    sprite.color = packColor( color );
+    sprite.key = index;
+
+    if ( transform.xRotation == 0.0f && transform.yRotation == 0.0f &&
+         transform.zRotation == 0.0f ) {
+      sprite.axisX = glm::vec3( transform.scale.x, 0.0f, 0.0f );
+      sprite.axisY = glm::vec3( 0.0f, transform.scale.y, 0.0f );
+      sprite.normal = glm::vec3( 0.0f, 0.0f, 1.0f );
+    } else {
+      const f32 rx = glm::radians( transform.xRotation );
+      const f32 ry = glm::radians( transform.yRotation );
+      const f32 rz = glm::radians( transform.zRotation );
+      const f32 cx = std::cos( rx ), sx = std::sin( rx );
+      const f32 cy = std::cos( ry ), sy = std::sin( ry );
+      const f32 cz = std::cos( rz ), sz = std::sin( rz );
+
+      sprite.axisX = glm::vec3( cy * cz, cx * sz + sx * sy * cz, sx * sz - cx * sy * cz ) *
+                     transform.scale.x;
+      sprite.axisY = glm::vec3( -cy * sz, cx * cz - sx * sy * sz, sx * cz + cx * sy * sz ) *
+                     transform.scale.y;
+      sprite.normal = glm::vec3( sy, -sx * cy, cx * cy );
+    }
+
+    const auto center = sprite.origin + ( sprite.axisX + sprite.axisY ) * 0.5f;
+    sprite.depth = glm::max( glm::dot( center - m_viewPosition, m_viewDirection ), 0.0f );
+
+    AABB bounds;
+    bounds.expand( sprite.origin );
+    bounds.expand( sprite.origin + sprite.axisX );
+    bounds.expand( sprite.origin + sprite.axisY );
+    bounds.expand( sprite.origin + sprite.axisX + sprite.axisY );
+    m_culler.add( bounds );
+
+    m_sprites.push_back( sprite );
+  }
+
+  void SpriteBatch::end() noexcept {
+
+    m_stats.sprites = static_cast<u32>( m_sprites.size() );
+    if ( m_sprites.empty() )
+      return;
+
+    // Rank the distinct keys by shader and texture, the rank is the material of the sort key
+    std::vector<u32> order( m_keys.size() );
+    std::iota( order.begin(), order.end(), 0 );
+    std::sort( order.begin(), order.end(), [ this ]( u32 a, u32 b ) {
+      const auto &ka = m_keys[ a ];
+      const auto &kb = m_keys[ b ];
+      if ( ka.shader != kb.shader )
+        return std::less<ShaderSet *> {}( ka.shader, kb.shader );
+      return std::less<Texture2D *> {}( ka.texture, kb.texture );
+    } );
+
+    std::vector<u32> rank( m_keys.size() );
+    for ( u32 i = 0; i < order.size(); ++i )
+      rank[ order[ i ] ] = i;
+
+    m_culler.cull( m_frustum );
+    m_stats.culled = m_culler.getStats().culled;
+
+    m_order.clear();
+    for ( u32 i = 0; i < m_sprites.size(); ++i ) {
+      if ( !m_culler.isVisible( i ) )
+        continue;
+
+      const auto &sprite = m_sprites[ i ];
+      const auto pass = m_keys[ sprite.key ].blend ? RenderPass::TRANSPARENT : RenderPass::OPAQUE;
+      const auto key =
+          makeRenderKey( RenderLayer::WORLD, pass, 0, rank[ sprite.key ], sprite.depth );
+      m_order.push_back( {key, i} );
+    }
+
+    // Stable, so sprites at the same depth keep the submission order
+    radixSort( m_order, m_scratch );
+
+    m_vertices.resize( m_order.size() * 4 );
+
+    for ( u32 i = 0; i < m_order.size(); ++i ) {
+      const auto &sprite = m_sprites[ m_order[ i ].index ];
+
+      // Consecutive sprites with the same key are drawn together
+      if ( m_batches.empty() || !( m_batches.back().key == m_keys[ sprite.key ] ) )
+        m_batches.push_back( {m_keys[ sprite.key ], m_order[ i ].key, i, 0} );
+      ++m_batches.back().quadCount;
+
+      auto *quad = &m_vertices[ i * 4 ];
+      for ( u32 corner = 0; corner < 4; ++corner ) {
+        quad[ corner ].position = sprite.origin + sprite.axisX * QUAD_CORNERS[ corner ][ 0 ] +
+                                  sprite.axisY * QUAD_CORNERS[ corner ][ 1 ];
+        quad[ corner ].normal = sprite.normal;
+        quad[ corner ].uv =
+            glm::vec2( QUAD_CORNERS[ corner ][ 0 ] ? sprite.uv.z : sprite.uv.x,
+                       QUAD_CORNERS[ corner ][ 1 ] ? sprite.uv.w : sprite.uv.y );
+        quad[ corner ].color = sprite.color;
+      }
+    }
+
+    m_stats.batches = static_cast<u32>( m_batches.size() );
+    m_stats.drawCalls = m_stats.batches;
+  }
+
+  void SpriteBatch::draw( RenderQueue &queue, GLStateCache &state,
+                          StreamBuffer &stream ) noexcept {
+
+    if ( m_batches.empty() )
+      return;
+
+    const auto quads = static_cast<u32>( m_vertices.size() / 4 );
+    this->reserveGpuBuffers( state, quads );
+
+    // Aligned to the vertex size, so the offset is a whole number of vertices
+    const auto bytes = m_vertices.size() * sizeof( SpriteVertex );
+    const auto allocation = stream.allocate( bytes, sizeof( SpriteVertex ) );
+    if ( !allocation.isValid() )
+      return;
+
+    std::memcpy( allocation.data, m_vertices.data(), bytes );
+    m_stats.uploadedBytes = bytes;
+
+    this->bindVertexBuffer( state, allocation.buffer );
+
+    for ( const auto &batch : m_batches ) {
+      DrawPacket packet;
+      packet.key = batch.sortKey;
+      packet.program = batch.key.shader->getProgramId();
+      packet.vertexArray = m_vao;
+      packet.texture = batch.key.texture->getID();
+      packet.first = batch.firstQuad * 6;
+      packet.count = batch.quadCount * 6;
+      packet.baseVertex = static_cast<i32>( allocation.offset / sizeof( SpriteVertex ) );
+      queue.submit( packet );
+    }
+  }
+
+  void SpriteBatch::bindVertexBuffer( GLStateCache &state, u32 buffer ) noexcept {
+
+    // The stream buffer only changes when it grows
+    if ( buffer == m_vertexBuffer )
+      return;
+
+    state.bindVertexArray( m_vao );
+    glBindBuffer( GL_ARRAY_BUFFER, buffer );
+
+    // Position
+    glEnableVertexAttribArray( 0 );
+    glVertexAttribPointer( 0, 3, GL_FLOAT, GL_FALSE, sizeof( SpriteVertex ),
+                           ( void * )offsetof( SpriteVertex, position ) );
+
+    // Normal
+    glEnableVertexAttribArray( 1 );
+    glVertexAttribPointer( 1, 3, GL_FLOAT, GL_FALSE, sizeof( SpriteVertex ),
+                           ( void * )offsetof( SpriteVertex, normal ) );
+
+    // UV
+    glEnableVertexAttribArray( 2 );
+    glVertexAttribPointer( 2, 2, GL_FLOAT, GL_FALSE, sizeof( SpriteVertex ),
+                           ( void * )offsetof( SpriteVertex, uv ) );
+
+    // Color, same location as the per instance color of the RenderingSystem
+    glEnableVertexAttribArray( COLOR_LOCATION );
+    glVertexAttribPointer( COLOR_LOCATION, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof( SpriteVertex ),
+                           ( void * )offsetof( SpriteVertex, color ) );
+
+    glBindBuffer( GL_ARRAY_BUFFER, 0 );
+    m_vertexBuffer = buffer;
+  }
+
+  void SpriteBatch::reserveGpuBuffers( GLStateCache &state, u32 quads ) noexcept {
+
+    if ( !m_vao ) {
+      glGenVertexArrays( 1, &m_vao );
+      glGenBuffers( 1, &m_ebo );
+
+      state.bindVertexArray( m_vao );
+
+      // Shaders shared with the RenderingSystem read the model matrix per instance.
+      // Quads are already in world space, so feed them a single identity matrix.
+      const glm::mat4 identity( 1.0f );
+      glGenBuffers( 1, &m_identityVbo );
+      glBindBuffer( GL_ARRAY_BUFFER, m_identityVbo );
+      glBufferData( GL_ARRAY_BUFFER, sizeof( identity ), &identity, GL_STATIC_DRAW );
+      for ( u32 column = 0; column < 4; ++column ) {
+        glEnableVertexAttribArray( MODEL_LOCATION + column );
+        glVertexAttribPointer( MODEL_LOCATION + column, 4, GL_FLOAT, GL_FALSE, sizeof( identity ),
+                               ( void * )( column * sizeof( glm::vec4 ) ) );
+        glVertexAttribDivisor( MODEL_LOCATION + column, 1 );
+      }
+
+      glBindBuffer( GL_ARRAY_BUFFER, 0 );
+    }
+
+    if ( quads <= m_capacity )
+      return;
+
+    m_capacity = std::max( {quads, m_capacity * 2, MIN_CAPACITY} );
+
+    // The index buffer never changes, it only grows with the number of sprites
+    std::vector<u32> indices( m_capacity * 6 );
+    for ( u32 quad = 0; quad < m_capacity; ++quad ) {
+      for ( u32 i = 0; i < 6; ++i )
+        indices[ quad * 6 + i ] = quad * 4 + QUAD_INDICES[ i ];
+    }
+
+    // The element buffer binding is stored in the vertex array
+    state.bindVertexArray( m_vao );
+    glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, m_ebo );
+    glBufferData( GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof( u32 ), indices.data(),
+                  GL_STATIC_DRAW );
+
+    spdlog::debug( "SpriteBatch buffers resized to {} quads", m_capacity );
+  }
+
+}    // namespace nile
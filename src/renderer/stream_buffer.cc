@@ -0,0 +1,238 @@
+/* ================================================================================
+$File: stream_buffer.cc
+$Date: $
+$Revision: $
+$Creator: Rostislav Orestis Stelmach
+$Notice: $
+================================================================================ */
+
+#include "Nile/renderer/stream_buffer.hh"
+
+#include <GL/glew.h>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+
+namespace nile {
+
+  namespace {
+
+    constexpr GLbitfield STORAGE_FLAGS =
+        GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+    // Waits at most a second per call, the loop keeps going until the GPU is done
+    constexpr GLuint64 WAIT_TIMEOUT = 1000000000;
+
+    bool isSignaled( void *fence ) noexcept {
+      const auto result = glClientWaitSync( static_cast<GLsync>( fence ), 0, 0 );
+      return result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED;
+    }
+
+    void waitFence( void *fence ) noexcept {
+      GLenum result = GL_TIMEOUT_EXPIRED;
+      while ( result == GL_TIMEOUT_EXPIRED )
+        result = glClientWaitSync( static_cast<GLsync>( fence ), GL_SYNC_FLUSH_COMMANDS_BIT,
+                                   WAIT_TIMEOUT );
+    }
+
+  }    // namespace
+
+  StreamBuffer::StreamBuffer( usize regionSize, bool allowPersistent ) noexcept
+      : m_regionSize( regionSize )
+      , m_allowPersistent( allowPersistent ) {}
+
+  StreamBuffer::~StreamBuffer() noexcept {
+    this->destroy();
+
+    for ( const auto &retired : m_retired ) {
+      if ( retired.fence )
+        glDeleteSync( static_cast<GLsync>( retired.fence ) );
+      glDeleteBuffers( 1, &retired.buffer );
+    }
+  }
+
+  void StreamBuffer::create() noexcept {
+
+    m_persistent = m_allowPersistent && ( GLEW_ARB_buffer_storage || GLEW_VERSION_4_4 );
+
+    glGenBuffers( 1, &m_buffer );
+    glBindBuffer( GL_ARRAY_BUFFER, m_buffer );
+
+    if ( m_persistent ) {
+      const usize size = m_regionSize * FRAMES;
+      glBufferStorage( GL_ARRAY_BUFFER, size, nullptr, STORAGE_FLAGS );
+      m_mapped = static_cast<u8 *>( glMapBufferRange( GL_ARRAY_BUFFER, 0, size, STORAGE_FLAGS ) );
+
+      if ( !m_mapped ) {
+        spdlog::warn( "StreamBuffer could not be mapped, falling back to orphaning." );
+        glBindBuffer( GL_ARRAY_BUFFER, 0 );
+        glDeleteBuffers( 1, &m_buffer );
+        m_allowPersistent = false;
+        this->create();
+        return;
+      }
+    } else {
+      // Every frame orphans the storage, one region is enough
+      glBufferData( GL_ARRAY_BUFFER, m_regionSize, nullptr, GL_STREAM_DRAW );
+      m_staging.resize( m_regionSize );
+    }
+
+    glBindBuffer( GL_ARRAY_BUFFER, 0 );
+
+    spdlog::debug( "StreamBuffer created, {} bytes per frame, persistent mapping: {}",
+                   m_regionSize, m_persistent );
+  }
+
+  void StreamBuffer::destroy() noexcept {
+    for ( auto &fence : m_fences ) {
+      if ( fence )
+        glDeleteSync( static_cast<GLsync>( fence ) );
+      fence = nullptr;
+    }
+
+    // Deleting the buffer unmaps it
+    if ( m_buffer )
+      glDeleteBuffers( 1, &m_buffer );
+
+    m_buffer = 0;
+    m_mapped = nullptr;
+  }
+
+  void StreamBuffer::beginFrame() noexcept {
+
+    if ( !m_buffer )
+      this->create();
+
+    this->deleteRetired();
+
+    m_stats = StreamBufferStats {};
+    m_stats.persistent = m_persistent;
+
+    m_region = m_persistent ? ( m_region + 1 ) % FRAMES : 0;
+    m_head = 0;
+    m_inFrame = true;
+
+    this->waitRegion();
+  }
+
+  void StreamBuffer::waitRegion() noexcept {
+
+    auto &fence = m_fences[ m_region ];
+    if ( !fence )
+      return;
+
+    if ( !isSignaled( fence ) ) {
+      ++m_stats.waits;
+      waitFence( fence );
+    }
+
+    glDeleteSync( static_cast<GLsync>( fence ) );
+    fence = nullptr;
+  }
+
+  StreamAllocation StreamBuffer::allocate( usize bytes, usize alignment ) noexcept {
+
+    if ( !m_inFrame || bytes == 0 )
+      return {};
+
+    alignment = std::max<usize>( alignment, 1 );
+
+    // Offsets are aligned from the beginning of the buffer, not of the region
+    const auto align = [ alignment ]( usize offset ) {
+      return ( offset + alignment - 1 ) / alignment * alignment;
+    };
+
+    usize base = m_region * m_regionSize;
+    usize start = align( base + m_head );
+
+    if ( start + bytes > base + m_regionSize ) {
+      this->grow( start - base + bytes );
+      base = m_region * m_regionSize;
+      start = align( base + m_head );
+    }
+
+    m_head = start + bytes - base;
+    ++m_stats.allocations;
+    m_stats.allocatedBytes += bytes;
+
+    StreamAllocation allocation;
+    allocation.data = m_persistent ? m_mapped + start : m_staging.data() + start;
+    allocation.buffer = m_buffer;
+    allocation.offset = start;
+    return allocation;
+  }
+
+  void StreamBuffer::grow( usize required ) noexcept {
+
+    const usize size = std::max( m_regionSize * 2, required );
+    spdlog::debug( "StreamBuffer grows from {} to {} bytes per frame", m_regionSize, size );
+
+    if ( !m_persistent ) {
+      // The storage is allocated again by the next flush anyway
+      m_regionSize = size;
+      m_staging.resize( size );
+      return;
+    }
+
+    // Draws of this frame may still use the old buffer, it is fenced together with
+    // the frame and deleted once the GPU is done with it
+    m_retired.push_back( {m_buffer, nullptr} );
+    m_buffer = 0;
+    m_mapped = nullptr;
+
+    for ( auto &fence : m_fences ) {
+      if ( fence )
+        glDeleteSync( static_cast<GLsync>( fence ) );
+      fence = nullptr;
+    }
+
+    m_regionSize = size;
+    this->create();
+    m_region = 0;
+    m_head = 0;
+  }
+
+  void StreamBuffer::flush() noexcept {
+
+    if ( m_persistent || m_head == 0 )
+      return;
+
+    glBindBuffer( GL_ARRAY_BUFFER, m_buffer );
+    glBufferData( GL_ARRAY_BUFFER, m_regionSize, nullptr, GL_STREAM_DRAW );
+    glBufferSubData( GL_ARRAY_BUFFER, 0, m_head, m_staging.data() );
+    glBindBuffer( GL_ARRAY_BUFFER, 0 );
+  }
+
+  void StreamBuffer::endFrame() noexcept {
+
+    if ( !m_inFrame )
+      return;
+
+    m_inFrame = false;
+
+    if ( !m_persistent )
+      return;
+
+    m_fences[ m_region ] = glFenceSync( GL_SYNC_GPU_COMMANDS_COMPLETE, 0 );
+
+    for ( auto &retired : m_retired ) {
+      if ( !retired.fence )
+        retired.fence = glFenceSync( GL_SYNC_GPU_COMMANDS_COMPLETE, 0 );
+    }
+  }
+
+  void StreamBuffer::deleteRetired() noexcept {
+
+    for ( auto it = m_retired.begin(); it != m_retired.end(); ) {
+      if ( !it->fence || !isSignaled( it->fence ) ) {
+        ++it;
+        continue;
+      }
+
+      glDeleteSync( static_cast<GLsync>( it->fence ) );
+      glDeleteBuffers( 1, &it->buffer );
+      it = m_retired.erase( it );
+    }
+  }
+
+}    // namespace nile
@@ -0,0 +1,254 @@
+/* ================================================================================
+$File: text_batch.cc
+$Date: $
+$Revision: $
+$Creator: Rostislav Orestis Stelmach
+$Notice: $
+================================================================================ */
+
+#include "Nile/renderer/text_batch.hh"
+#include "Nile/renderer/gl_state_cache.hh"
+#include "Nile/renderer/glyph_atlas.hh"
+
+#include <GL/glew.h>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <cstddef>
+
+namespace nile {
+
+  namespace {
+
+    // Same winding as the old per-glyph triangles, corners are written in the order
+    // top-left, top-right, bottom-right, bottom-left
+    constexpr u32 QUAD_INDICES[ 6 ] = {3, 1, 0, 3, 2, 1};
+
+    constexpr u32 COLOR_LOCATION = 1;
+
+    // Minimal size of the GPU buffers in quads, enough for a few lines of debug text
+    constexpr u32 MIN_CAPACITY = 256;
+
+    u32 packColor( const glm::vec3 &color ) noexcept {
+      const auto c = glm::clamp( color, 0.0f, 1.0f ) * 255.0f + 0.5f;
+      return static_cast<u32>( c.r ) | ( static_cast<u32>( c.g ) << 8 ) |
+             ( static_cast<u32>( c.b ) << 16 ) | ( 0xffu << 24 );
+    }
+
+  }    // namespace
+
+  TextBatch::~TextBatch() noexcept {
+    if ( m_vao ) {
+      glDeleteVertexArrays( 1, &m_vao );
+      glDeleteBuffers( 1, &m_vbo );
+      glDeleteBuffers( 1, &m_ebo );
+    }
+  }
+
+  void TextBatch::begin() noexcept {
+    m_submitted.clear();
+    ++m_frame;
+    m_stats = TextBatchStats {};
+  }
+
+  glm::vec2 TextBatch::submit( u32 id, const GlyphAtlas *atlas, const std::string &text,
+                               const glm::vec3 &position, const glm::vec3 &scale,
+                               const glm::vec3 &color ) noexcept {
+
+    if ( !atlas )
+      return glm::vec2( 0.0f );
+
+    auto &entry = m_texts[ id ];
+    const auto packed = packColor( color );
+
+    if ( entry.atlas != atlas || entry.text != text ||
+         entry.position != glm::vec2( position ) || entry.scale != glm::vec2( scale ) ||
+         entry.color != packed ) {
+      entry.atlas = atlas;
+      entry.text = text;
+      entry.position = glm::vec2( position );
+      entry.scale = glm::vec2( scale );
+      entry.color = packed;
+
+      layout( entry );
+      m_dirty = true;
+      ++m_stats.rebuilt;
+    }
+
+    if ( entry.frame != m_frame ) {
+      entry.frame = m_frame;
+      m_submitted.push_back( id );
+    }
+
+    return entry.extents;
+  }
+
+  void TextBatch::layout( Text &text ) noexcept {
+
+    const auto &atlas = *text.atlas;
+    const auto scale = text.scale;
+
+    text.vertices.clear();
+    text.extents = glm::vec2( 0.0f );
+
+    f32 pen = text.position.x;
+    for ( const auto c : text.text ) {
+      const auto &glyph = atlas.getGlyph( static_cast<unsigned char>( c ) );
+
+      const f32 x = pen + glyph.bearing.x * scale.x;
+      const f32 y = text.position.y + ( atlas.getAscent() - glyph.bearing.y ) * scale.y;
+      const f32 w = glyph.size.x * scale.x;
+      const f32 h = glyph.size.y * scale.y;
+
+      // Advance is stored in 1/64 pixels
+      pen += ( glyph.advance >> 6 ) * scale.x;
+
+      // Glyphs without a bitmap ( e.g space ) only move the pen
+      if ( glyph.size.x == 0 || glyph.size.y == 0 )
+        continue;
+
+      text.vertices.push_back( {{x, y}, glyph.uvMin, text.color} );
+      text.vertices.push_back( {{x + w, y}, {glyph.uvMax.x, glyph.uvMin.y}, text.color} );
+      text.vertices.push_back( {{x + w, y + h}, glyph.uvMax, text.color} );
+      text.vertices.push_back( {{x, y + h}, {glyph.uvMin.x, glyph.uvMax.y}, text.color} );
+
+      text.extents.y = std::max( text.extents.y, y + h - text.position.y );
+    }
+
+    text.extents.x = pen - text.position.x;
+  }
+
+  void TextBatch::end() noexcept {
+
+    // Texts that were not submitted this frame are gone, their quads with them
+    if ( m_texts.size() != m_submitted.size() ) {
+      for ( auto it = m_texts.begin(); it != m_texts.end(); ) {
+        if ( it->second.frame != m_frame )
+          it = m_texts.erase( it );
+        else
+          ++it;
+      }
+    }
+
+    // Same texts in the same order and none of them changed, the vertices are still valid
+    if ( m_submitted != m_previous )
+      m_dirty = true;
+
+    if ( m_dirty ) {
+      m_vertices.clear();
+      m_batches.clear();
+
+      // Texts are grouped by atlas, in the order the atlases were first seen. There are
+      // only a few atlases, so one pass over the texts per atlas is cheap.
+      std::vector<const GlyphAtlas *> atlases;
+      for ( auto id : m_submitted ) {
+        const auto *atlas = m_texts[ id ].atlas;
+        if ( std::find( atlases.begin(), atlases.end(), atlas ) == atlases.end() )
+          atlases.push_back( atlas );
+      }
+
+      for ( const auto *atlas : atlases ) {
+        Batch batch {atlas, static_cast<u32>( m_vertices.size() / 4 ), 0};
+
+        for ( auto id : m_submitted ) {
+          const auto &text = m_texts[ id ];
+          if ( text.atlas == atlas )
+            m_vertices.insert( m_vertices.end(), text.vertices.begin(), text.vertices.end() );
+        }
+
+        batch.quadCount = static_cast<u32>( m_vertices.size() / 4 ) - batch.firstQuad;
+        if ( batch.quadCount > 0 )
+          m_batches.push_back( batch );
+      }
+    }
+
+    m_previous.swap( m_submitted );
+
+    m_stats.texts = static_cast<u32>( m_previous.size() );
+    m_stats.glyphs = static_cast<u32>( m_vertices.size() / 4 );
+    m_stats.batches = static_cast<u32>( m_batches.size() );
+  }
+
+  void TextBatch::draw( RenderQueue &queue, GLStateCache &state, u32 program,
+                        u64 key ) noexcept {
+
+    const auto quads = static_cast<u32>( m_vertices.size() / 4 );
+    if ( quads == 0 )
+      return;
+
+    if ( m_dirty ) {
+      this->reserveGpuBuffers( state, quads );
+
+      state.bindVertexArray( m_vao );
+      glBindBuffer( GL_ARRAY_BUFFER, m_vbo );
+
+      // Orphan the previous storage, so we don't stall on the buffer used by the last draw
+      const auto bytes = quads * 4 * sizeof( TextVertex );
+      glBufferData( GL_ARRAY_BUFFER, m_capacity * 4 * sizeof( TextVertex ), nullptr,
+                    GL_DYNAMIC_DRAW );
+      glBufferSubData( GL_ARRAY_BUFFER, 0, bytes, m_vertices.data() );
+      m_stats.uploadedBytes = bytes;
+
+      glBindBuffer( GL_ARRAY_BUFFER, 0 );
+      m_dirty = false;
+    }
+
+    for ( const auto &batch : m_batches ) {
+      DrawPacket packet;
+      packet.key = key;
+      packet.program = program;
+      packet.vertexArray = m_vao;
+      packet.texture = batch.atlas->getTextureId();
+      packet.first = batch.firstQuad * 6;
+      packet.count = batch.quadCount * 6;
+      queue.submit( packet );
+    }
+
+    m_stats.drawCalls = static_cast<u32>( m_batches.size() );
+  }
+
+  void TextBatch::reserveGpuBuffers( GLStateCache &state, u32 quads ) noexcept {
+
+    if ( !m_vao ) {
+      glGenVertexArrays( 1, &m_vao );
+      glGenBuffers( 1, &m_vbo );
+      glGenBuffers( 1, &m_ebo );
+
+      state.bindVertexArray( m_vao );
+      glBindBuffer( GL_ARRAY_BUFFER, m_vbo );
+
+      // Position and uv
+      glEnableVertexAttribArray( 0 );
+      glVertexAttribPointer( 0, 4, GL_FLOAT, GL_FALSE, sizeof( TextVertex ),
+                             ( void * )offsetof( TextVertex, position ) );
+
+      // Color
+      glEnableVertexAttribArray( COLOR_LOCATION );
+      glVertexAttribPointer( COLOR_LOCATION, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof( TextVertex ),
+                             ( void * )offsetof( TextVertex, color ) );
+
+      glBindBuffer( GL_ARRAY_BUFFER, 0 );
+    }
+
+    if ( quads <= m_capacity )
+      return;
+
+    m_capacity = std::max( {quads, m_capacity * 2, MIN_CAPACITY} );
+
+    // The index buffer never changes, it only grows together with the vertex buffer
+    std::vector<u32> indices( m_capacity * 6 );
+    for ( u32 quad = 0; quad < m_capacity; ++quad ) {
+      for ( u32 i = 0; i < 6; ++i )
+        indices[ quad * 6 + i ] = quad * 4 + QUAD_INDICES[ i ];
+    }
+
+    // The element buffer binding is stored in the vertex array
+    state.bindVertexArray( m_vao );
+    glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, m_ebo );
+    glBufferData( GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof( u32 ), indices.data(),
+                  GL_STATIC_DRAW );
+
+    spdlog::debug( "TextBatch buffers resized to {} quads", m_capacity );
+  }
+
+}    // namespace nile
@@ -7,11 +7,34 @@ $Notice: $
 ================================================================================ */
 
 #include "Nile/renderer/texture2d.hh"
+#include "Nile/renderer/mip_chain.hh"
+#include "Nile/renderer/texture_compression.hh"
 
 #include <GL/glew.h>
 
+#include <vector>
+
 namespace nile {
 
+  namespace {
+
+    usize bytesPerPixel( u32 format ) noexcept {
+      switch ( format ) {
+        case GL_RED:
+          return 1;
+        case GL_RG:
+          return 2;
+        case GL_RGB:
+          return 3;
+        default:
+          return 4;
+      }
+    }
+
+  }    // namespace
+
+  TextureMemoryStats Texture2D::s_memoryStats;
+
   Texture2D::Texture2D() noexcept
       : m_width( 0 )
       , m_height( 0 )
@@ -44,6 +67,107 @@ namespace nile {
 
     // unbind texture
     glBindTexture( GL_TEXTURE_2D, 0 );
+
+    this->setMemory( 1, static_cast<usize>( width ) * height * bytesPerPixel( m_internalFormat ),
+                     0 );
+  }
+
+  void Texture2D::generate( const MipChain &chain ) noexcept {
+
+    if ( chain.getLevelCount() == 0 )
+      return;
+
+    this->m_width = chain.getLevel( 0 ).width;
+    this->m_height = chain.getLevel( 0 ).height;
+    this->m_imageFormat = GL_RGBA;
+    // Trilinear, unless the chain has a single level
+    this->m_filterMin = chain.getLevelCount() > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR;
+
+    glBindTexture( GL_TEXTURE_2D, this->m_id );
+    for ( u32 level = 0; level < chain.getLevelCount(); ++level ) {
+      const auto &size = chain.getLevel( level );
+      glTexImage2D( GL_TEXTURE_2D, static_cast<GLint>( level ), this->m_internalFormat,
+                    static_cast<GLsizei>( size.width ), static_cast<GLsizei>( size.height ), 0,
+                    this->m_imageFormat, GL_UNSIGNED_BYTE, chain.getData( level ) );
+    }
+
+    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0 );
+    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL,
+                     static_cast<GLint>( chain.getLevelCount() - 1 ) );
+    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, this->m_wrapS );
+    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, this->m_wrapT );
+    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, this->m_filterMin );
+    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, this->m_filterMax );
+
+    glBindTexture( GL_TEXTURE_2D, 0 );
+
+    // The chain is RGBA8, so are its levels on the GPU
+    this->setMemory( chain.getLevelCount(), chain.getBaseBytes(), chain.getMipBytes() );
+  }
+
+  void Texture2D::generate( const CompressedImage &image ) noexcept {
+
+    if ( image.levels.empty() )
+      return;
+
+    const auto levels = static_cast<u32>( image.levels.size() );
+    this->m_width = image.levels[ 0 ].width;
+    this->m_height = image.levels[ 0 ].height;
+    this->m_filterMin = levels > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR;
+
+    const bool native = TextureCompression::isSupported( image.format );
+    this->m_internalFormat =
+        native ? TextureCompression::glInternalFormat( image.format ) : GL_RGBA;
+    this->m_imageFormat = GL_RGBA;
+
+    usize baseBytes = 0;
+    usize mipBytes = 0;
+    std::vector<u8> pixels;
+
+    glBindTexture( GL_TEXTURE_2D, this->m_id );
+    for ( u32 level = 0; level < levels; ++level ) {
+      const auto &size = image.levels[ level ];
+      const auto width = static_cast<GLsizei>( size.width );
+      const auto height = static_cast<GLsizei>( size.height );
+
+      usize bytes = size.size;
+      if ( native ) {
+        glCompressedTexImage2D( GL_TEXTURE_2D, static_cast<GLint>( level ), this->m_internalFormat,
+                                width, height, 0, static_cast<GLsizei>( size.size ),
+                                image.data.data() + size.offset );
+      } else {
+        bytes = static_cast<usize>( size.width ) * size.height * 4;
+        pixels.resize( bytes );
+        TextureCompression::decode( image, level, pixels.data() );
+        glTexImage2D( GL_TEXTURE_2D, static_cast<GLint>( level ), GL_RGBA, width, height, 0,
+                      GL_RGBA, GL_UNSIGNED_BYTE, pixels.data() );
+      }
+      ( level == 0 ? baseBytes : mipBytes ) += bytes;
+    }
+
+    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0 );
+    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>( levels - 1 ) );
+    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, this->m_wrapS );
+    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, this->m_wrapT );
+    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, this->m_filterMin );
+    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, this->m_filterMax );
+
+    glBindTexture( GL_TEXTURE_2D, 0 );
+
+    // The compressed size when the GPU keeps the blocks, RGBA8 otherwise
+    this->setMemory( levels, baseBytes, mipBytes );
+  }
+
+  void Texture2D::setMemory( u32 levels, usize baseBytes, usize mipBytes ) noexcept {
+    // Generating again replaces the storage of the texture
+    if ( m_levels == 0 )
+      ++s_memoryStats.textures;
+    s_memoryStats.baseBytes += baseBytes - m_baseBytes;
+    s_memoryStats.mipBytes += mipBytes - m_mipBytes;
+
+    m_levels = levels;
+    m_baseBytes = baseBytes;
+    m_mipBytes = mipBytes;
   }
 
   void Texture2D::bind() const noexcept {
@@ -0,0 +1,217 @@
+/* ================================================================================
+$File: texture_atlas.cc
+$Date: $
+$Revision: $
+$Creator: Rostislav Orestis Stelmach
+$Notice: $
+================================================================================ */
+
+#include "Nile/renderer/texture_atlas.hh"
+#include "Nile/log/log.hh"
+#include "Nile/renderer/mip_chain.hh"
+#include "Nile/renderer/texture2d.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+// The implementation is private to the atlas, imgui has its own copy
+#define STBRP_STATIC
+#define STB_RECT_PACK_IMPLEMENTATION
+#if defined( __GNUC__ )
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-function"
+#endif
+#include "imgui/imstb_rectpack.h"
+#if defined( __GNUC__ )
+#pragma GCC diagnostic pop
+#endif
+
+#include "stb_image.h"
+
+namespace nile {
+
+  namespace {
+
+    u32 nextPowerOfTwo( u32 value ) noexcept {
+      u32 result = 1;
+      while ( result < value )
+        result <<= 1;
+      return result;
+    }
+
+    // Copies the image to ( x, y ) and repeats its edges over the padding around it
+    void blit( std::vector<u8> &page, u32 pageSize, u32 x, u32 y, const u8 *pixels, u32 width,
+               u32 height ) noexcept {
+      constexpr u32 CHANNELS = MipChain::CHANNELS;
+      constexpr auto PADDING = static_cast<i64>( TextureAtlas::PADDING );
+
+      for ( i64 row = -PADDING; row < static_cast<i64>( height ) + PADDING; ++row ) {
+        const auto sourceRow = static_cast<u32>( std::clamp<i64>( row, 0, height - 1 ) );
+        const u8 *source = pixels + static_cast<usize>( sourceRow ) * width * CHANNELS;
+        u8 *target = page.data() + ( static_cast<usize>( y + row ) * pageSize + x ) * CHANNELS;
+
+        for ( i64 column = -PADDING; column < 0; ++column )
+          std::memcpy( target + column * CHANNELS, source, CHANNELS );
+        std::memcpy( target, source, static_cast<usize>( width ) * CHANNELS );
+        for ( i64 column = 0; column < PADDING; ++column )
+          std::memcpy( target + ( width + column ) * CHANNELS,
+                       source + ( width - 1 ) * CHANNELS, CHANNELS );
+      }
+    }
+
+  }    // namespace
+
+  TextureAtlas::TextureAtlas( u32 maxPageSize ) noexcept
+      : m_maxPageSize( nextPowerOfTwo( std::max( maxPageSize, MIN_PAGE_SIZE ) ) ) {}
+
+  bool TextureAtlas::add( const std::string &name, const u8 *rgba, u32 width,
+                          u32 height ) noexcept {
+
+    if ( !rgba || width == 0 || height == 0 )
+      return false;
+
+    if ( std::max( width, height ) + 2 * PADDING > m_maxPageSize ) {
+      log::error( "TextureAtlas: { %s } is %ux%u, larger than a %u page\n", name.data(), width,
+                  height, m_maxPageSize );
+      return false;
+    }
+
+    const bool pending = std::any_of( m_images.begin(), m_images.end(),
+                                      [ & ]( const Image &image ) { return image.name == name; } );
+    if ( pending || m_placements.count( name ) ) {
+      log::error( "TextureAtlas: { %s } has been added already\n", name.data() );
+      return false;
+    }
+
+    const auto bytes = static_cast<usize>( width ) * height * MipChain::CHANNELS;
+    m_images.push_back( {name, width, height, std::vector<u8>( rgba, rgba + bytes )} );
+    return true;
+  }
+
+  bool TextureAtlas::addFile( const std::string &name, const std::string &filePath ) noexcept {
+
+    int width, height, channels;
+    stbi_set_flip_vertically_on_load( true );
+    unsigned char *image = stbi_load( filePath.data(), &width, &height, &channels, STBI_rgb_alpha );
+
+    if ( !image ) {
+      log::error( "TextureAtlas: failed to load { %s }\n", filePath.data() );
+      return false;
+    }
+
+    const bool added =
+        this->add( name, image, static_cast<u32>( width ), static_cast<u32>( height ) );
+    stbi_image_free( image );
+    return added;
+  }
+
+  TextureAtlas::Page TextureAtlas::packPage( std::vector<Image> &images ) noexcept {
+
+    u64 area = 0;
+    u32 largest = 0;
+    for ( const auto &image : images ) {
+      area += static_cast<u64>( image.width + 2 * PADDING ) * ( image.height + 2 * PADDING );
+      largest = std::max( {largest, image.width + 2 * PADDING, image.height + 2 * PADDING} );
+    }
+
+    // The smallest square the images could fit, grown until they do or it is a full page
+    const auto side = static_cast<u32>( std::ceil( std::sqrt( static_cast<f64>( area ) ) ) );
+    u32 size = std::clamp( nextPowerOfTwo( std::max( side, largest ) ), MIN_PAGE_SIZE,
+                           m_maxPageSize );
+
+    std::vector<stbrp_rect> rects( images.size() );
+    std::vector<stbrp_node> nodes( m_maxPageSize );
+    for ( ;; ) {
+      for ( usize i = 0; i < images.size(); ++i ) {
+        rects[ i ] = stbrp_rect {};
+        rects[ i ].id = static_cast<int>( i );
+        rects[ i ].w = static_cast<stbrp_coord>( images[ i ].width + 2 * PADDING );
+        rects[ i ].h = static_cast<stbrp_coord>( images[ i ].height + 2 * PADDING );
+      }
+
+      stbrp_context context;
+      stbrp_init_target( &context, static_cast<int>( size ), static_cast<int>( size ),
+                         nodes.data(), static_cast<int>( size ) );
+      if ( stbrp_pack_rects( &context, rects.data(), static_cast<int>( rects.size() ) ) ||
+           size >= m_maxPageSize )
+        break;
+      size <<= 1;
+    }
+
+    Page page {size, std::vector<u8>( static_cast<usize>( size ) * size * MipChain::CHANNELS )};
+    const auto index = static_cast<u32>( m_pages.size() );
+
+    std::vector<Image> rest;
+    for ( const auto &rect : rects ) {
+      auto &image = images[ static_cast<usize>( rect.id ) ];
+      if ( !rect.was_packed ) {
+        rest.push_back( std::move( image ) );
+        continue;
+      }
+
+      const u32 x = static_cast<u32>( rect.x ) + PADDING;
+      const u32 y = static_cast<u32>( rect.y ) + PADDING;
+      blit( page.pixels, size, x, y, image.pixels.data(), image.width, image.height );
+
+      m_placements[ image.name ] = {index, x, y, image.width, image.height};
+      m_packedTexels += static_cast<u64>( rect.w ) * rect.h;
+      ++m_stats.images;
+    }
+
+    images = std::move( rest );
+    return page;
+  }
+
+  void TextureAtlas::build() noexcept {
+
+    while ( !m_images.empty() ) {
+      auto page = this->packPage( m_images );
+
+      MipChainOptions options;
+      options.wrap = false;
+      MipChain chain;
+      chain.build( page.pixels.data(), page.size, page.size, options );
+
+      auto texture = std::make_shared<Texture2D>();
+      texture->setInternalFormat( GL_RGBA );
+      texture->generate( chain );
+      // Sprites are not tiled, and the edges of the page are not repeated
+      texture->setParameter( TextureTargetParams::TEXTURE_WRAP_S, TextureParams::CLAMP_TO_EDGE );
+      texture->setParameter( TextureTargetParams::TEXTURE_WRAP_T, TextureParams::CLAMP_TO_EDGE );
+      texture->unbind();
+
+      m_pages.push_back( texture );
+      m_pageTexels += static_cast<u64>( page.size ) * page.size;
+    }
+
+    for ( const auto &[ name, placement ] : m_placements ) {
+      if ( m_regions.count( name ) )
+        continue;
+
+      const auto &page = m_pages[ placement.page ];
+      const glm::vec2 size( page->getWidth(), page->getHeight() );
+      AtlasRegion region;
+      region.texture = page;
+      region.uvMin = glm::vec2( placement.x, placement.y ) / size;
+      region.uvMax =
+          glm::vec2( placement.x + placement.width, placement.y + placement.height ) / size;
+      m_regions.emplace( name, region );
+    }
+
+    m_stats.pages = static_cast<u32>( m_pages.size() );
+    m_stats.occupancy =
+        m_pageTexels ? static_cast<f32>( static_cast<f64>( m_packedTexels ) / m_pageTexels ) : 0.0f;
+  }
+
+  const AtlasRegion *TextureAtlas::getRegion( const std::string &name ) const noexcept {
+    const auto it = m_regions.find( name );
+    return it != m_regions.end() ? &it->second : nullptr;
+  }
+
+  const AtlasPlacement *TextureAtlas::getPlacement( const std::string &name ) const noexcept {
+    const auto it = m_placements.find( name );
+    return it != m_placements.end() ? &it->second : nullptr;
+  }
+
+}    // namespace nile
@@ -0,0 +1,883 @@
+/* ================================================================================
+$File: texture_compression.cc
+$Date: $
+$Revision: $
+$Creator: Rostislav Orestis Stelmach
+$Notice: $
+================================================================================ */
+
+#include "Nile/renderer/texture_compression.hh"
+#include "Nile/log/log.hh"
+
+#include <GL/glew.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+namespace nile {
+
+  namespace {
+
+    // Containers
+
+    constexpr u32 DDS_MAGIC = 0x20534444;    // "DDS "
+    constexpr usize DDS_HEADER_BYTES = 128;
+    constexpr usize DDS_DX10_BYTES = 20;
+
+    constexpr u8 KTX_IDENTIFIER[ 12 ] = {0xAB, 'K',  'T',  'X',  ' ',  '1',
+                                         '1',  0xBB, '\r', '\n', 0x1A, '\n'};
+    constexpr usize KTX_HEADER_BYTES = 64;
+    constexpr u32 KTX_ENDIANNESS = 0x04030201;
+
+    constexpr u32 fourCC( char a, char b, char c, char d ) noexcept {
+      return static_cast<u32>( a ) | static_cast<u32>( b ) << 8 | static_cast<u32>( c ) << 16 |
+             static_cast<u32>( d ) << 24;
+    }
+
+    u32 readU32( const u8 *data ) noexcept {
+      return static_cast<u32>( data[ 0 ] ) | static_cast<u32>( data[ 1 ] ) << 8 |
+             static_cast<u32>( data[ 2 ] ) << 16 | static_cast<u32>( data[ 3 ] ) << 24;
+    }
+
+    u64 readU64( const u8 *data ) noexcept {
+      return static_cast<u64>( readU32( data ) ) | static_cast<u64>( readU32( data + 4 ) ) << 32;
+    }
+
+    // ETC2 and EAC blocks are big endian
+    u64 readU64BigEndian( const u8 *data ) noexcept {
+      u64 value = 0;
+      for ( u32 i = 0; i < 8; ++i )
+        value = value << 8 | data[ i ];
+      return value;
+    }
+
+    bool formatFromDxgi( u32 dxgi, CompressedFormat &format ) noexcept {
+      switch ( dxgi ) {
+        case 71:    // DXGI_FORMAT_BC1_UNORM
+        case 72:    // DXGI_FORMAT_BC1_UNORM_SRGB
+          format = CompressedFormat::BC1;
+          return true;
+        case 77:    // DXGI_FORMAT_BC3_UNORM
+        case 78:    // DXGI_FORMAT_BC3_UNORM_SRGB
+          format = CompressedFormat::BC3;
+          return true;
+        case 83:    // DXGI_FORMAT_BC5_UNORM
+          format = CompressedFormat::BC5;
+          return true;
+        case 98:    // DXGI_FORMAT_BC7_UNORM
+        case 99:    // DXGI_FORMAT_BC7_UNORM_SRGB
+          format = CompressedFormat::BC7;
+          return true;
+        default:
+          return false;
+      }
+    }
+
+    bool formatFromGl( u32 internalFormat, CompressedFormat &format ) noexcept {
+      switch ( internalFormat ) {
+        case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+        case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT:
+          format = CompressedFormat::BC1;
+          return true;
+        case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+          format = CompressedFormat::BC3;
+          return true;
+        case GL_COMPRESSED_RG_RGTC2:
+          format = CompressedFormat::BC5;
+          return true;
+        case GL_COMPRESSED_RGBA_BPTC_UNORM:
+        case GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM:
+          format = CompressedFormat::BC7;
+          return true;
+        case GL_COMPRESSED_RGB8_ETC2:
+        case GL_COMPRESSED_SRGB8_ETC2:
+          format = CompressedFormat::ETC2_RGB;
+          return true;
+        case GL_COMPRESSED_RGBA8_ETC2_EAC:
+        case GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC:
+          format = CompressedFormat::ETC2_RGBA;
+          return true;
+        default:
+          return false;
+      }
+    }
+
+    // Computed in 64 bits, width + 3 must not wrap for the sizes a header may claim
+    u64 levelBytes( CompressedFormat format, u32 width, u32 height ) noexcept {
+      constexpr u64 B = TextureCompression::BLOCK_SIZE;
+      return ( ( width + B - 1 ) / B ) * ( ( height + B - 1 ) / B ) *
+             TextureCompression::blockBytes( format );
+    }
+
+    bool isValidSize( u32 width, u32 height ) noexcept {
+      using TextureCompression::MAX_DIMENSION;
+      if ( width == 0 || height == 0 || width > MAX_DIMENSION || height > MAX_DIMENSION ) {
+        log::error( "TextureCompression: invalid size %ux%u\n", width, height );
+        return false;
+      }
+      return true;
+    }
+
+    // Levels stored back to back from offset, as in a DDS file
+    bool readPackedLevels( usize size, usize offset, u32 width, u32 height, u32 levels,
+                           CompressedImage &image ) noexcept {
+      image.levels.clear();
+      for ( u32 level = 0; level < levels; ++level ) {
+        const u64 bytes = levelBytes( image.format, width, height );
+        if ( bytes == 0 || bytes > size - offset )
+          break;
+        image.levels.push_back( {width, height, offset, static_cast<usize>( bytes )} );
+        offset += static_cast<usize>( bytes );
+        width = std::max( 1u, width >> 1 );
+        height = std::max( 1u, height >> 1 );
+      }
+      return !image.levels.empty();
+    }
+
+    bool parseDds( const u8 *data, usize size, CompressedImage &image ) noexcept {
+      if ( size < DDS_HEADER_BYTES )
+        return false;
+
+      const u32 height = readU32( data + 12 );
+      const u32 width = readU32( data + 16 );
+      const u32 levels = std::max( 1u, readU32( data + 28 ) );
+      const u32 code = readU32( data + 84 );
+
+      usize offset = DDS_HEADER_BYTES;
+      if ( code == fourCC( 'D', 'X', '1', '0' ) ) {
+        if ( size < DDS_HEADER_BYTES + DDS_DX10_BYTES )
+          return false;
+        const u32 dxgi = readU32( data + DDS_HEADER_BYTES );
+        if ( !formatFromDxgi( dxgi, image.format ) ) {
+          log::error( "TextureCompression: unsupported DXGI format %u\n", dxgi );
+          return false;
+        }
+        offset += DDS_DX10_BYTES;
+      } else if ( code == fourCC( 'D', 'X', 'T', '1' ) ) {
+        image.format = CompressedFormat::BC1;
+      } else if ( code == fourCC( 'D', 'X', 'T', '5' ) ) {
+        image.format = CompressedFormat::BC3;
+      } else if ( code == fourCC( 'A', 'T', 'I', '2' ) || code == fourCC( 'B', 'C', '5', 'U' ) ) {
+        image.format = CompressedFormat::BC5;
+      } else {
+        log::error( "TextureCompression: unsupported DDS four character code %08x\n", code );
+        return false;
+      }
+
+      if ( !isValidSize( width, height ) || offset > size )
+        return false;
+      return readPackedLevels( size, offset, width, height, levels, image );
+    }
+
+    bool parseKtx( const u8 *data, usize size, CompressedImage &image ) noexcept {
+      if ( size < KTX_HEADER_BYTES )
+        return false;
+
+      if ( readU32( data + 12 ) != KTX_ENDIANNESS ) {
+        log::error( "TextureCompression: big endian KTX files are not supported\n" );
+        return false;
+      }
+
+      const u32 internalFormat = readU32( data + 28 );
+      if ( !formatFromGl( internalFormat, image.format ) ) {
+        log::error( "TextureCompression: unsupported KTX internal format %04x\n",
+                    internalFormat );
+        return false;
+      }
+
+      u32 width = readU32( data + 36 );
+      u32 height = std::max( 1u, readU32( data + 40 ) );
+      const u32 levels = std::max( 1u, readU32( data + 56 ) );
+      const u32 keyValueBytes = readU32( data + 60 );
+      if ( !isValidSize( width, height ) )
+        return false;
+
+      // Every level is prefixed with its size, 2D textures have a single image per level
+      usize offset = KTX_HEADER_BYTES + keyValueBytes;
+      image.levels.clear();
+      for ( u32 level = 0; level < levels; ++level ) {
+        if ( offset + 4 > size )
+          break;
+        const usize bytes = readU32( data + offset );
+        offset += 4;
+        if ( bytes == 0 || bytes != levelBytes( image.format, width, height ) ||
+             bytes > size - offset )
+          break;
+        image.levels.push_back( {width, height, offset, bytes} );
+        offset += ( bytes + 3 ) & ~static_cast<usize>( 3 );
+        width = std::max( 1u, width >> 1 );
+        height = std::max( 1u, height >> 1 );
+      }
+      return !image.levels.empty();
+    }
+
+    // BC1 - BC5, interpolated in exact fractions rounded to the nearest byte as the D3D
+    // reference does, GPUs may differ by one
+
+    // Replicates the top bits of a quantized value into the low bits
+    u32 expand( u32 value, u32 bits ) noexcept {
+      value <<= 8 - bits;
+      return value | value >> bits;
+    }
+
+    // Colors of a BC1 block, the third and fourth interpolated unless it has the transparent
+    // black entry, which only BC1 has
+    void decodeBC1( const u8 *block, u8 *rgba, bool transparent ) noexcept {
+      const u32 c0 = static_cast<u32>( block[ 0 ] ) | static_cast<u32>( block[ 1 ] ) << 8;
+      const u32 c1 = static_cast<u32>( block[ 2 ] ) | static_cast<u32>( block[ 3 ] ) << 8;
+      const u32 indices = readU32( block + 4 );
+
+      u8 palette[ 4 ][ 4 ];
+      for ( u32 i = 0; i < 2; ++i ) {
+        const u32 color = i == 0 ? c0 : c1;
+        palette[ i ][ 0 ] = static_cast<u8>( expand( color >> 11, 5 ) );
+        palette[ i ][ 1 ] = static_cast<u8>( expand( ( color >> 5 ) & 0x3F, 6 ) );
+        palette[ i ][ 2 ] = static_cast<u8>( expand( color & 0x1F, 5 ) );
+        palette[ i ][ 3 ] = 255;
+      }
+
+      const bool opaque = !transparent || c0 > c1;
+      for ( u32 c = 0; c < 3; ++c ) {
+        const u32 a = palette[ 0 ][ c ];
+        const u32 b = palette[ 1 ][ c ];
+        palette[ 2 ][ c ] = static_cast<u8>( opaque ? ( 2 * a + b + 1 ) / 3 : ( a + b + 1 ) / 2 );
+        palette[ 3 ][ c ] = static_cast<u8>( opaque ? ( a + 2 * b + 1 ) / 3 : 0 );
+      }
+      palette[ 2 ][ 3 ] = 255;
+      palette[ 3 ][ 3 ] = opaque ? 255 : 0;
+
+      for ( u32 i = 0; i < 16; ++i )
+        std::memcpy( rgba + i * 4, palette[ ( indices >> ( 2 * i ) ) & 3 ], 4 );
+    }
+
+    // A single channel BC4 block, the alpha of BC3 and both channels of BC5
+    void decodeBC4( const u8 *block, u8 *rgba, u32 channel ) noexcept {
+      const u32 a0 = block[ 0 ];
+      const u32 a1 = block[ 1 ];
+      const u64 indices = readU64( block ) >> 16;
+
+      u8 palette[ 8 ] = {static_cast<u8>( a0 ), static_cast<u8>( a1 )};
+      for ( u32 code = 2; code < 8; ++code ) {
+        if ( a0 > a1 )
+          palette[ code ] = static_cast<u8>( ( a0 * ( 8 - code ) + a1 * ( code - 1 ) + 3 ) / 7 );
+        else if ( code < 6 )
+          palette[ code ] = static_cast<u8>( ( a0 * ( 6 - code ) + a1 * ( code - 1 ) + 2 ) / 5 );
+        else
+          palette[ code ] = code == 6 ? 0 : 255;
+      }
+
+      for ( u32 i = 0; i < 16; ++i )
+        rgba[ i * 4 + channel ] = palette[ ( indices >> ( 3 * i ) ) & 7 ];
+    }
+
+    // BC7
+
+    struct BC7Mode {
+      u32 subsets;
+      u32 partitionBits;
+      u32 rotationBits;
+      u32 selectorBits;
+      u32 colorBits;
+      u32 alphaBits;
+      u32 endpointPBits;
+      u32 sharedPBits;
+      u32 indexBits;
+      u32 indexBits2;
+    };
+
+    constexpr BC7Mode BC7_MODES[ 8 ] = {
+        {3, 4, 0, 0, 4, 0, 1, 0, 3, 0}, {2, 6, 0, 0, 6, 0, 0, 1, 3, 0},
+        {3, 6, 0, 0, 5, 0, 0, 0, 2, 0}, {2, 6, 0, 0, 7, 0, 1, 0, 2, 0},
+        {1, 0, 2, 1, 5, 6, 0, 0, 2, 3}, {1, 0, 2, 0, 7, 8, 0, 0, 2, 2},
+        {1, 0, 0, 0, 7, 7, 1, 0, 4, 0}, {2, 6, 0, 0, 5, 5, 1, 0, 2, 0},
+    };
+
+    // Subset of every texel of the two subset partitions, one bit per texel
+    constexpr u16 BC7_PARTITIONS2[ 64 ] = {
+        0xCCCC, 0x8888, 0xEEEE, 0xECC8, 0xC880, 0xFEEC, 0xFEC8, 0xEC80, 0xC800, 0xFFEC, 0xFE80,
+        0xE800, 0xFFE8, 0xFF00, 0xFFF0, 0xF000, 0xF710, 0x008E, 0x7100, 0x08CE, 0x008C, 0x7310,
+        0x3100, 0x8CCE, 0x088C, 0x3110, 0x6666, 0x366C, 0x17E8, 0x0FF0, 0x718E, 0x399C, 0xAAAA,
+        0xF0F0, 0x5A5A, 0x33CC, 0x3C3C, 0x55AA, 0x9696, 0xA55A, 0x73CE, 0x13C8, 0x324C, 0x3BDC,
+        0x6996, 0xC33C, 0x9966, 0x0660, 0x0272, 0x04E4, 0x4E40, 0x2720, 0xC936, 0x936C, 0x39C6,
+        0x639C, 0x9336, 0x9CC6, 0x817E, 0xE718, 0xCCF0, 0x0FCC, 0x7744, 0xEE22,
+    };
+
+    // Subset of every texel of the three subset partitions
+    constexpr u8 BC7_PARTITIONS3[ 64 ][ 16 ] = {
+        {0, 0, 1, 1, 0, 0, 1, 1, 0, 2, 2, 1, 2, 2, 2, 2},
+        {0, 0, 0, 1, 0, 0, 1, 1, 2, 2, 1, 1, 2, 2, 2, 1},
+        {0, 0, 0, 0, 2, 0, 0, 1, 2, 2, 1, 1, 2, 2, 1, 1},
+        {0, 2, 2, 2, 0, 0, 2, 2, 0, 0, 1, 1, 0, 1, 1, 1},
+        {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 2, 2, 1, 1, 2, 2},
+        {0, 0, 1, 1, 0, 0, 1, 1, 0, 0, 2, 2, 0, 0, 2, 2},
+        {0, 0, 2, 2, 0, 0, 2, 2, 1, 1, 1, 1, 1, 1, 1, 1},
+        {0, 0, 1, 1, 0, 0, 1, 1, 2, 2, 1, 1, 2, 2, 1, 1},
+        {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2},
+        {0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 2, 2, 2, 2},
+        {0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 2, 2, 2, 2},
+        {0, 0, 1, 2, 0, 0, 1, 2, 0, 0, 1, 2, 0, 0, 1, 2},
+        {0, 1, 1, 2, 0, 1, 1, 2, 0, 1, 1, 2, 0, 1, 1, 2},
+        {0, 1, 2, 2, 0, 1, 2, 2, 0, 1, 2, 2, 0, 1, 2, 2},
+        {0, 0, 1, 1, 0, 1, 1, 2, 1, 1, 2, 2, 1, 2, 2, 2},
+        {0, 0, 1, 1, 2, 0, 0, 1, 2, 2, 0, 0, 2, 2, 2, 0},
+        {0, 0, 0, 1, 0, 0, 1, 1, 0, 1, 1, 2, 1, 1, 2, 2},
+        {0, 1, 1, 1, 0, 0, 1, 1, 2, 0, 0, 1, 2, 2, 0, 0},
+        {0, 0, 0, 0, 1, 1, 2, 2, 1, 1, 2, 2, 1, 1, 2, 2},
+        {0, 0, 2, 2, 0, 0, 2, 2, 0, 0, 2, 2, 1, 1, 1, 1},
+        {0, 1, 1, 1, 0, 1, 1, 1, 0, 2, 2, 2, 0, 2, 2, 2},
+        {0, 0, 0, 1, 0, 0, 0, 1, 2, 2, 2, 1, 2, 2, 2, 1},
+        {0, 0, 0, 0, 0, 0, 1, 1, 0, 1, 2, 2, 0, 1, 2, 2},
+        {0, 0, 0, 0, 1, 1, 0, 0, 2, 2, 1, 0, 2, 2, 1, 0},
+        {0, 1, 2, 2, 0, 1, 2, 2, 0, 0, 1, 1, 0, 0, 0, 0},
+        {0, 0, 1, 2, 0, 0, 1, 2, 1, 1, 2, 2, 2, 2, 2, 2},
+        {0, 1, 1, 0, 1, 2, 2, 1, 1, 2, 2, 1, 0, 1, 1, 0},
+        {0, 0, 0, 0, 0, 1, 1, 0, 1, 2, 2, 1, 1, 2, 2, 1},
+        {0, 0, 2, 2, 1, 1, 0, 2, 1, 1, 0, 2, 0, 0, 2, 2},
+        {0, 1, 1, 0, 0, 1, 1, 0, 2, 0, 0, 2, 2, 2, 2, 2},
+        {0, 0, 1, 1, 0, 1, 2, 2, 0, 1, 2, 2, 0, 0, 1, 1},
+        {0, 0, 0, 0, 2, 0, 0, 0, 2, 2, 1, 1, 2, 2, 2, 1},
+        {0, 0, 0, 0, 0, 0, 0, 2, 1, 1, 2, 2, 1, 2, 2, 2},
+        {0, 2, 2, 2, 0, 0, 2, 2, 0, 0, 1, 2, 0, 0, 1, 1},
+        {0, 0, 1, 1, 0, 0, 1, 2, 0, 0, 2, 2, 0, 2, 2, 2},
+        {0, 1, 2, 0, 0, 1, 2, 0, 0, 1, 2, 0, 0, 1, 2, 0},
+        {0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 0, 0, 0, 0},
+        {0, 1, 2, 0, 1, 2, 0, 1, 2, 0, 1, 2, 0, 1, 2, 0},
+        {0, 1, 2, 0, 2, 0, 1, 2, 1, 2, 0, 1, 0, 1, 2, 0},
+        {0, 0, 1, 1, 2, 2, 0, 0, 1, 1, 2, 2, 0, 0, 1, 1},
+        {0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 0, 0, 0, 0, 1, 1},
+        {0, 1, 0, 1, 0, 1, 0, 1, 2, 2, 2, 2, 2, 2, 2, 2},
+        {0, 0, 0, 0, 0, 0, 0, 0, 2, 1, 2, 1, 2, 1, 2, 1},
+        {0, 0, 2, 2, 1, 1, 2, 2, 0, 0, 2, 2, 1, 1, 2, 2},
+        {0, 0, 2, 2, 0, 0, 1, 1, 0, 0, 2, 2, 0, 0, 1, 1},
+        {0, 2, 2, 0, 1, 2, 2, 1, 0, 2, 2, 0, 1, 2, 2, 1},
+        {0, 1, 0, 1, 2, 2, 2, 2, 2, 2, 2, 2, 0, 1, 0, 1},
+        {0, 0, 0, 0, 2, 1, 2, 1, 2, 1, 2, 1, 2, 1, 2, 1},
+        {0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 2, 2, 2, 2},
+        {0, 2, 2, 2, 0, 1, 1, 1, 0, 2, 2, 2, 0, 1, 1, 1},
+        {0, 0, 0, 2, 1, 1, 1, 2, 0, 0, 0, 2, 1, 1, 1, 2},
+        {0, 0, 0, 0, 2, 1, 1, 2, 2, 1, 1, 2, 2, 1, 1, 2},
+        {0, 2, 2, 2, 0, 1, 1, 1, 0, 1, 1, 1, 0, 2, 2, 2},
+        {0, 0, 0, 2, 1, 1, 1, 2, 1, 1, 1, 2, 0, 0, 0, 2},
+        {0, 1, 1, 0, 0, 1, 1, 0, 0, 1, 1, 0, 2, 2, 2, 2},
+        {0, 0, 0, 0, 0, 0, 0, 0, 2, 1, 1, 2, 2, 1, 1, 2},
+        {0, 1, 1, 0, 0, 1, 1, 0, 2, 2, 2, 2, 2, 2, 2, 2},
+        {0, 0, 2, 2, 0, 0, 1, 1, 0, 0, 1, 1, 0, 0, 2, 2},
+        {0, 0, 2, 2, 1, 1, 2, 2, 1, 1, 2, 2, 0, 0, 2, 2},
+        {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2, 1, 1, 2},
+        {0, 0, 0, 2, 0, 0, 0, 1, 0, 0, 0, 2, 0, 0, 0, 1},
+        {0, 2, 2, 2, 1, 2, 2, 2, 0, 2, 2, 2, 1, 2, 2, 2},
+        {0, 1, 0, 1, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2},
+        {0, 1, 1, 1, 2, 0, 1, 1, 2, 2, 0, 1, 2, 2, 2, 0},
+    };
+
+    // Texels that store one index bit less, the first texel of subset 1 ( and 2 )
+    constexpr u8 BC7_ANCHORS2[ 64 ] = {
+        15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 2,  8,  2,  2,  8,
+        8,  15, 2,  8,  2,  2,  8,  8,  2,  2,  15, 15, 6,  8,  2,  8,  15, 15, 2,  8,  2,  2,
+        2,  15, 15, 6,  6,  2,  6,  8,  15, 15, 2,  2,  15, 15, 15, 15, 15, 2,  2,  15,
+    };
+
+    constexpr u8 BC7_ANCHORS3A[ 64 ] = {
+        3,  3,  15, 15, 8,  3,  15, 15, 8,  8,  6,  6,  6,  5,  3,  3,  3,  3,  8,  15, 3,  3,
+        6,  10, 5,  8,  8,  6,  8,  5,  15, 15, 8,  15, 3,  5,  6,  10, 8,  15, 15, 3,  15, 5,
+        15, 15, 15, 15, 3,  15, 5,  5,  5,  8,  5,  10, 5,  10, 8,  13, 15, 12, 3,  3,
+    };
+
+    constexpr u8 BC7_ANCHORS3B[ 64 ] = {
+        15, 8,  8,  3,  15, 15, 3,  8,  15, 15, 15, 15, 15, 15, 15, 8,  15, 8,  15, 3,  15, 8,
+        15, 8,  3,  15, 6,  10, 15, 15, 10, 8,  15, 3,  15, 10, 10, 8,  9,  10, 6,  15, 8,  15,
+        3,  6,  6,  8,  15, 3,  15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 3,  15, 15, 8,
+    };
+
+    constexpr u8 BC7_WEIGHTS2[ 4 ] = {0, 21, 43, 64};
+    constexpr u8 BC7_WEIGHTS3[ 8 ] = {0, 9, 18, 27, 37, 46, 55, 64};
+    constexpr u8 BC7_WEIGHTS4[ 16 ] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+    const u8 *bc7Weights( u32 bits ) noexcept {
+      return bits == 2 ? BC7_WEIGHTS2 : ( bits == 3 ? BC7_WEIGHTS3 : BC7_WEIGHTS4 );
+    }
+
+    // Reads the 128 bits of a block from the lowest
+    class BlockBits {
+    private:
+      u64 m_low;
+      u64 m_high;
+      u32 m_position = 0;
+
+    public:
+      explicit BlockBits( const u8 *block ) noexcept
+          : m_low( readU64( block ) ), m_high( readU64( block + 8 ) ) {}
+
+      u32 read( u32 count ) noexcept {
+        if ( count == 0 )
+          return 0;
+        u64 bits;
+        if ( m_position >= 64 )
+          bits = m_high >> ( m_position - 64 );
+        else if ( m_position == 0 )
+          bits = m_low;
+        else
+          bits = m_low >> m_position | m_high << ( 64 - m_position );
+        m_position += count;
+        return static_cast<u32>( bits & ( ( 1ull << count ) - 1 ) );
+      }
+    };
+
+    void decodeBC7( const u8 *block, u8 *rgba ) noexcept {
+      u32 modeIndex = 0;
+      while ( modeIndex < 8 && !( block[ 0 ] & ( 1u << modeIndex ) ) )
+        ++modeIndex;
+
+      // The reserved mode decodes to transparent black
+      if ( modeIndex == 8 ) {
+        std::memset( rgba, 0, 64 );
+        return;
+      }
+
+      const auto &mode = BC7_MODES[ modeIndex ];
+      BlockBits bits( block );
+      bits.read( modeIndex + 1 );
+      const u32 partition = bits.read( mode.partitionBits );
+      const u32 rotation = bits.read( mode.rotationBits );
+      const u32 selector = bits.read( mode.selectorBits );
+
+      // [ subset ][ endpoint ][ channel ]
+      u32 endpoints[ 3 ][ 2 ][ 4 ] = {};
+      for ( u32 c = 0; c < 3; ++c )
+        for ( u32 s = 0; s < mode.subsets; ++s )
+          for ( u32 e = 0; e < 2; ++e )
+            endpoints[ s ][ e ][ c ] = bits.read( mode.colorBits );
+      for ( u32 s = 0; s < mode.subsets && mode.alphaBits; ++s )
+        for ( u32 e = 0; e < 2; ++e )
+          endpoints[ s ][ e ][ 3 ] = bits.read( mode.alphaBits );
+
+      u32 pbits[ 3 ][ 2 ] = {};
+      for ( u32 s = 0; s < mode.subsets; ++s ) {
+        if ( mode.endpointPBits ) {
+          pbits[ s ][ 0 ] = bits.read( 1 );
+          pbits[ s ][ 1 ] = bits.read( 1 );
+        } else if ( mode.sharedPBits ) {
+          pbits[ s ][ 0 ] = pbits[ s ][ 1 ] = bits.read( 1 );
+        }
+      }
+
+      const bool hasPBits = mode.endpointPBits || mode.sharedPBits;
+      for ( u32 s = 0; s < mode.subsets; ++s )
+        for ( u32 e = 0; e < 2; ++e )
+          for ( u32 c = 0; c < 4; ++c ) {
+            auto &value = endpoints[ s ][ e ][ c ];
+            if ( c == 3 && mode.alphaBits == 0 ) {
+              value = 255;
+              continue;
+            }
+            u32 precision = c < 3 ? mode.colorBits : mode.alphaBits;
+            if ( hasPBits ) {
+              value = value << 1 | pbits[ s ][ e ];
+              ++precision;
+            }
+            value = expand( value, precision );
+          }
+
+      u32 subsets[ 16 ] = {};
+      u32 anchors[ 3 ] = {0, 0, 0};
+      if ( mode.subsets == 2 ) {
+        for ( u32 i = 0; i < 16; ++i )
+          subsets[ i ] = BC7_PARTITIONS2[ partition ] >> i & 1;
+        anchors[ 1 ] = BC7_ANCHORS2[ partition ];
+      } else if ( mode.subsets == 3 ) {
+        for ( u32 i = 0; i < 16; ++i )
+          subsets[ i ] = BC7_PARTITIONS3[ partition ][ i ];
+        anchors[ 1 ] = BC7_ANCHORS3A[ partition ];
+        anchors[ 2 ] = BC7_ANCHORS3B[ partition ];
+      }
+
+      u32 indices[ 16 ];
+      u32 indices2[ 16 ] = {};
+      for ( u32 i = 0; i < 16; ++i )
+        indices[ i ] = bits.read( mode.indexBits - ( i == anchors[ subsets[ i ] ] ? 1 : 0 ) );
+      for ( u32 i = 0; i < 16 && mode.indexBits2; ++i )
+        indices2[ i ] = bits.read( mode.indexBits2 - ( i == 0 ? 1 : 0 ) );
+
+      // The selector swaps which of the two index sets the colors use
+      const bool swapped = mode.indexBits2 && selector;
+      const u32 colorBits = swapped ? mode.indexBits2 : mode.indexBits;
+      const u32 alphaBits = mode.indexBits2 && !swapped ? mode.indexBits2 : mode.indexBits;
+      const u8 *colorWeights = bc7Weights( colorBits );
+      const u8 *alphaWeights = bc7Weights( alphaBits );
+
+      for ( u32 i = 0; i < 16; ++i ) {
+        const auto &e = endpoints[ subsets[ i ] ];
+        const u32 colorIndex = swapped ? indices2[ i ] : indices[ i ];
+        const u32 alphaIndex = mode.indexBits2 && !swapped ? indices2[ i ] : indices[ i ];
+
+        u8 *texel = rgba + i * 4;
+        for ( u32 c = 0; c < 4; ++c ) {
+          const u32 w = c < 3 ? colorWeights[ colorIndex ] : alphaWeights[ alphaIndex ];
+          texel[ c ] = static_cast<u8>( ( ( 64 - w ) * e[ 0 ][ c ] + w * e[ 1 ][ c ] + 32 ) >> 6 );
+        }
+        if ( rotation )
+          std::swap( texel[ 3 ], texel[ rotation - 1 ] );
+      }
+    }
+
+    // ETC2
+
+    constexpr i32 ETC_MODIFIERS[ 8 ][ 4 ] = {
+        {2, 8, -2, -8},     {5, 17, -5, -17},   {9, 29, -9, -29},     {13, 42, -13, -42},
+        {18, 60, -18, -60}, {24, 80, -24, -80}, {33, 106, -33, -106}, {47, 183, -47, -183},
+    };
+
+    constexpr i32 ETC_DISTANCES[ 8 ] = {3, 6, 11, 16, 23, 32, 41, 64};
+
+    constexpr i32 EAC_MODIFIERS[ 16 ][ 8 ] = {
+        {-3, -6, -9, -15, 2, 5, 8, 14}, {-3, -7, -10, -13, 2, 6, 9, 12},
+        {-2, -5, -8, -13, 1, 4, 7, 12}, {-2, -4, -6, -13, 1, 3, 5, 12},
+        {-3, -6, -8, -12, 2, 5, 7, 11}, {-3, -7, -9, -11, 2, 6, 8, 10},
+        {-4, -7, -8, -11, 3, 6, 7, 10}, {-3, -5, -8, -11, 2, 4, 7, 10},
+        {-2, -6, -8, -10, 1, 5, 7, 9},  {-2, -5, -8, -10, 1, 4, 7, 9},
+        {-2, -4, -8, -10, 1, 3, 7, 9},  {-2, -5, -7, -10, 1, 4, 6, 9},
+        {-3, -4, -7, -10, 2, 3, 6, 9},  {-1, -2, -3, -10, 0, 1, 2, 9},
+        {-4, -6, -8, -9, 3, 5, 7, 8},   {-3, -5, -7, -9, 2, 4, 6, 8},
+    };
+
+    u8 clampByte( i32 value ) noexcept {
+      return static_cast<u8>( std::clamp( value, 0, 255 ) );
+    }
+
+    // Bits hi..lo of a 64 bit block
+    u32 field( u64 block, u32 hi, u32 lo ) noexcept {
+      return static_cast<u32>( block >> lo & ( ( 1ull << ( hi - lo + 1 ) ) - 1 ) );
+    }
+
+    void setColor( u8 *texel, i32 r, i32 g, i32 b ) noexcept {
+      texel[ 0 ] = clampByte( r );
+      texel[ 1 ] = clampByte( g );
+      texel[ 2 ] = clampByte( b );
+      texel[ 3 ] = 255;
+    }
+
+    void decodeEtc2( const u8 *block, u8 *rgba ) noexcept {
+      const u64 bits = readU64BigEndian( block );
+
+      // The texels are indexed column by column, the index bits are split in two halves
+      const auto index = [ bits ]( u32 x, u32 y ) {
+        const u32 i = x * 4 + y;
+        return static_cast<u32>( ( bits >> ( 16 + i ) & 1 ) << 1 | ( bits >> i & 1 ) );
+      };
+
+      const bool differential = bits >> 33 & 1;
+      const bool flip = bits >> 32 & 1;
+
+      i32 base[ 2 ][ 3 ];
+      if ( !differential ) {
+        for ( u32 c = 0; c < 3; ++c ) {
+          base[ 0 ][ c ] = static_cast<i32>( expand( field( bits, 63 - 8 * c, 60 - 8 * c ), 4 ) );
+          base[ 1 ][ c ] = static_cast<i32>( expand( field( bits, 59 - 8 * c, 56 - 8 * c ), 4 ) );
+        }
+      } else {
+        i32 color[ 3 ];
+        i32 delta[ 3 ];
+        for ( u32 c = 0; c < 3; ++c ) {
+          color[ c ] = static_cast<i32>( field( bits, 63 - 8 * c, 59 - 8 * c ) );
+          delta[ c ] = static_cast<i32>( field( bits, 58 - 8 * c, 56 - 8 * c ) );
+          delta[ c ] = delta[ c ] >= 4 ? delta[ c ] - 8 : delta[ c ];
+        }
+        const auto overflows = [ & ]( u32 c ) {
+          return color[ c ] + delta[ c ] < 0 || color[ c ] + delta[ c ] > 31;
+        };
+
+        // T mode, two colors and two more a distance from the second
+        if ( overflows( 0 ) ) {
+          const i32 c1[ 3 ] = {
+              static_cast<i32>( expand( field( bits, 60, 59 ) << 2 | field( bits, 57, 56 ), 4 ) ),
+              static_cast<i32>( expand( field( bits, 55, 52 ), 4 ) ),
+              static_cast<i32>( expand( field( bits, 51, 48 ), 4 ) )};
+          const i32 c2[ 3 ] = {static_cast<i32>( expand( field( bits, 47, 44 ), 4 ) ),
+                               static_cast<i32>( expand( field( bits, 43, 40 ), 4 ) ),
+                               static_cast<i32>( expand( field( bits, 39, 36 ), 4 ) )};
+          const i32 d = ETC_DISTANCES[ field( bits, 35, 34 ) << 1 | field( bits, 32, 32 ) ];
+          const i32 paint[ 4 ][ 3 ] = {{c1[ 0 ], c1[ 1 ], c1[ 2 ]},
+                                       {c2[ 0 ] + d, c2[ 1 ] + d, c2[ 2 ] + d},
+                                       {c2[ 0 ], c2[ 1 ], c2[ 2 ]},
+                                       {c2[ 0 ] - d, c2[ 1 ] - d, c2[ 2 ] - d}};
+          for ( u32 y = 0; y < 4; ++y )
+            for ( u32 x = 0; x < 4; ++x ) {
+              const auto &p = paint[ index( x, y ) ];
+              setColor( rgba + ( y * 4 + x ) * 4, p[ 0 ], p[ 1 ], p[ 2 ] );
+            }
+          return;
+        }
+
+        // H mode, two colors a distance apart on both sides
+        if ( overflows( 1 ) ) {
+          const u32 r1 = field( bits, 62, 59 );
+          const u32 g1 = field( bits, 58, 56 ) << 1 | field( bits, 52, 52 );
+          const u32 b1 = field( bits, 51, 51 ) << 3 | field( bits, 49, 47 );
+          const u32 r2 = field( bits, 46, 43 );
+          const u32 g2 = field( bits, 42, 39 );
+          const u32 b2 = field( bits, 38, 35 );
+          // The order of the colors holds the last bit of the distance
+          const u32 order = ( r1 << 8 | g1 << 4 | b1 ) >= ( r2 << 8 | g2 << 4 | b2 ) ? 1 : 0;
+          const i32 d = ETC_DISTANCES[ field( bits, 34, 34 ) << 2 | field( bits, 32, 32 ) << 1 |
+                                       order ];
+          const i32 c1[ 3 ] = {static_cast<i32>( expand( r1, 4 ) ),
+                               static_cast<i32>( expand( g1, 4 ) ),
+                               static_cast<i32>( expand( b1, 4 ) )};
+          const i32 c2[ 3 ] = {static_cast<i32>( expand( r2, 4 ) ),
+                               static_cast<i32>( expand( g2, 4 ) ),
+                               static_cast<i32>( expand( b2, 4 ) )};
+          const i32 paint[ 4 ][ 3 ] = {{c1[ 0 ] + d, c1[ 1 ] + d, c1[ 2 ] + d},
+                                       {c1[ 0 ] - d, c1[ 1 ] - d, c1[ 2 ] - d},
+                                       {c2[ 0 ] + d, c2[ 1 ] + d, c2[ 2 ] + d},
+                                       {c2[ 0 ] - d, c2[ 1 ] - d, c2[ 2 ] - d}};
+          for ( u32 y = 0; y < 4; ++y )
+            for ( u32 x = 0; x < 4; ++x ) {
+              const auto &p = paint[ index( x, y ) ];
+              setColor( rgba + ( y * 4 + x ) * 4, p[ 0 ], p[ 1 ], p[ 2 ] );
+            }
+          return;
+        }
+
+        // Planar mode, a gradient from the origin to the horizontal and vertical colors
+        if ( overflows( 2 ) ) {
+          const i32 origin[ 3 ] = {
+              static_cast<i32>( expand( field( bits, 62, 57 ), 6 ) ),
+              static_cast<i32>( expand( field( bits, 56, 56 ) << 6 | field( bits, 54, 49 ), 7 ) ),
+              static_cast<i32>( expand( field( bits, 48, 48 ) << 5 | field( bits, 44, 43 ) << 3 |
+                                            field( bits, 41, 39 ),
+                                        6 ) )};
+          const i32 horizontal[ 3 ] = {
+              static_cast<i32>( expand( field( bits, 38, 34 ) << 1 | field( bits, 32, 32 ), 6 ) ),
+              static_cast<i32>( expand( field( bits, 31, 25 ), 7 ) ),
+              static_cast<i32>( expand( field( bits, 24, 19 ), 6 ) )};
+          const i32 vertical[ 3 ] = {static_cast<i32>( expand( field( bits, 18, 13 ), 6 ) ),
+                                     static_cast<i32>( expand( field( bits, 12, 6 ), 7 ) ),
+                                     static_cast<i32>( expand( field( bits, 5, 0 ), 6 ) )};
+          for ( i32 y = 0; y < 4; ++y )
+            for ( i32 x = 0; x < 4; ++x ) {
+              i32 color[ 3 ];
+              for ( u32 c = 0; c < 3; ++c )
+                color[ c ] = ( x * ( horizontal[ c ] - origin[ c ] ) +
+                               y * ( vertical[ c ] - origin[ c ] ) + 4 * origin[ c ] + 2 ) >>
+                             2;
+              setColor( rgba + ( y * 4 + x ) * 4, color[ 0 ], color[ 1 ], color[ 2 ] );
+            }
+          return;
+        }
+
+        for ( u32 c = 0; c < 3; ++c ) {
+          base[ 0 ][ c ] = static_cast<i32>( expand( static_cast<u32>( color[ c ] ), 5 ) );
+          base[ 1 ][ c ] = static_cast<i32>( expand( static_cast<u32>( color[ c ] + delta[ c ] ), 5 ) );
+        }
+      }
+
+      // Individual and differential modes, two halves with a base color and a table each
+      const u32 tables[ 2 ] = {field( bits, 39, 37 ), field( bits, 36, 34 )};
+      for ( u32 y = 0; y < 4; ++y )
+        for ( u32 x = 0; x < 4; ++x ) {
+          const u32 half = flip ? y >> 1 : x >> 1;
+          const i32 modifier = ETC_MODIFIERS[ tables[ half ] ][ index( x, y ) ];
+          setColor( rgba + ( y * 4 + x ) * 4, base[ half ][ 0 ] + modifier,
+                    base[ half ][ 1 ] + modifier, base[ half ][ 2 ] + modifier );
+        }
+    }
+
+    void decodeEac( const u8 *block, u8 *rgba ) noexcept {
+      const u64 bits = readU64BigEndian( block );
+      const auto base = static_cast<i32>( block[ 0 ] );
+      const auto multiplier = static_cast<i32>( block[ 1 ] >> 4 );
+      const auto &modifiers = EAC_MODIFIERS[ block[ 1 ] & 0xF ];
+
+      for ( u32 y = 0; y < 4; ++y )
+        for ( u32 x = 0; x < 4; ++x ) {
+          const u32 index = field( bits, 47 - 3 * ( x * 4 + y ), 45 - 3 * ( x * 4 + y ) );
+          rgba[ ( y * 4 + x ) * 4 + 3 ] = clampByte( base + modifiers[ index ] * multiplier );
+        }
+    }
+
+  }    // namespace
+
+  namespace TextureCompression {
+
+    u32 blockBytes( CompressedFormat format ) noexcept {
+      switch ( format ) {
+        case CompressedFormat::BC1:
+        case CompressedFormat::ETC2_RGB:
+          return 8;
+        default:
+          return 16;
+      }
+    }
+
+    u32 glInternalFormat( CompressedFormat format ) noexcept {
+      switch ( format ) {
+        case CompressedFormat::BC1:
+          return GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+        case CompressedFormat::BC3:
+          return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+        case CompressedFormat::BC5:
+          return GL_COMPRESSED_RG_RGTC2;
+        case CompressedFormat::BC7:
+          return GL_COMPRESSED_RGBA_BPTC_UNORM;
+        case CompressedFormat::ETC2_RGB:
+          return GL_COMPRESSED_RGB8_ETC2;
+        case CompressedFormat::ETC2_RGBA:
+          return GL_COMPRESSED_RGBA8_ETC2_EAC;
+      }
+      return 0;
+    }
+
+    const char *formatName( CompressedFormat format ) noexcept {
+      switch ( format ) {
+        case CompressedFormat::BC1:
+          return "BC1";
+        case CompressedFormat::BC3:
+          return "BC3";
+        case CompressedFormat::BC5:
+          return "BC5";
+        case CompressedFormat::BC7:
+          return "BC7";
+        case CompressedFormat::ETC2_RGB:
+          return "ETC2 RGB";
+        case CompressedFormat::ETC2_RGBA:
+          return "ETC2 RGBA";
+      }
+      return "unknown";
+    }
+
+    bool isContainer( const std::string &filePath ) noexcept {
+      const auto dot = filePath.find_last_of( '.' );
+      if ( dot == std::string::npos )
+        return false;
+      std::string extension = filePath.substr( dot + 1 );
+      std::transform( extension.begin(), extension.end(), extension.begin(),
+                      []( unsigned char c ) { return static_cast<char>( std::tolower( c ) ); } );
+      return extension == "dds" || extension == "ktx";
+    }
+
+    bool parse( const u8 *data, usize size, CompressedImage &image ) noexcept {
+      image.data.clear();
+      image.levels.clear();
+      if ( !data )
+        return false;
+
+      bool parsed = false;
+      if ( size >= 4 && readU32( data ) == DDS_MAGIC )
+        parsed = parseDds( data, size, image );
+      else if ( size >= sizeof( KTX_IDENTIFIER ) &&
+                std::memcmp( data, KTX_IDENTIFIER, sizeof( KTX_IDENTIFIER ) ) == 0 )
+        parsed = parseKtx( data, size, image );
+      else
+        log::error( "TextureCompression: neither a DDS nor a KTX container\n" );
+
+      if ( !parsed ) {
+        image.levels.clear();
+        return false;
+      }
+
+      // Only the levels are kept, packed back to back
+      usize bytes = 0;
+      for ( const auto &level : image.levels )
+        bytes += level.size;
+      image.data.resize( bytes );
+
+      usize offset = 0;
+      for ( auto &level : image.levels ) {
+        std::memcpy( image.data.data() + offset, data + level.offset, level.size );
+        level.offset = offset;
+        offset += level.size;
+      }
+      return true;
+    }
+
+    bool load( const std::string &filePath, CompressedImage &image ) noexcept {
+      std::ifstream file( filePath.data(), std::ios::binary );
+      if ( !file.is_open() ) {
+        log::error( "TextureCompression: failed to open { %s }\n", filePath.data() );
+        return false;
+      }
+
+      const std::vector<u8> bytes( ( std::istreambuf_iterator<char>( file ) ),
+                                   std::istreambuf_iterator<char>() );
+      if ( !parse( bytes.data(), bytes.size(), image ) ) {
+        log::error( "TextureCompression: failed to read { %s }\n", filePath.data() );
+        return false;
+      }
+      return true;
+    }
+
+    bool isSupported( CompressedFormat format ) noexcept {
+      switch ( format ) {
+        case CompressedFormat::BC1:
+        case CompressedFormat::BC3:
+          return GLEW_EXT_texture_compression_s3tc;
+        case CompressedFormat::BC5:
+          return GLEW_ARB_texture_compression_rgtc || GLEW_VERSION_3_0;
+        case CompressedFormat::BC7:
+          return GLEW_ARB_texture_compression_bptc || GLEW_VERSION_4_2;
+        case CompressedFormat::ETC2_RGB:
+        case CompressedFormat::ETC2_RGBA:
+          return GLEW_ARB_ES3_compatibility || GLEW_VERSION_4_3;
+      }
+      return false;
+    }
+
+    void decodeBlock( CompressedFormat format, const u8 *block, u8 *rgba ) noexcept {
+      switch ( format ) {
+        case CompressedFormat::BC1:
+          decodeBC1( block, rgba, true );
+          break;
+        case CompressedFormat::BC3:
+          decodeBC1( block + 8, rgba, false );
+          decodeBC4( block, rgba, 3 );
+          break;
+        case CompressedFormat::BC5:
+          // Red and green, as the GPU returns them
+          for ( u32 i = 0; i < 16; ++i ) {
+            rgba[ i * 4 + 2 ] = 0;
+            rgba[ i * 4 + 3 ] = 255;
+          }
+          decodeBC4( block, rgba, 0 );
+          decodeBC4( block + 8, rgba, 1 );
+          break;
+        case CompressedFormat::BC7:
+          decodeBC7( block, rgba );
+          break;
+        case CompressedFormat::ETC2_RGB:
+          decodeEtc2( block, rgba );
+          break;
+        case CompressedFormat::ETC2_RGBA:
+          decodeEtc2( block + 8, rgba );
+          decodeEac( block, rgba );
+          break;
+      }
+    }
+
+    void decode( const CompressedImage &image, u32 level, u8 *rgba ) noexcept {
+      if ( level >= image.levels.size() || !rgba )
+        return;
+
+      const auto &size = image.levels[ level ];
+      const u8 *block = image.data.data() + size.offset;
+      const u32 stride = blockBytes( image.format );
+
+      u8 texels[ BLOCK_SIZE * BLOCK_SIZE * 4 ];
+      for ( u32 by = 0; by < size.height; by += BLOCK_SIZE )
+        for ( u32 bx = 0; bx < size.width; bx += BLOCK_SIZE, block += stride ) {
+          decodeBlock( image.format, block, texels );
+
+          // Blocks of the right and top edges can hang over the level
+          const u32 columns = std::min( BLOCK_SIZE, size.width - bx );
+          const u32 rows = std::min( BLOCK_SIZE, size.height - by );
+          for ( u32 y = 0; y < rows; ++y )
+            std::memcpy( rgba + ( static_cast<usize>( by + y ) * size.width + bx ) * 4,
+                         texels + y * BLOCK_SIZE * 4, static_cast<usize>( columns ) * 4 );
+        }
+    }
+
+  }    // namespace TextureCompression
+
+}    // namespace nile
@@ -0,0 +1,167 @@
+/* ================================================================================
+$File: vertex_format.cc
+$Date: $
+$Revision: $
+$Creator: Rostislav Orestis Stelmach
+$Notice: $
+================================================================================ */
+
+#include "Nile/renderer/vertex_format.hh"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace nile {
+
+  namespace {
+
+    constexpr f32 UNORM16_MAX = 65535.0f;
+    constexpr f32 SNORM10_MAX = 511.0f;
+
+    u32 packSnorm10( f32 value ) noexcept {
+      const auto scaled = static_cast<i32>( std::round( glm::clamp( value, -1.0f, 1.0f ) *
+                                                        SNORM10_MAX ) );
+      return static_cast<u32>( scaled ) & 0x3ffu;
+    }
+
+    f32 unpackSnorm10( u32 bits ) noexcept {
+      auto value = static_cast<i32>( bits & 0x3ffu );
+      if ( value & 0x200 )
+        value -= 0x400;
+      return std::max( static_cast<f32>( value ) / SNORM10_MAX, -1.0f );
+    }
+
+    // IEEE half float, rounded to nearest even. glm/gtc/packing.hpp does not build
+    // with our warnings, so it is done by hand.
+    u16 packHalf( f32 value ) noexcept {
+      u32 bits;
+      std::memcpy( &bits, &value, sizeof( bits ) );
+
+      const auto sign = static_cast<u16>( ( bits >> 16 ) & 0x8000u );
+      const auto magnitude = std::fabs( value );
+
+      if ( std::isnan( value ) )
+        return sign | 0x7e00u;
+
+      // Subnormal halves are multiples of 2^-24
+      if ( magnitude < 6.103515625e-05f )
+        return sign | static_cast<u16>( std::nearbyint( magnitude * 16777216.0f ) );
+
+      u32 half = ( bits & 0x7fffffffu ) - ( 112u << 23 );
+      half = ( half + 0x0fffu + ( ( half >> 13 ) & 1u ) ) >> 13;
+      return sign | static_cast<u16>( std::min( half, 0x7c00u ) );
+    }
+
+    f32 unpackHalf( u16 half ) noexcept {
+      const auto exponent = static_cast<i32>( ( half >> 10 ) & 0x1fu );
+      const auto mantissa = static_cast<f32>( half & 0x3ffu );
+
+      f32 value;
+      if ( exponent == 0 )
+        value = std::ldexp( mantissa, -24 );
+      else if ( exponent == 31 )
+        value = mantissa == 0.0f ? INFINITY : NAN;
+      else
+        value = std::ldexp( mantissa + 1024.0f, exponent - 25 );
+
+      return ( half & 0x8000u ) ? -value : value;
+    }
+
+  }    // namespace
+
+  glm::mat4 VertexQuantization::dequantizeMatrix() const noexcept {
+    const auto translate = glm::translate( glm::mat4 {1.0f}, offset );
+    return glm::scale( translate, glm::vec3 {scale} );
+  }
+
+  namespace Math {
+
+    VertexQuantization computeQuantization( const AABB &bounds ) noexcept {
+      VertexQuantization quantization;
+      if ( !bounds.isValid() )
+        return quantization;
+
+      const auto size = bounds.max - bounds.min;
+      quantization.offset = bounds.min;
+      // A single point still needs an invertible matrix
+      quantization.scale = std::max( {size.x, size.y, size.z} );
+      if ( quantization.scale <= 0.0f )
+        quantization.scale = 1.0f;
+
+      return quantization;
+    }
+
+    PackedVertex packVertex( const Vertex &vertex,
+                             const VertexQuantization &quantization ) noexcept {
+      PackedVertex packed {};
+
+      const auto position = ( vertex.position - quantization.offset ) / quantization.scale;
+      for ( u32 i = 0; i < 3; ++i ) {
+        packed.position[ i ] =
+            static_cast<u16>( std::round( glm::clamp( position[ i ], 0.0f, 1.0f ) * UNORM16_MAX ) );
+      }
+
+      // Meshes without normals are left with a zero one
+      const auto length = glm::length( vertex.normal );
+      const auto normal = length > 0.0f ? vertex.normal / length : glm::vec3 {0.0f};
+      packed.normal = packSnorm10( normal.x ) | packSnorm10( normal.y ) << 10 |
+                      packSnorm10( normal.z ) << 20;
+
+      packed.uv[ 0 ] = packHalf( vertex.uv.x );
+      packed.uv[ 1 ] = packHalf( vertex.uv.y );
+
+      return packed;
+    }
+
+    Vertex unpackVertex( const PackedVertex &vertex,
+                         const VertexQuantization &quantization ) noexcept {
+      Vertex unpacked;
+
+      for ( u32 i = 0; i < 3; ++i ) {
+        const auto normalized = static_cast<f32>( vertex.position[ i ] ) / UNORM16_MAX;
+        unpacked.position[ i ] = quantization.offset[ i ] + normalized * quantization.scale;
+      }
+
+      unpacked.normal = {unpackSnorm10( vertex.normal ), unpackSnorm10( vertex.normal >> 10 ),
+                         unpackSnorm10( vertex.normal >> 20 )};
+
+      unpacked.uv = {unpackHalf( vertex.uv[ 0 ] ), unpackHalf( vertex.uv[ 1 ] )};
+
+      return unpacked;
+    }
+
+    QuantizationError packVertices( const std::vector<Vertex> &vertices,
+                                    const VertexQuantization &quantization,
+                                    std::vector<PackedVertex> &packed ) noexcept {
+      QuantizationError error;
+
+      packed.resize( vertices.size() );
+      for ( usize i = 0; i < vertices.size(); ++i ) {
+        const auto &vertex = vertices[ i ];
+        packed[ i ] = packVertex( vertex, quantization );
+        const auto decoded = unpackVertex( packed[ i ], quantization );
+
+        error.position =
+            std::max( error.position, glm::length( decoded.position - vertex.position ) );
+
+        const auto uv = glm::abs( decoded.uv - vertex.uv );
+        error.uv = std::max( {error.uv, uv.x, uv.y} );
+
+        const auto length = glm::length( vertex.normal );
+        if ( length > 0.0f ) {
+          // The shaders normalize the decoded normal as well
+          const auto cosine = glm::dot( vertex.normal / length, glm::normalize( decoded.normal ) );
+          const auto angle = glm::degrees( std::acos( glm::clamp( cosine, -1.0f, 1.0f ) ) );
+          error.normal = std::max( error.normal, angle );
+        }
+      }
+
+      return error;
+    }
+
+  }    // namespace Math
+
+}    // namespace nile
@@ -1 +1,430 @@
+/* ================================================================================
+$File: scene_graph.cc
+$Date: $
+$Revision: $
+$Creator: Rostislav Orestis Stelmach
+$Notice: $
+================================================================================ */
+
 #include "Nile/scene/scene_graph.hh"
+#include "Nile/core/assert.hh"
+
+#include <algorithm>
+#include <cmath>
+
+namespace nile {
+
+  namespace {
+
+    constexpr usize INITIAL_CAPACITY = 16;
+
+    // Moving objects get their fat bounds stretched by this many frames of movement
+    constexpr f32 DISPLACEMENT_MULTIPLIER = 4.0f;
+
+    AABB combine( const AABB &a, const AABB &b ) noexcept {
+      return {glm::min( a.min, b.min ), glm::max( a.max, b.max )};
+    }
+
+    // Surface area, the cost of a node is proportional to it
+    f32 area( const AABB &bounds ) noexcept {
+      const auto size = bounds.max - bounds.min;
+      return 2.0f * ( size.x * size.y + size.y * size.z + size.z * size.x );
+    }
+
+    bool contains( const AABB &outer, const AABB &inner ) noexcept {
+      return outer.min.x <= inner.min.x && outer.min.y <= inner.min.y &&
+             outer.min.z <= inner.min.z && inner.max.x <= outer.max.x &&
+             inner.max.y <= outer.max.y && inner.max.z <= outer.max.z;
+    }
+
+    f32 distanceSquared( const AABB &bounds, const glm::vec3 &point ) noexcept {
+      const auto closest = glm::clamp( point, bounds.min, bounds.max );
+      const auto delta = point - closest;
+      return glm::dot( delta, delta );
+    }
+
+    // Slab test, returns the entry distance or a negative value on a miss
+    f32 intersectRay( const AABB &bounds, const glm::vec3 &origin, const glm::vec3 &inverse,
+                      f32 maxDistance ) noexcept {
+      const auto t0 = ( bounds.min - origin ) * inverse;
+      const auto t1 = ( bounds.max - origin ) * inverse;
+      const auto tmin = glm::min( t0, t1 );
+      const auto tmax = glm::max( t0, t1 );
+
+      const f32 enter = std::max( std::max( tmin.x, tmin.y ), std::max( tmin.z, 0.0f ) );
+      const f32 exit = std::min( std::min( tmax.x, tmax.y ), std::min( tmax.z, maxDistance ) );
+      return enter <= exit ? enter : -1.0f;
+    }
+
+  }    // namespace
+
+  SceneGraph::SceneGraph( f32 margin ) noexcept
+      : m_margin( margin ) {
+    m_nodes.reserve( INITIAL_CAPACITY );
+    m_stack.reserve( 64 );
+  }
+
+  i32 SceneGraph::allocateNode() noexcept {
+
+    if ( m_freeList == NULL_NODE ) {
+      m_nodes.emplace_back();
+      m_nodes.back().height = 0;
+      return static_cast<i32>( m_nodes.size() - 1 );
+    }
+
+    const auto node = m_freeList;
+    m_freeList = m_nodes[ node ].parent;
+    m_nodes[ node ] = SceneNode {};
+    m_nodes[ node ].height = 0;
+    return node;
+  }
+
+  void SceneGraph::freeNode( i32 node ) noexcept {
+    m_nodes[ node ].parent = m_freeList;
+    m_nodes[ node ].height = -1;
+    m_freeList = node;
+  }
+
+  i32 SceneGraph::createProxy( const AABB &bounds, Entity entity ) noexcept {
+
+    ASSERT_M( bounds.isValid(), "SceneGraph proxies need valid bounds" );
+
+    const auto proxy = this->allocateNode();
+    auto &node = m_nodes[ proxy ];
+    node.bounds = {bounds.min - glm::vec3( m_margin ), bounds.max + glm::vec3( m_margin )};
+    node.objectBounds = bounds;
+    node.entity = entity;
+
+    this->insertLeaf( proxy );
+    ++m_proxyCount;
+    return proxy;
+  }
+
+  void SceneGraph::destroyProxy( i32 proxy ) noexcept {
+
+    ASSERT_M( m_nodes[ proxy ].isLeaf() && m_nodes[ proxy ].height == 0,
+              "SceneGraph proxy is not a leaf" );
+
+    this->removeLeaf( proxy );
+    this->freeNode( proxy );
+    --m_proxyCount;
+  }
+
+  bool SceneGraph::moveProxy( i32 proxy, const AABB &bounds,
+                              const glm::vec3 &displacement ) noexcept {
+
+    auto &node = m_nodes[ proxy ];
+    node.objectBounds = bounds;
+
+    if ( contains( node.bounds, bounds ) )
+      return false;
+
+    this->removeLeaf( proxy );
+
+    AABB fat {bounds.min - glm::vec3( m_margin ), bounds.max + glm::vec3( m_margin )};
+    const auto stretch = displacement * DISPLACEMENT_MULTIPLIER;
+    fat.min += glm::min( stretch, glm::vec3( 0.0f ) );
+    fat.max += glm::max( stretch, glm::vec3( 0.0f ) );
+    m_nodes[ proxy ].bounds = fat;
+
+    this->insertLeaf( proxy );
+    return true;
+  }
+
+  void SceneGraph::insertLeaf( i32 leaf ) noexcept {
+
+    if ( m_root == NULL_NODE ) {
+      m_root = leaf;
+      m_nodes[ leaf ].parent = NULL_NODE;
+      return;
+    }
+
+    // Branch and bound search for the sibling that makes the tree grow the least
+    // ( surface area of the new parent plus the growth of all its ancestors )
+    const auto leafBounds = m_nodes[ leaf ].bounds;
+    const f32 leafArea = area( leafBounds );
+
+    i32 sibling = m_root;
+    f32 bestCost = area( combine( m_nodes[ m_root ].bounds, leafBounds ) );
+
+    m_candidates.clear();
+    m_candidates.push_back( {m_root, 0.0f} );
+
+    while ( !m_candidates.empty() ) {
+      const auto candidate = m_candidates.back();
+      m_candidates.pop_back();
+
+      const auto &node = m_nodes[ candidate.index ];
+      const f32 combinedArea = area( combine( node.bounds, leafBounds ) );
+      const f32 cost = combinedArea + candidate.inheritedCost;
+      if ( cost < bestCost ) {
+        bestCost = cost;
+        sibling = candidate.index;
+      }
+
+      if ( node.isLeaf() )
+        continue;
+
+      // Nothing below this node can be cheaper than this
+      const f32 inheritedCost = candidate.inheritedCost + combinedArea - area( node.bounds );
+      if ( leafArea + inheritedCost >= bestCost )
+        continue;
+
+      // The child that grows less is searched first, so the best cost drops early
+      // and more of the tree is pruned
+      const f32 leftGrowth = area( combine( m_nodes[ node.left ].bounds, leafBounds ) ) -
+                             area( m_nodes[ node.left ].bounds );
+      const f32 rightGrowth = area( combine( m_nodes[ node.right ].bounds, leafBounds ) ) -
+                              area( m_nodes[ node.right ].bounds );
+      const bool leftFirst = leftGrowth < rightGrowth;
+      m_candidates.push_back( {leftFirst ? node.right : node.left, inheritedCost} );
+      m_candidates.push_back( {leftFirst ? node.left : node.right, inheritedCost} );
+    }
+
+
+    // New parent of the sibling and the leaf
+    const auto oldParent = m_nodes[ sibling ].parent;
+    const auto newParent = this->allocateNode();
+    m_nodes[ newParent ].parent = oldParent;
+    m_nodes[ newParent ].bounds = combine( leafBounds, m_nodes[ sibling ].bounds );
+    m_nodes[ newParent ].height = m_nodes[ sibling ].height + 1;
+    m_nodes[ newParent ].left = sibling;
+    m_nodes[ newParent ].right = leaf;
+    m_nodes[ sibling ].parent = newParent;
+    m_nodes[ leaf ].parent = newParent;
+
+    if ( oldParent == NULL_NODE ) {
+      m_root = newParent;
+    } else if ( m_nodes[ oldParent ].left == sibling ) {
+      m_nodes[ oldParent ].left = newParent;
+    } else {
+      m_nodes[ oldParent ].right = newParent;
+    }
+
+    // Fix the heights and bounds on the way up
+    auto index = m_nodes[ leaf ].parent;
+    while ( index != NULL_NODE ) {
+      index = this->balance( index );
+
+      auto &node = m_nodes[ index ];
+      node.height = 1 + std::max( m_nodes[ node.left ].height, m_nodes[ node.right ].height );
+      node.bounds = combine( m_nodes[ node.left ].bounds, m_nodes[ node.right ].bounds );
+
+      index = node.parent;
+    }
+  }
+
+  void SceneGraph::removeLeaf( i32 leaf ) noexcept {
+
+    if ( leaf == m_root ) {
+      m_root = NULL_NODE;
+      return;
+    }
+
+    const auto parent = m_nodes[ leaf ].parent;
+    const auto grandParent = m_nodes[ parent ].parent;
+    const auto sibling =
+        m_nodes[ parent ].left == leaf ? m_nodes[ parent ].right : m_nodes[ parent ].left;
+
+    // The sibling takes the place of the parent
+    if ( grandParent == NULL_NODE ) {
+      m_root = sibling;
+      m_nodes[ sibling ].parent = NULL_NODE;
+      this->freeNode( parent );
+      return;
+    }
+
+    if ( m_nodes[ grandParent ].left == parent )
+      m_nodes[ grandParent ].left = sibling;
+    else
+      m_nodes[ grandParent ].right = sibling;
+    m_nodes[ sibling ].parent = grandParent;
+    this->freeNode( parent );
+
+    auto index = grandParent;
+    while ( index != NULL_NODE ) {
+      index = this->balance( index );
+
+      auto &node = m_nodes[ index ];
+      node.height = 1 + std::max( m_nodes[ node.left ].height, m_nodes[ node.right ].height );
+      node.bounds = combine( m_nodes[ node.left ].bounds, m_nodes[ node.right ].bounds );
+
+      index = node.parent;
+    }
+  }
+
+  i32 SceneGraph::balance( i32 a ) noexcept {
+
+    const auto &node = m_nodes[ a ];
+    if ( node.isLeaf() || node.height < 2 )
+      return a;
+
+    const auto b = node.left;
+    const auto c = node.right;
+    const i32 difference = m_nodes[ c ].height - m_nodes[ b ].height;
+
+    // Promotes the higher child ( up ) to the place of a, a takes one of its children
+    const auto rotate = [&]( i32 up, i32 other ) {
+      auto &nodeUp = m_nodes[ up ];
+      const auto f = nodeUp.left;
+      const auto g = nodeUp.right;
+
+      nodeUp.left = a;
+      nodeUp.parent = m_nodes[ a ].parent;
+      m_nodes[ a ].parent = up;
+
+      if ( nodeUp.parent == NULL_NODE ) {
+        m_root = up;
+      } else if ( m_nodes[ nodeUp.parent ].left == a ) {
+        m_nodes[ nodeUp.parent ].left = up;
+      } else {
+        m_nodes[ nodeUp.parent ].right = up;
+      }
+
+      // The higher grandchild stays under up, the other one moves to a
+      const bool keepF = m_nodes[ f ].height > m_nodes[ g ].height;
+      const auto kept = keepF ? f : g;
+      const auto moved = keepF ? g : f;
+
+      nodeUp.right = kept;
+      if ( m_nodes[ a ].left == up )
+        m_nodes[ a ].left = moved;
+      else
+        m_nodes[ a ].right = moved;
+      m_nodes[ moved ].parent = a;
+
+      auto &nodeDown = m_nodes[ a ];
+      nodeDown.bounds = combine( m_nodes[ other ].bounds, m_nodes[ moved ].bounds );
+      nodeDown.height = 1 + std::max( m_nodes[ other ].height, m_nodes[ moved ].height );
+
+      nodeUp.bounds = combine( nodeDown.bounds, m_nodes[ kept ].bounds );
+      nodeUp.height = 1 + std::max( nodeDown.height, m_nodes[ kept ].height );
+      return up;
+    };
+
+    if ( difference > 1 )
+      return rotate( c, b );
+    if ( difference < -1 )
+      return rotate( b, c );
+    return a;
+  }
+
+  bool SceneGraph::raycast( const glm::vec3 &origin, const glm::vec3 &direction,
+                            f32 maxDistance, RayHit &hit ) const noexcept {
+
+    const auto length = glm::length( direction );
+    if ( m_root == NULL_NODE || length == 0.0f )
+      return false;
+
+    const auto dir = direction / length;
+    // Division by zero gives infinities, which the slab test handles
+    const auto inverse = 1.0f / dir;
+
+    bool found = false;
+    f32 closest = maxDistance;
+
+    m_stack.clear();
+    m_stack.push_back( m_root );
+
+    while ( !m_stack.empty() ) {
+      const auto index = m_stack.back();
+      m_stack.pop_back();
+
+      const auto &node = m_nodes[ index ];
+      if ( intersectRay( node.bounds, origin, inverse, closest ) < 0.0f )
+        continue;
+
+      if ( node.isLeaf() ) {
+        const f32 distance = intersectRay( node.objectBounds, origin, inverse, closest );
+        if ( distance >= 0.0f ) {
+          closest = distance;
+          hit = {node.entity, index, distance};
+          found = true;
+        }
+      } else {
+        m_stack.push_back( node.left );
+        m_stack.push_back( node.right );
+      }
+    }
+
+    return found;
+  }
+
+  bool SceneGraph::nearest( const glm::vec3 &point, f32 maxDistance,
+                            RayHit &hit ) const noexcept {
+
+    if ( m_root == NULL_NODE )
+      return false;
+
+    bool found = false;
+    f32 best = maxDistance * maxDistance;
+
+    m_stack.clear();
+    m_stack.push_back( m_root );
+
+    while ( !m_stack.empty() ) {
+      const auto index = m_stack.back();
+      m_stack.pop_back();
+
+      const auto &node = m_nodes[ index ];
+      if ( distanceSquared( node.bounds, point ) > best )
+        continue;
+
+      if ( node.isLeaf() ) {
+        const f32 distance = distanceSquared( node.objectBounds, point );
+        if ( distance <= best ) {
+          best = distance;
+          hit = {node.entity, index, std::sqrt( distance )};
+          found = true;
+        }
+        continue;
+      }
+
+      // Visit the closer child first ( it is pushed last ), so the bound shrinks early
+      const f32 left = distanceSquared( m_nodes[ node.left ].bounds, point );
+      const f32 right = distanceSquared( m_nodes[ node.right ].bounds, point );
+      m_stack.push_back( left < right ? node.right : node.left );
+      m_stack.push_back( left < right ? node.left : node.right );
+    }
+
+    return found;
+  }
+
+  bool SceneGraph::validate() const noexcept {
+    if ( m_root == NULL_NODE )
+      return m_proxyCount == 0;
+    if ( m_nodes[ m_root ].parent != NULL_NODE )
+      return false;
+    return this->validateNode( m_root ) >= 0;
+  }
+
+  i32 SceneGraph::validateNode( i32 index ) const noexcept {
+    const auto &node = m_nodes[ index ];
+
+    if ( node.isLeaf() )
+      return node.height == 0 && node.right == NULL_NODE &&
+                     contains( node.bounds, node.objectBounds )
+                 ? 1
+                 : -1;
+
+    const auto &left = m_nodes[ node.left ];
+    const auto &right = m_nodes[ node.right ];
+    if ( left.parent != index || right.parent != index )
+      return -1;
+    if ( node.height != 1 + std::max( left.height, right.height ) )
+      return -1;
+    if ( !contains( node.bounds, left.bounds ) || !contains( node.bounds, right.bounds ) )
+      return -1;
+
+    const auto leftLeaves = this->validateNode( node.left );
+    const auto rightLeaves = this->validateNode( node.right );
+    if ( leftLeaves < 0 || rightLeaves < 0 )
+      return -1;
+
+    const auto leaves = leftLeaves + rightLeaves;
+    if ( index == m_root && static_cast<u32>( leaves ) != m_proxyCount )
+      return -1;
+    return leaves;
+  }
+
+}    // namespace nile
@@ -0,0 +1,153 @@
+#include <Nile/debug/debug_draw.hh>
+#include <catch.hpp>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <thread>
+#include <vector>
+
+using nile::AABB;
+using nile::DebugDraw;
+using nile::f32;
+using nile::u32;
+
+// The lines of the game ( Primitive entities ) are drawn in every build
+TEST_CASE( "DebugDraw keeps the lines of addLine() in release builds", "[DebugDraw]" ) {
+
+  DebugDraw debug;
+  debug.addLine( glm::vec3( 0.0f ), glm::vec3( 1.0f ), glm::vec3( 0.0f, 1.0f, 0.0f ) );
+  debug.prepare( glm::vec3( 0.0f, 0.0f, -1.0f ) );
+
+  REQUIRE( debug.getStats().lines == 1 );
+  REQUIRE( debug.getVertices().size() == 2 );
+  REQUIRE( debug.getVertices()[ 1 ].position == glm::vec3( 1.0f ) );
+  REQUIRE( debug.getVertices()[ 0 ].color == 0xff00ff00u );
+}
+
+// Release builds compile the rest of the debug draw out, there is nothing else to test
+#if defined( NILE_DEBUG_DRAW )
+
+namespace {
+
+  const glm::vec3 forward( 0.0f, 0.0f, -1.0f );
+
+  bool near( const glm::vec3 &a, const glm::vec3 &b ) {
+    return glm::all( glm::lessThan( glm::abs( a - b ), glm::vec3( 1e-4f ) ) );
+  }
+
+}    // namespace
+
+TEST_CASE( "DebugDraw turns every primitive into lines", "[DebugDraw]" ) {
+
+  DebugDraw debug;
+
+  AABB bounds;
+  bounds.expand( glm::vec3( -1.0f ) );
+  bounds.expand( glm::vec3( 2.0f ) );
+
+  debug.line( glm::vec3( 0.0f ), glm::vec3( 1.0f ), glm::vec3( 1.0f, 0.0f, 0.0f ) );
+  debug.box( bounds, glm::vec3( 1.0f ) );
+  debug.box( glm::scale( glm::mat4( 1.0f ), glm::vec3( 2.0f ) ), glm::vec3( 1.0f ) );
+  debug.sphere( glm::vec3( 0.0f ), 1.0f, glm::vec3( 1.0f ) );
+  debug.frustum( glm::perspective( 1.0f, 1.0f, 1.0f, 10.0f ), glm::vec3( 1.0f ) );
+  debug.prepare( forward );
+
+  const u32 lines = 1 + 12 + 12 + DebugDraw::SPHERE_SEGMENTS * 3 + 12;
+  REQUIRE( debug.getStats().lines == lines );
+  REQUIRE( debug.getVertices().size() == lines * 2 );
+
+  const auto &vertices = debug.getVertices();
+  REQUIRE( vertices[ 0 ].color == 0xff0000ffu );
+
+  SECTION( "Boxes span their bounds" ) {
+    AABB drawn;
+    for ( u32 i = 2; i < 2 + 24; ++i )
+      drawn.expand( vertices[ i ].position );
+    REQUIRE( near( drawn.min, bounds.min ) );
+    REQUIRE( near( drawn.max, bounds.max ) );
+
+    AABB unit;
+    for ( u32 i = 2 + 24; i < 2 + 48; ++i )
+      unit.expand( vertices[ i ].position );
+    REQUIRE( near( unit.min, glm::vec3( -1.0f ) ) );
+    REQUIRE( near( unit.max, glm::vec3( 1.0f ) ) );
+  }
+
+  SECTION( "Sphere points lie on the sphere" ) {
+    for ( u32 i = 2 + 48; i < 2 + 48 + DebugDraw::SPHERE_SEGMENTS * 6; ++i )
+      REQUIRE( glm::length( vertices[ i ].position ) == Approx( 1.0f ) );
+  }
+
+  SECTION( "Frustum corners reach the far plane" ) {
+    f32 farthest = 0.0f;
+    for ( u32 i = 2 + 48 + DebugDraw::SPHERE_SEGMENTS * 6; i < vertices.size(); ++i )
+      farthest = glm::max( farthest, -vertices[ i ].position.z );
+    REQUIRE( farthest == Approx( 10.0f ) );
+  }
+}
+
+TEST_CASE( "DebugDraw only keeps the primitives of one frame", "[DebugDraw]" ) {
+
+  DebugDraw debug;
+  debug.line( glm::vec3( 0.0f ), glm::vec3( 1.0f ), glm::vec3( 1.0f ) );
+  debug.prepare( forward );
+  REQUIRE( debug.getStats().lines == 1 );
+
+  debug.prepare( forward );
+  REQUIRE( debug.getStats().lines == 0 );
+  REQUIRE( debug.getVertices().empty() );
+}
+
+TEST_CASE( "DebugDraw text faces the camera", "[DebugDraw]" ) {
+
+  DebugDraw debug;
+  // '1' has three segments, ' ' and '~' have none
+  debug.text( glm::vec3( 5.0f, 0.0f, 0.0f ), "1 ~1", glm::vec3( 1.0f ), 2.0f );
+  debug.prepare( forward );
+
+  REQUIRE( debug.getStats().texts == 1 );
+  REQUIRE( debug.getStats().lines == 6 );
+
+  AABB bounds;
+  for ( const auto &vertex : debug.getVertices() )
+    bounds.expand( vertex.position );
+
+  // Flat, facing the camera, with letters 2 units high
+  REQUIRE( bounds.min.z == Approx( 0.0f ) );
+  REQUIRE( bounds.max.z == Approx( 0.0f ) );
+  REQUIRE( bounds.min.y == Approx( 0.0f ) );
+  REQUIRE( bounds.max.y == Approx( 2.0f ) );
+  REQUIRE( bounds.min.x >= 5.0f );
+
+  SECTION( "Seen from the side the text turns with the camera" ) {
+    debug.text( glm::vec3( 0.0f ), "1", glm::vec3( 1.0f ) );
+    debug.prepare( glm::vec3( 1.0f, 0.0f, 0.0f ) );
+
+    AABB side;
+    for ( const auto &vertex : debug.getVertices() )
+      side.expand( vertex.position );
+    REQUIRE( side.min.x == Approx( 0.0f ) );
+    REQUIRE( side.max.x == Approx( 0.0f ) );
+    REQUIRE( side.max.z > 0.0f );
+  }
+}
+
+TEST_CASE( "DebugDraw accepts primitives from several threads", "[DebugDraw]" ) {
+
+  DebugDraw debug;
+
+  std::vector<std::thread> threads;
+  for ( u32 t = 0; t < 4; ++t ) {
+    threads.emplace_back( [ &debug ] {
+      for ( u32 i = 0; i < 1000; ++i )
+        debug.line( glm::vec3( 0.0f ), glm::vec3( 1.0f ), glm::vec3( 1.0f ) );
+    } );
+  }
+
+  for ( auto &thread : threads )
+    thread.join();
+
+  debug.prepare( forward );
+  REQUIRE( debug.getStats().lines == 4000 );
+}
+
+#endif
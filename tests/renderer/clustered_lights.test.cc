@@ -0,0 +1,254 @@
+#include <Nile/renderer/clustered_lights.hh>
+#include <catch.hpp>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using nile::ClusteredLights;
+using nile::PointLightData;
+using nile::f32;
+using nile::u32;
+
+namespace {
+
+  const glm::vec2 viewport( 1280.0f, 720.0f );
+
+  glm::mat4 projection() {
+    return glm::perspective( glm::radians( 45.0f ), viewport.x / viewport.y, 0.1f, 100.0f );
+  }
+
+  // Camera at ( 0, 0, 10 ) looking down -z
+  glm::mat4 view() {
+    return glm::lookAt( glm::vec3( 0.0f, 0.0f, 10.0f ), glm::vec3( 0.0f ),
+                        glm::vec3( 0.0f, 1.0f, 0.0f ) );
+  }
+
+  PointLightData light( const glm::vec3 &position, f32 range ) {
+    PointLightData data;
+    data.position = glm::vec4( position, range );
+    return data;
+  }
+
+  // Cluster of a world space point, computed the way model.frag.glsl does it
+  bool clusterOf( const ClusteredLights &lights, const glm::vec3 &point,
+                  const glm::mat4 &projectionMatrix, const glm::mat4 &viewMatrix,
+                  u32 &cluster ) {
+    const auto viewPoint = viewMatrix * glm::vec4( point, 1.0f );
+    const auto clip = projectionMatrix * viewPoint;
+    if ( clip.w <= 0.0f )
+      return false;
+
+    const glm::vec3 ndc = glm::vec3( clip ) / clip.w;
+    if ( glm::any( glm::greaterThan( glm::abs( ndc ), glm::vec3( 1.0f ) ) ) )
+      return false;
+
+    const auto depth = lights.getDepthParameters();
+    const auto window = ( glm::vec2( ndc ) + 1.0f ) * 0.5f * viewport;
+    const auto tile = glm::min( glm::uvec2( window / lights.getClusterSize() ),
+                                glm::uvec2( ClusteredLights::CLUSTERS_X - 1,
+                                            ClusteredLights::CLUSTERS_Y - 1 ) );
+    u32 z = 0;
+    if ( depth.z != 0.0f ) {
+      const f32 slice = std::log( std::max( -viewPoint.z, depth.x ) ) * depth.z + depth.w;
+      z = std::min( static_cast<u32>( std::max( slice, 0.0f ) ), ClusteredLights::CLUSTERS_Z - 1 );
+    }
+
+    cluster = ClusteredLights::clusterIndex( tile.x, tile.y, z );
+    return true;
+  }
+
+  bool clusterOf( const ClusteredLights &lights, const glm::vec3 &point, u32 &cluster ) {
+    return clusterOf( lights, point, projection(), view(), cluster );
+  }
+
+  bool clusterHasLight( const ClusteredLights &lights, u32 cluster, u32 light ) {
+    const auto begin = lights.getIndices().begin() + lights.getClusterOffset( cluster );
+    const auto end = begin + lights.getClusterCount( cluster );
+    return std::find( begin, end, light ) != end;
+  }
+
+}    // namespace
+
+TEST_CASE( "Light range is where the attenuation reaches the cutoff", "[ClusteredLights]" ) {
+
+  // 1 + d^2 = 256
+  const f32 quadratic = ClusteredLights::computeRange( glm::vec3( 1.0f, 0.0f, 1.0f ), 1.0f );
+  REQUIRE( quadratic == Approx( std::sqrt( 255.0f ) ) );
+
+  // 1 + d = 128
+  const f32 linear = ClusteredLights::computeRange( glm::vec3( 1.0f, 1.0f, 0.0f ), 0.5f );
+  REQUIRE( linear == Approx( 127.0f ) );
+
+  // Never brighter than the cutoff
+  const f32 dark = ClusteredLights::computeRange( glm::vec3( 1.0f, 0.1f, 0.1f ), 0.001f );
+  REQUIRE( dark == 0.0f );
+}
+
+TEST_CASE( "Lights are assigned to the clusters they reach", "[ClusteredLights]" ) {
+
+  ClusteredLights lights;
+  lights.setProjection( projection(), viewport );
+
+  lights.begin();
+  lights.add( light( glm::vec3( 0.0f ), 1.0f ) );
+  // Behind the camera, beyond the far plane and far to the side
+  lights.add( light( glm::vec3( 0.0f, 0.0f, 20.0f ), 1.0f ) );
+  lights.add( light( glm::vec3( 0.0f, 0.0f, -200.0f ), 1.0f ) );
+  lights.add( light( glm::vec3( -80.0f, 0.0f, 0.0f ), 1.0f ) );
+  // No range, it is not added at all
+  lights.add( light( glm::vec3( 0.0f ), 0.0f ) );
+  lights.assign( view() );
+
+  const auto &stats = lights.getStats();
+  REQUIRE( stats.lights == 4 );
+  REQUIRE( stats.visibleLights == 1 );
+  REQUIRE( stats.droppedEntries == 0 );
+
+  u32 center = 0;
+  REQUIRE( clusterOf( lights, glm::vec3( 0.0f ), center ) );
+  REQUIRE( clusterHasLight( lights, center, 0 ) );
+
+  // A small light only covers a few clusters around its center
+  REQUIRE( stats.entries < 32 );
+
+  u32 corner = 0;
+  REQUIRE( clusterOf( lights, glm::vec3( 3.0f, 3.0f, 0.0f ), corner ) );
+  REQUIRE( lights.getClusterCount( corner ) == 0 );
+}
+
+TEST_CASE( "Every point lit by a light is in a cluster listing it", "[ClusteredLights]" ) {
+
+  std::mt19937 rng( 7 );
+  std::uniform_real_distribution<f32> position( -20.0f, 20.0f );
+  std::uniform_real_distribution<f32> range( 0.5f, 6.0f );
+  std::uniform_real_distribution<f32> unit( -1.0f, 1.0f );
+
+  std::vector<PointLightData> scene;
+  for ( u32 i = 0; i < 200; ++i ) {
+    const glm::vec3 center( position( rng ), position( rng ), position( rng ) - 10.0f );
+    scene.push_back( light( center, range( rng ) ) );
+  }
+
+  ClusteredLights lights;
+  lights.setProjection( projection(), viewport );
+  lights.begin();
+  for ( const auto &data : scene )
+    lights.add( data );
+  lights.assign( view() );
+
+  REQUIRE( lights.getStats().droppedEntries == 0 );
+
+  // Points inside of the light spheres that are on the screen have to find the light
+  // in their cluster, otherwise the shader would miss it
+  u32 tested = 0;
+  u32 missing = 0;
+  for ( u32 i = 0; i < scene.size(); ++i ) {
+    const glm::vec3 center( scene[ i ].position );
+    const f32 radius = scene[ i ].position.w;
+
+    for ( u32 sample = 0; sample < 64; ++sample ) {
+      const glm::vec3 offset( unit( rng ), unit( rng ), unit( rng ) );
+      u32 cluster = 0;
+      if ( glm::length( offset ) > 1.0f || !clusterOf( lights, center + offset * radius, cluster ) )
+        continue;
+
+      ++tested;
+      if ( !clusterHasLight( lights, cluster, i ) )
+        ++missing;
+    }
+  }
+
+  REQUIRE( tested > 1000 );
+  REQUIRE( missing == 0 );
+
+  SECTION( "SIMD and scalar assignment build the same lists" ) {
+    const auto indices = lights.getIndices();
+    const auto entries = lights.getStats().entries;
+
+    lights.assignScalar( view() );
+    REQUIRE( lights.getStats().entries == entries );
+    REQUIRE( lights.getIndices() == indices );
+  }
+}
+
+TEST_CASE( "Worker threads build the same lists as the calling thread", "[ClusteredLights]" ) {
+
+  std::mt19937 rng( 11 );
+  std::uniform_real_distribution<f32> position( -20.0f, 20.0f );
+  std::uniform_real_distribution<f32> range( 0.5f, 4.0f );
+
+  ClusteredLights lights;
+  lights.setProjection( projection(), viewport );
+  lights.begin();
+  for ( u32 i = 0; i < ClusteredLights::PARALLEL_LIGHTS * 2 + 3; ++i ) {
+    const glm::vec3 center( position( rng ), position( rng ), position( rng ) - 10.0f );
+    lights.add( light( center, range( rng ) ) );
+  }
+
+  lights.setThreads( 1 );
+  lights.assign( view() );
+  const auto indices = lights.getIndices();
+  const auto stats = lights.getStats();
+  REQUIRE( stats.entries > 0 );
+
+  // An uneven split, the last worker gets fewer lights
+  lights.setThreads( 5 );
+  lights.assign( view() );
+  REQUIRE( lights.getIndices() == indices );
+  REQUIRE( lights.getStats().entries == stats.entries );
+  REQUIRE( lights.getStats().visibleLights == stats.visibleLights );
+  REQUIRE( lights.getStats().droppedEntries == stats.droppedEntries );
+}
+
+TEST_CASE( "Clusters keep a bounded number of lights", "[ClusteredLights]" ) {
+
+  ClusteredLights lights;
+  lights.setProjection( projection(), viewport );
+
+  lights.begin();
+  for ( u32 i = 0; i < ClusteredLights::MAX_LIGHTS_PER_CLUSTER + 20; ++i )
+    lights.add( light( glm::vec3( 0.0f ), 0.5f ) );
+  lights.assign( view() );
+
+  const auto &stats = lights.getStats();
+  REQUIRE( stats.maxPerCluster == ClusteredLights::MAX_LIGHTS_PER_CLUSTER );
+  REQUIRE( stats.droppedEntries > 0 );
+
+  // The first lights are kept
+  u32 center = 0;
+  REQUIRE( clusterOf( lights, glm::vec3( 0.0f ), center ) );
+  REQUIRE( clusterHasLight( lights, center, 0 ) );
+  REQUIRE_FALSE( clusterHasLight( lights, center, ClusteredLights::MAX_LIGHTS_PER_CLUSTER ) );
+}
+
+TEST_CASE( "Orthographic projections do not cull the lights", "[ClusteredLights]" ) {
+
+  ClusteredLights lights;
+  lights.setProjection( glm::ortho( 0.0f, viewport.x, viewport.y, 0.0f ), viewport );
+
+  lights.begin();
+  lights.add( light( glm::vec3( 1e4f ), 1.0f ) );
+  lights.assign( glm::mat4( 1.0f ) );
+
+  REQUIRE( lights.getStats().visibleLights == 1 );
+
+  const auto last = ClusteredLights::clusterIndex( ClusteredLights::CLUSTERS_X - 1,
+                                                   ClusteredLights::CLUSTERS_Y - 1, 0 );
+  REQUIRE( clusterHasLight( lights, 0, 0 ) );
+  REQUIRE( clusterHasLight( lights, last, 0 ) );
+
+  SECTION( "Sprites at depth 0 look up the first slice" ) {
+    // No slices, log( 0 ) would be undefined in the shader
+    REQUIRE( lights.getDepthParameters().z == 0.0f );
+
+    const auto ortho = glm::ortho( 0.0f, viewport.x, viewport.y, 0.0f );
+    u32 cluster = ClusteredLights::CLUSTER_COUNT;
+    REQUIRE( clusterOf( lights, glm::vec3( 700.0f, 300.0f, 0.0f ), ortho, glm::mat4( 1.0f ),
+                        cluster ) );
+    REQUIRE( cluster < ClusteredLights::CLUSTERS_X * ClusteredLights::CLUSTERS_Y );
+    REQUIRE( clusterHasLight( lights, cluster, 0 ) );
+  }
+}
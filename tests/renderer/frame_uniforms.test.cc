@@ -0,0 +1,54 @@
+#include <Nile/renderer/frame_uniforms.hh>
+#include <catch.hpp>
+#include <cstddef>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+using nile::CameraBlock;
+using nile::FrameUniforms;
+using nile::LightBlock;
+using nile::u32;
+
+TEST_CASE( "Uniform blocks follow the std140 layout", "[FrameUniforms]" ) {
+
+  // Offsets the GLSL blocks in frame_uniforms.hh get under std140
+  REQUIRE( offsetof( CameraBlock, projection ) == 64 );
+  REQUIRE( offsetof( CameraBlock, viewProjection ) == 128 );
+  REQUIRE( offsetof( CameraBlock, viewPosition ) == 192 );
+
+  REQUIRE( offsetof( LightBlock, clusterGrid ) == 64 );
+  REQUIRE( offsetof( LightBlock, clusterDepth ) == 80 );
+  REQUIRE( offsetof( LightBlock, clusterSize ) == 96 );
+}
+
+TEST_CASE( "Camera block is filled from the view and the projection", "[FrameUniforms]" ) {
+
+  FrameUniforms uniforms;
+
+  const auto view = glm::lookAt( glm::vec3( 0.0f, 0.0f, 5.0f ), glm::vec3( 0.0f ),
+                                 glm::vec3( 0.0f, 1.0f, 0.0f ) );
+  const auto projection = glm::perspective( glm::radians( 45.0f ), 1.0f, 0.1f, 100.0f );
+  uniforms.setCamera( view, projection, glm::vec3( 0.0f, 0.0f, 5.0f ) );
+
+  const auto &camera = uniforms.getCamera();
+  REQUIRE( camera.view == view );
+  REQUIRE( camera.viewProjection == projection * view );
+  REQUIRE( camera.viewPosition == glm::vec4( 0.0f, 0.0f, 5.0f, 1.0f ) );
+}
+
+TEST_CASE( "Cluster grid is stored in the light block", "[FrameUniforms]" ) {
+
+  FrameUniforms uniforms;
+
+  const glm::uvec4 grid( 16, 9, 24, 300 );
+  const glm::vec4 depth( 0.1f, 200.0f, 3.2f, 7.3f );
+  uniforms.setClusters( grid, depth, glm::vec2( 80.0f, 60.0f ) );
+
+  const auto &lights = uniforms.getLights();
+  REQUIRE( lights.clusterGrid == grid );
+  REQUIRE( lights.clusterDepth == depth );
+  REQUIRE( lights.clusterSize == glm::vec4( 80.0f, 60.0f, 0.0f, 0.0f ) );
+
+  const u32 count = uniforms.getPointLightCount();
+  REQUIRE( count == 300 );
+}
@@ -0,0 +1,102 @@
+#include <Nile/math/bounds.hh>
+#include <Nile/math/frustum.hh>
+#include <Nile/renderer/frustum_culler.hh>
+#include <catch.hpp>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <random>
+#include <vector>
+
+using nile::AABB;
+using nile::Frustum;
+using nile::FrustumCuller;
+using nile::f32;
+using nile::u32;
+
+namespace {
+
+  // Camera at ( 0, 0, 10 ) looking down -z, sees everything between z = 9 and z = -90
+  Frustum perspectiveFrustum() {
+    const auto projection = glm::perspective( glm::radians( 45.0f ), 1.0f, 1.0f, 100.0f );
+    const auto view = glm::lookAt( glm::vec3( 0.0f, 0.0f, 10.0f ), glm::vec3( 0.0f ),
+                                   glm::vec3( 0.0f, 1.0f, 0.0f ) );
+    return Frustum::fromMatrix( projection * view );
+  }
+
+  AABB box( const glm::vec3 &center, f32 size ) {
+    return {center - glm::vec3( size ), center + glm::vec3( size )};
+  }
+
+}    // namespace
+
+TEST_CASE( "Frustum planes are extracted from the view-projection", "[FrustumCuller]" ) {
+
+  const auto frustum = perspectiveFrustum();
+
+  REQUIRE( frustum.intersects( box( glm::vec3( 0.0f ), 1.0f ) ) );
+  // Behind the camera and beyond the far plane
+  REQUIRE_FALSE( frustum.intersects( box( glm::vec3( 0.0f, 0.0f, 20.0f ), 1.0f ) ) );
+  REQUIRE_FALSE( frustum.intersects( box( glm::vec3( 0.0f, 0.0f, -200.0f ), 1.0f ) ) );
+  // Far to the side, and a box that only straddles the left plane
+  REQUIRE_FALSE( frustum.intersects( box( glm::vec3( -50.0f, 0.0f, 0.0f ), 1.0f ) ) );
+  REQUIRE( frustum.intersects( box( glm::vec3( -5.0f, 0.0f, 0.0f ), 1.0f ) ) );
+
+  REQUIRE( frustum.intersects( nile::BoundingSphere {glm::vec3( 0.0f, 0.0f, -50.0f ), 1.0f} ) );
+  REQUIRE_FALSE(
+      frustum.intersects( nile::BoundingSphere {glm::vec3( 0.0f, 0.0f, 50.0f ), 1.0f} ) );
+
+  SECTION( "The default frustum contains everything" ) {
+    REQUIRE( Frustum {}.intersects( box( glm::vec3( 1e6f ), 1.0f ) ) );
+  }
+}
+
+TEST_CASE( "Bounds are transformed into world space", "[FrustumCuller]" ) {
+
+  const AABB local {glm::vec3( 0.0f ), glm::vec3( 1.0f, 2.0f, 1.0f )};
+  auto model = glm::translate( glm::mat4( 1.0f ), glm::vec3( 10.0f, 0.0f, 0.0f ) );
+  model = glm::rotate( model, glm::radians( 90.0f ), glm::vec3( 0.0f, 0.0f, 1.0f ) );
+
+  const auto world = nile::Math::transformBounds( local, model );
+
+  REQUIRE( glm::length( world.min - glm::vec3( 8.0f, 0.0f, 0.0f ) ) < 1e-4f );
+  REQUIRE( glm::length( world.max - glm::vec3( 10.0f, 1.0f, 1.0f ) ) < 1e-4f );
+  REQUIRE_FALSE( nile::Math::transformBounds( AABB {}, model ).isValid() );
+}
+
+TEST_CASE( "FrustumCuller matches the scalar test", "[FrustumCuller]" ) {
+
+  const auto frustum = perspectiveFrustum();
+  std::mt19937 rng( 1337 );
+  std::uniform_real_distribution<float> position( -100.0f, 100.0f );
+  std::uniform_real_distribution<float> size( 0.1f, 5.0f );
+
+  // Not a multiple of the SIMD width on purpose
+  std::vector<AABB> boxes( 1003 );
+  for ( auto &bounds : boxes )
+    bounds = box( glm::vec3( position( rng ), position( rng ), position( rng ) ), size( rng ) );
+
+  FrustumCuller culler;
+  culler.begin();
+  for ( const auto &bounds : boxes )
+    culler.add( bounds );
+  culler.cull( frustum );
+
+  REQUIRE( culler.getStats().tested == boxes.size() );
+  REQUIRE( culler.getStats().visible + culler.getStats().culled == boxes.size() );
+  REQUIRE( culler.getStats().visible > 0 );
+  REQUIRE( culler.getStats().culled > 0 );
+
+  for ( u32 i = 0; i < boxes.size(); ++i )
+    REQUIRE( culler.isVisible( i ) == frustum.intersects( boxes[ i ] ) );
+
+  SECTION( "Boxes without bounds are never culled" ) {
+    culler.begin();
+    culler.add( box( glm::vec3( 0.0f, 0.0f, 50.0f ), 1.0f ) );
+    culler.add( AABB {} );
+    culler.cull( frustum );
+
+    REQUIRE_FALSE( culler.isVisible( 0 ) );
+    REQUIRE( culler.isVisible( 1 ) );
+    REQUIRE( culler.getStats().culled == 1 );
+  }
+}
@@ -0,0 +1,105 @@
+#include <Nile/renderer/glyph_atlas.hh>
+#include <catch.hpp>
+#include <glm/glm.hpp>
+#include <vector>
+
+using nile::Glyph;
+using nile::GlyphAtlas;
+using nile::i32;
+using nile::u32;
+using nile::u8;
+
+namespace {
+
+  // Glyph bitmap filled with its own codepoint, so copies can be traced back
+  std::vector<u8> bitmap( u32 codepoint, u32 width, u32 rows ) {
+    return std::vector<u8>( width * rows, static_cast<u8>( codepoint ) );
+  }
+
+  bool add( GlyphAtlas &atlas, u32 codepoint, u32 width, u32 rows ) {
+    const auto pixels = bitmap( codepoint, width, rows );
+    return atlas.addGlyph( codepoint, width, rows, static_cast<i32>( width ), pixels.data(),
+                           glm::ivec2( 1, static_cast<i32>( rows ) ), ( width + 2 ) << 6 );
+  }
+
+  bool overlaps( const Glyph &a, const Glyph &b ) {
+    return a.uvMin.x < b.uvMax.x && b.uvMin.x < a.uvMax.x && a.uvMin.y < b.uvMax.y &&
+           b.uvMin.y < a.uvMax.y;
+  }
+
+}    // namespace
+
+TEST_CASE( "Glyphs are packed on shelves without overlapping", "[GlyphAtlas]" ) {
+
+  GlyphAtlas atlas( 64, 16 );
+
+  for ( u32 c = 33; c < 127; ++c )
+    REQUIRE( add( atlas, c, 5 + c % 7, 6 + c % 9 ) );
+
+  // Height grows in powers of two and holds every glyph
+  const auto height = atlas.getHeight();
+  REQUIRE( height > 0 );
+  REQUIRE( ( height & ( height - 1 ) ) == 0 );
+  REQUIRE( atlas.getPixels().size() == static_cast<size_t>( atlas.getWidth() ) * height );
+
+  for ( u32 a = 33; a < 127; ++a ) {
+    const auto &glyph = atlas.getGlyph( a );
+    REQUIRE( glyph.uvMax.x <= atlas.getWidth() - GlyphAtlas::PADDING );
+    REQUIRE( glyph.uvMax.y <= height - GlyphAtlas::PADDING );
+
+    for ( u32 b = a + 1; b < 127; ++b )
+      REQUIRE_FALSE( overlaps( glyph, atlas.getGlyph( b ) ) );
+  }
+}
+
+TEST_CASE( "Glyph bitmaps are copied into their atlas region", "[GlyphAtlas]" ) {
+
+  GlyphAtlas atlas( 32, 8 );
+  REQUIRE( add( atlas, 'A', 4, 3 ) );
+  REQUIRE( add( atlas, 'B', 6, 5 ) );
+
+  const auto &pixels = atlas.getPixels();
+  for ( u32 c : {u32( 'A' ), u32( 'B' )} ) {
+    const auto &glyph = atlas.getGlyph( c );
+    const auto x = static_cast<u32>( glyph.uvMin.x );
+    const auto y = static_cast<u32>( glyph.uvMin.y );
+    for ( i32 row = 0; row < glyph.size.y; ++row )
+      for ( i32 column = 0; column < glyph.size.x; ++column )
+        REQUIRE( pixels[ ( y + row ) * atlas.getWidth() + x + column ] == c );
+  }
+
+  // Padding around the glyphs stays empty
+  const auto &a = atlas.getGlyph( 'A' );
+  const auto row = static_cast<u32>( a.uvMin.y ) * atlas.getWidth();
+  REQUIRE( pixels[ row + static_cast<u32>( a.uvMax.x ) ] == 0 );
+}
+
+TEST_CASE( "Bottom up bitmaps are flipped while copying", "[GlyphAtlas]" ) {
+
+  GlyphAtlas atlas( 16, 8 );
+  // First row in memory is the bottom row of the glyph
+  const std::vector<u8> pixels = {1, 1, 2, 2};
+  REQUIRE( atlas.addGlyph( 'x', 2, 2, -2, pixels.data(), glm::ivec2( 0 ), 0 ) );
+
+  const auto &glyph = atlas.getGlyph( 'x' );
+  const auto top = static_cast<u32>( glyph.uvMin.y ) * atlas.getWidth();
+  REQUIRE( atlas.getPixels()[ top + static_cast<u32>( glyph.uvMin.x ) ] == 2 );
+}
+
+TEST_CASE( "Glyph lookup is done by codepoint", "[GlyphAtlas]" ) {
+
+  GlyphAtlas atlas( 32, 8 );
+  REQUIRE( add( atlas, '?', 3, 4 ) );
+  REQUIRE( add( atlas, ' ', 0, 0 ) );
+
+  // Empty glyphs keep their metrics but take no space
+  REQUIRE( atlas.getGlyph( ' ' ).advance == ( 2u << 6 ) );
+  REQUIRE( atlas.getGlyph( ' ' ).uvMax == glm::vec2( 0.0f ) );
+
+  // Codepoints out of the atlas fall back to '?'
+  REQUIRE( &atlas.getGlyph( 200 ) == &atlas.getGlyph( '?' ) );
+  REQUIRE_FALSE( add( atlas, 200, 3, 3 ) );
+
+  // Glyphs wider than the atlas are rejected
+  REQUIRE_FALSE( add( atlas, 'W', 40, 3 ) );
+}
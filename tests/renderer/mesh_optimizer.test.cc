@@ -0,0 +1,152 @@
+#include <Nile/renderer/mesh_optimizer.hh>
+#include <catch.hpp>
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using nile::f32;
+using nile::u32;
+using nile::Vertex;
+
+namespace MeshOptimizer = nile::MeshOptimizer;
+
+namespace {
+
+  // Grid of size x size quads facing +z, two counter-clockwise triangles per quad
+  void makeGrid( u32 size, f32 z, std::vector<Vertex> &vertices, std::vector<u32> &indices ) {
+    const auto base = static_cast<u32>( vertices.size() );
+    for ( u32 y = 0; y <= size; ++y ) {
+      for ( u32 x = 0; x <= size; ++x )
+        vertices.push_back( {{x, y, z}, {0.0f, 0.0f, 1.0f}, {0.0f, 0.0f}} );
+    }
+
+    for ( u32 y = 0; y < size; ++y ) {
+      for ( u32 x = 0; x < size; ++x ) {
+        const auto corner = base + y * ( size + 1 ) + x;
+        indices.insert( indices.end(), {corner, corner + 1, corner + size + 2} );
+        indices.insert( indices.end(), {corner, corner + size + 2, corner + size + 1} );
+      }
+    }
+  }
+
+  void shuffleTriangles( std::vector<u32> &indices ) {
+    std::vector<u32> order( indices.size() / 3 );
+    for ( u32 i = 0; i < order.size(); ++i )
+      order[ i ] = i;
+    std::shuffle( order.begin(), order.end(), std::mt19937( 3 ) );
+
+    std::vector<u32> shuffled;
+    for ( const auto triangle : order )
+      shuffled.insert( shuffled.end(), indices.begin() + triangle * 3,
+                       indices.begin() + triangle * 3 + 3 );
+    indices.swap( shuffled );
+  }
+
+  std::vector<u32> sortedTriangles( const std::vector<u32> &indices,
+                                    const std::vector<Vertex> &vertices ) {
+    // Triangles compared by their positions, independent of the vertex order
+    std::vector<u32> keys;
+    for ( const auto index : indices ) {
+      const auto &position = vertices[ index ].position;
+      keys.push_back( static_cast<u32>( position.x * 1000 + position.y * 10 + position.z ) );
+    }
+    std::sort( keys.begin(), keys.end() );
+    return keys;
+  }
+
+}    // namespace
+
+TEST_CASE( "Vertex cache analysis counts FIFO misses", "[MeshOptimizer]" ) {
+
+  // Every triangle uses new vertices
+  const std::vector<u32> separate = {0, 1, 2, 3, 4, 5};
+  auto quality = MeshOptimizer::analyzeVertexCache( separate, 6 );
+  REQUIRE( quality.acmr == 3.0f );
+  REQUIRE( quality.atvr == 1.0f );
+
+  // A quad shares two vertices between its triangles
+  const std::vector<u32> quad = {0, 1, 2, 0, 2, 3};
+  quality = MeshOptimizer::analyzeVertexCache( quad, 4 );
+  REQUIRE( quality.acmr == 2.0f );
+  REQUIRE( quality.atvr == 1.0f );
+
+  // A cache of 3 vertices forgets the first one before it is used again
+  const std::vector<u32> strip = {0, 1, 2, 2, 1, 3, 3, 1, 0};
+  quality = MeshOptimizer::analyzeVertexCache( strip, 4, 3 );
+  REQUIRE( quality.acmr == Approx( 5.0f / 3.0f ) );
+}
+
+TEST_CASE( "Vertex cache optimization improves a shuffled grid", "[MeshOptimizer]" ) {
+
+  std::vector<Vertex> vertices;
+  std::vector<u32> indices;
+  makeGrid( 32, 0.0f, vertices, indices );
+  shuffleTriangles( indices );
+
+  const auto before = MeshOptimizer::analyzeVertexCache( indices, vertices.size() );
+  const auto triangles = sortedTriangles( indices, vertices );
+
+  MeshOptimizer::optimizeVertexCache( indices, vertices.size() );
+  const auto after = MeshOptimizer::analyzeVertexCache( indices, vertices.size() );
+
+  REQUIRE( before.acmr > 1.5f );
+  REQUIRE( after.acmr < 0.8f );
+  REQUIRE( after.atvr < before.atvr );
+  // Same triangles, only reordered
+  REQUIRE( sortedTriangles( indices, vertices ) == triangles );
+}
+
+TEST_CASE( "Overdraw optimization draws the front layer first", "[MeshOptimizer]" ) {
+
+  // The back layer is drawn first, everything of the front layer is shaded again
+  std::vector<Vertex> vertices;
+  std::vector<u32> indices;
+  makeGrid( 4, 0.0f, vertices, indices );
+  makeGrid( 4, 1.0f, vertices, indices );
+
+  const auto before = MeshOptimizer::analyzeOverdraw( vertices, indices );
+
+  MeshOptimizer::optimizeVertexCache( indices, vertices.size() );
+  MeshOptimizer::optimizeOverdraw( indices, vertices );
+  const auto after = MeshOptimizer::analyzeOverdraw( vertices, indices );
+
+  REQUIRE( before == Approx( 2.0f ).epsilon( 0.01 ) );
+  REQUIRE( after == Approx( 1.0f ).epsilon( 0.01 ) );
+  REQUIRE( indices.size() == 2 * 4 * 4 * 6 );
+}
+
+TEST_CASE( "Overdraw optimization keeps every triangle", "[MeshOptimizer]" ) {
+
+  std::vector<Vertex> vertices;
+  for ( u32 i = 0; i < 4; ++i )
+    vertices.push_back( {{i & 1, i >> 1, 0.0f}, {0.0f, 0.0f, 1.0f}, {0.0f, 0.0f}} );
+
+  // The first triangle is degenerate, none of them misses on all three corners after it
+  std::vector<u32> indices = {0, 0, 1, 0, 1, 2, 1, 3, 2};
+  const auto triangles = sortedTriangles( indices, vertices );
+
+  MeshOptimizer::optimizeOverdraw( indices, vertices );
+
+  REQUIRE( indices.size() == 9 );
+  REQUIRE( sortedTriangles( indices, vertices ) == triangles );
+}
+
+TEST_CASE( "Vertex fetch optimization stores vertices in the order of use", "[MeshOptimizer]" ) {
+
+  std::vector<Vertex> vertices( 5 );
+  for ( u32 i = 0; i < vertices.size(); ++i )
+    vertices[ i ].position = glm::vec3( static_cast<f32>( i ) );
+
+  // Vertex 1 is never used
+  std::vector<u32> indices = {4, 2, 0, 0, 2, 3};
+  MeshOptimizer::optimizeVertexFetch( vertices, indices );
+
+  const std::vector<u32> expected = {0, 1, 2, 2, 1, 3};
+  REQUIRE( vertices.size() == 4 );
+  REQUIRE( indices == expected );
+  REQUIRE( vertices[ 0 ].position.x == 4.0f );
+  REQUIRE( vertices[ 1 ].position.x == 2.0f );
+  REQUIRE( vertices[ 2 ].position.x == 0.0f );
+  REQUIRE( vertices[ 3 ].position.x == 3.0f );
+}
@@ -0,0 +1,142 @@
+#include <Nile/renderer/mip_chain.hh>
+#include <catch.hpp>
+
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using nile::MipChain;
+using nile::MipChainOptions;
+using nile::MipFilter;
+using nile::u32;
+using nile::u8;
+
+namespace {
+
+  std::vector<u8> solid( u32 width, u32 height, u8 r, u8 g, u8 b, u8 a ) {
+    std::vector<u8> pixels( width * height * MipChain::CHANNELS );
+    for ( u32 i = 0; i < width * height; ++i ) {
+      pixels[ i * 4 + 0 ] = r;
+      pixels[ i * 4 + 1 ] = g;
+      pixels[ i * 4 + 2 ] = b;
+      pixels[ i * 4 + 3 ] = a;
+    }
+    return pixels;
+  }
+
+  MipChainOptions options( MipFilter filter, bool srgb ) {
+    MipChainOptions result;
+    result.filter = filter;
+    result.srgb = srgb;
+    return result;
+  }
+
+}    // namespace
+
+TEST_CASE( "MipChain builds every level down to 1x1", "[MipChain]" ) {
+
+  REQUIRE( MipChain::levelCount( 1, 1 ) == 1 );
+  REQUIRE( MipChain::levelCount( 256, 64 ) == 9 );
+  REQUIRE( MipChain::levelCount( 5, 3 ) == 3 );
+
+  const auto pixels = solid( 5, 3, 10, 20, 30, 255 );
+  MipChain chain;
+  chain.build( pixels.data(), 5, 3 );
+
+  REQUIRE( chain.getLevelCount() == 3 );
+  REQUIRE( chain.getLevel( 1 ).width == 2 );
+  REQUIRE( chain.getLevel( 1 ).height == 1 );
+  REQUIRE( chain.getLevel( 2 ).width == 1 );
+  REQUIRE( chain.getLevel( 2 ).height == 1 );
+  REQUIRE( std::memcmp( chain.getData( 0 ), pixels.data(), pixels.size() ) == 0 );
+  REQUIRE( chain.getBaseBytes() == 5 * 3 * 4 );
+  REQUIRE( chain.getMipBytes() == ( 2 + 1 ) * 4 );
+}
+
+TEST_CASE( "MipChain mips of a square texture cost a third of it", "[MipChain]" ) {
+
+  const auto pixels = solid( 256, 256, 0, 0, 0, 255 );
+  MipChain chain;
+  chain.build( pixels.data(), 256, 256 );
+
+  // 1/4 + 1/16 + ... + 1/65536 of the base, a texel short of a third
+  REQUIRE( chain.getMipBytes() * 3 == chain.getBaseBytes() - 4 );
+}
+
+TEST_CASE( "MipChain keeps a solid color in every level", "[MipChain]" ) {
+
+  const auto pixels = solid( 37, 21, 200, 100, 50, 255 );
+
+  for ( auto filter : {MipFilter::BOX, MipFilter::KAISER} ) {
+    MipChain chain;
+    chain.build( pixels.data(), 37, 21, options( filter, true ) );
+    for ( u32 level = 1; level < chain.getLevelCount(); ++level ) {
+      const auto &size = chain.getLevel( level );
+      const u8 *data = chain.getData( level );
+      for ( u32 i = 0; i < size.width * size.height * 4; i += 4 ) {
+        REQUIRE( data[ i ] == 200 );
+        REQUIRE( data[ i + 1 ] == 100 );
+        REQUIRE( data[ i + 2 ] == 50 );
+        REQUIRE( data[ i + 3 ] == 255 );
+      }
+    }
+  }
+}
+
+TEST_CASE( "MipChain averages colors in linear space", "[MipChain]" ) {
+
+  // Black and white columns
+  auto pixels = solid( 2, 2, 0, 0, 0, 255 );
+  for ( u32 y = 0; y < 2; ++y )
+    std::memset( &pixels[ ( y * 2 + 1 ) * 4 ], 255, 4 );
+
+  MipChain linear;
+  linear.build( pixels.data(), 2, 2, options( MipFilter::BOX, true ) );
+  // Half the light of white is 188 in sRGB, not 128
+  REQUIRE( std::abs( linear.getData( 1 )[ 0 ] - 188 ) <= 1 );
+
+  MipChain data;
+  data.build( pixels.data(), 2, 2, options( MipFilter::BOX, false ) );
+  REQUIRE( std::abs( data.getData( 1 )[ 0 ] - 128 ) <= 1 );
+}
+
+TEST_CASE( "MipChain doesn't bleed transparent texels", "[MipChain]" ) {
+
+  // Opaque green next to transparent red
+  auto pixels = solid( 2, 1, 0, 255, 0, 255 );
+  pixels[ 4 ] = 255;
+  pixels[ 5 ] = 0;
+  pixels[ 7 ] = 0;
+
+  MipChain chain;
+  chain.build( pixels.data(), 2, 1, options( MipFilter::BOX, true ) );
+  const u8 *mip = chain.getData( 1 );
+
+  REQUIRE( mip[ 0 ] == 0 );
+  REQUIRE( mip[ 1 ] == 255 );
+  REQUIRE( std::abs( mip[ 3 ] - 128 ) <= 1 );
+}
+
+TEST_CASE( "MipChain gives the same levels on any number of threads", "[MipChain]" ) {
+
+  constexpr u32 SIZE = 300;
+  std::vector<u8> pixels( SIZE * SIZE * 4 );
+  std::mt19937 random( 7 );
+  for ( auto &value : pixels )
+    value = static_cast<u8>( random() );
+
+  auto single = options( MipFilter::KAISER, true );
+  single.threads = 1;
+  auto parallel = single;
+  parallel.threads = 4;
+
+  MipChain a;
+  MipChain b;
+  a.build( pixels.data(), SIZE, SIZE, single );
+  b.build( pixels.data(), SIZE, SIZE, parallel );
+
+  REQUIRE( a.getLevelCount() == b.getLevelCount() );
+  REQUIRE( std::memcmp( a.getData( 0 ), b.getData( 0 ), a.getBaseBytes() + a.getMipBytes() ) ==
+           0 );
+}
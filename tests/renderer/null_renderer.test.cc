@@ -0,0 +1,351 @@
+#include <Nile/core/camera_system.hh>
+#include <Nile/core/settings.hh>
+#include <Nile/debug/debug_draw.hh>
+#include <Nile/ecs/components/camera_component.hh>
+#include <Nile/ecs/components/font_component.hh>
+#include <Nile/ecs/components/mesh_component.hh>
+#include <Nile/ecs/components/primitive.hh>
+#include <Nile/ecs/components/renderable.hh>
+#include <Nile/ecs/components/sprite.hh>
+#include <Nile/ecs/components/transform.hh>
+#include <Nile/ecs/ecs_coordinator.hh>
+#include <Nile/renderer/font_rendering_system.hh>
+#include <Nile/renderer/gl_state_cache.hh>
+#include <Nile/renderer/glyph_atlas.hh>
+#include <Nile/renderer/null_renderer.hh>
+#include <Nile/renderer/render_primitive_system.hh>
+#include <Nile/renderer/render_queue.hh>
+#include <Nile/renderer/rendering_system.hh>
+#include <Nile/renderer/shaderset.hh>
+#include <Nile/renderer/sprite_batch.hh>
+#include <Nile/renderer/sprite_rendering_system.hh>
+#include <Nile/renderer/stream_buffer.hh>
+#include <Nile/renderer/texture2d.hh>
+#include <catch.hpp>
+
+#include <memory>
+
+using nile::CameraComponent;
+using nile::CameraSystem;
+using nile::Coordinator;
+using nile::f32;
+using nile::FontComponent;
+using nile::FontRenderingSystem;
+using nile::GlyphAtlas;
+using nile::MeshComponent;
+using nile::NullRenderer;
+using nile::Primitive;
+using nile::ProjectionType;
+using nile::Renderable;
+using nile::RenderPrimitiveSystem;
+using nile::RenderingSystem;
+using nile::Settings;
+using nile::ShaderSet;
+using nile::Signature;
+using nile::SpriteComponent;
+using nile::SpriteRenderingSystem;
+using nile::SpriteVertex;
+using nile::Texture2D;
+using nile::Transform;
+using nile::u32;
+using nile::u8;
+using nile::Vertex;
+
+namespace {
+
+  // Same frame as the X11 host, without the framebuffer
+  void renderFrame( NullRenderer &renderer, Coordinator &coordinator ) {
+    renderer.submitFrame();
+    coordinator.render( 0.0f );
+    renderer.getStreamBuffer()->flush();
+    renderer.getRenderQueue()->execute( *renderer.getStateCache() );
+    renderer.endFrame();
+  }
+
+}    // namespace
+
+TEST_CASE( "NullRenderer counts the GL calls of the SpriteRenderingSystem", "[NullRenderer]" ) {
+
+  auto settings =
+      std::make_shared<Settings>( Settings::Builder {}.setWidth( 640 ).setHeight( 480 ).build() );
+  NullRenderer renderer( settings );
+  renderer.init();
+
+  auto coordinator = std::make_shared<Coordinator>();
+  coordinator->init();
+  coordinator->registerComponent<Transform>();
+  coordinator->registerComponent<Renderable>();
+  coordinator->registerComponent<SpriteComponent>();
+
+  // Program 1 doesn't exist, the null GL accepts any name
+  auto shader = std::make_shared<ShaderSet>( 1, "", "", "" );
+  auto system = coordinator->registerSystem<SpriteRenderingSystem>(
+      coordinator, renderer.getStateCache(), renderer.getRenderQueue(),
+      renderer.getStreamBuffer(), shader );
+
+  Signature signature;
+  signature.set( coordinator->getComponentType<Transform>() );
+  signature.set( coordinator->getComponentType<Renderable>() );
+  signature.set( coordinator->getComponentType<SpriteComponent>() );
+  coordinator->setSystemSignature<SpriteRenderingSystem>( signature );
+  coordinator->createSystems();
+
+  std::shared_ptr<Texture2D> textures[] = {std::make_shared<Texture2D>(),
+                                           std::make_shared<Texture2D>()};
+
+  constexpr int SPRITES = 1000;
+  for ( int i = 0; i < SPRITES; ++i ) {
+    const auto entity = coordinator->createEntity();
+    coordinator->addComponent<Transform>(
+        entity, Transform( glm::vec3( i, 0.0f, -1.0f ), glm::vec3( 1.0f ) ) );
+    coordinator->addComponent<Renderable>( entity, Renderable() );
+    coordinator->addComponent<SpriteComponent>( entity, SpriteComponent( textures[ i % 2 ] ) );
+  }
+
+  // The first frame creates the vertex arrays and grows the buffers
+  renderFrame( renderer, *coordinator );
+  renderFrame( renderer, *coordinator );
+  const auto &stats = renderer.getLastFrameStats();
+
+  SECTION( "One draw per texture" ) {
+    REQUIRE( system->getStats().sprites == SPRITES );
+    REQUIRE( stats.draws == 2 );
+    REQUIRE( stats.drawCommands == 2 );
+  }
+
+  SECTION( "Textures are bound once per batch at most" ) {
+    REQUIRE( stats.textureBinds <= 2 );
+  }
+
+  SECTION( "The quads are streamed every frame" ) {
+    REQUIRE( stats.bufferBytes >= SPRITES * 4 * sizeof( SpriteVertex ) );
+  }
+
+  SECTION( "Counters are reset every frame" ) {
+    renderer.submitFrame();
+    renderer.endFrame();
+    REQUIRE( renderer.getLastFrameStats().draws == 0 );
+    REQUIRE( renderer.getLastFrameStats().bufferBytes == 0 );
+  }
+}
+
+TEST_CASE( "An orthographic camera culls the sprites outside of the screen", "[NullRenderer]" ) {
+
+  auto settings =
+      std::make_shared<Settings>( Settings::Builder {}.setWidth( 640 ).setHeight( 480 ).build() );
+  NullRenderer renderer( settings );
+  renderer.init();
+
+  auto coordinator = std::make_shared<Coordinator>();
+  coordinator->init();
+  coordinator->registerComponent<Transform>();
+  coordinator->registerComponent<Renderable>();
+  coordinator->registerComponent<SpriteComponent>();
+  coordinator->registerComponent<CameraComponent>();
+
+  auto shader = std::make_shared<ShaderSet>( 1, "", "", "" );
+  auto system = coordinator->registerSystem<SpriteRenderingSystem>(
+      coordinator, renderer.getStateCache(), renderer.getRenderQueue(),
+      renderer.getStreamBuffer(), shader );
+  coordinator->registerSystem<CameraSystem>( coordinator, settings, renderer.getRenderQueue(),
+                                             renderer.getFrameUniforms() );
+
+  Signature sprites;
+  sprites.set( coordinator->getComponentType<Transform>() );
+  sprites.set( coordinator->getComponentType<Renderable>() );
+  sprites.set( coordinator->getComponentType<SpriteComponent>() );
+  coordinator->setSystemSignature<SpriteRenderingSystem>( sprites );
+
+  Signature cameras;
+  cameras.set( coordinator->getComponentType<Transform>() );
+  cameras.set( coordinator->getComponentType<CameraComponent>() );
+  coordinator->setSystemSignature<CameraSystem>( cameras );
+
+  const auto camera = coordinator->createEntity();
+  coordinator->addComponent<Transform>( camera, Transform( glm::vec3( 0.0f ), glm::vec3( 1.0f ) ) );
+  coordinator->addComponent<CameraComponent>(
+      camera, CameraComponent( 0.1f, 100.0f, 45.0f, ProjectionType::ORTHOGRAPHIC ) );
+  coordinator->createSystems();
+
+  auto texture = std::make_shared<Texture2D>();
+
+  // Half of the sprites are on the 640x480 screen, the other half far to the right
+  constexpr u32 SPRITES = 100;
+  for ( u32 i = 0; i < SPRITES; ++i ) {
+    const f32 x = i % 2 ? 10000.0f + i : 6.0f * i;
+    const auto entity = coordinator->createEntity();
+    coordinator->addComponent<Transform>(
+        entity, Transform( glm::vec3( x, 100.0f, 0.0f ), glm::vec3( 4.0f ) ) );
+    coordinator->addComponent<Renderable>( entity, Renderable() );
+    coordinator->addComponent<SpriteComponent>( entity, SpriteComponent( texture ) );
+  }
+
+  coordinator->update( 0.0f );
+  renderFrame( renderer, *coordinator );
+
+  REQUIRE( system->getStats().culled == SPRITES / 2 );
+  REQUIRE( system->getStats().sprites == SPRITES );
+  REQUIRE( renderer.getLastFrameStats().draws == 1 );
+}
+
+TEST_CASE( "NullRenderer counts the GL calls of the RenderPrimitiveSystem", "[NullRenderer]" ) {
+
+  auto settings =
+      std::make_shared<Settings>( Settings::Builder {}.setWidth( 640 ).setHeight( 480 ).build() );
+  NullRenderer renderer( settings );
+  renderer.init();
+
+  auto coordinator = std::make_shared<Coordinator>();
+  coordinator->init();
+  coordinator->registerComponent<Transform>();
+  coordinator->registerComponent<Renderable>();
+  coordinator->registerComponent<Primitive>();
+
+  auto shader = std::make_shared<ShaderSet>( 1, "", "", "" );
+  coordinator->registerSystem<RenderPrimitiveSystem>(
+      coordinator, renderer.getStateCache(), renderer.getRenderQueue(),
+      renderer.getStreamBuffer(), renderer.getDebugDraw(), shader );
+
+  Signature signature;
+  signature.set( coordinator->getComponentType<Transform>() );
+  signature.set( coordinator->getComponentType<Renderable>() );
+  signature.set( coordinator->getComponentType<Primitive>() );
+  coordinator->setSystemSignature<RenderPrimitiveSystem>( signature );
+  coordinator->createSystems();
+
+  constexpr int PRIMITIVES = 100;
+  for ( int i = 0; i < PRIMITIVES; ++i ) {
+    const auto entity = coordinator->createEntity();
+    coordinator->addComponent<Transform>(
+        entity, Transform( glm::vec3( i, 0.0f, -1.0f ), glm::vec3( 1.0f ) ) );
+    coordinator->addComponent<Renderable>( entity, Renderable() );
+    coordinator->addComponent<Primitive>( entity, Primitive() );
+  }
+
+  renderFrame( renderer, *coordinator );
+  renderFrame( renderer, *coordinator );
+  const auto &stats = renderer.getLastFrameStats();
+
+  // Drawn with or without NILE_DEBUG_DRAW, all the lines in one draw
+  REQUIRE( renderer.getDebugDraw()->getStats().lines == PRIMITIVES );
+  REQUIRE( stats.draws == 1 );
+  REQUIRE( stats.bufferBytes >= PRIMITIVES * 2 * sizeof( nile::DebugVertex ) );
+}
+
+TEST_CASE( "NullRenderer counts the GL calls of the RenderingSystem", "[NullRenderer]" ) {
+
+  auto settings =
+      std::make_shared<Settings>( Settings::Builder {}.setWidth( 640 ).setHeight( 480 ).build() );
+  NullRenderer renderer( settings );
+  renderer.init();
+
+  auto coordinator = std::make_shared<Coordinator>();
+  coordinator->init();
+  coordinator->registerComponent<Transform>();
+  coordinator->registerComponent<Renderable>();
+  coordinator->registerComponent<MeshComponent>();
+
+  auto shader = std::make_shared<ShaderSet>( 1, "", "", "" );
+  auto system = coordinator->registerSystem<RenderingSystem>(
+      coordinator, renderer.getStateCache(), renderer.getRenderQueue(),
+      renderer.getStreamBuffer(), shader );
+
+  Signature signature;
+  signature.set( coordinator->getComponentType<Transform>() );
+  signature.set( coordinator->getComponentType<Renderable>() );
+  signature.set( coordinator->getComponentType<MeshComponent>() );
+  coordinator->setSystemSignature<RenderingSystem>( signature );
+  coordinator->createSystems();
+
+  // A triangle and a quad, no bounds, so nothing is culled
+  MeshComponent meshes[ 2 ];
+  for ( u32 i = 0; i < 4; ++i ) {
+    const Vertex vertex {{i & 1, i >> 1, 0.0f}, {0.0f, 0.0f, 1.0f}, {i & 1, i >> 1}};
+    meshes[ 1 ].vertices.push_back( vertex );
+    if ( i < 3 )
+      meshes[ 0 ].vertices.push_back( vertex );
+  }
+  meshes[ 0 ].indices = {0, 1, 2};
+  meshes[ 1 ].indices = {0, 1, 3, 0, 3, 2};
+
+  constexpr int MESHES = 1000;
+  for ( int i = 0; i < MESHES; ++i ) {
+    const auto entity = coordinator->createEntity();
+    coordinator->addComponent<Transform>(
+        entity, Transform( glm::vec3( i, 0.0f, -1.0f ), glm::vec3( 1.0f ) ) );
+    Renderable renderable;
+    renderable.blend = false;
+    coordinator->addComponent<Renderable>( entity, renderable );
+    coordinator->addComponent<MeshComponent>( entity, meshes[ i % 2 ] );
+  }
+
+  renderFrame( renderer, *coordinator );
+  renderFrame( renderer, *coordinator );
+  const auto &stats = renderer.getLastFrameStats();
+
+  // Both groups share the material, one multi draw with a command per group
+  REQUIRE( system->getStats().instances == MESHES );
+  REQUIRE( system->getStats().groups == 2 );
+  REQUIRE( stats.draws == 1 );
+  REQUIRE( stats.drawCommands == 2 );
+  // Nothing moved, the instances of the first frame are still in the instance buffer
+  REQUIRE( system->getStats().residentGroups == 2 );
+}
+
+TEST_CASE( "NullRenderer counts the GL calls of the FontRenderingSystem", "[NullRenderer]" ) {
+
+  auto settings =
+      std::make_shared<Settings>( Settings::Builder {}.setWidth( 640 ).setHeight( 480 ).build() );
+  NullRenderer renderer( settings );
+  renderer.init();
+
+  auto coordinator = std::make_shared<Coordinator>();
+  coordinator->init();
+  coordinator->registerComponent<Transform>();
+  coordinator->registerComponent<Renderable>();
+  coordinator->registerComponent<FontComponent>();
+
+  // The atlases are filled by hand, the system has no font to rasterize and no asset
+  // manager to ask
+  auto shader = std::make_shared<ShaderSet>( 1, "", "", "" );
+  auto system = coordinator->registerSystem<FontRenderingSystem>(
+      coordinator, settings, renderer.getStateCache(), renderer.getRenderQueue(), nullptr,
+      shader );
+
+  Signature signature;
+  signature.set( coordinator->getComponentType<Transform>() );
+  signature.set( coordinator->getComponentType<Renderable>() );
+  signature.set( coordinator->getComponentType<FontComponent>() );
+  coordinator->setSystemSignature<FontRenderingSystem>( signature );
+  coordinator->createSystems();
+
+  std::shared_ptr<GlyphAtlas> atlases[] = {std::make_shared<GlyphAtlas>( 128, 18 ),
+                                           std::make_shared<GlyphAtlas>( 128, 18 )};
+  const std::vector<u8> pixels( 4 * 6, 255 );
+  for ( auto &atlas : atlases ) {
+    for ( u32 c = 33; c < 127; ++c )
+      atlas->addGlyph( c, 4, 6, 4, pixels.data(), glm::ivec2( 0, 6 ), 5 << 6 );
+  }
+
+  constexpr int TEXTS = 100;
+  for ( int i = 0; i < TEXTS; ++i ) {
+    const auto entity = coordinator->createEntity();
+    coordinator->addComponent<Transform>(
+        entity, Transform( glm::vec3( 0.0f, i * 10.0f, 0.0f ), glm::vec3( 1.0f ) ) );
+    coordinator->addComponent<Renderable>( entity, Renderable() );
+    FontComponent font;
+    font.atlas = atlases[ i % 2 ];
+    font.fontSize = 18;
+    font.text = "fps:60";
+    coordinator->addComponent<FontComponent>( entity, font );
+  }
+
+  renderFrame( renderer, *coordinator );
+  renderFrame( renderer, *coordinator );
+  const auto &stats = renderer.getLastFrameStats();
+
+  // One draw per atlas, the unchanged texts are not laid out again
+  REQUIRE( system->getStats().glyphs == TEXTS * 6 );
+  REQUIRE( system->getStats().rebuilt == 0 );
+  REQUIRE( stats.draws == 2 );
+}
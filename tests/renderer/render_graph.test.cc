@@ -0,0 +1,172 @@
+#include <Nile/renderer/gl_state_cache.hh>
+#include <Nile/renderer/render_graph.hh>
+#include <catch.hpp>
+
+#include <string>
+#include <vector>
+
+using nile::GLStateCache;
+using nile::RenderClear;
+using nile::RenderGraph;
+using nile::RenderPassContext;
+using nile::RenderResource;
+using nile::RenderTargetDepth;
+using nile::RenderTargetDesc;
+using nile::RenderTargetFormat;
+using nile::u32;
+
+namespace {
+
+  RenderTargetDesc makeDesc( u32 width, u32 height,
+                             RenderTargetFormat format = RenderTargetFormat::RGBA8 ) {
+    RenderTargetDesc desc;
+    desc.width = width;
+    desc.height = height;
+    desc.format = format;
+    return desc;
+  }
+
+}    // namespace
+
+TEST_CASE( "RenderGraph culls the passes nothing on screen depends on", "[RenderGraph]" ) {
+
+  GLStateCache state;
+  RenderGraph graph;
+  graph.setBackbufferSize( 640, 480 );
+
+  std::vector<std::string> order;
+  const auto record = [ &order ]( const char *name ) {
+    return [ &order, name ]( RenderPassContext & ) { order.push_back( name ); };
+  };
+
+  const auto scene = graph.createTarget( "scene", makeDesc( 640, 480 ) );
+  const auto debug = graph.createTarget( "debug", makeDesc( 640, 480 ) );
+  const auto probe = graph.createTarget( "probe", makeDesc( 64, 64 ) );
+
+  graph.addPass( "scene", record( "scene" ) ).write( scene );
+  graph.addPass( "debug", record( "debug" ) ).read( scene ).write( debug );
+  graph.addPass( "probe", record( "probe" ) ).write( probe ).setSideEffects();
+  graph.addPass( "screen", record( "screen" ) ).read( scene ).write( RenderGraph::BACKBUFFER );
+
+  graph.execute( state );
+
+  const std::vector<std::string> expected {"scene", "probe", "screen"};
+  REQUIRE( order == expected );
+  REQUIRE( graph.isCulled( "debug" ) );
+  REQUIRE_FALSE( graph.isCulled( "scene" ) );
+  REQUIRE( graph.getStats().passes == 3 );
+  REQUIRE( graph.getStats().culledPasses == 1 );
+  // The target of the culled pass gets no framebuffer
+  REQUIRE( graph.getTarget( debug ) == nullptr );
+  REQUIRE( graph.getTarget( scene ) != nullptr );
+}
+
+TEST_CASE( "RenderGraph aliases targets whose lifetimes don't overlap", "[RenderGraph]" ) {
+
+  GLStateCache state;
+  RenderGraph graph;
+  graph.setBackbufferSize( 640, 480 );
+
+  // A post process chain: scene -> bright -> blur -> composite. Each target is dead once
+  // the next pass has read it
+  const auto scene = graph.createTarget( "scene", makeDesc( 640, 480 ) );
+  const auto bright = graph.createTarget( "bright", makeDesc( 320, 240 ) );
+  const auto blur = graph.createTarget( "blur", makeDesc( 320, 240 ) );
+  const auto tonemap = graph.createTarget( "tonemap", makeDesc( 320, 240 ) );
+
+  graph.addPass( "scene", nullptr ).write( scene );
+  graph.addPass( "bright", nullptr ).read( scene ).write( bright );
+  graph.addPass( "blur", nullptr ).read( bright ).write( blur );
+  graph.addPass( "tonemap", nullptr ).read( blur ).write( tonemap );
+  graph.addPass( "screen", nullptr )
+      .read( scene )
+      .read( tonemap )
+      .write( RenderGraph::BACKBUFFER );
+
+  graph.execute( state );
+
+  // bright and blur overlap in the blur pass, tonemap takes over the one of bright
+  REQUIRE( graph.getStats().resources == 4 );
+  REQUIRE( graph.getStats().targets == 3 );
+  REQUIRE( graph.getTarget( tonemap )->framebuffer == graph.getTarget( bright )->framebuffer );
+  REQUIRE( graph.getTarget( blur )->framebuffer != graph.getTarget( bright )->framebuffer );
+  REQUIRE( graph.getStats().aliasedBytes == makeDesc( 320, 240 ).getBytes() );
+
+  // A different description is never aliased
+  REQUIRE( graph.getTarget( scene )->framebuffer != graph.getTarget( bright )->framebuffer );
+  REQUIRE( graph.getPool().getStats().allocations == 3 );
+
+  // Later frames take the same framebuffers from the pool
+  graph.execute( state );
+  REQUIRE( graph.getPool().getStats().allocations == 3 );
+}
+
+TEST_CASE( "RenderGraph binds and clears only when needed", "[RenderGraph]" ) {
+
+  GLStateCache state;
+  RenderGraph graph;
+  graph.setBackbufferSize( 640, 480 );
+
+  RenderClear clear;
+  clear.color = true;
+  clear.depth = true;
+  const auto scene = graph.createTarget( "scene", makeDesc( 640, 480 ), clear );
+
+  std::vector<u32> sizes;
+  const auto size = [ &sizes ]( RenderPassContext &pass ) {
+    sizes.push_back( pass.getWidth() );
+    sizes.push_back( pass.getHeight() );
+  };
+
+  // Opaque and transparent draw into the same target, it is bound and cleared once
+  graph.addPass( "opaque", size ).write( scene );
+  graph.addPass( "transparent", size ).write( scene );
+  graph.addPass( "screen", size ).read( scene ).write( RenderGraph::BACKBUFFER );
+
+  graph.execute( state );
+
+  REQUIRE( graph.getStats().framebufferBinds == 2 );
+  REQUIRE( graph.getStats().clears == 1 );
+  const std::vector<u32> full {640, 480, 640, 480, 640, 480};
+  REQUIRE( sizes == full );
+
+  // The scene target follows the render scale, the graph compiles again
+  graph.setTargetSize( scene, 320, 240 );
+  sizes.clear();
+  graph.execute( state );
+
+  const std::vector<u32> scaled {320, 240, 320, 240, 640, 480};
+  REQUIRE( sizes == scaled );
+  REQUIRE( graph.getTarget( scene )->width == 320 );
+  // The full size target stays in the pool for when the scale goes back
+  REQUIRE( graph.getPool().getStats().targets == 2 );
+}
+
+TEST_CASE( "RenderGraph samples depth only targets", "[RenderGraph]" ) {
+
+  GLStateCache state;
+  RenderGraph graph;
+  graph.setBackbufferSize( 640, 480 );
+
+  RenderTargetDesc shadowDesc = makeDesc( 1024, 1024, RenderTargetFormat::NONE );
+  shadowDesc.depth = RenderTargetDepth::TEXTURE;
+  RenderClear clear;
+  clear.depth = true;
+  const RenderResource shadow = graph.createTarget( "shadow", shadowDesc, clear );
+
+  u32 texture = 0;
+  graph.addPass( "shadow", nullptr ).write( shadow );
+  graph.addPass( "scene",
+                 [ &texture, shadow ]( RenderPassContext &pass ) {
+                   texture = pass.getTexture( shadow );
+                 } )
+      .read( shadow )
+      .write( RenderGraph::BACKBUFFER );
+
+  graph.execute( state );
+
+  REQUIRE( graph.getTarget( shadow )->color == 0 );
+  REQUIRE( texture != 0 );
+  REQUIRE( texture == graph.getTarget( shadow )->depthStencil );
+  REQUIRE( graph.getStats().clears == 1 );
+}
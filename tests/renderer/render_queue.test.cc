@@ -0,0 +1,101 @@
+#include <Nile/renderer/render_queue.hh>
+#include <algorithm>
+#include <catch.hpp>
+#include <random>
+#include <vector>
+
+using nile::DrawPacket;
+using nile::makeRenderKey;
+using nile::RenderLayer;
+using nile::RenderPass;
+using nile::RenderQueue;
+using nile::SortItem;
+using nile::u32;
+using nile::u64;
+
+namespace {
+
+  // Submits a packet that only carries the key, userIndex is used to identify it
+  void submit( RenderQueue &queue, u64 key, u32 id ) {
+    DrawPacket packet;
+    packet.key = key;
+    packet.userIndex = id;
+    queue.submit( packet );
+  }
+
+  std::vector<u32> drawOrder( RenderQueue &queue ) {
+    queue.sort();
+    std::vector<u32> ids;
+    for ( const auto &item : queue.getOrder() )
+      ids.push_back( queue.getPackets()[ item.index ].userIndex );
+    return ids;
+  }
+
+}    // namespace
+
+TEST_CASE( "RenderQueue orders packets by layer and pass", "[RenderQueue]" ) {
+
+  RenderQueue queue;
+  submit( queue, makeRenderKey( RenderLayer::OVERLAY, RenderPass::TRANSPARENT, 1, 0, 0.0f ), 0 );
+  submit( queue, makeRenderKey( RenderLayer::WORLD, RenderPass::TRANSPARENT, 1, 0, 5.0f ), 1 );
+  submit( queue, makeRenderKey( RenderLayer::WORLD, RenderPass::OPAQUE, 1, 0, 50.0f ), 2 );
+
+  const std::vector<u32> expected {2, 1, 0};
+  REQUIRE( drawOrder( queue ) == expected );
+  REQUIRE( nile::renderKeyLayer( queue.getPackets()[ 0 ].key ) == RenderLayer::OVERLAY );
+  REQUIRE( nile::renderKeyPass( queue.getPackets()[ 1 ].key ) == RenderPass::TRANSPARENT );
+}
+
+TEST_CASE( "RenderQueue sorts by depth", "[RenderQueue]" ) {
+
+  RenderQueue queue;
+
+  SECTION( "Opaque packets are grouped by state, then drawn front to back" ) {
+    submit( queue, makeRenderKey( RenderLayer::WORLD, RenderPass::OPAQUE, 2, 0, 1.0f ), 0 );
+    submit( queue, makeRenderKey( RenderLayer::WORLD, RenderPass::OPAQUE, 1, 0, 30.0f ), 1 );
+    submit( queue, makeRenderKey( RenderLayer::WORLD, RenderPass::OPAQUE, 1, 0, 2.0f ), 2 );
+    submit( queue, makeRenderKey( RenderLayer::WORLD, RenderPass::OPAQUE, 2, 0, 0.5f ), 3 );
+
+    const std::vector<u32> expected {2, 1, 3, 0};
+    REQUIRE( drawOrder( queue ) == expected );
+  }
+
+  SECTION( "Transparent packets are drawn back to front" ) {
+    submit( queue, makeRenderKey( RenderLayer::WORLD, RenderPass::TRANSPARENT, 1, 0, 1.0f ), 0 );
+    submit( queue, makeRenderKey( RenderLayer::WORLD, RenderPass::TRANSPARENT, 2, 0, 30.0f ), 1 );
+    submit( queue, makeRenderKey( RenderLayer::WORLD, RenderPass::TRANSPARENT, 1, 0, 2.0f ), 2 );
+
+    const std::vector<u32> expected {1, 2, 0};
+    REQUIRE( drawOrder( queue ) == expected );
+  }
+
+  SECTION( "Depth is measured along the view direction" ) {
+    queue.setView( glm::vec3( 0.0f, 0.0f, 10.0f ), glm::vec3( 0.0f, 0.0f, -1.0f ) );
+
+    REQUIRE( queue.viewDepth( glm::vec3( 3.0f, 4.0f, 0.0f ) ) == 10.0f );
+    REQUIRE( queue.viewDepth( glm::vec3( 0.0f, 0.0f, 20.0f ) ) == 0.0f );
+  }
+}
+
+TEST_CASE( "radixSort matches a stable sort", "[RenderQueue]" ) {
+
+  std::mt19937_64 rng( 1337 );
+  std::vector<SortItem> items( 10000 );
+  for ( u32 i = 0; i < items.size(); ++i ) {
+    // Few distinct keys, so that stability matters
+    items[ i ] = {rng() % 64 << 40 | rng() % 4, i};
+  }
+
+  auto expected = items;
+  std::stable_sort( expected.begin(), expected.end(),
+                    []( const auto &a, const auto &b ) { return a.key < b.key; } );
+
+  std::vector<SortItem> scratch;
+  nile::radixSort( items, scratch );
+
+  REQUIRE( items.size() == expected.size() );
+  for ( size_t i = 0; i < items.size(); ++i ) {
+    REQUIRE( items[ i ].key == expected[ i ].key );
+    REQUIRE( items[ i ].index == expected[ i ].index );
+  }
+}
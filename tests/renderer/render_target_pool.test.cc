@@ -0,0 +1,57 @@
+#include <Nile/renderer/render_target_pool.hh>
+#include <catch.hpp>
+
+using nile::RenderTargetPool;
+using nile::u32;
+
+TEST_CASE( "RenderTargetPool reuses the targets of a size", "[RenderTargetPool]" ) {
+
+  RenderTargetPool pool;
+
+  const auto &full = pool.acquire( 640, 480 );
+  REQUIRE( full.framebuffer != 0 );
+  REQUIRE( full.width == 640 );
+  REQUIRE( full.height == 480 );
+
+  const auto &scaled = pool.acquire( 320, 240 );
+  REQUIRE( scaled.framebuffer != full.framebuffer );
+
+  // Going back and forth between two scales doesn't allocate
+  for ( int i = 0; i < 10; ++i ) {
+    REQUIRE( pool.acquire( 640, 480 ).framebuffer == full.framebuffer );
+    REQUIRE( pool.acquire( 320, 240 ).framebuffer == scaled.framebuffer );
+  }
+  REQUIRE( pool.getStats().allocations == 2 );
+  REQUIRE( pool.getStats().targets == 2 );
+}
+
+TEST_CASE( "RenderTargetPool evicts the least recently used size", "[RenderTargetPool]" ) {
+
+  RenderTargetPool pool;
+
+  for ( u32 i = 1; i <= RenderTargetPool::CAPACITY; ++i )
+    pool.acquire( 100 * i, 100 * i );
+  // The first size is used again, the second one is the oldest now
+  pool.acquire( 100, 100 );
+
+  pool.acquire( 1000, 1000 );
+  REQUIRE( pool.getStats().targets == RenderTargetPool::CAPACITY );
+  REQUIRE( pool.getStats().releases == 1 );
+
+  const auto allocations = pool.getStats().allocations;
+  pool.acquire( 100, 100 );
+  REQUIRE( pool.getStats().allocations == allocations );
+  pool.acquire( 200, 200 );
+  REQUIRE( pool.getStats().allocations == allocations + 1 );
+}
+
+TEST_CASE( "RenderTargetPool releases every target on clear", "[RenderTargetPool]" ) {
+
+  RenderTargetPool pool;
+  pool.acquire( 640, 480 );
+  pool.acquire( 320, 240 );
+  pool.clear();
+
+  REQUIRE( pool.getStats().targets == 0 );
+  REQUIRE( pool.getStats().releases == 2 );
+}
@@ -0,0 +1,82 @@
+#include <Nile/renderer/resolution_scaler.hh>
+#include <catch.hpp>
+
+using nile::f32;
+using nile::ResolutionScaler;
+using nile::u32;
+
+namespace {
+
+  void feed( ResolutionScaler &scaler, f32 frameTime, u32 frames ) {
+    for ( u32 i = 0; i < frames; ++i )
+      scaler.update( frameTime );
+  }
+
+}    // namespace
+
+TEST_CASE( "ResolutionScaler without a budget keeps the full resolution", "[ResolutionScaler]" ) {
+
+  ResolutionScaler scaler;
+  feed( scaler, 100.0f, 100 );
+
+  REQUIRE( scaler.getScale() == 1.0f );
+  REQUIRE( scaler.getStats().decreases == 0 );
+}
+
+TEST_CASE( "ResolutionScaler drops the scale to fit the budget", "[ResolutionScaler]" ) {
+
+  ResolutionScaler scaler( 10.0f, 0.5f );
+
+  // Twice the budget, half the pixels fit: sqrt( 0.5 ) rounded down to a step
+  REQUIRE( scaler.update( 20.0f ) == Approx( 0.7f ) );
+  REQUIRE( scaler.getStats().decreases == 1 );
+
+  // The timings of the old scale are still coming in
+  feed( scaler, 20.0f, ResolutionScaler::SETTLE_FRAMES );
+  REQUIRE( scaler.getScale() == Approx( 0.7f ) );
+
+  // Never below the minimum scale
+  feed( scaler, 20.0f, 200 );
+  REQUIRE( scaler.getScale() == Approx( 0.5f ) );
+}
+
+TEST_CASE( "ResolutionScaler steps down at least once when over budget", "[ResolutionScaler]" ) {
+
+  ResolutionScaler scaler( 10.0f );
+  REQUIRE( scaler.update( 10.1f ) == Approx( 1.0f - ResolutionScaler::STEP ) );
+}
+
+TEST_CASE( "ResolutionScaler grows back one step at a time", "[ResolutionScaler]" ) {
+
+  ResolutionScaler scaler( 10.0f, 0.5f );
+  scaler.update( 40.0f );
+  REQUIRE( scaler.getScale() == Approx( 0.5f ) );
+
+  // Within budget but without headroom, the scale holds
+  feed( scaler, 9.0f, ResolutionScaler::SETTLE_FRAMES + 100 );
+  REQUIRE( scaler.getScale() == Approx( 0.5f ) );
+
+  for ( u32 i = 0; i < 100 && scaler.getStats().increases == 0; ++i )
+    scaler.update( 2.0f );
+  REQUIRE( scaler.getScale() == Approx( 0.5f + ResolutionScaler::STEP ) );
+
+  // Each step waits for the settle frames and GROW_FRAMES frames under budget
+  feed( scaler, 2.0f, ResolutionScaler::SETTLE_FRAMES + ResolutionScaler::GROW_FRAMES - 1 );
+  REQUIRE( scaler.getScale() == Approx( 0.5f + ResolutionScaler::STEP ) );
+  scaler.update( 2.0f );
+  REQUIRE( scaler.getScale() == Approx( 0.5f + 2.0f * ResolutionScaler::STEP ) );
+
+  // Back to the full resolution, and no further
+  feed( scaler, 2.0f, 1000 );
+  REQUIRE( scaler.getScale() == 1.0f );
+  REQUIRE( scaler.getStats().increases == 10 );
+}
+
+TEST_CASE( "ResolutionScaler ignores missing timings", "[ResolutionScaler]" ) {
+
+  ResolutionScaler scaler( 10.0f );
+  feed( scaler, 0.0f, 100 );
+
+  REQUIRE( scaler.getScale() == 1.0f );
+  REQUIRE( scaler.getStats().frameTime == 0.0f );
+}
@@ -0,0 +1,192 @@
+#include <Nile/ecs/components/transform.hh>
+#include <Nile/renderer/sprite_batch.hh>
+#include <catch.hpp>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+using nile::ShaderSet;
+using nile::SpriteBatch;
+using nile::Texture2D;
+using nile::Transform;
+
+namespace {
+
+  // SpriteBatch::end() only uses shaders and textures as grouping keys, it never
+  // dereferences them, so the tests can run without an OpenGL context
+  template <typename T>
+  T *fakeHandle( std::uintptr_t id ) {
+    return reinterpret_cast<T *>( id * 64 );
+  }
+
+}    // namespace
+
+TEST_CASE( "SpriteBatch groups sprites by shader and texture", "[SpriteBatch]" ) {
+
+  SpriteBatch batch;
+  auto *shader = fakeHandle<ShaderSet>( 1 );
+  Texture2D *textures[] = {fakeHandle<Texture2D>( 2 ), fakeHandle<Texture2D>( 3 ),
+                           fakeHandle<Texture2D>( 4 )};
+
+  batch.begin();
+  for ( int i = 0; i < 1000; ++i )
+    batch.submit( shader, textures[ i % 3 ], Transform {}, glm::vec3( 1.0f ), true );
+  batch.end();
+
+  SECTION( "One draw call per texture" ) {
+    REQUIRE( batch.getStats().sprites == 1000 );
+    REQUIRE( batch.getStats().batches == 3 );
+    REQUIRE( batch.getStats().drawCalls == 3 );
+    REQUIRE( batch.getVertices().size() == 4000 );
+  }
+
+  SECTION( "Counters are reset every frame" ) {
+    batch.begin();
+    batch.submit( shader, textures[ 0 ], Transform {}, glm::vec3( 1.0f ), true );
+    batch.submit( fakeHandle<ShaderSet>( 5 ), textures[ 0 ], Transform {}, glm::vec3( 1.0f ),
+                  true );
+    batch.submit( shader, textures[ 0 ], Transform {}, glm::vec3( 1.0f ), false );
+    batch.end();
+
+    REQUIRE( batch.getStats().sprites == 3 );
+    REQUIRE( batch.getStats().drawCalls == 3 );
+  }
+}
+
+TEST_CASE( "SpriteBatch pre-transforms the quads", "[SpriteBatch]" ) {
+
+  SpriteBatch batch;
+  auto *shader = fakeHandle<ShaderSet>( 1 );
+  auto *texture = fakeHandle<Texture2D>( 2 );
+
+  Transform transform( glm::vec3( 2.0f, 3.0f, -1.0f ), glm::vec3( 4.0f, 2.0f, 1.0f ), 30.0f,
+                       45.0f, 60.0f );
+
+  batch.begin();
+  batch.submit( shader, texture, transform, glm::vec3( 1.0f ), true );
+  batch.end();
+
+  // The model matrix the sprite renderer used to upload per sprite
+  glm::mat4 model = glm::translate( glm::mat4( 1.0f ), transform.position );
+  model = glm::rotate( model, glm::radians( transform.xRotation ), glm::vec3( 1.0f, 0.0f, 0.0f ) );
+  model = glm::rotate( model, glm::radians( transform.yRotation ), glm::vec3( 0.0f, 1.0f, 0.0f ) );
+  model = glm::rotate( model, glm::radians( transform.zRotation ), glm::vec3( 0.0f, 0.0f, 1.0f ) );
+  model = glm::scale( model, glm::vec3( transform.scale.x, transform.scale.y, 1.0f ) );
+
+  for ( const auto &vertex : batch.getVertices() ) {
+    const auto expected = glm::vec3( model * glm::vec4( vertex.uv, 0.0f, 1.0f ) );
+    REQUIRE( glm::length( vertex.position - expected ) < 1e-4f );
+  }
+}
+
+TEST_CASE( "SpriteBatch draws opaque sprites first", "[SpriteBatch]" ) {
+
+  SpriteBatch batch;
+  auto *shader = fakeHandle<ShaderSet>( 1 );
+  auto *texture = fakeHandle<Texture2D>( 2 );
+
+  Transform blended;
+  blended.position = glm::vec3( 10.0f );
+  Transform opaque;
+  opaque.position = glm::vec3( 20.0f );
+
+  batch.begin();
+  batch.submit( shader, texture, blended, glm::vec3( 1.0f ), true );
+  batch.submit( shader, texture, opaque, glm::vec3( 1.0f ), false );
+  batch.end();
+
+  REQUIRE( batch.getStats().drawCalls == 2 );
+  REQUIRE( batch.getVertices().front().position == opaque.position );
+}
+
+TEST_CASE( "SpriteBatch orders sprites by depth", "[SpriteBatch]" ) {
+
+  SpriteBatch batch;
+  auto *shader = fakeHandle<ShaderSet>( 1 );
+  Texture2D *textures[] = {fakeHandle<Texture2D>( 2 ), fakeHandle<Texture2D>( 3 )};
+
+  // Camera at the origin looking down -z, sprites further away have a lower z
+  batch.setView( glm::vec3( 0.0f ), glm::vec3( 0.0f, 0.0f, -1.0f ) );
+
+  auto submitRow = [&]( bool blend ) {
+    batch.begin();
+    for ( int i = 0; i < 4; ++i ) {
+      Transform transform;
+      transform.position = glm::vec3( 0.0f, 0.0f, -1.0f - i );
+      batch.submit( shader, textures[ i % 2 ], transform, glm::vec3( 1.0f ), blend );
+    }
+    batch.end();
+  };
+
+  SECTION( "Blended sprites are drawn back to front" ) {
+    submitRow( true );
+
+    // Alternating textures can't be merged without breaking the order
+    REQUIRE( batch.getStats().drawCalls == 4 );
+    REQUIRE( batch.getVertices().front().position.z == -4.0f );
+    REQUIRE( batch.getVertices().back().position.z == -1.0f );
+  }
+
+  SECTION( "Opaque sprites are grouped by texture, then drawn front to back" ) {
+    submitRow( false );
+
+    REQUIRE( batch.getStats().drawCalls == 2 );
+    REQUIRE( batch.getVertices()[ 0 ].position.z == -1.0f );
+    REQUIRE( batch.getVertices()[ 4 ].position.z == -3.0f );
+  }
+}
+
+TEST_CASE( "SpriteBatch culls sprites outside of the frustum", "[SpriteBatch]" ) {
+
+  SpriteBatch batch;
+  auto *shader = fakeHandle<ShaderSet>( 1 );
+  auto *texture = fakeHandle<Texture2D>( 2 );
+
+  // Sees x and y in [ 0, 100 ]
+  batch.setFrustum(
+      nile::Frustum::fromMatrix( glm::ortho( 0.0f, 100.0f, 0.0f, 100.0f, -1.0f, 1.0f ) ) );
+
+  Transform inside;
+  inside.position = glm::vec3( 10.0f, 10.0f, 0.0f );
+  Transform outside;
+  outside.position = glm::vec3( 200.0f, 10.0f, 0.0f );
+  // The quad spans [ -5, 5 ], only half of it is visible
+  Transform straddling;
+  straddling.position = glm::vec3( -5.0f, 10.0f, 0.0f );
+  straddling.scale = glm::vec3( 10.0f );
+
+  batch.begin();
+  batch.submit( shader, texture, inside, glm::vec3( 1.0f ), false );
+  batch.submit( shader, texture, outside, glm::vec3( 1.0f ), false );
+  batch.submit( shader, texture, straddling, glm::vec3( 1.0f ), false );
+  batch.end();
+
+  REQUIRE( batch.getStats().sprites == 3 );
+  REQUIRE( batch.getStats().culled == 1 );
+  REQUIRE( batch.getVertices().size() == 8 );
+}
+
+TEST_CASE( "SpriteBatch maps the quad corners to the uv region", "[SpriteBatch]" ) {
+
+  SpriteBatch batch;
+  auto *shader = fakeHandle<ShaderSet>( 1 );
+  auto *page = fakeHandle<Texture2D>( 2 );
+
+  // Two regions of the same atlas page
+  batch.begin();
+  batch.submit( shader, page, Transform {}, glm::vec3( 1.0f ), false, glm::vec2( 0.0f ),
+                glm::vec2( 0.5f ) );
+  batch.submit( shader, page, Transform {}, glm::vec3( 1.0f ), false, glm::vec2( 0.5f, 0.25f ),
+                glm::vec2( 1.0f, 0.75f ) );
+  batch.end();
+
+  REQUIRE( batch.getStats().drawCalls == 1 );
+
+  glm::vec2 lower( 1.0f );
+  glm::vec2 upper( 0.0f );
+  for ( const auto &vertex : batch.getVertices() ) {
+    lower = glm::min( lower, vertex.uv );
+    upper = glm::max( upper, vertex.uv );
+  }
+  REQUIRE( lower == glm::vec2( 0.0f ) );
+  REQUIRE( upper == glm::vec2( 1.0f, 0.75f ) );
+}
@@ -0,0 +1,119 @@
+#include <Nile/renderer/glyph_atlas.hh>
+#include <Nile/renderer/text_batch.hh>
+#include <catch.hpp>
+#include <glm/glm.hpp>
+#include <string>
+#include <vector>
+
+using nile::GlyphAtlas;
+using nile::TextBatch;
+using nile::f32;
+using nile::u32;
+using nile::u8;
+
+namespace {
+
+  // Every printable glyph is 4x6 pixels and advances the pen by 5 pixels,
+  // the atlas is never uploaded
+  void fillAtlas( GlyphAtlas &atlas ) {
+    const std::vector<u8> pixels( 4 * 6, 255 );
+    for ( u32 c = 33; c < 127; ++c )
+      atlas.addGlyph( c, 4, 6, 4, pixels.data(), glm::ivec2( 0, 6 ), 5 << 6 );
+    atlas.addGlyph( ' ', 0, 0, 0, nullptr, glm::ivec2( 0 ), 5 << 6 );
+    atlas.setAscent( 6 );
+  }
+
+  const glm::vec3 WHITE( 1.0f );
+
+  void frame( TextBatch &batch, const GlyphAtlas *atlas, const std::string &text,
+              const glm::vec3 &position ) {
+    batch.begin();
+    batch.submit( 1, atlas, text, position, glm::vec3( 1.0f ), WHITE );
+    batch.end();
+  }
+
+}    // namespace
+
+TEST_CASE( "Text is laid out into one quad per visible glyph", "[TextBatch]" ) {
+
+  GlyphAtlas atlas( 128, 8 );
+  fillAtlas( atlas );
+
+  TextBatch batch;
+  batch.begin();
+  const auto extents =
+      batch.submit( 1, &atlas, "ab c", glm::vec3( 10.0f, 20.0f, 0.0f ), glm::vec3( 2.0f ), WHITE );
+  batch.end();
+
+  // Space only moves the pen
+  REQUIRE( batch.getStats().glyphs == 3 );
+  REQUIRE( batch.getVertices().size() == 12 );
+  REQUIRE( extents.x == Approx( 4 * 5 * 2.0f ) );
+  REQUIRE( extents.y == Approx( 6 * 2.0f ) );
+
+  // Top-left corner of the first and the last glyph
+  const auto &vertices = batch.getVertices();
+  REQUIRE( vertices[ 0 ].position == glm::vec2( 10.0f, 20.0f ) );
+  REQUIRE( vertices[ 8 ].position == glm::vec2( 10.0f + 3 * 5 * 2.0f, 20.0f ) );
+  REQUIRE( vertices[ 2 ].position == glm::vec2( 10.0f + 4 * 2.0f, 20.0f + 6 * 2.0f ) );
+}
+
+TEST_CASE( "Unchanged text is not laid out again", "[TextBatch]" ) {
+
+  GlyphAtlas atlas( 128, 8 );
+  fillAtlas( atlas );
+
+  TextBatch batch;
+  frame( batch, &atlas, "fps: 60", glm::vec3( 0.0f ) );
+  REQUIRE( batch.getStats().rebuilt == 1 );
+
+  frame( batch, &atlas, "fps: 60", glm::vec3( 0.0f ) );
+  REQUIRE( batch.getStats().rebuilt == 0 );
+  REQUIRE( batch.getStats().glyphs == 6 );
+
+  SECTION( "Changing the string lays the text out again" ) {
+    frame( batch, &atlas, "fps: 59", glm::vec3( 0.0f ) );
+    REQUIRE( batch.getStats().rebuilt == 1 );
+  }
+
+  SECTION( "Moving the text lays the text out again" ) {
+    frame( batch, &atlas, "fps: 60", glm::vec3( 1.0f, 0.0f, 0.0f ) );
+    REQUIRE( batch.getStats().rebuilt == 1 );
+    REQUIRE( batch.getVertices()[ 0 ].position.x == Approx( 1.0f ) );
+  }
+}
+
+TEST_CASE( "Texts are grouped by atlas", "[TextBatch]" ) {
+
+  GlyphAtlas small( 128, 8 );
+  GlyphAtlas large( 128, 16 );
+  fillAtlas( small );
+  fillAtlas( large );
+
+  TextBatch batch;
+  batch.begin();
+  batch.submit( 1, &small, "aa", glm::vec3( 0.0f ), glm::vec3( 1.0f ), WHITE );
+  batch.submit( 2, &large, "bbb", glm::vec3( 0.0f ), glm::vec3( 1.0f ), WHITE );
+  batch.submit( 3, &small, "cccc", glm::vec3( 0.0f ), glm::vec3( 1.0f ), WHITE );
+  batch.end();
+
+  REQUIRE( batch.getStats().texts == 3 );
+  REQUIRE( batch.getStats().batches == 2 );
+  REQUIRE( batch.getStats().glyphs == 9 );
+
+  // Texts of the first atlas come first, in submission order
+  const auto &vertices = batch.getVertices();
+  REQUIRE( vertices.size() == 36 );
+  REQUIRE( vertices[ 2 * 4 ].position.x == Approx( 0.0f ) );
+  REQUIRE( vertices[ 3 * 4 ].position.x == Approx( 5.0f ) );
+
+  SECTION( "Texts that are not submitted are dropped" ) {
+    batch.begin();
+    batch.submit( 2, &large, "bbb", glm::vec3( 0.0f ), glm::vec3( 1.0f ), WHITE );
+    batch.end();
+
+    REQUIRE( batch.getStats().rebuilt == 0 );
+    REQUIRE( batch.getStats().batches == 1 );
+    REQUIRE( batch.getStats().glyphs == 3 );
+  }
+}
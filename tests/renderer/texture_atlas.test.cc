@@ -0,0 +1,102 @@
+#include <Nile/renderer/texture2d.hh>
+#include <Nile/renderer/texture_atlas.hh>
+#include <catch.hpp>
+
+#include <string>
+#include <vector>
+
+using nile::AtlasPlacement;
+using nile::TextureAtlas;
+using nile::u32;
+using nile::u8;
+
+namespace {
+
+  std::vector<u8> image( u32 width, u32 height ) {
+    return std::vector<u8>( width * height * 4, 255 );
+  }
+
+  bool overlap( const AtlasPlacement &a, const AtlasPlacement &b ) {
+    // Padding included, the extruded edges of two images must not overlap either
+    const u32 p = TextureAtlas::PADDING;
+    return a.page == b.page && a.x - p < b.x + b.width + p && b.x - p < a.x + a.width + p &&
+           a.y - p < b.y + b.height + p && b.y - p < a.y + a.height + p;
+  }
+
+}    // namespace
+
+TEST_CASE( "TextureAtlas packs small images into one page", "[TextureAtlas]" ) {
+
+  TextureAtlas atlas;
+  std::vector<std::string> names;
+  for ( u32 i = 0; i < 64; ++i ) {
+    const u32 width = 8 + i % 7 * 4;
+    const u32 height = 8 + i % 5 * 6;
+    names.push_back( "sprite" + std::to_string( i ) );
+    REQUIRE( atlas.add( names.back(), image( width, height ).data(), width, height ) );
+  }
+  atlas.build();
+
+  REQUIRE( atlas.getStats().images == 64 );
+  REQUIRE( atlas.getStats().pages == 1 );
+  // No larger than needed
+  REQUIRE( atlas.getPages()[ 0 ]->getWidth() <= 512 );
+  REQUIRE( atlas.getStats().occupancy > 0.25f );
+
+  const auto size = atlas.getPages()[ 0 ]->getWidth();
+  for ( u32 i = 0; i < names.size(); ++i ) {
+    const auto *a = atlas.getPlacement( names[ i ] );
+    REQUIRE( a != nullptr );
+    REQUIRE( a->x >= TextureAtlas::PADDING );
+    REQUIRE( a->y >= TextureAtlas::PADDING );
+    REQUIRE( a->x + a->width + TextureAtlas::PADDING <= size );
+    REQUIRE( a->y + a->height + TextureAtlas::PADDING <= size );
+    for ( u32 j = i + 1; j < names.size(); ++j )
+      REQUIRE_FALSE( overlap( *a, *atlas.getPlacement( names[ j ] ) ) );
+  }
+}
+
+TEST_CASE( "TextureAtlas regions are the placements in uvs", "[TextureAtlas]" ) {
+
+  TextureAtlas atlas;
+  atlas.add( "grass", image( 30, 20 ).data(), 30, 20 );
+  atlas.add( "window", image( 16, 16 ).data(), 16, 16 );
+
+  // Not packed yet
+  REQUIRE( atlas.getRegion( "grass" ) == nullptr );
+  atlas.build();
+
+  const auto *grass = atlas.getRegion( "grass" );
+  const auto *window = atlas.getRegion( "window" );
+  REQUIRE( grass != nullptr );
+  REQUIRE( window != nullptr );
+  REQUIRE( atlas.getRegion( "torch" ) == nullptr );
+
+  // Same page, the sprites can be drawn together
+  REQUIRE( grass->texture == window->texture );
+
+  const auto *placement = atlas.getPlacement( "grass" );
+  const auto size = static_cast<float>( grass->texture->getWidth() );
+  REQUIRE( grass->uvMin.x == Approx( placement->x / size ) );
+  REQUIRE( grass->uvMin.y == Approx( placement->y / size ) );
+  REQUIRE( ( grass->uvMax.x - grass->uvMin.x ) * size == Approx( 30.0f ) );
+  REQUIRE( ( grass->uvMax.y - grass->uvMin.y ) * size == Approx( 20.0f ) );
+}
+
+TEST_CASE( "TextureAtlas starts a new page when one is full", "[TextureAtlas]" ) {
+
+  TextureAtlas atlas( 128 );
+  for ( u32 i = 0; i < 8; ++i )
+    REQUIRE( atlas.add( std::to_string( i ), image( 56, 56 ).data(), 56, 56 ) );
+
+  // Larger than a page, and a name that is taken
+  REQUIRE_FALSE( atlas.add( "large", image( 128, 8 ).data(), 128, 8 ) );
+  REQUIRE_FALSE( atlas.add( "0", image( 8, 8 ).data(), 8, 8 ) );
+
+  atlas.build();
+
+  // Four 64x64 padded images per 128 page
+  REQUIRE( atlas.getStats().images == 8 );
+  REQUIRE( atlas.getStats().pages == 2 );
+  REQUIRE( atlas.getStats().occupancy == Approx( 1.0f ) );
+}
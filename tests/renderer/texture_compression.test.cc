@@ -0,0 +1,275 @@
+#include <Nile/renderer/texture_compression.hh>
+#include <catch.hpp>
+
+#include <cstring>
+#include <vector>
+
+using nile::CompressedFormat;
+using nile::CompressedImage;
+using nile::u32;
+using nile::u64;
+using nile::u8;
+namespace TextureCompression = nile::TextureCompression;
+
+namespace {
+
+  void writeU32( std::vector<u8> &data, size_t offset, u32 value ) {
+    for ( u32 i = 0; i < 4; ++i )
+      data[ offset + i ] = static_cast<u8>( value >> ( 8 * i ) );
+  }
+
+  std::vector<u8> dds( const char *fourCC, u32 width, u32 height, u32 levels, u32 dxgi,
+                       size_t payload ) {
+    const size_t header = std::strcmp( fourCC, "DX10" ) == 0 ? 148 : 128;
+    std::vector<u8> data( header + payload );
+    std::memcpy( data.data(), "DDS ", 4 );
+    writeU32( data, 4, 124 );
+    writeU32( data, 12, height );
+    writeU32( data, 16, width );
+    writeU32( data, 28, levels );
+    std::memcpy( data.data() + 84, fourCC, 4 );
+    if ( header == 148 )
+      writeU32( data, 128, dxgi );
+    for ( size_t i = 0; i < payload; ++i )
+      data[ header + i ] = static_cast<u8>( i );
+    return data;
+  }
+
+  // Writes the bits of a BC7 block from the lowest
+  struct BitWriter {
+    u8 block[ 16 ] = {};
+    u32 position = 0;
+
+    void write( u32 value, u32 count ) {
+      for ( u32 i = 0; i < count; ++i, ++position )
+        block[ position / 8 ] |= static_cast<u8>( ( value >> i & 1 ) << ( position % 8 ) );
+    }
+  };
+
+  const u8 *texel( const u8 *rgba, u32 x, u32 y ) {
+    return rgba + ( y * 4 + x ) * 4;
+  }
+
+}    // namespace
+
+TEST_CASE( "TextureCompression reads the levels of a DDS file", "[TextureCompression]" ) {
+
+  // 8x8 DXT1, 2x2 blocks, then one block for 4x4, 2x2 and 1x1
+  const auto data = dds( "DXT1", 8, 8, 4, 0, 32 + 8 + 8 + 8 );
+  CompressedImage image;
+  REQUIRE( TextureCompression::parse( data.data(), data.size(), image ) );
+
+  REQUIRE( image.format == CompressedFormat::BC1 );
+  REQUIRE( image.levels.size() == 4 );
+  REQUIRE( image.levels[ 0 ].width == 8 );
+  REQUIRE( image.levels[ 0 ].size == 32 );
+  REQUIRE( image.levels[ 1 ].offset == 32 );
+  REQUIRE( image.levels[ 3 ].width == 1 );
+  REQUIRE( image.levels[ 3 ].size == 8 );
+  REQUIRE( image.data.size() == 56 );
+  REQUIRE( std::memcmp( image.data.data(), data.data() + 128, 56 ) == 0 );
+
+  // The DX10 header names BC7 by its DXGI format
+  const auto bc7 = dds( "DX10", 4, 4, 1, 98, 16 );
+  REQUIRE( TextureCompression::parse( bc7.data(), bc7.size(), image ) );
+  REQUIRE( image.format == CompressedFormat::BC7 );
+  REQUIRE( image.levels.size() == 1 );
+  REQUIRE( image.data[ 0 ] == 0 );
+}
+
+TEST_CASE( "TextureCompression keeps the levels a truncated file has", "[TextureCompression]" ) {
+
+  // Four levels announced, the last one is missing
+  const auto data = dds( "DXT5", 8, 8, 4, 0, 64 + 16 + 16 );
+  CompressedImage image;
+  REQUIRE( TextureCompression::parse( data.data(), data.size(), image ) );
+  REQUIRE( image.format == CompressedFormat::BC3 );
+  REQUIRE( image.levels.size() == 3 );
+
+  const auto unknown = dds( "DXT3", 4, 4, 1, 0, 16 );
+  REQUIRE_FALSE( TextureCompression::parse( unknown.data(), unknown.size(), image ) );
+  REQUIRE( image.levels.empty() );
+
+  const u8 garbage[ 8 ] = {1, 2, 3, 4, 5, 6, 7, 8};
+  REQUIRE_FALSE( TextureCompression::parse( garbage, sizeof( garbage ), image ) );
+}
+
+TEST_CASE( "TextureCompression rejects headers with invalid sizes", "[TextureCompression]" ) {
+
+  CompressedImage image;
+
+  // The block count of 0xFFFFFFFE used to wrap to 0, a 0 byte level was accepted
+  const auto wrapped = dds( "DXT1", 0xFFFFFFFE, 4, 1, 0, 8 );
+  REQUIRE_FALSE( TextureCompression::parse( wrapped.data(), wrapped.size(), image ) );
+  REQUIRE( image.levels.empty() );
+
+  const auto large = dds( "DXT1", TextureCompression::MAX_DIMENSION + 4, 4, 1, 0, 8 );
+  REQUIRE_FALSE( TextureCompression::parse( large.data(), large.size(), image ) );
+
+  const auto empty = dds( "DXT1", 4, 0, 1, 0, 8 );
+  REQUIRE_FALSE( TextureCompression::parse( empty.data(), empty.size(), image ) );
+
+  // The largest size is fine, as long as the file has the data
+  const auto largest = dds( "DXT1", TextureCompression::MAX_DIMENSION, 4, 1, 0, 8 );
+  REQUIRE_FALSE( TextureCompression::parse( largest.data(), largest.size(), image ) );
+  const auto full =
+      dds( "DXT1", TextureCompression::MAX_DIMENSION, 4, 1, 0,
+           TextureCompression::MAX_DIMENSION / TextureCompression::BLOCK_SIZE * 8 );
+  REQUIRE( TextureCompression::parse( full.data(), full.size(), image ) );
+  REQUIRE( image.levels[ 0 ].size == full.size() - 128 );
+}
+
+TEST_CASE( "TextureCompression reads the levels of a KTX file", "[TextureCompression]" ) {
+
+  // 8x4 ETC2 RGBA with two levels and some key / value data
+  const u8 identifier[ 12 ] = {0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', 0x1A, '\n'};
+  std::vector<u8> data( 64 + 8 + 4 + 32 + 4 + 16 );
+  std::memcpy( data.data(), identifier, 12 );
+  writeU32( data, 12, 0x04030201 );
+  writeU32( data, 28, 0x9278 );    // GL_COMPRESSED_RGBA8_ETC2_EAC
+  writeU32( data, 36, 8 );
+  writeU32( data, 40, 4 );
+  writeU32( data, 56, 2 );
+  writeU32( data, 60, 8 );
+  writeU32( data, 72, 32 );
+  data[ 76 ] = 0xEE;
+  writeU32( data, 108, 16 );
+  data[ 112 ] = 0xDD;
+
+  CompressedImage image;
+  REQUIRE( TextureCompression::parse( data.data(), data.size(), image ) );
+  REQUIRE( image.format == CompressedFormat::ETC2_RGBA );
+  REQUIRE( image.levels.size() == 2 );
+  REQUIRE( image.levels[ 0 ].width == 8 );
+  REQUIRE( image.levels[ 0 ].height == 4 );
+  REQUIRE( image.levels[ 1 ].width == 4 );
+  REQUIRE( image.levels[ 1 ].offset == 32 );
+  REQUIRE( image.data[ 0 ] == 0xEE );
+  REQUIRE( image.data[ 32 ] == 0xDD );
+
+  REQUIRE( TextureCompression::isContainer( "textures/stone.KTX" ) );
+  REQUIRE( TextureCompression::isContainer( "stone_normal.dds" ) );
+  REQUIRE_FALSE( TextureCompression::isContainer( "stone.png" ) );
+}
+
+TEST_CASE( "TextureCompression decodes BC1 and BC3 blocks", "[TextureCompression]" ) {
+
+  // Red and blue, with the two colors between them
+  const u8 bc1[ 8 ] = {0x00, 0xF8, 0x1F, 0x00, 0xE4, 0, 0, 0};
+  u8 rgba[ 64 ];
+  TextureCompression::decodeBlock( CompressedFormat::BC1, bc1, rgba );
+  REQUIRE( texel( rgba, 0, 0 )[ 0 ] == 255 );
+  REQUIRE( texel( rgba, 1, 0 )[ 2 ] == 255 );
+  REQUIRE( texel( rgba, 2, 0 )[ 0 ] == 170 );
+  REQUIRE( texel( rgba, 2, 0 )[ 2 ] == 85 );
+  REQUIRE( texel( rgba, 3, 0 )[ 0 ] == 85 );
+  REQUIRE( texel( rgba, 3, 0 )[ 2 ] == 170 );
+  REQUIRE( texel( rgba, 3, 0 )[ 3 ] == 255 );
+
+  // The colors swapped, the fourth entry is transparent black
+  const u8 punchThrough[ 8 ] = {0x1F, 0x00, 0x00, 0xF8, 0xE4, 0, 0, 0};
+  TextureCompression::decodeBlock( CompressedFormat::BC1, punchThrough, rgba );
+  REQUIRE( texel( rgba, 2, 0 )[ 0 ] == 128 );
+  REQUIRE( texel( rgba, 3, 0 )[ 0 ] == 0 );
+  REQUIRE( texel( rgba, 3, 0 )[ 3 ] == 0 );
+
+  // BC3 alpha of 255 and 0, the first texel interpolated
+  u8 bc3[ 16 ] = {255, 0, 2, 0, 0, 0, 0, 0};
+  std::memcpy( bc3 + 8, punchThrough, 8 );
+  TextureCompression::decodeBlock( CompressedFormat::BC3, bc3, rgba );
+  REQUIRE( texel( rgba, 0, 0 )[ 3 ] == 219 );
+  REQUIRE( texel( rgba, 1, 0 )[ 3 ] == 255 );
+  // BC3 colors always have four entries
+  REQUIRE( texel( rgba, 3, 0 )[ 0 ] == 170 );
+  REQUIRE( texel( rgba, 3, 0 )[ 3 ] == 255 );
+}
+
+TEST_CASE( "TextureCompression decodes BC5 to red and green", "[TextureCompression]" ) {
+
+  const u8 bc5[ 16 ] = {200, 10, 0, 0, 0, 0, 0, 0, 10, 200, 0, 0, 0, 0, 0, 0};
+  u8 rgba[ 64 ];
+  TextureCompression::decodeBlock( CompressedFormat::BC5, bc5, rgba );
+  for ( u32 i = 0; i < 16; ++i ) {
+    REQUIRE( rgba[ i * 4 + 0 ] == 200 );
+    REQUIRE( rgba[ i * 4 + 1 ] == 10 );
+    REQUIRE( rgba[ i * 4 + 2 ] == 0 );
+    REQUIRE( rgba[ i * 4 + 3 ] == 255 );
+  }
+}
+
+TEST_CASE( "TextureCompression decodes BC7 blocks", "[TextureCompression]" ) {
+
+  // Mode 6, white to transparent black with 4 bit indices
+  BitWriter bits;
+  bits.write( 1 << 6, 7 );
+  for ( u32 channel = 0; channel < 4; ++channel ) {
+    bits.write( 127, 7 );
+    bits.write( 0, 7 );
+  }
+  bits.write( 1, 1 );
+  bits.write( 0, 1 );
+  bits.write( 0, 3 );
+  bits.write( 8, 4 );
+  bits.write( 15, 4 );
+
+  u8 rgba[ 64 ];
+  TextureCompression::decodeBlock( CompressedFormat::BC7, bits.block, rgba );
+  REQUIRE( texel( rgba, 0, 0 )[ 0 ] == 255 );
+  REQUIRE( texel( rgba, 0, 0 )[ 3 ] == 255 );
+  REQUIRE( texel( rgba, 1, 0 )[ 1 ] == 120 );
+  REQUIRE( texel( rgba, 2, 0 )[ 2 ] == 0 );
+  REQUIRE( texel( rgba, 2, 0 )[ 3 ] == 0 );
+  REQUIRE( texel( rgba, 3, 3 )[ 0 ] == 255 );
+
+  // The reserved mode is transparent black
+  const u8 reserved[ 16 ] = {0, 0xFF, 0xFF, 0xFF};
+  TextureCompression::decodeBlock( CompressedFormat::BC7, reserved, rgba );
+  for ( u32 i = 0; i < 64; ++i )
+    REQUIRE( rgba[ i ] == 0 );
+}
+
+TEST_CASE( "TextureCompression decodes ETC2 and EAC blocks", "[TextureCompression]" ) {
+
+  // Individual mode, 0x88 and 0x44 halves side by side, the first table, all indices +2
+  const u8 etc[ 8 ] = {0x84, 0x84, 0x84, 0x00, 0, 0, 0, 0};
+  u8 rgba[ 64 ];
+  TextureCompression::decodeBlock( CompressedFormat::ETC2_RGB, etc, rgba );
+  REQUIRE( texel( rgba, 0, 3 )[ 0 ] == 0x88 + 2 );
+  REQUIRE( texel( rgba, 1, 0 )[ 1 ] == 0x88 + 2 );
+  REQUIRE( texel( rgba, 2, 0 )[ 2 ] == 0x44 + 2 );
+  REQUIRE( texel( rgba, 3, 3 )[ 3 ] == 255 );
+
+  // Flipped, the halves are on top of each other, every index -8
+  const u8 flipped[ 8 ] = {0x84, 0x84, 0x84, 0x01, 0xFF, 0xFF, 0xFF, 0xFF};
+  TextureCompression::decodeBlock( CompressedFormat::ETC2_RGB, flipped, rgba );
+  REQUIRE( texel( rgba, 3, 1 )[ 0 ] == 0x88 - 8 );
+  REQUIRE( texel( rgba, 0, 2 )[ 0 ] == 0x44 - 8 );
+
+  // EAC alpha 100, multiplier 2, the first table at index 4 ( +2 ) for every texel
+  u8 eac[ 16 ] = {100, 0x20};
+  u64 indices = 0;
+  for ( u32 i = 0; i < 16; ++i )
+    indices = indices << 3 | 4;
+  for ( u32 i = 0; i < 6; ++i )
+    eac[ 2 + i ] = static_cast<u8>( indices >> ( 40 - 8 * i ) );
+  std::memcpy( eac + 8, etc, 8 );
+  TextureCompression::decodeBlock( CompressedFormat::ETC2_RGBA, eac, rgba );
+  REQUIRE( texel( rgba, 0, 0 )[ 3 ] == 104 );
+  REQUIRE( texel( rgba, 3, 2 )[ 3 ] == 104 );
+  REQUIRE( texel( rgba, 0, 0 )[ 0 ] == 0x88 + 2 );
+}
+
+TEST_CASE( "TextureCompression decodes levels smaller than a block", "[TextureCompression]" ) {
+
+  CompressedImage image;
+  image.format = CompressedFormat::BC1;
+  image.data = {0x00, 0xF8, 0x1F, 0x00, 0x44, 0x44, 0x44, 0x44};
+  image.levels.push_back( {2, 2, 0, 8} );
+
+  u8 rgba[ 2 * 2 * 4 ];
+  TextureCompression::decode( image, 0, rgba );
+  REQUIRE( rgba[ 0 ] == 255 );
+  REQUIRE( rgba[ 4 ] == 0 );
+  REQUIRE( rgba[ 6 ] == 255 );
+  REQUIRE( rgba[ 8 ] == 255 );
+}
@@ -0,0 +1,107 @@
+#include <Nile/math/bounds.hh>
+#include <Nile/renderer/vertex_format.hh>
+#include <catch.hpp>
+#include <glm/glm.hpp>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using nile::AABB;
+using nile::f32;
+using nile::u32;
+using nile::Vertex;
+
+namespace {
+
+  std::vector<Vertex> randomVertices( u32 count, const glm::vec3 &min, const glm::vec3 &max ) {
+    std::mt19937 random( 7 );
+    std::uniform_real_distribution<f32> unit( 0.0f, 1.0f );
+    std::uniform_real_distribution<f32> signedUnit( -1.0f, 1.0f );
+
+    std::vector<Vertex> vertices( count );
+    for ( auto &vertex : vertices ) {
+      vertex.position = min + glm::vec3( unit( random ), unit( random ), unit( random ) ) *
+                                  ( max - min );
+      vertex.normal = glm::normalize(
+          glm::vec3( signedUnit( random ), signedUnit( random ), signedUnit( random ) ) + 0.01f );
+      vertex.uv = glm::vec2( unit( random ), unit( random ) );
+    }
+    return vertices;
+  }
+
+}    // namespace
+
+TEST_CASE( "Quantization box is a cube over the bounds", "[VertexFormat]" ) {
+
+  AABB bounds;
+  bounds.expand( glm::vec3( -1.0f, 2.0f, 0.0f ) );
+  bounds.expand( glm::vec3( 3.0f, 3.0f, 0.0f ) );
+
+  const auto quantization = nile::Math::computeQuantization( bounds );
+  REQUIRE( quantization.offset == glm::vec3( -1.0f, 2.0f, 0.0f ) );
+  REQUIRE( quantization.scale == 4.0f );
+
+  // The dequantize matrix maps the normalized corners back onto the box
+  const auto matrix = quantization.dequantizeMatrix();
+  REQUIRE( glm::vec3( matrix * glm::vec4( 0.0f, 0.0f, 0.0f, 1.0f ) ) == bounds.min );
+  REQUIRE( glm::vec3( matrix * glm::vec4( 1.0f, 0.25f, 0.0f, 1.0f ) ) == bounds.max );
+
+  // A single point still gets an invertible matrix
+  AABB point;
+  point.expand( glm::vec3( 5.0f ) );
+  REQUIRE( nile::Math::computeQuantization( point ).scale == 1.0f );
+}
+
+TEST_CASE( "Packed vertices stay within the error bounds", "[VertexFormat]" ) {
+
+  const auto vertices =
+      randomVertices( 1000, glm::vec3( -50.0f ), glm::vec3( 50.0f, 10.0f, 20.0f ) );
+  const auto bounds = nile::Math::computeBounds( vertices );
+  const auto quantization = nile::Math::computeQuantization( bounds );
+
+  std::vector<nile::PackedVertex> packed;
+  const auto error = nile::Math::packVertices( vertices, quantization, packed );
+
+  REQUIRE( packed.size() == vertices.size() );
+
+  // Half a step of 16 bits along every axis
+  REQUIRE( error.position > 0.0f );
+  REQUIRE( error.position <= quantization.scale / 65535.0f * 0.5f * std::sqrt( 3.0f ) * 1.01f );
+  // 10 bits per component are within a fraction of a degree
+  REQUIRE( error.normal < 0.25f );
+  // Half floats below one have at least 11 bits of precision
+  REQUIRE( error.uv <= 1.0f / 4096.0f );
+
+  for ( u32 i = 0; i < vertices.size(); ++i ) {
+    const auto decoded = nile::Math::unpackVertex( packed[ i ], quantization );
+    REQUIRE( glm::length( decoded.position - vertices[ i ].position ) <= error.position );
+  }
+}
+
+TEST_CASE( "Packed vertices encode exact values", "[VertexFormat]" ) {
+
+  nile::VertexQuantization quantization;
+  quantization.offset = glm::vec3( -1.0f );
+  quantization.scale = 2.0f;
+
+  Vertex vertex;
+  vertex.position = glm::vec3( -1.0f, 0.0f, 1.0f );
+  vertex.normal = glm::vec3( 0.0f, -1.0f, 0.0f );
+  vertex.uv = glm::vec2( 0.5f, 3.0f );
+
+  const auto packed = nile::Math::packVertex( vertex, quantization );
+  REQUIRE( packed.position[ 0 ] == 0 );
+  REQUIRE( packed.position[ 2 ] == 65535 );
+
+  const auto decoded = nile::Math::unpackVertex( packed, quantization );
+  REQUIRE( decoded.position.x == -1.0f );
+  REQUIRE( decoded.position.z == 1.0f );
+  REQUIRE( decoded.normal == glm::vec3( 0.0f, -1.0f, 0.0f ) );
+  // Repeating uvs outside of 0..1 survive
+  REQUIRE( decoded.uv == glm::vec2( 0.5f, 3.0f ) );
+
+  // Meshes without normals
+  vertex.normal = glm::vec3( 0.0f );
+  REQUIRE( nile::Math::unpackVertex( nile::Math::packVertex( vertex, quantization ), quantization )
+               .normal == glm::vec3( 0.0f ) );
+}
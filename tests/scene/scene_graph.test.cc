@@ -0,0 +1,166 @@
+#include <Nile/scene/scene_graph.hh>
+#include <algorithm>
+#include <catch.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <random>
+#include <vector>
+
+using nile::AABB;
+using nile::Entity;
+using nile::f32;
+using nile::i32;
+using nile::RayHit;
+using nile::SceneGraph;
+using nile::u32;
+
+namespace {
+
+  struct Object {
+    AABB bounds;
+    i32 proxy;
+  };
+
+  AABB randomBox( std::mt19937 &rng ) {
+    std::uniform_real_distribution<f32> position( -100.0f, 100.0f );
+    std::uniform_real_distribution<f32> size( 0.1f, 2.0f );
+    const glm::vec3 center( position( rng ), position( rng ), position( rng ) );
+    return {center - glm::vec3( size( rng ) ), center + glm::vec3( size( rng ) )};
+  }
+
+  std::vector<Entity> sorted( std::vector<Entity> entities ) {
+    std::sort( entities.begin(), entities.end() );
+    return entities;
+  }
+
+}    // namespace
+
+TEST_CASE( "SceneGraph stays valid and balanced", "[SceneGraph]" ) {
+
+  std::mt19937 rng( 1337 );
+  SceneGraph graph;
+  std::vector<Object> objects;
+
+  for ( Entity entity = 1; entity <= 1000; ++entity ) {
+    const auto bounds = randomBox( rng );
+    objects.push_back( {bounds, graph.createProxy( bounds, entity )} );
+  }
+
+  REQUIRE( graph.size() == 1000 );
+  REQUIRE( graph.validate() );
+  // A perfectly balanced tree of 1000 leaves has a height of 10
+  REQUIRE( graph.getHeight() <= 20 );
+
+  SECTION( "Moving objects" ) {
+    std::uniform_real_distribution<f32> step( -3.0f, 3.0f );
+    u32 reinserted = 0;
+
+    for ( u32 frame = 0; frame < 10; ++frame ) {
+      for ( auto &object : objects ) {
+        const glm::vec3 displacement( step( rng ), step( rng ), step( rng ) );
+        object.bounds = {object.bounds.min + displacement, object.bounds.max + displacement};
+        reinserted += graph.moveProxy( object.proxy, object.bounds, displacement );
+      }
+    }
+
+    REQUIRE( reinserted > 0 );
+    REQUIRE( graph.validate() );
+    REQUIRE( graph.getHeight() <= 20 );
+  }
+
+  SECTION( "Removing objects" ) {
+    for ( u32 i = 0; i < objects.size(); i += 2 )
+      graph.destroyProxy( objects[ i ].proxy );
+
+    REQUIRE( graph.size() == 500 );
+    REQUIRE( graph.validate() );
+
+    // Freed nodes are reused
+    const auto proxy = graph.createProxy( randomBox( rng ), 5000 );
+    REQUIRE( graph.getEntity( proxy ) == 5000 );
+    REQUIRE( graph.validate() );
+  }
+}
+
+TEST_CASE( "SceneGraph queries match a brute force search", "[SceneGraph]" ) {
+
+  std::mt19937 rng( 42 );
+  SceneGraph graph;
+  std::vector<AABB> boxes( 1 );
+
+  for ( Entity entity = 1; entity <= 2000; ++entity ) {
+    boxes.push_back( randomBox( rng ) );
+    graph.createProxy( boxes.back(), entity );
+  }
+
+  SECTION( "Box query" ) {
+    const AABB region {glm::vec3( -20.0f ), glm::vec3( 20.0f )};
+
+    std::vector<Entity> found;
+    graph.query( region, [&]( Entity entity, i32 ) {
+      // Fat bounds may report a few extra objects, keep the exact ones
+      if ( nile::Math::overlaps( boxes[ entity ], region ) )
+        found.push_back( entity );
+      return true;
+    } );
+
+    std::vector<Entity> expected;
+    for ( Entity entity = 1; entity < boxes.size(); ++entity ) {
+      if ( nile::Math::overlaps( boxes[ entity ], region ) )
+        expected.push_back( entity );
+    }
+
+    REQUIRE( !expected.empty() );
+    REQUIRE( sorted( found ) == expected );
+  }
+
+  SECTION( "Frustum query" ) {
+    const auto frustum = nile::Frustum::fromMatrix(
+        glm::perspective( glm::radians( 45.0f ), 1.0f, 1.0f, 100.0f ) *
+        glm::lookAt( glm::vec3( 0.0f ), glm::vec3( 0.0f, 0.0f, -1.0f ),
+                     glm::vec3( 0.0f, 1.0f, 0.0f ) ) );
+
+    std::vector<Entity> found;
+    graph.query( frustum, [&]( Entity entity, i32 ) {
+      if ( frustum.intersects( boxes[ entity ] ) )
+        found.push_back( entity );
+      return true;
+    } );
+
+    std::vector<Entity> expected;
+    for ( Entity entity = 1; entity < boxes.size(); ++entity ) {
+      if ( frustum.intersects( boxes[ entity ] ) )
+        expected.push_back( entity );
+    }
+
+    REQUIRE( !expected.empty() );
+    REQUIRE( sorted( found ) == expected );
+  }
+
+  SECTION( "Nearest object" ) {
+    const glm::vec3 point( 3.0f, -7.0f, 12.0f );
+
+    RayHit hit;
+    REQUIRE( graph.nearest( point, 1000.0f, hit ) );
+
+    f32 best = 1000.0f;
+    for ( Entity entity = 1; entity < boxes.size(); ++entity ) {
+      const auto closest = glm::clamp( point, boxes[ entity ].min, boxes[ entity ].max );
+      best = std::min( best, glm::length( point - closest ) );
+    }
+
+    REQUIRE( hit.distance == Approx( best ) );
+  }
+
+  SECTION( "Ray cast" ) {
+    // Straight through the box of the first object
+    const auto target = boxes[ 1 ].center();
+    const glm::vec3 origin( 0.0f, 0.0f, 200.0f );
+
+    RayHit hit;
+    REQUIRE( graph.raycast( origin, target - origin, 1000.0f, hit ) );
+    REQUIRE( hit.distance <= glm::length( target - origin ) );
+
+    RayHit miss;
+    REQUIRE_FALSE( graph.raycast( origin, glm::vec3( 0.0f, 0.0f, 1.0f ), 1000.0f, miss ) );
+  }
+}